@@ -33,6 +33,30 @@ contains(DEFINES, LIISIM_FULL){
 }
 TARGET = LIISim3
 
+# -------------------------------------------------
+# BATCH PROCESSING TARGET
+# 'qmake CONFIG+=liisim_batch' builds LIISim3-batch from
+# the same sources, which always starts in batch mode
+# (see general/batchprocessor.h, otherwise use 'LIISim3 --batch')
+# -------------------------------------------------
+
+liisim_batch{
+    message("LIISim3.pro: Batch processing target will be build")
+    TARGET = LIISim3-batch
+    DEFINES += "LIISIM_BATCH"
+}
+
+# -------------------------------------------------
+# PROFILING
+# profiling zones (see general/profiling.h) are compiled
+# into debug builds, 'qmake CONFIG+=liisim_profiling'
+# enables them for release builds
+# -------------------------------------------------
+
+CONFIG(debug, debug|release)|liisim_profiling{
+    DEFINES += "LIISIM_PROFILING"
+}
+
 # -------------------------------------------------
 # EXTERNAL LIBRARY PATHS
 # -------------------------------------------------
@@ -93,6 +117,11 @@ SOURCES += \
     database/structure/material.cpp \
     database/structure/opticalproperty.cpp \
     database/structure/property.cpp \
+    general/batchprocessor.cpp \
+    general/benchmark.cpp \
+    general/headlessapplication.cpp \
+    general/profiling.cpp \
+    general/taskscheduler.cpp \
     general/channel.cpp \
     general/filter.cpp \    
     gui/analysisTools/analysistools.cpp \
@@ -122,6 +151,8 @@ SOURCES += \
     gui/signalEditor/gridablesplitter.cpp \
     gui/signalEditor/importdialog.cpp \
     gui/signalEditor/memusagewidget.cpp \
+    gui/signalEditor/profilingwidget.cpp \
+    gui/signalEditor/profilingresultsdialog.cpp \
     gui/signalEditor/sessionloaddialog.cpp \
     gui/signalEditor/sessionsavedialog.cpp \
     gui/signalEditor/signalprocessingeditor.cpp \
@@ -133,6 +164,7 @@ SOURCES += \
     gui/utils/customQwtPlot/customplotoptionswidget.cpp \
     gui/utils/customQwtPlot/customplotpicker.cpp \
     gui/utils/customQwtPlot/signalplotcurve.cpp \
+    gui/utils/customQwtPlot/signalseriesdata.cpp \
     gui/utils/datatablewidget.cpp \
     gui/utils/helpmanager.cpp \
     gui/utils/labeledcombobox.cpp \
@@ -154,6 +186,7 @@ SOURCES += \
     io/ioxml.cpp \    
     io/signalfileinfo.cpp \
     io/signaliorequest.cpp \
+    logging/asynclogwriter.cpp \
     logging/consoleouthandler.cpp \
     logging/logfilehandler.cpp \
     logging/logmessagewidget.cpp \
@@ -193,6 +226,7 @@ SOURCES += \
     signal/processing/plugins/temperaturecalculator.cpp \    
     signal/processing/plugins/xshiftsignals.cpp \
     signal/processing/ppstepbuffer.cpp \
+    signal/processing/ppresultcache.cpp \
     signal/processing/processingchain.cpp \
     signal/processing/processingplugin.cpp \
     signal/processing/processingpluginconnector.cpp \
@@ -203,6 +237,9 @@ SOURCES += \
     signal/signal.cpp \
     signal/signalmanager.cpp \
     signal/signalpair.cpp \
+    signal/compactsignal.cpp \
+    signal/fithistorystore.cpp \
+    signal/signalresampler.cpp \
     models/dataitemobserverobject.cpp \
     models/dataitemobserverwidget.cpp \
     gui/analysisTools/tools/atoolcalibration.cpp \
@@ -280,7 +317,12 @@ SOURCES += \
     gui/databaseEditor/liisettingsnamedialog.cpp \
     gui/analysisTools/tools/measurementlist.cpp \
     calculations/models/htm_musikhin.cpp \
-    gui/utils/flowlayout.cpp
+    gui/utils/flowlayout.cpp \
+    signal/processing/pointwiseoperation.cpp \
+    signal/processing/pointwisesegment.cpp \
+    io/numerictableparser.cpp \
+    io/fitresultfile.cpp \
+    io/sessionautosaver.cpp
 
 
 HEADERS  += \
@@ -303,6 +345,11 @@ HEADERS  += \
     database/structure/material.h \
     database/structure/opticalproperty.h \
     database/structure/property.h \
+    general/batchprocessor.h \
+    general/benchmark.h \
+    general/headlessapplication.h \
+    general/profiling.h \
+    general/taskscheduler.h \
     general/channel.h \
     general/filter.h \
     general/LIISimException.h \
@@ -335,6 +382,8 @@ HEADERS  += \
     gui/signalEditor/gridablesplitter.h \
     gui/signalEditor/importdialog.h \
     gui/signalEditor/memusagewidget.h \
+    gui/signalEditor/profilingwidget.h \
+    gui/signalEditor/profilingresultsdialog.h \
     gui/signalEditor/sessionloaddialog.h \
     gui/signalEditor/sessionsavedialog.h \
     gui/signalEditor/signalprocessingeditor.h \
@@ -345,6 +394,7 @@ HEADERS  += \
     gui/utils/customQwtPlot/customplotmagnifier.h \
     gui/utils/customQwtPlot/customplotoptionswidget.h \
     gui/utils/customQwtPlot/customplotpicker.h \
+    gui/utils/customQwtPlot/signalseriesdata.h \
     gui/utils/customQwtPlot/signalplotcurve.h \
     gui/utils/datatablewidget.h \
     gui/utils/helpmanager.h \
@@ -368,6 +418,7 @@ HEADERS  += \
     io/ioxml.h \    
     io/signalfileinfo.h \
     io/signaliorequest.h \
+    logging/asynclogwriter.h \
     logging/consoleouthandler.h \
     logging/logfilehandler.h \
     logging/logmessagewidget.h \
@@ -407,6 +458,7 @@ HEADERS  += \
     signal/processing/plugins/temperaturecalculator.h \
     signal/processing/plugins/xshiftsignals.h \
     signal/processing/ppstepbuffer.h \
+    signal/processing/ppresultcache.h \
     signal/processing/processingchain.h \
     signal/processing/processingplugin.h \
     signal/processing/processingpluginconnector.h \
@@ -417,6 +469,9 @@ HEADERS  += \
     signal/signal.h \
     signal/signalmanager.h \
     signal/signalpair.h \
+    signal/compactsignal.h \
+    signal/fithistorystore.h \
+    signal/signalresampler.h \
     models/dataitemobserverobject.h \
     models/dataitemobserverwidget.h \
     gui/utils/baseplotwidgetqwt.h \
@@ -481,7 +536,6 @@ HEADERS  += \
     calculations/models/htm_liu.h \
     io/consistencycheck.h \
     gui/utils/aboutwindow.h \
-    general/profiler.h \
     calculations/models/htm_menser.h \
     gui/utils/minimizablewidget.h \
     signal/tempcalcmetadata.h \
@@ -497,7 +551,12 @@ HEADERS  += \
     gui/analysisTools/tools/measurementlist.h \
     gui/analysisTools/tools/measurementlisthelper.h \
     calculations/models/htm_musikhin.h \
-    gui/utils/flowlayout.h
+    gui/utils/flowlayout.h \
+    signal/processing/pointwiseoperation.h \
+    signal/processing/pointwisesegment.h \
+    io/numerictableparser.h \
+    io/fitresultfile.h \
+    io/sessionautosaver.h
 
 # include PicoScope/DataAcquisition Code
 # if LIISIM_PICOSCOPE has been defined (see top of this file)
@@ -507,23 +566,27 @@ contains(DEFINES, LIISIM_PICOSCOPE){
     gui/dataAcquisition/dataacquisitionwindow.h \
     settings/picoscopesettings.h \
     io/picoscope.h \
+    io/streamrecorder.h \
     io/laserenergyposition.h \
     gui/dataAcquisition/da_laserenergysettingswidget.h \
     gui/dataAcquisition/picoscopesettingswidget.h \
     gui/dataAcquisition/da_runsettingswidget.h \
     gui/dataAcquisition/da_triggerdialog.h \
-    gui/dataAcquisition/da_exportsettingswidget.h
+    gui/dataAcquisition/da_exportsettingswidget.h \
+    gui/dataAcquisition/da_processingpipeline.h
 
     SOURCES += \
     gui/dataAcquisition/dataacquisitionwindow.cpp \
     settings/picoscopesettings.cpp \
     io/picoscope.cpp \
+    io/streamrecorder.cpp \
     io/laserenergyposition.cpp \
     gui/dataAcquisition/da_laserenergysettingswidget.cpp \
     gui/dataAcquisition/picoscopesettingswidget.cpp \
     gui/dataAcquisition/da_runsettingswidget.cpp \
     gui/dataAcquisition/da_triggerdialog.cpp \
-    gui/dataAcquisition/da_exportsettingswidget.cpp
+    gui/dataAcquisition/da_exportsettingswidget.cpp \
+    gui/dataAcquisition/da_processingpipeline.cpp
 
 }
 
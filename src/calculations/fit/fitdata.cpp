@@ -1,5 +1,7 @@
 #include "fitdata.h"
 
+#include <cmath>
+
 #include "../../core.h"
 #include "../../signal/mrungroup.h"
 #include "fitrun.h"
@@ -246,6 +248,7 @@ Signal FitData::dataSignal()
 void FitData::clearResults()
 {
     m_iterationResults.clear();
+    m_resultsFile.clear();
 }
 
 
@@ -260,7 +263,7 @@ QString FitData::toString()
             .arg(m_in_mp_idx)
             .arg(m_in_ch_id)
             .arg(Signal::stypeToString(m_in_stype))
-            .arg(m_iterationResults.size());
+            .arg(iterationResCount());
     for(int i = 0; i < m_iterationResults.size(); i++)
     {
         res.append(QString("\t%0\n").arg(m_iterationResults[i].toString()));
@@ -280,23 +283,121 @@ void FitData::addIterationResult(const FitIterationResult& res)
 
 QList<FitIterationResult> FitData::iterationResultList()
 {
+    loadResults();
     return m_iterationResults;
 }
 
 
 FitIterationResult FitData::iterationResult(int i)
 {
+    loadResults();
     return m_iterationResults.value(i, FitIterationResult(0));
 }
 
 
 FitIterationResult FitData::iterationResultLast()
 {
+    loadResults();
     return m_iterationResults.last();
 }
 
 
-void FitData::writeToXML(QXmlStreamWriter &w)
+/**
+ * @brief FitData::setResultsLocation defines the position of the iteration
+ * results within a sidecar file, results are loaded on first access
+ * @param fileName sidecar file (see FitResultFile)
+ * @param block
+ */
+void FitData::setResultsLocation(const QString &fileName, const FitResultFile::Block &block)
+{
+    m_iterationResults.clear();
+    m_resultsFile = fileName;
+    m_resultsBlock = block;
+}
+
+
+/**
+ * @brief FitData::loadResults loads the iteration results from the sidecar file
+ * (does nothing if the results are already loaded)
+ * @return true if results are available
+ */
+bool FitData::loadResults()
+{
+    if(m_resultsFile.isEmpty())
+        return true;
+
+    QFile file(m_resultsFile);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        MSG_WARN(QString("FitData: cannot open fit results %0 (%1)").arg(m_resultsFile).arg(file.errorString()));
+        m_resultsFile.clear();
+        return false;
+    }
+    if(!FitResultFile::readHeader(file))
+    {
+        m_resultsFile.clear();
+        return false;
+    }
+    return loadResults(file);
+}
+
+
+/**
+ * @brief FitData::loadResults loads the iteration results from an opened sidecar file
+ * (see FitRun::loadResults())
+ * @param file sidecar file
+ * @return true if results are available
+ */
+bool FitData::loadResults(QFile &file)
+{
+    if(m_resultsFile.isEmpty())
+        return true;
+
+    // results are not available if loading failed, do not retry
+    m_resultsFile.clear();
+    return FitResultFile::readBlock(file, m_resultsBlock, m_iterationResults);
+}
+
+
+/**
+ * @brief FitData::bestParameters returns the parameter values of the
+ * iteration with the lowest chi-square (used as start values for the next fit)
+ * @return parameter values (empty if no iteration results are available)
+ */
+QVector<double> FitData::bestParameters()
+{
+    QVector<double> res;
+
+    loadResults();
+
+    int best = -1;
+    for(int i = 0; i < m_iterationResults.size(); i++)
+    {
+        if(m_iterationResults.at(i).size() < 2 || !std::isfinite(m_iterationResults.at(i).at(0)))
+            continue;
+        if(best < 0 || m_iterationResults.at(i).at(0) < m_iterationResults.at(best).at(0))
+            best = i;
+    }
+
+    if(best < 0)
+        return res;
+
+    // layout: chisquare, lambda, a[0], da[0], a[1], da[1], ...
+    const FitIterationResult &fres = m_iterationResults.at(best);
+    for(int k = 2; k < fres.size(); k += 2)
+        res.append(fres.at(k));
+
+    return res;
+}
+
+
+/**
+ * @brief FitData::writeToXML
+ * @param w
+ * @param block position of iteration results in sidecar file,
+ * if not set, all iteration results are written to XML
+ */
+void FitData::writeToXML(QXmlStreamWriter &w, const FitResultFile::Block *block)
 {
     MRun* mr = Core::instance()->dataModel()->mrun(m_in_mrun_id);
     if(!mr)
@@ -314,13 +415,30 @@ void FitData::writeToXML(QXmlStreamWriter &w)
     w.writeAttribute("ch_id",QString::number(m_in_ch_id));
     w.writeAttribute("stype",Signal::stypeToString(m_in_stype));
 
-    for(int i = 0; i < m_iterationResults.size();i++)
-        m_iterationResults[i].writeToXML(w);
+    if(block)
+    {
+        w.writeAttribute("offset", QString::number(block->offset));
+        w.writeAttribute("iterations", QString::number(block->iterations));
+        w.writeAttribute("params", QString::number(block->params));
+    }
+    else
+    {
+        loadResults();
+        for(int i = 0; i < m_iterationResults.size();i++)
+            m_iterationResults[i].writeToXML(w);
+    }
 
     w.writeEndElement(); // FitData
 }
 
-bool FitData::readFromXml(QXmlStreamReader &r)
+/**
+ * @brief FitData::readFromXml
+ * @param r
+ * @param resultsFile sidecar file of FitRun (results are stored in sidecar
+ * if the FitData element has an 'offset' attribute)
+ * @return
+ */
+bool FitData::readFromXml(QXmlStreamReader &r, const QString &resultsFile)
 {
 
     if(r.tokenType() != QXmlStreamReader::StartElement &&  r.name() == "FitData")
@@ -349,6 +467,15 @@ bool FitData::readFromXml(QXmlStreamReader &r)
     m_in_ch_id = a.value("ch_id").toInt();
     m_in_stype = Signal::stypeFromString(a.value("stype").toString());
 
+    if(a.hasAttribute("offset") && !resultsFile.isEmpty())
+    {
+        FitResultFile::Block block;
+        block.offset = a.value("offset").toLongLong();
+        block.iterations = a.value("iterations").toInt();
+        block.params = a.value("params").toInt();
+        setResultsLocation(resultsFile, block);
+    }
+
     while( !(r.name() == "FitData" &&  r.tokenType() == QXmlStreamReader::EndElement))
     {
         if(r.tokenType() == QXmlStreamReader::StartElement)
@@ -385,6 +512,8 @@ MRun* FitData::mrun()
 QVector<double> FitData::getParameterCurve(int param)
 {
     QVector<double> curve;
+
+    loadResults();
     if(m_iterationResults.isEmpty())
         return curve;
 
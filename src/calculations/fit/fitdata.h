@@ -7,6 +7,7 @@
 #include <QXmlStreamReader>
 
 #include "fititerationresult.h"
+#include "../../io/fitresultfile.h"
 #include "../../signal/signal.h"
 #include "../../signal/mrun.h"
 
@@ -54,21 +55,36 @@ public:
     void clearResults();
 
     void addIterationResult(const FitIterationResult &res);
-    inline int iterationResCount() const{ return m_iterationResults.size(); }
+    inline int iterationResCount() const{ return m_resultsFile.isEmpty() ? m_iterationResults.size() : m_resultsBlock.iterations; }
+
+    /** @brief false if iteration results are stored in sidecar file and have not been loaded yet */
+    inline bool resultsLoaded() const { return m_resultsFile.isEmpty(); }
+    inline QString resultsFile() const { return m_resultsFile; }
+    inline FitResultFile::Block resultsBlock() const { return m_resultsBlock; }
+    void setResultsLocation(const QString &fileName, const FitResultFile::Block &block);
+    bool loadResults();
+    bool loadResults(QFile &file);
 
     QList<FitIterationResult> iterationResultList();
     FitIterationResult iterationResult(int i);
     FitIterationResult iterationResultLast();
 
+    QVector<double> bestParameters();
+
+    /** @brief start values of fit parameters (empty: FitParameter::value() is used) */
+    inline QVector<double> startValues() const { return m_startValues; }
+    inline void setStartValues(const QVector<double> &values) { m_startValues = values; }
+
     QString toString();
 
     inline int mrunID()const {                  return m_in_mrun_id;}
     inline int temperatureChannelID() const {   return m_in_ch_id;}
     inline int mpoint()const {                  return m_in_mp_idx;}
+    inline Signal::SType signalType() const {   return m_in_stype;}
     inline FitRun* fitRun()const {              return m_fitrun;}
 
-    void writeToXML(QXmlStreamWriter &w);
-    bool readFromXml(QXmlStreamReader &r);
+    void writeToXML(QXmlStreamWriter &w, const FitResultFile::Block *block = 0);
+    bool readFromXml(QXmlStreamReader &r, const QString &resultsFile = QString());
 
     MRun* mrun();
 
@@ -80,6 +96,12 @@ private:
 
     QList<FitIterationResult> m_iterationResults;
 
+    QVector<double> m_startValues;
+
+    /** @brief sidecar file of iteration results which have not been loaded yet */
+    QString m_resultsFile;
+    FitResultFile::Block m_resultsBlock;
+
     int m_in_mrun_id;
     int m_in_mp_idx;
     int m_in_ch_id;
@@ -1,18 +1,26 @@
 #include "fitrun.h"
 
-#include <QtConcurrent/qtconcurrentrun.h>
 #include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <algorithm>
 
 #include "../../core.h"
 #include "../../calculations/numeric.h"
+#include "../../general/taskscheduler.h"
 
 int FitRun::m_id_count = 0;
+int FitRun::m_results_number_count = 0;
 
 FitRun::FitRun(FitMode mode, QObject *parent) : QObject(parent)
 {
     m_mode = mode;
 
     m_id = m_id_count++;
+    m_resultsNumber = -1;
     m_finishedfits = 0;
 
     m_name = generateName();
@@ -31,6 +39,9 @@ FitRun::FitRun(FitMode mode, QObject *parent) : QObject(parent)
     m_numericSettings = new NumericSettings(this);
     m_fitSettings = new FitSettings(this);
     m_canceled = false;
+    m_fitting = false;
+    m_batchMode = false;
+    m_nextChunk = 0;
 
 
     Core::instance()->dataModel()->registerFitRun(this);
@@ -99,6 +110,7 @@ ModelingSettings* FitRun::modelingSettings(int i)
 void FitRun::setFitData(QList<FitData> &data)
 {
     m_fitData = data;
+    m_savedResultsFile.clear();
     for(int i = 0; i < m_fitData.size(); i++)
     {
         m_fitData[i].setFitRun(this);
@@ -139,6 +151,17 @@ int FitRun::updatedProgressStepCount(int iterations_passed)
 }
 
 
+/**
+ * @brief FitRun::setBatchMode enables chunked fitting with warm start
+ * (see class description)
+ * @param batchMode
+ */
+void FitRun::setBatchMode(bool batchMode)
+{
+    m_batchMode = batchMode;
+}
+
+
 void FitRun::fitAll()
 {
     emit fitStarted();
@@ -152,12 +175,98 @@ void FitRun::fitAll()
     int steps = calculateProgressStepCount();
     Core::instance()->initProgressBar(steps);
 
-    Numeric::canceled = false;
+    m_token = TaskCancellationToken();
+    m_canceled = false;
+    m_fitting = true;
     m_finishedfits = 0;
 
+    // iteration results change, sidecar file has to be written again
+    m_savedResultsFile.clear();
+
+    if(m_batchMode)
+    {
+        fitBatch();
+        return;
+    }
+
     for(int i = 0; i < m_fitData.size(); i++)
         //fitAsync(i);
-        QtConcurrent::run(this, &FitRun::fitAsync, i);
+        TaskScheduler::instance()->run(TaskScheduler::FITTING, [this, i]{ fitAsync(i); });
+}
+
+
+/**
+ * @brief FitRun::cancel cancels all running/pending fits of this FitRun
+ */
+void FitRun::cancel()
+{
+    m_token.cancel();
+}
+
+
+/**
+ * @brief FitRun::fitBatch splits the FitData into chunks of consecutive
+ * shots (same run and channel, ordered by MPoint index) and starts the
+ * batch workers
+ */
+void FitRun::fitBatch()
+{
+    QMap<QPair<int,int>, QList<int>> series;
+
+    for(int i = 0; i < m_fitData.size(); i++)
+        series[qMakePair(m_fitData.at(i).mrunID(), m_fitData.at(i).temperatureChannelID())].append(i);
+
+    m_chunks.clear();
+
+    for(auto it = series.begin(); it != series.end(); ++it)
+    {
+        QList<int> &indices = it.value();
+        std::sort(indices.begin(), indices.end(), [this](int a, int b) {
+            return m_fitData.at(a).mpoint() < m_fitData.at(b).mpoint();
+        });
+
+        for(int k = 0; k < indices.size(); k += batchChunkSize)
+            m_chunks.append(indices.mid(k, batchChunkSize));
+    }
+
+    m_nextChunk = 0;
+
+    // bounded worker pool: at most one worker per thread of the fitting lane
+    int workers = qMin(m_chunks.size(),
+                       TaskScheduler::instance()->laneLimit(TaskScheduler::FITTING));
+
+    for(int w = 0; w < workers; w++)
+        TaskScheduler::instance()->run(TaskScheduler::FITTING, [this]{ batchWorker(); });
+}
+
+
+/**
+ * @brief FitRun::batchWorker fits chunk after chunk until all chunks are
+ * processed. The best parameters of the previous shot are used as start
+ * values of the next fit. The first shot of a chunk is started from the start
+ * values of FitSettings (not from the preceding chunk, which might still be in
+ * progress), so the results are reproducible.
+ */
+void FitRun::batchWorker()
+{
+    int c;
+    while((c = m_nextChunk.fetch_add(1)) < m_chunks.size())
+    {
+        const QList<int> &chunk = m_chunks.at(c);
+
+        // empty: start values of FitSettings
+        QVector<double> seed;
+        for(int i : chunk)
+        {
+            m_fitData[i].setStartValues(seed);
+            fitAsync(i);
+
+            // keep last seed if fit failed
+            QVector<double> best = m_fitData[i].bestParameters();
+            if(!best.isEmpty())
+                seed = best;
+        }
+    }
 }
 
 
@@ -179,7 +288,8 @@ void FitRun::fitAsync(int i)
                     &m_fitData[i],
                     m_modelingSettingsList[i],
                     m_fitSettings,
-                    m_numericSettings);
+                    m_numericSettings,
+                    &m_token);
 
 
     emit asyncFitFinished(i);
@@ -196,8 +306,8 @@ void FitRun::onAsyncFitFinished(int i)
 
     if(m_finishedfits == m_fitData.size())
     {
-        m_canceled = Numeric::canceled;
-        Numeric::canceled = false;
+        m_canceled = m_token.isCancelled();
+        m_fitting = false;
 
         emit modified();
         emit fitFinished();
@@ -281,24 +391,81 @@ QString FitRun::toString()
 }
 
 
-void FitRun::writeToXML(QXmlStreamWriter &w)
+/**
+ * @brief FitRun::writeToXML
+ * @param w
+ * @param resultsFile if set, the iteration results are written asynchronously
+ * to this binary sidecar file (see FitResultFile) and the XML only contains
+ * the position of the results, otherwise all iteration results are written to XML.
+ * If the sidecar file already holds the current results (results unchanged
+ * since the file has been written or loaded), only the positions are written:
+ * results which have not been loaded yet are not accessed.
+ */
+void FitRun::writeToXML(QXmlStreamWriter &w, const QString &resultsFile)
 {
     w.writeStartElement("FitRun");
     w.writeAttribute("name",m_name);
     w.writeAttribute("creationDate",m_creationDate.toString("dd.MM.yyyy hh:mm:ss.zzz"));
 
+    QList<QList<FitIterationResult>> results;
+    QList<FitResultFile::Block> blocks;
+
+    if(!resultsFile.isEmpty())
+    {
+        if(resultsFile == m_savedResultsFile && m_savedBlocks.size() == m_fitData.size())
+            blocks = m_savedBlocks;
+        else
+        {
+            for(int i = 0; i < m_fitData.size(); i++)
+                results.append(m_fitData[i].iterationResultList());
+
+            blocks = FitResultFile::layout(results);
+        }
+
+        // relative to session file
+        w.writeAttribute("results", QFileInfo(resultsFile).fileName());
+    }
+
     m_initModelingSettings->writeToXML(w);
     m_fitSettings->writeToXML(w);
     m_numericSettings->writeToXML(w);
 
     for(int i = 0; i < m_fitData.size(); i++)
-        m_fitData[i].writeToXML(w);
+        m_fitData[i].writeToXML(w, blocks.isEmpty() ? 0 : &blocks.at(i));
 
     w.writeEndElement(); // FitRun
+
+    if(!resultsFile.isEmpty() && resultsFile != m_savedResultsFile)
+    {
+        FitResultFile::writeAsync(resultsFile, results);
+        m_savedResultsFile = resultsFile;
+        m_savedBlocks = blocks;
+    }
 }
 
 
-void FitRun::readFromXml(QXmlStreamReader &r)
+/**
+ * @brief FitRun::resultsFileName
+ * @param sessionFile
+ * @return sidecar file of this FitRun next to the session file. The number
+ * of the file is kept when the session is loaded again, the FitRun id may change.
+ */
+QString FitRun::resultsFileName(const QString &sessionFile)
+{
+    if(m_resultsNumber < 0)
+        m_resultsNumber = m_results_number_count++;
+
+    return FitResultFile::sidecarFileName(sessionFile, m_resultsNumber);
+}
+
+
+/**
+ * @brief FitRun::readFromXml
+ * @param r
+ * @param baseDir directory of session file (location of sidecar files),
+ * iteration results stored in sidecar files are loaded on first access (see loadResults())
+ */
+void FitRun::readFromXml(QXmlStreamReader &r, const QString &baseDir)
 {
     if(r.tokenType() != QXmlStreamReader::StartElement &&  r.name() == "FitRun")
         return;
@@ -307,6 +474,29 @@ void FitRun::readFromXml(QXmlStreamReader &r)
     m_name = a.value("name").toString();
 
     m_creationDate = QDateTime::fromString(a.value("creationDate").toString(),"dd.MM.yyyy hh:mm:ss.zzz");
+
+    QString resultsFile;
+    bool numberUsed = false;
+    if(a.hasAttribute("results"))
+    {
+        resultsFile = QDir(baseDir).filePath(a.value("results").toString());
+
+        // keep number of sidecar file (unless used by another FitRun)
+        QRegularExpressionMatch match = QRegularExpression("\\.fitrun(\\d+)\\.")
+                .match(a.value("results").toString());
+        if(match.hasMatch())
+        {
+            int number = match.captured(1).toInt();
+            for(FitRun* other : Core::instance()->dataModel()->fitRuns())
+                numberUsed |= (other != this && other->m_resultsNumber == number);
+
+            if(!numberUsed)
+            {
+                m_resultsNumber = number;
+                m_results_number_count = qMax(m_results_number_count, number + 1);
+            }
+        }
+    }
     while( !(r.name() == "FitRun" &&  r.tokenType() == QXmlStreamReader::EndElement))
     {
         if(r.tokenType() == QXmlStreamReader::StartElement)
@@ -317,19 +507,89 @@ void FitRun::readFromXml(QXmlStreamReader &r)
             if(r.name() == "FitData")
             {
                 FitData fdat;
-                bool success = fdat.readFromXml(r);
+                bool success = fdat.readFromXml(r, resultsFile);
                 if(success)
                     m_fitData << fdat;
             }
         }
         r.readNext();
     }
-    qDebug() << "FitRun::readFromXml";
-    qDebug() << toString();
+    // results of all FitData are stored within the sidecar file
+    m_savedResultsFile.clear();
+    m_savedBlocks.clear();
+    for(int i = 0; i < m_fitData.size(); i++)
+    {
+        if(m_fitData.at(i).resultsFile() != resultsFile || resultsFile.isEmpty())
+        {
+            m_savedBlocks.clear();
+            break;
+        }
+        m_savedBlocks << m_fitData.at(i).resultsBlock();
+    }
+    if(m_savedBlocks.size() == m_fitData.size() && !resultsFile.isEmpty())
+        m_savedResultsFile = resultsFile;
+
+    // sidecar file may be overwritten by the FitRun which uses its number
+    if(numberUsed)
+        loadResults();
+
+    qDebug() << "FitRun::readFromXml" << m_name << m_fitData.size();
     emit modified();
 }
 
 
+/**
+ * @brief FitRun::resultsLoaded
+ * @return false if iteration results of any FitData have not been loaded from sidecar file
+ */
+bool FitRun::resultsLoaded()
+{
+    for(int i = 0; i < m_fitData.size(); i++)
+        if(!m_fitData.at(i).resultsLoaded())
+            return false;
+    return true;
+}
+
+
+/**
+ * @brief FitRun::loadResults loads the iteration results of all FitData
+ * from the sidecar file (file is opened once)
+ */
+void FitRun::loadResults()
+{
+    QString fileName;
+    for(int i = 0; i < m_fitData.size() && fileName.isEmpty(); i++)
+        if(!m_fitData.at(i).resultsLoaded())
+            fileName = m_fitData[i].resultsFile();
+
+    if(fileName.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(fileName);
+    bool valid = file.open(QIODevice::ReadOnly) && FitResultFile::readHeader(file);
+    if(!valid)
+        MSG_WARN(QString("FitRun: cannot load fit results of %0 from %1").arg(m_name).arg(fileName));
+
+    for(int i = 0; i < m_fitData.size(); i++)
+    {
+        if(m_fitData.at(i).resultsLoaded())
+            continue;
+
+        if(m_fitData.at(i).resultsFile() != fileName)
+            m_fitData[i].loadResults();
+        else if(valid)
+            m_fitData[i].loadResults(file);
+        else
+            m_fitData[i].clearResults();
+    }
+
+    MSG_DETAIL_1(QString("FitRun: results of %0 loaded (%1 ms)").arg(m_name).arg(timer.elapsed()));
+}
+
+
 /**
  * @brief FitRun::generateName generates unique default name
  * @return
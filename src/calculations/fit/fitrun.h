@@ -7,14 +7,26 @@
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
 
+#include <atomic>
+
 #include "../../settings/fitsettings.h"
 #include "../../settings/numericsettings.h"
 #include "../../settings/modelingsettings.h"
 
+#include "../../general/taskscheduler.h"
+
 #include "fitdata.h"
 
 /**
  * @brief The FitRun class
+ * @details fitAll() fits all FitData in parallel (FITTING lane of TaskScheduler).
+ * In batch mode (single-shot fits of many MPoints) the FitData of each run/channel
+ * are sorted by MPoint index and split into chunks of batchChunkSize shots.
+ * A bounded number of workers (lane limit) processes the chunks, each fit is started
+ * from the best parameters of the previous shot (warm start). The first shot of a chunk
+ * is started from the start values of FitSettings, thus the results do not depend
+ * on the order in which the workers process the chunks.
+ * cancel() only cancels the fits of this FitRun.
  */
 class FitRun : public QObject
 {
@@ -38,6 +50,13 @@ public:
     inline FitSettings* fitSettings(){return m_fitSettings;}
     inline QDateTime creationDate(){return m_creationDate;}
     inline bool canceled(){return m_canceled;}
+    inline bool isFitting(){return m_fitting;}
+
+    /** @brief number of consecutive shots fitted with warm start by one batch worker */
+    static const int batchChunkSize = 32;
+
+    inline bool batchMode(){return m_batchMode;}
+    void setBatchMode(bool batchMode);
 
     void setFitSettings(FitSettings* fs);
     void setNumericSettings(NumericSettings* ns);
@@ -53,8 +72,13 @@ public:
 
     QString toString();
 
-    void writeToXML(QXmlStreamWriter &w);
-    void readFromXml(QXmlStreamReader &r);
+    void writeToXML(QXmlStreamWriter &w, const QString &resultsFile = QString());
+    void readFromXml(QXmlStreamReader &r, const QString &baseDir = QString());
+
+    QString resultsFileName(const QString &sessionFile);
+
+    bool resultsLoaded();
+    void loadResults();
 
     void setFitData(QList<FitData> & data);
 
@@ -62,6 +86,7 @@ public:
     int updatedProgressStepCount(int iterations_passed);
 
     void fitAll();
+    void cancel();
 
 
     /** @brief returns the FitData count of this run
@@ -91,18 +116,40 @@ private:
     FitSettings* m_fitSettings;
 
     bool m_canceled;
+    bool m_fitting;
+    bool m_batchMode;
+
+    /** @brief cancellation token of current fit job */
+    TaskCancellationToken m_token;
+
+    /** @brief batch mode: FitData indices of each chunk */
+    QList<QList<int>> m_chunks;
+    /** @brief batch mode: next chunk to be processed by a worker */
+    std::atomic<int> m_nextChunk;
 
     /** @brief global counter for id generation */
     static int m_id_count;
 
     /** @brief unique fitrun id */
     int m_id;
+
+    /** @brief global counter for sidecar file numbers (see resultsFileName()) */
+    static int m_results_number_count;
+    /** @brief number of sidecar file, kept when the session is loaded (-1: not assigned) */
+    int m_resultsNumber;
+
+    /** @brief sidecar file which holds the current iteration results (empty: none) */
+    QString m_savedResultsFile;
+    /** @brief position of the results of each FitData within m_savedResultsFile */
+    QList<FitResultFile::Block> m_savedBlocks;
     int m_finishedfits;
     int m_max_iteration_count;
 
     QString generateName();
 
     void fitAsync(int i);
+    void fitBatch();
+    void batchWorker();
 
     bool m_sectionSet;
     double m_sectionBegin;
@@ -4,11 +4,15 @@
 #include <boost/numeric/odeint.hpp> // runge_kutta4
 
 #include <algorithm>
+#include <limits>
+#include <QVarLengthArray>
 
 #include "../core.h"
 #include "../gui/utils/signalplotwidgetqwt.h"
 
-#include "../../general/profiler.h"
+#include "../general/profiling.h"
+#include "../general/taskscheduler.h"
+#include "constants.h"
 
 namespace odeint = boost::numeric::odeint;
 namespace pl = std::placeholders;
@@ -16,7 +20,6 @@ namespace pl = std::placeholders;
 /*******************************
  *      DEFAULT VALUES
  *******************************/
-bool Numeric::canceled = false;
 double Numeric::EPS = 1E-15;
 double Numeric::TOL = 1E-15; // 1E-5
 
@@ -185,12 +188,7 @@ Signal Numeric::solveODE(double T_start,
     //qDebug() << "Numeric::solver: " << getODEName(ODEsolver) << " - " << ODEsolver;
 
 
-    // timer for processing performance
-    bool timer = true;
-    QString timer_str = QString("Numeric::Timer: %0 - %1").arg(T_start).arg(dp_start);
-    Profiler p(timer_str.toStdString());
-    if(timer)
-        p.begin();
+    PROFILE_ZONE("numeric", "Numeric::solveODE (" + getODEName(ODEsolver) + ")", QString());
 
 
     // start values
@@ -449,13 +447,6 @@ Signal Numeric::solveODE(double T_start,
         }
     }
 
-    if(timer)
-    {
-        // Timer: End
-        p.end();
-        //qDebug() << p.getResult().c_str();
-    }
-
     // update progress bar
     Core::instance()->incProgressBar();
 
@@ -463,19 +454,312 @@ Signal Numeric::solveODE(double T_start,
 }
 
 
- /**
+ namespace {
+
+/**
+ * @brief solveCholeskyFixed solves A x = b (A: symmetric, positive definite)
+ * by Cholesky decomposition A = LL^T, the size is known at compile time
+ * (stack arrays, no heap allocation)
+ * @return false if A is not positive definite
+ */
+template<int N>
+bool solveCholeskyFixed(const double (&A)[N][N], const double (&b)[N], double (&x)[N])
+{
+    double L[N][N] = {};
+    double y[N];
+    double sum;
+
+    for(int i = 0; i < N; i++)
+    {
+        for(int j = 0; j <= i; j++)
+        {
+            sum = 0.0;
+            for(int k = 0; k < j; k++)
+                sum += L[i][k] * L[j][k];
+
+            if(i == j)
+            {
+                if(A[i][i] - sum <= 0.0)
+                    return false;
+                L[i][i] = std::sqrt(A[i][i] - sum);
+            }
+            else
+                L[i][j] = (A[i][j] - sum) / L[j][j];
+        }
+    }
+
+    // forward solution (L y = b)
+    for(int i = 0; i < N; i++)
+    {
+        sum = 0.0;
+        for(int k = 0; k < i; k++)
+            sum += L[i][k] * y[k];
+        y[i] = (b[i] - sum) / L[i][i];
+    }
+
+    // backward solution (L^T x = y)
+    for(int i = N-1; i >= 0; i--)
+    {
+        sum = 0.0;
+        for(int k = i+1; k < N; k++)
+            sum += L[k][i] * x[k];
+        x[i] = (y[i] - sum) / L[i][i];
+    }
+    return true;
+}
+
+
+/**
+ * @brief levmarPlanck Levenberg-Marquardt algorithm for FitRun::TEMP without
+ * bandpass integration (see Numeric::levmar(), same iteration scheme and results).
+ * @details Parameters: a[0]: temperature [K], a[1]: scaling factor C [-],
+ * NF: number of free parameters. The model y = C * K / (exp(x0 / T) - 1) with
+ * K = E(m) * c_1 / lambda^6 and x0 = c_2 / lambda is evaluated with analytic
+ * derivatives, E(m) is calculated once per wavelength. Curvature matrix and
+ * Cholesky solution use stack arrays of size NF.
+ */
+template<int NF>
+void levmarPlanck(FitData *fd,
+                  const QList<FitParameter> &fparams,
+                  ModelingSettings *ms,
+                  FitSettings *fs,
+                  NumericSettings *ns,
+                  const TaskCancellationToken *token)
+{
+    const int N = 2;
+
+    bool weighting = fs->weightingActive();
+
+    int IT = ns->iterations();
+    int NDONE = 4; // number of iterations with delta_chisquare < tol
+    int done = 0;
+    int stagnant = 0; // iterations without significant improvement
+
+    double a[N], a_next[N], a_min[N], a_max[N], da[N], da_max[N];
+    bool ia[N];
+
+    // indices of free parameters
+    int fidx[NF];
+
+    int nf = 0;
+    for(int j = 0; j < N; j++)
+    {
+        da[j]       = 0.0;
+        a[j]        = fparams.at(j).value();
+        a_next[j]   = a[j];
+        a_min[j]    = fparams.at(j).lowerBound();
+        a_max[j]    = fparams.at(j).upperBound();
+        da_max[j]   = fparams.at(j).maxDelta();
+        ia[j]       = fparams.at(j).enabled();
+        if(ia[j])
+            fidx[nf++] = j;
+    }
+
+    // model constants for each wavelength
+    const int M = fd->xdata.size();
+    QVarLengthArray<double, 16> K(M);
+    QVarLengthArray<double, 16> x0(M);
+
+    Material material_spec = ms->materialSpec();
+    QString sourceEm = fs->sourceEm();
+
+    for(int i = 0; i < M; i++)
+    {
+        double lambda_m = fd->xdata.at(i) * 1E-9;
+        double Em = Temperature::getEmBySource(lambda_m, material_spec, sourceEm);
+        K[i]  = Em / lambda_m * Constants::c_1 / pow(lambda_m, 5);
+        x0[i] = Constants::c_2 / lambda_m;
+    }
+
+    const int ysize = qMin(M, fd->ydata.size());
+
+    double chisquare;
+    double prev_chisquare = -1.0;
+
+    double lambda       = ns->lambda_init;
+    double lambda_dec   = ns->lambda_decrease;
+    double lambda_inc   = ns->lambda_increase;
+    double lambda_scale = ns->lambda_scaling;
+
+    double alpha[NF][NF];
+    double alpha_lambda[NF][NF];
+    double beta[NF];
+    double solution[NF];
+
+    for(int iter = 0; iter < IT; iter++)
+    {
+        if(token && token->isCancelled())
+        {
+            MSG_ASYNC("Numeric::levmar canceled!", DEBUG);
+            return;
+        }
+
+        // last pass, set damping factor to zero
+        if(done == NDONE) lambda = 0.0;
+
+        for(int j = 0; j < N; j++)
+        {
+            if(ia[j])
+            {
+                a[j] = a_next[j] - da[j];
+
+                if (a[j] < a_min[j])        a[j] = a_min[j];
+                else if(a[j] > a_max[j])    a[j] = a_max[j];
+            }
+        }
+
+        for(int j = 0; j < NF; j++)
+        {
+            for(int k = 0; k < NF; k++)
+                alpha[j][k] = 0.0;
+            beta[j] = 0.0;
+        }
+
+        chisquare = 0.0;
+
+        const double T = a[0];
+        const double C = a[1];
+
+        for(int i = 0; i < ysize; i++)
+        {
+            double e = exp(x0[i] / T);
+            double g = 1.0 / (e - 1.0);
+            double ymod = C * K[i] * g;
+
+            // negative derivatives (same convention as Numeric::levmar(): (ymod - ymod(a+h)) / h)
+            double dyda[N];
+            dyda[0] = -C * K[i] * e * g * g * x0[i] / (T * T);
+            dyda[1] = -K[i] * g;
+
+            double dy = fd->ydata.at(i) - ymod;
+
+            double sigma = 1.0;
+            if(weighting)
+                sigma = fd->stdev.at(i);
+
+            double sigma2i = 1.0 / (sigma*sigma);
+
+            for(int j = 0; j < NF; j++)
+            {
+                double wt = dyda[fidx[j]] * sigma2i;
+
+                for(int k = 0; k < NF; k++)
+                    alpha[j][k] += wt * dyda[fidx[k]];
+
+                beta[j] += dy * wt;
+            }
+
+            chisquare += dy*dy*sigma2i;
+        }
+
+        for(int j = 0; j < NF; j++)
+        {
+            for(int k = 0; k < NF; k++)
+                alpha_lambda[j][k] = alpha[j][k];
+
+            alpha_lambda[j][j] = alpha[j][j] * (1.0 + lambda);
+        }
+
+        for(int j = 0; j < N; j++)
+            da[j] = 0.0;
+
+        // solve equation system for Newton direction
+        if(NF == 1)
+            da[fidx[0]] = beta[0] / alpha_lambda[0][0];
+        else if(solveCholeskyFixed<NF>(alpha_lambda, beta, solution))
+        {
+            for(int j = 0; j < NF; j++)
+                da[fidx[j]] = solution[j];
+        }
+
+        //  evaluate this iteration
+        if(prev_chisquare == -1.0)
+        {
+            prev_chisquare = chisquare;
+
+            for(int k = 0; k < N; k++)
+                a_next[k] = a[k];
+        }
+        else
+        {
+            if(std::abs(chisquare - prev_chisquare) < std::max(Numeric::TOL, Numeric::TOL*chisquare))
+                done++;
+
+            if(chisquare < prev_chisquare * (1.0 - ns->stagnation_tolerance))
+                stagnant = 0;
+            else
+                stagnant++;
+
+            if(chisquare < prev_chisquare)
+            {
+                lambda *= lambda_dec;
+                prev_chisquare = chisquare;
+
+                for(int k = 0; k < N; k++)
+                    a_next[k] = a[k];
+            }
+            else
+                lambda *= lambda_inc;
+        }
+
+        // limit delta a for stability
+        double da_scaling = 1.0;
+
+        for(int k = 0; k < N; k++)
+        {
+            if(ia[k] && std::abs(da[k]) > da_max[k])
+            {
+                if(std::abs(da_max[k] / da[k]) < da_scaling)
+                {
+                    da_scaling = std::abs(da_max[k] / da[k]);
+                    lambda *= lambda_scale;
+                }
+            }
+        }
+
+        for(int k = 0; k < N; k++)
+        {
+            if(ia[k]) da[k] = da_scaling * da[k];
+        }
+
+        // write iteration result
+        FitIterationResult fres = FitIterationResult(2+N*2);
+        fres[0] = chisquare;
+        fres[1] = lambda;
+
+        for(int n = 0; n < N; n++)
+        {
+            fres[2+2*n] = a[n];
+            fres[2+2*n+1] = -da[n];
+        }
+        fd->addIterationResult(fres);
+
+        if(done == NDONE) break;
+
+        if(ns->stagnationIterations() > 0 && stagnant >= ns->stagnationIterations()) break;
+    }
+}
+
+} // namespace
+
+
+/**
  * @brief Numeric::levmar Levenberg-Marquardt algorithm (inspired by "Numerical Recipes Third Edition")
- * @param fd FitData
+ * @param fd FitData (FitData::startValues() overwrite the start values of the fit parameters)
  * @param ms ModelingSettings
  * @param fs FitSettings
  * @param ns NumericSettings
+ * @param token cancellation token of the fit job (optional)
  */
 void Numeric::levmar(FitRun::FitMode mode,
                      FitData *fd,
                      ModelingSettings *ms,
                      FitSettings *fs,
-                     NumericSettings *ns)
+                     NumericSettings *ns,
+                     const TaskCancellationToken *token)
 {
+    PROFILE_ZONE("numeric", "Numeric::levmar (" + FitRun::modeToString(mode) + ")", QString());
+
     QList<FitParameter> fparams = fs->fitParameters();
 
     // weighting (consider standard deviation (stdev) during fitting)
@@ -488,6 +772,7 @@ void Numeric::levmar(FitRun::FitMode mode,
     int IT = ns->iterations();
     int NDONE = 4; // number of iterations with delta_chisquare < tol
     int done = 0; // counter for termination
+    int stagnant = 0; // counter for iterations without significant improvement
     QString msg;
 
     // number of parameters
@@ -496,6 +781,32 @@ void Numeric::levmar(FitRun::FitMode mode,
     if(N == 0)
         return;
 
+    // warm start (i.e. converged parameters of previous fit)
+    QVector<double> startValues = fd->startValues();
+    if(startValues.size() == N)
+    {
+        for(int j = 0; j < N; j++)
+            if(fparams.at(j).enabled())
+                fparams[j].setValue(startValues.at(j));
+    }
+
+    // spectral temperature fit (T, C): specialized solver with analytic derivatives
+    if(mode == FitRun::TEMP && N == 2 && !fs->bandpassIntegration())
+    {
+        int nfree = int(fparams.at(0).enabled()) + int(fparams.at(1).enabled());
+
+        if(nfree == 2)
+        {
+            levmarPlanck<2>(fd, fparams, ms, fs, ns, token);
+            return;
+        }
+        else if(nfree == 1)
+        {
+            levmarPlanck<1>(fd, fparams, ms, fs, ns, token);
+            return;
+        }
+    }
+
     // number of free parameters
     int NF = 0;
 
@@ -578,7 +889,7 @@ void Numeric::levmar(FitRun::FitMode mode,
     for(size_t iter=0; iter<IT; iter++)
     {
 
-        if(Numeric::canceled)
+        if(token && token->isCancelled())
         {
             MSG_ASYNC("Numeric::levmar canceled!", DEBUG);
             return;
@@ -832,6 +1143,12 @@ void Numeric::levmar(FitRun::FitMode mode,
                 done++;
             }
 
+            // check for stagnation (no significant improvement)
+            if(chisquare < prev_chisquare * (1.0 - ns->stagnation_tolerance))
+                stagnant = 0;
+            else
+                stagnant++;
+
             // evaluate and change lambda
             // for very small lambda, the Levenberg-Marquardt method
             // reverts to the Gauss-Newton Method
@@ -902,6 +1219,14 @@ void Numeric::levmar(FitRun::FitMode mode,
         // stop if converged
         if(done == NDONE) break;
 
+        // stop if stagnating
+        if(ns->stagnationIterations() > 0 && stagnant >= ns->stagnationIterations())
+        {
+            MSG_ASYNC(QString("Numeric::levmar: stopped after %0 iterations without improvement")
+                      .arg(stagnant), DEBUG);
+            break;
+        }
+
     } // iterations
 }
 
@@ -916,7 +1241,7 @@ void Numeric::levmar(FitRun::FitMode mode,
  * @return
  */
 QVector<double> Numeric::modeledData(FitRun::FitMode mode,
-                                     VecDoub a,
+                                     const VecDoub &a,
                                      FitData *fd,
                                      ModelingSettings *ms,
                                      FitSettings *fs,
@@ -1237,12 +1562,6 @@ void Numeric::levmar_test(FitRun::FitMode mode,
    for(size_t iter=0; iter<IT; iter++)
    {
 
-       if(Numeric::canceled)
-       {
-           MSG_ASYNC("Numeric::levmar canceled!", DEBUG);
-           return;
-       }
-
        // last pass, set damping factor to zero
        if(done == NDONE) lambda = 0.0;
 
@@ -1557,6 +1876,157 @@ void Numeric::levmar_test(FitRun::FitMode mode,
 
 
 
+/**
+ * @brief Numeric::fft in-place radix-2 fast Fourier transform
+ * @param data complex data, size must be a power of two
+ * @param inverse calculate inverse transform (scaled by 1/N)
+ */
+void Numeric::fft(std::vector<std::complex<double>> &data, bool inverse)
+{
+    const size_t n = data.size();
+    if(n < 2)
+        return;
+
+    if(n & (n - 1))
+        throw LIISimException(QString("Numeric::fft: data size (%0) is not a power of two").arg(n));
+
+    // bit reversal permutation
+    for(size_t i = 1, j = 0; i < n; i++)
+    {
+        size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if(i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    // twiddle factors (calculated once, exact for each stage)
+    const double sign = inverse ? 1.0 : -1.0;
+    std::vector<std::complex<double>> twiddle(n / 2);
+    for(size_t k = 0; k < n / 2; k++)
+        twiddle[k] = std::polar(1.0, sign * 2.0 * Constants::pi * double(k) / double(n));
+
+    // butterflies
+    for(size_t len = 2; len <= n; len <<= 1)
+    {
+        const size_t half = len / 2;
+        const size_t step = n / len;
+
+        for(size_t i = 0; i < n; i += len)
+        {
+            for(size_t k = 0; k < half; k++)
+            {
+                std::complex<double> u = data[i + k];
+                std::complex<double> v = data[i + k + half] * twiddle[k * step];
+                data[i + k]        = u + v;
+                data[i + k + half] = u - v;
+            }
+        }
+    }
+
+    if(inverse)
+    {
+        const double scale = 1.0 / double(n);
+        for(size_t i = 0; i < n; i++)
+            data[i] *= scale;
+    }
+}
+
+
+/**
+ * @brief Numeric::crossCorrelationLag estimates the delay of a signal relative
+ * to a reference from the maximum of their cross-correlation
+ * @details The cross-correlation of the mean-free data is calculated by FFT
+ * (both real sequences are transformed by a single complex FFT, zero padded to
+ * avoid circular wrap-around). The integer maximum is refined to sub-sample
+ * accuracy by a parabola through the maximum and its neighbours.
+ * @param ref reference data
+ * @param sig data
+ * @param maxLag maximum absolute lag [data points] (0: all lags)
+ * @return lag [data points], positive if sig is delayed relative to ref
+ */
+double Numeric::crossCorrelationLag(const QVector<double> &ref, const QVector<double> &sig, int maxLag)
+{
+    const int nr = ref.size();
+    const int ns = sig.size();
+
+    if(nr == 0 || ns == 0)
+        return 0.0;
+
+    size_t n = 1;
+    while(n < size_t(nr + ns))
+        n <<= 1;
+
+    double meanRef = std::accumulate(ref.constBegin(), ref.constEnd(), 0.0) / nr;
+    double meanSig = std::accumulate(sig.constBegin(), sig.constEnd(), 0.0) / ns;
+
+    // z = ref + i*sig
+    std::vector<std::complex<double>> z(n);
+    for(int i = 0; i < nr; i++)
+        z[i].real(ref[i] - meanRef);
+    for(int i = 0; i < ns; i++)
+        z[i].imag(sig[i] - meanSig);
+
+    fft(z);
+
+    // separate spectra: REF[k] = (Z[k] + conj(Z[n-k]))/2, SIG[k] = (Z[k] - conj(Z[n-k]))/2i,
+    // cross spectrum SIG[k] * conj(REF[k])
+    std::vector<std::complex<double>> cross(n);
+    for(size_t k = 0; k < n; k++)
+    {
+        std::complex<double> zk  = z[k];
+        std::complex<double> znk = std::conj(z[(n - k) & (n - 1)]);
+
+        std::complex<double> r = 0.5 * (zk + znk);
+        std::complex<double> s = std::complex<double>(0.0, -0.5) * (zk - znk);
+
+        cross[k] = s * std::conj(r);
+    }
+
+    fft(cross, true);
+
+    // lag l is stored at index l (l >= 0) or n + l (l < 0)
+    auto corr = [&cross, n](int lag) { return cross[(lag + n) & (n - 1)].real(); };
+
+    int minLag = -(nr - 1);
+    int maxLagSig = ns - 1;
+    if(maxLag > 0)
+    {
+        minLag = std::max(minLag, -maxLag);
+        maxLagSig = std::min(maxLagSig, maxLag);
+    }
+
+    int best = 0;
+    double bestValue = -std::numeric_limits<double>::max();
+    for(int lag = minLag; lag <= maxLagSig; lag++)
+    {
+        double value = corr(lag);
+        if(value > bestValue)
+        {
+            bestValue = value;
+            best = lag;
+        }
+    }
+
+    // parabolic refinement
+    double delta = 0.0;
+    if(best > minLag && best < maxLagSig)
+    {
+        double y0 = corr(best - 1);
+        double y1 = bestValue;
+        double y2 = corr(best + 1);
+        double denom = y0 - 2.0 * y1 + y2;
+
+        if(denom < 0.0)
+            delta = std::max(-0.5, std::min(0.5, 0.5 * (y0 - y2) / denom));
+    }
+
+    return double(best) + delta;
+}
+
+
 /**
  * @brief Numeric::debugCholesky debug output for levmar
  * @param alpha_lambda
@@ -1780,7 +2250,7 @@ double Numeric::integrate_trapezoid_func(std::function<double(double)> func, dou
  */
 //template <size_t N,size_t M>
 //bool Numeric::swapLine(double mat[N][M], size_t line1, size_t line2)
-bool Numeric::swapLine(MatDoub mat, size_t line1, size_t line2)
+bool Numeric::swapLine(MatDoub &mat, size_t line1, size_t line2)
 {
     int N = mat.shape()[0];
     int M = mat.shape()[1];
@@ -1807,7 +2277,7 @@ bool Numeric::swapLine(MatDoub mat, size_t line1, size_t line2)
  */
 //template <size_t N>
 //bool Numeric::invertMatrix(const double mat[N][N], double inv[N][N])
-bool Numeric::invertMatrix(const MatDoub mat, MatDoub &inv)
+bool Numeric::invertMatrix(const MatDoub &mat, MatDoub &inv)
 {
     // Create Nx2N matrix for Gauß-Jordan-algorithm
     //double A[N][2*N];
@@ -1897,7 +2367,7 @@ bool Numeric::invertMatrix(const MatDoub mat, MatDoub &inv)
  * @param L lower triangular matrix
  * @return
  */
-bool Numeric::cholesky_LLT(const MatDoub A, MatDoub &L)
+bool Numeric::cholesky_LLT(const MatDoub &A, MatDoub &L)
 {
     size_t N = A.shape()[0];
     size_t M = A.shape()[1];
@@ -1946,7 +2416,7 @@ bool Numeric::cholesky_LLT(const MatDoub A, MatDoub &L)
  * @param x solution is saved in this vector
  * @return
  */
-bool Numeric::cholesky_solve_LLT(const MatDoub L, const VecDoub b, VecDoub &x)
+bool Numeric::cholesky_solve_LLT(const MatDoub &L, const VecDoub &b, VecDoub &x)
 {
     // TODO: include check:
      // - if matrix is positive definite: if yAy^T > 0 for any given vector [y]nx1 != 0
@@ -2002,7 +2472,7 @@ bool Numeric::cholesky_solve_LLT(const MatDoub L, const VecDoub b, VecDoub &x)
  * @param Ainv inverse of A
  * @return
  */
-bool Numeric::cholesky_inverse_A(const MatDoub L, MatDoub &Ainv)
+bool Numeric::cholesky_inverse_A(const MatDoub &L, MatDoub &Ainv)
 {
     size_t N = L.shape()[0];
     size_t M = L.shape()[1];
@@ -2044,7 +2514,7 @@ bool Numeric::cholesky_inverse_A(const MatDoub L, MatDoub &Ainv)
  * @param D diagonal matrix
  * @return
  */
-bool Numeric::cholesky_LDLT(const MatDoub A, MatDoub &L, MatDoub &D)
+bool Numeric::cholesky_LDLT(const MatDoub &A, MatDoub &L, MatDoub &D)
 {
     size_t N = A.shape()[0];
     size_t M = A.shape()[1];
@@ -2094,7 +2564,7 @@ bool Numeric::cholesky_LDLT(const MatDoub A, MatDoub &L, MatDoub &D)
  * @param x solution is saved in this vector
  * @return
  */
-bool Numeric::cholesky_solve_LDLT(const MatDoub L, const MatDoub D, const VecDoub b, VecDoub &x)
+bool Numeric::cholesky_solve_LDLT(const MatDoub &L, const MatDoub &D, const VecDoub &b, VecDoub &x)
 {
     // TODO: include check:
     // - if matrix is positive definite: if yAy^T > 0 for any given vector [y]nx1 != 0
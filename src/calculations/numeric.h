@@ -6,6 +6,7 @@
 #include "../calculations/temperature.h"
 
 #include <vector>
+#include <complex>
 #include <functional> //rk4 bind()
 #include <numeric> // accumulate()
 
@@ -46,7 +47,6 @@ class Numeric
         static QStringList getAvailableODENameList();
         static QStringList getAvailableODEDescriptionList();
 
-        static bool canceled;
         static double EPS;
         static double TOL;
         static int iterationsDefault;
@@ -67,7 +67,8 @@ class Numeric
                            FitData* fd,
                            ModelingSettings* ms,
                            FitSettings* fs,
-                           NumericSettings* ns);
+                           NumericSettings* ns,
+                           const TaskCancellationToken *token = 0);
 
         static void levmar_test(FitRun::FitMode mode,
                            FitData* fd,
@@ -76,7 +77,7 @@ class Numeric
                            NumericSettings* ns);
 
         static QVector<double> modeledData(FitRun::FitMode mode,
-                                                    VecDoub a,
+                                                    const VecDoub &a,
                                                     FitData *fd,
                                                     ModelingSettings *ms,
                                                     FitSettings *fs,
@@ -95,15 +96,18 @@ class Numeric
         // define accuracy of integration (acc)
         static double integrate_trapezoid_func(std::function<double(double)> func, const double T0, const double T1, const double acc);
 
-        static bool swapLine(MatDoub mat, size_t line1, size_t line2);
-        static bool invertMatrix(const MatDoub mat, MatDoub &inv);
+        static bool swapLine(MatDoub &mat, size_t line1, size_t line2);
+        static bool invertMatrix(const MatDoub &mat, MatDoub &inv);
+
+        static bool cholesky_LLT(const MatDoub &A, MatDoub &L);
+        static bool cholesky_solve_LLT(const MatDoub &L, const VecDoub &b, VecDoub &x);
+        static bool cholesky_inverse_A(const MatDoub &L, MatDoub &Ainv);
 
-        static bool cholesky_LLT(const MatDoub A, MatDoub &L);
-        static bool cholesky_solve_LLT(const MatDoub L, const VecDoub b, VecDoub &x);
-        static bool cholesky_inverse_A(const MatDoub L, MatDoub &Ainv);
+        static bool cholesky_LDLT(const MatDoub &A, MatDoub &L, MatDoub &D);
+        static bool cholesky_solve_LDLT(const MatDoub &L, const MatDoub &D, const VecDoub &b, VecDoub &x);
 
-        static bool cholesky_LDLT(const MatDoub A, MatDoub &L, MatDoub &D);
-        static bool cholesky_solve_LDLT(const MatDoub L, const MatDoub D, const VecDoub b, VecDoub &x);
+        static void fft(std::vector<std::complex<double>> &data, bool inverse = false);
+        static double crossCorrelationLag(const QVector<double> &ref, const QVector<double> &sig, int maxLag = 0);
 
 
         static void debugCholesky(MatDoub alpha_lambda, MatDoub L, MatDoub Linv, MatDoub D, MatDoub covar, VecDoub da, VecDoub solution, VecDoub beta);
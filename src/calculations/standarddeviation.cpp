@@ -30,7 +30,7 @@ void StandardDeviation::reset()
 void StandardDeviation::addValue(double value)
 {
     _sum  += value;
-    _sum2 += pow(value, 2);
+    _sum2 += value * value;
 
     _N++;
 }
@@ -41,7 +41,7 @@ void StandardDeviation::addVector(QVector<double> vector)
     for(int k=0; k < vector.size(); k++)
     {
         _sum += vector.at(k);
-        _sum2 += pow(vector.at(k), 2);
+        _sum2 += vector.at(k) * vector.at(k);
         _N++;
     }
 }
@@ -316,9 +316,10 @@ Signal Temperature::calcTemperatureFromSpectrum(LIISettings& liiSettings,
                                                 bool bpIntegration,
                                                 bool weighting,
                                                 bool autoStartC,
-                                                int iterations = 60,
-                                                double startTemperature = 2500.0,
-                                                double startC = 1.0
+                                                int iterations,
+                                                double startTemperature,
+                                                double startC,
+                                                FitHistoryStore::Trace* history
                                                 )
 {
     // empty signal is returned if error occurs
@@ -442,6 +443,14 @@ Signal Temperature::calcTemperatureFromSpectrum(LIISettings& liiSettings,
     }
 
 
+    // active channels used for fitting
+    for(int k = 0; k < activeChannels->size(); k++)
+        t_signal.fitActiveChannels.append(activeChannels->at(k));
+
+    // iteration history (see FitHistoryStore), one entry per data point
+    if(history)
+        history->init(t_signal.start_time, t_signal.dt);
+
     //----------------------------
     // process all data points (y)
     //----------------------------
@@ -503,12 +512,8 @@ Signal Temperature::calcTemperatureFromSpectrum(LIISettings& liiSettings,
         // res[2]: Temperature      // res[3]: Delta Temperature
         // res[4]: Scaling factor   // res[5]: Delta scaling factor
 
-        t_signal.fitData.append(fitResList);
-
-        for(int k = 0; k < activeChannels->size(); k++)
-        {
-            t_signal.fitActiveChannels.append(activeChannels->at(k));
-        }
+        if(history)
+            history->append(fitResList);
 
         // get final temperature        
         t_signal.data.append(fitData->iterationResultLast().at(2));
@@ -543,9 +548,10 @@ Signal Temperature::calcTemperatureFromSpectrumTest(LIISettings& liiSettings,
                                                 MPoint * mpoint,
                                                 Signal::SType inputSigType,
                                                 QList<bool> *activeChannels,
-                                                int iterations = 60,
-                                                double startTemperature = 2500.0,
-                                                double startC = 1.0
+                                                int iterations,
+                                                double startTemperature,
+                                                double startC,
+                                                FitHistoryStore::Trace* history
                                                 )
 {
     // empty signal is returned if error occurs
@@ -700,14 +706,6 @@ Signal Temperature::calcTemperatureFromSpectrumTest(LIISettings& liiSettings,
         // res[2]: Temperature      // res[3]: Delta Temperature
         // res[4]: Scaling factor   // res[5]: Delta scaling factor
 
-        t_signal.fitData.append(fitResList);
-
-        for(int k = 0; k < activeChannels->size(); k++)
-        {
-            t_signal.fitActiveChannels.append(activeChannels->at(k));
-        }
-
-
         qDebug() << "Iterations: " << fitResList.size();
 //        for(int k = 0; k < fitResList.size(); k++)
 //        {
@@ -762,7 +760,8 @@ Signal Temperature::calcTemperatureFromSpectrumTest(LIISettings& liiSettings,
                                              false,
                                              iterations,
                                              startTemperature,
-                                             startC);
+                                             startC,
+                                             history);
 
     return t_signal;
 }
@@ -4,6 +4,7 @@
 #include "../database/structure/material.h"
 
 #include "../signal/signal.h"
+#include "../signal/fithistorystore.h"
 #include "../calculations/constants.h"
 
 #include <QDebug> //!!!
@@ -55,7 +56,8 @@ public:
                                                bool autoStartC,
                                                int iterations,
                                                double startTemperature,
-                                               double startC
+                                               double startC,
+                                               FitHistoryStore::Trace* history = 0
                                                );
 
     static Signal calcTemperatureFromSpectrumTest( LIISettings& liiSettings,
@@ -66,7 +68,8 @@ public:
                                                QList<bool>* activeChannels,
                                                int iterations,
                                                double startTemperature,
-                                               double startC
+                                               double startC,
+                                               FitHistoryStore::Trace* history = 0
                                                );
 
     static double calcTwoColor(double v1, double v2,
@@ -11,6 +11,7 @@
 #include "gui/signalEditor/sessionsavedialog.h"
 #include "gui/signalEditor/sessionloaddialog.h"
 #include "io/ioxml.h"
+#include "io/sessionautosaver.h"
 #include "calculations/numeric.h"
 
 
@@ -70,6 +71,7 @@ Core::Core() : QObject(0)
     sigManager->setCore(this);
 
     // programm settings/session auto-save
+    m_autoSaver = new SessionAutoSaver(m_dataModel, this);
     autoSaveTimer = new QTimer;
     autoSaveTimer->setTimerType(Qt::CoarseTimer);
 
@@ -206,6 +208,11 @@ SignalManager* Core::getSignalManager()
     return sigManager;
 }
 
+SessionAutoSaver* Core::getSessionAutoSaver()
+{
+    return m_autoSaver;
+}
+
 NotificationManager* Core::getNotificationManager()
 {
     return notifiManager;
@@ -310,15 +317,10 @@ void Core::handleAsyncMsg(QString msg, LIISimMessageType type)
 
 void Core::onAutoSaveTimerTimeout()
 {
-    if(sigManager->isBusy())
-    {
-        MESSAGE("Processing signals, auto-saving skipped!", WARNING);
-        return;
-    }
-
     MESSAGE("Auto-saving settings...", INFO);
 
-    IOxml::saveInitSession();
+    // snapshot of session, written in background (processing/fitting can continue)
+    m_autoSaver->save();
 
     QString savePath;
     if(guiSettings->hasEntry("io/programsettings","lastfname"))
@@ -29,6 +29,7 @@
 #include "gui/utils/notificationmanager.h"
 
 class Numeric;
+class SessionAutoSaver;
 
 
 /**
@@ -46,6 +47,7 @@ private:
     DatabaseManager* dbManager;
     SignalManager* sigManager;
     NotificationManager* notifiManager;
+    SessionAutoSaver* m_autoSaver;
 
     static Core* c_instance;
     static bool m_underConstruction;
@@ -92,6 +94,7 @@ public:
 
     DatabaseManager* getDatabaseManager();
     SignalManager* getSignalManager();
+    SessionAutoSaver* getSessionAutoSaver();
     NotificationManager* getNotificationManager();
 
     GeneralSettings* generalSettings;
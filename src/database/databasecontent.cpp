@@ -9,4 +9,5 @@ DatabaseContent::DatabaseContent()
     type        = "none";
     version     = "0.0";
     description = "no description";
+    revision    = 0;
 }
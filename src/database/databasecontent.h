@@ -31,6 +31,9 @@ public:
     QString description;
     int ident;
 
+    /** @brief incremented if the content is modified (see DatabaseManager::modifiedContent()) */
+    int revision;
+
     /**
      * @brief return Property List of variables
      * @return
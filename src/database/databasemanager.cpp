@@ -859,6 +859,7 @@ void DatabaseManager::modifiedContent(DatabaseContent *content)
                 saveFile(curMix);             // update GasMixture file
         }
     }
+    content->revision++;
     saveFile(content);
 
     qDebug() << "DatabaseManager: modified "<< content->ident << Core::instance()->modelingSettings->material().ident;
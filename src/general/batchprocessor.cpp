@@ -0,0 +1,883 @@
+#include "batchprocessor.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QTimer>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include "../core.h"
+#include "headlessapplication.h"
+#include "../io/iobase.h"
+#include "../signal/mrun.h"
+#include "../signal/mrungroup.h"
+#include "../signal/processing/processingchain.h"
+#include "../calculations/fit/fitrun.h"
+#include "LIISimException.h"
+#include "profiling.h"
+#include "taskscheduler.h"
+
+
+/**
+ * @brief BatchProcessor::BatchProcessor Constructor
+ * @param parent parent object
+ */
+BatchProcessor::BatchProcessor(QObject *parent) : QObject(parent)
+{
+    m_state = IDLE;
+    m_exitCode = 0;
+
+    m_settingsFile = Core::rootDir + "defaultSettings.ini";
+    m_exportType = CSV;
+    m_threads = QThread::idealThreadCount();
+    m_fit = false;
+    m_timeout = 3600;
+
+    m_fileIdx = -1;
+
+    m_watchdog.setSingleShot(true);
+    connect(&m_watchdog, SIGNAL(timeout()), SLOT(onStepTimeout()));
+}
+
+
+BatchProcessor::~BatchProcessor() {}
+
+
+/**
+ * @brief BatchProcessor::isBatchCall checks if the program should be started in batch mode
+ * @param argc number of command line arguments
+ * @param argv command line arguments
+ * @return true if program has been built as batch target or '--batch' has been passed
+ */
+bool BatchProcessor::isBatchCall(int argc, char *argv[])
+{
+#ifdef LIISIM_BATCH
+    Q_UNUSED(argc);
+    Q_UNUSED(argv);
+    return true;
+#else
+    for(int i = 1; i < argc; i++)
+        if(QString(argv[i]) == "--batch")
+            return true;
+    return false;
+#endif
+}
+
+
+/**
+ * @brief BatchProcessor::exec runs the batch processing (replaces the
+ * main window event loop, see main.cpp)
+ * @param argc number of command line arguments
+ * @param argv command line arguments
+ * @return exit code (0: success, 1: processing of at least one file failed,
+ * 2: invalid arguments, 3: aborted, a step could not be stopped after timeout)
+ */
+int BatchProcessor::exec(int argc, char *argv[])
+{
+    return HeadlessApplication::exec<BatchProcessor>(argc, argv);
+}
+
+
+/**
+ * @brief BatchProcessor::parseArguments parses the command line
+ * @param arguments command line arguments (QCoreApplication::arguments())
+ * @return false if arguments are invalid
+ */
+bool BatchProcessor::parseArguments(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("LIISim3 batch processing: imports sessions/import requests, "
+                                     "processes all runs and exports the results.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("files", "XML session files or XML files containing SignalIORequest elements.");
+
+    QCommandLineOption batchOption("batch", "Run without main window (batch mode).");
+    QCommandLineOption fileListOption("file-list", "Text file containing one input file per line.", "file");
+    QCommandLineOption shardOption("shard", "Process only input files with index i where i % n == k.", "k/n");
+    QCommandLineOption chainOption("chain", "Replace processing chain of all runs by saved chain, "
+                                   "signal type: raw, abs or temp (can be used multiple times).", "stype=file");
+    QCommandLineOption threadsOption("threads", "Number of threads for processing and fitting.", "n");
+    QCommandLineOption fitOption("fit", "Refit all FitRuns of the session after processing.");
+    QCommandLineOption exportDirOption("export-dir", "Export directory (one subdirectory per input file).", "dir");
+    QCommandLineOption exportFormatOption("export-format", "Export format: csv or mat.", "format", "csv");
+    QCommandLineOption settingsOption("settings", "Program settings file (default: defaultSettings.ini).", "file");
+    QCommandLineOption timeoutOption("timeout", "Max duration of each step (import, processing, fit, export) "
+                                     "in seconds, 0: no limit (default: 3600).", "s");
+    QCommandLineOption traceOption("trace", "Record profiling zones and write Chrome trace file "
+                                   "(requires build with LIISIM_PROFILING).", "file");
+
+    parser.addOption(batchOption);
+    parser.addOption(fileListOption);
+    parser.addOption(shardOption);
+    parser.addOption(chainOption);
+    parser.addOption(threadsOption);
+    parser.addOption(fitOption);
+    parser.addOption(exportDirOption);
+    parser.addOption(exportFormatOption);
+    parser.addOption(settingsOption);
+    parser.addOption(timeoutOption);
+    parser.addOption(traceOption);
+
+    if(!parser.parse(arguments))
+    {
+        MSG_ERR("BatchProcessor: " + parser.errorText());
+        return false;
+    }
+
+    if(parser.isSet("help"))
+    {
+        QTextStream(stdout) << parser.helpText();
+        return false;
+    }
+
+    m_files = parser.positionalArguments();
+
+    if(parser.isSet(fileListOption) && !readFileList(parser.value(fileListOption)))
+        return false;
+
+    if(parser.isSet(shardOption) && !applyShard(parser.value(shardOption)))
+        return false;
+
+    QStringList chains = parser.values(chainOption);
+    for(int i = 0; i < chains.size(); i++)
+    {
+        QString stype = chains.at(i).section('=', 0, 0).trimmed().toLower();
+        QString fname = chains.at(i).section('=', 1);
+
+        if(fname.isEmpty() || !QFileInfo(fname).exists())
+        {
+            MSG_ERR(QString("BatchProcessor: processing chain file does not exist: '%0'").arg(fname));
+            return false;
+        }
+
+        if(stype == "raw")
+            m_chains.insert(Signal::RAW, fname);
+        else if(stype == "abs")
+            m_chains.insert(Signal::ABS, fname);
+        else if(stype == "temp")
+            m_chains.insert(Signal::TEMPERATURE, fname);
+        else
+        {
+            MSG_ERR(QString("BatchProcessor: invalid signal type for processing chain: '%0'").arg(stype));
+            return false;
+        }
+    }
+
+    if(parser.isSet(threadsOption))
+    {
+        bool ok;
+        m_threads = parser.value(threadsOption).toInt(&ok);
+        if(!ok || m_threads < 1)
+        {
+            MSG_ERR("BatchProcessor: invalid number of threads: " + parser.value(threadsOption));
+            return false;
+        }
+    }
+
+    m_fit = parser.isSet(fitOption);
+
+    if(parser.isSet(timeoutOption))
+    {
+        bool ok;
+        m_timeout = parser.value(timeoutOption).toInt(&ok);
+        if(!ok || m_timeout < 0)
+        {
+            MSG_ERR("BatchProcessor: invalid timeout: " + parser.value(timeoutOption));
+            return false;
+        }
+    }
+
+    QString format = parser.value(exportFormatOption).toLower();
+    if(format == "csv")
+        m_exportType = CSV;
+    else if(format == "mat")
+        m_exportType = MAT;
+    else
+    {
+        MSG_ERR("BatchProcessor: invalid export format: " + format);
+        return false;
+    }
+
+    m_exportDir = parser.value(exportDirOption);
+
+    if(parser.isSet(settingsOption))
+        m_settingsFile = parser.value(settingsOption);
+
+    m_traceFile = parser.value(traceOption);
+    if(!m_traceFile.isEmpty() && !ProfilingRecorder::isAvailable())
+        MSG_WARN("BatchProcessor: profiling zones are not available in this build, trace will be empty");
+
+    if(m_files.isEmpty())
+    {
+        MSG_ERR("BatchProcessor: no input files");
+        QTextStream(stdout) << parser.helpText();
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief BatchProcessor::readFileList appends all files of a file list (one file per line,
+ * empty lines and lines starting with '#' are ignored)
+ * @param fname file list
+ */
+bool BatchProcessor::readFileList(const QString &fname)
+{
+    QFile file(fname);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        MSG_ERR("BatchProcessor: cannot read file list: " + fname);
+        return false;
+    }
+
+    QTextStream in(&file);
+    while(!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        if(line.isEmpty() || line.startsWith("#"))
+            continue;
+        m_files << line;
+    }
+    return true;
+}
+
+
+/**
+ * @brief BatchProcessor::applyShard reduces the input file list to one shard
+ * @param shard "k/n": keep files with index i where i % n == k
+ */
+bool BatchProcessor::applyShard(const QString &shard)
+{
+    bool ok_k, ok_n;
+    int k = shard.section('/', 0, 0).toInt(&ok_k);
+    int n = shard.section('/', 1, 1).toInt(&ok_n);
+
+    if(!ok_k || !ok_n || n < 1 || k < 0 || k >= n)
+    {
+        MSG_ERR("BatchProcessor: invalid shard (expected k/n with 0 <= k < n): " + shard);
+        return false;
+    }
+
+    QStringList files;
+    for(int i = k; i < m_files.size(); i += n)
+        files << m_files.at(i);
+    m_files = files;
+
+    return true;
+}
+
+
+/**
+ * @brief BatchProcessor::start loads the program settings and starts processing of the first file
+ */
+void BatchProcessor::start()
+{
+    m_totalTimer.start();
+
+    if(!m_traceFile.isEmpty())
+        ProfilingRecorder::setRecording(true);
+
+    Core* core = Core::instance();
+    core->loadProgramSettings(m_settingsFile);
+
+    // processing and fitting threads (import threads: see coreCountImport)
+    TaskScheduler::instance()->setThreadCount(m_threads);
+
+    SignalManager* sm = core->getSignalManager();
+
+    connect(sm, SIGNAL(importFinished()), SLOT(onImportFinished()), Qt::QueuedConnection);
+    connect(sm, SIGNAL(allProcessingTasksFinished()), SLOT(onProcessingFinished()), Qt::QueuedConnection);
+    connect(sm, SIGNAL(exportFinished()), SLOT(onExportFinished()), Qt::QueuedConnection);
+    connect(sm, SIGNAL(ioImportError(SignalIORequest,SignalFileInfo,QString)),
+            SLOT(onImportError(SignalIORequest,SignalFileInfo,QString)));
+
+    MSG_NORMAL(QString("BatchProcessor: processing %0 file(s) with %1 thread(s)")
+               .arg(m_files.size()).arg(m_threads));
+
+    nextFile();
+}
+
+
+void BatchProcessor::nextFile()
+{
+    m_fileIdx++;
+
+    if(m_fileIdx >= m_files.size())
+    {
+        clearDataModel();
+        finishBatch();
+        return;
+    }
+
+    clearDataModel();
+
+    QString fname = m_files.at(m_fileIdx);
+
+    m_current.fname = fname;
+    m_current.runs = 0;
+    m_current.failedRuns = 0;
+    m_current.importTime = 0;
+    m_current.processingTime = 0;
+    m_current.fitTime = 0;
+    m_current.exportTime = 0;
+    m_current.errors = 0;
+    m_current.success = false;
+
+    MSG_NORMAL(QString("BatchProcessor: [%0/%1] %2").arg(m_fileIdx + 1).arg(m_files.size()).arg(fname));
+
+    startStep(IMPORT);
+
+    if(!importFile(fname))
+        finishFile(false);
+}
+
+
+/**
+ * @brief BatchProcessor::importFile starts the import of an XML session or
+ * of all SignalIORequests within the file
+ * @param fname input file
+ * @return false if import could not be started
+ */
+bool BatchProcessor::importFile(const QString &fname)
+{
+    QFile file(fname);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        MSG_ERR("BatchProcessor: cannot read " + fname);
+        return false;
+    }
+
+    QString xmlFname = QFileInfo(fname).absoluteFilePath();
+    QList<SignalIORequest> requests;
+    bool session = false;
+
+    QXmlStreamReader r(&file);
+    while(!r.atEnd() && !r.hasError())
+    {
+        r.readNext();
+
+        if(r.tokenType() != QXmlStreamReader::StartElement)
+            continue;
+
+        if(r.name() == "LIISim")
+        {
+            session = true;
+            break;
+        }
+
+        if(r.name() == "SignalIORequest")
+            requests << SignalIORequest::fromXML(r, xmlFname);
+    }
+
+    if(r.hasError() && !session)
+    {
+        MSG_ERR(QString("BatchProcessor: cannot parse %0 (%1)").arg(fname).arg(r.errorString()));
+        return false;
+    }
+    file.close();
+
+    SignalManager* sm = Core::instance()->getSignalManager();
+
+    if(session)
+    {
+        SignalIORequest rq;
+        rq.itype = XML;
+        rq.userData.insert(0, xmlFname);
+        rq.userData.insert(19, 0); // clear existing data
+
+        sm->importSignalsManager(rq);
+        return true;
+    }
+
+    if(requests.isEmpty())
+    {
+        MSG_ERR("BatchProcessor: no session or SignalIORequest found in " + fname);
+        return false;
+    }
+
+    // SignalManager::loadImportRequests() uses one IO object for all requests
+    for(int i = 1; i < requests.size(); i++)
+        if(requests.at(i).itype != requests.first().itype)
+        {
+            MSG_ERR("BatchProcessor: all SignalIORequests of a file need the same import type: " + fname);
+            return false;
+        }
+
+    sm->loadImportRequests(requests);
+    return true;
+}
+
+
+void BatchProcessor::onImportFinished()
+{
+    if(m_state != IMPORT)
+        return;
+
+    m_current.importTime = m_stepTimer.elapsed();
+
+    QList<MRun*> runs = Core::instance()->dataModel()->mrunList();
+    m_current.runs = runs.size();
+
+    if(runs.isEmpty())
+    {
+        MSG_ERR("BatchProcessor: no runs imported from " + m_current.fname);
+        finishFile(false);
+        return;
+    }
+
+    try
+    {
+        applyProcessingChains();
+    }
+    catch(LIISimException e)
+    {
+        MSG_ERR("BatchProcessor: " + e.what());
+        finishFile(false);
+        return;
+    }
+
+    startStep(PROCESSING);
+
+    // processing not started (eg. memory check failed): do not wait for the watchdog
+    if(!Core::instance()->getSignalManager()->processAllMRuns(Signal::RAW))
+    {
+        MSG_ERR("BatchProcessor: signal processing could not be started for " + m_current.fname);
+        finishFile(false);
+    }
+}
+
+
+/**
+ * @brief BatchProcessor::applyProcessingChains replaces the processing chains of all
+ * runs by the chains passed with '--chain'
+ * @throws LIISimException
+ */
+void BatchProcessor::applyProcessingChains()
+{
+    if(m_chains.isEmpty())
+        return;
+
+    QList<MRun*> runs = Core::instance()->dataModel()->mrunList();
+
+    QMapIterator<Signal::SType, QString> it(m_chains);
+    while(it.hasNext())
+    {
+        it.next();
+        for(int i = 0; i < runs.size(); i++)
+        {
+            ProcessingChain* pchain = runs[i]->getProcessingChain(it.key());
+            if(!pchain)
+                continue;
+
+            pchain->clearAll();
+            pchain->load(it.value());
+        }
+    }
+}
+
+
+void BatchProcessor::onProcessingFinished()
+{
+    if(m_state != PROCESSING)
+        return;
+
+    m_current.processingTime = m_stepTimer.elapsed();
+
+    QList<MRun*> runs = Core::instance()->dataModel()->mrunList();
+    for(int i = 0; i < runs.size(); i++)
+        if(runs[i]->calculationStatus()->isError())
+        {
+            m_current.failedRuns++;
+            MSG_WARN(QString("BatchProcessor: processing of run '%0' failed").arg(runs[i]->getName()));
+        }
+
+    if(m_fit)
+        startFits();
+    else
+        startExport();
+}
+
+
+/**
+ * @brief BatchProcessor::startFits creates a new FitRun (same settings and signals)
+ * for each FitRun of the imported session and starts the fits
+ */
+void BatchProcessor::startFits()
+{
+    startStep(FITTING);
+    m_pendingFits.clear();
+
+    QList<FitRun*> sessionFits = Core::instance()->dataModel()->fitRuns();
+
+    for(int i = 0; i < sessionFits.size(); i++)
+    {
+        FitRun* src = sessionFits[i];
+
+        QList<FitData> data;
+        for(int j = 0; j < src->count(); j++)
+        {
+            FitData fd = src->at(j);
+            if(!fd.mrun())
+                continue;
+            data << FitData(fd.mrunID(), fd.mpoint(), fd.signalType(), fd.temperatureChannelID());
+        }
+
+        if(data.isEmpty())
+            continue;
+
+        FitSettings* fitSettings = new FitSettings;
+        QList<FitParameter> fparams = src->fitSettings()->fitParameters();
+        fitSettings->setFitParameters(fparams);
+
+        NumericSettings* numSettings = new NumericSettings;
+        numSettings->setIterations(src->numericSettings()->iterations());
+        numSettings->setOdeSolver(src->numericSettings()->odeSolverIdx());
+        numSettings->setOdeSolverStepSizeFactor(src->numericSettings()->odeSolverStepSizeFactor());
+
+        ModelingSettings* modSettings = new ModelingSettings;
+        modSettings->copyFrom(src->modelingSettings());
+
+        FitRun* fitrun = new FitRun(src->mode());
+        fitrun->blockSignals(true);
+        fitrun->setModelingSettings(modSettings);
+        fitrun->setFitData(data);
+        fitrun->setFitSettings(fitSettings);
+        fitrun->setNumericSettings(numSettings);
+        fitrun->blockSignals(false);
+
+        connect(fitrun, SIGNAL(fitFinished()), SLOT(onFitFinished()), Qt::QueuedConnection);
+        m_pendingFits << fitrun;
+    }
+
+    if(m_pendingFits.isEmpty())
+    {
+        MSG_WARN("BatchProcessor: no FitRuns found in session " + m_current.fname);
+        startExport();
+        return;
+    }
+
+    // FitRun::fitAll() runs all fits on the global thread pool, start runs one after another
+    m_pendingFits.first()->fitAll();
+}
+
+
+void BatchProcessor::onFitFinished()
+{
+    if(m_state != FITTING)
+        return;
+
+    FitRun* fitrun = qobject_cast<FitRun*>(sender());
+    if(fitrun && fitrun->canceled())
+    {
+        m_current.errors++;
+        MSG_WARN(QString("BatchProcessor: FitRun %0 has been canceled").arg(fitrun->id()));
+    }
+
+    int idx = m_pendingFits.indexOf(fitrun);
+    if(idx + 1 < m_pendingFits.size())
+    {
+        m_pendingFits.at(idx + 1)->fitAll();
+        return;
+    }
+
+    m_current.fitTime = m_stepTimer.elapsed();
+    startExport();
+}
+
+
+/**
+ * @brief BatchProcessor::startExport exports the processed signals of all runs
+ * (and the fit results) to the export directory
+ */
+void BatchProcessor::startExport()
+{
+    if(m_exportDir.isEmpty())
+    {
+        finishFile(true);
+        return;
+    }
+
+    startStep(EXPORT);
+
+    QString dirname = QDir(m_exportDir).absoluteFilePath(QFileInfo(m_current.fname).completeBaseName()) + "/";
+    if(!QDir().mkpath(dirname))
+    {
+        MSG_ERR("BatchProcessor: cannot create export directory " + dirname);
+        finishFile(false);
+        return;
+    }
+
+    if(!m_pendingFits.isEmpty())
+        writeFitResults(dirname + "fitruns.xml");
+
+    QList<QVariant> runIDs;
+    QList<MRun*> runs = Core::instance()->dataModel()->mrunList();
+    for(int i = 0; i < runs.size(); i++)
+        runIDs << runs[i]->id();
+
+    // see ExportDialog::onOk()
+    SignalIORequest erq;
+    erq.itype = m_exportType;
+    erq.datadir = dirname;
+
+    erq.userData.insert(0, "multiple files");
+    erq.userData.insert(8, runIDs);
+    erq.userData.insert(9 ,false); // modeling settings
+    erq.userData.insert(10,false); // gui settings
+    erq.userData.insert(11,false); // general settings
+    erq.userData.insert(12,true);  // data
+
+    // processed raw, absolute and temperature data
+    if(m_exportType == CSV)
+    {
+        erq.userData.insert(13, true);
+        erq.userData.insert(14, true);
+        erq.userData.insert(15, true);
+        erq.userData.insert(16, true);
+        erq.userData.insert(17, true);
+    }
+    else
+    {
+        // MAT: flags 13-15 select the unprocessed data
+        erq.userData.insert(13, false);
+        erq.userData.insert(14, false);
+        erq.userData.insert(15, false);
+        erq.userData.insert(16, true);
+        erq.userData.insert(17, true);
+        erq.userData.insert(35, true);
+    }
+    erq.userData.insert(25, true);
+    erq.userData.insert(26, false);
+    erq.userData.insert(28, false);
+    erq.userData.insert(29, false);
+
+    Core::instance()->getSignalManager()->exportSignalsManager(erq);
+}
+
+
+/**
+ * @brief BatchProcessor::writeFitResults writes all FitRuns of this
+ * batch step (FitRun::writeToXML())
+ * @param fname XML file
+ */
+void BatchProcessor::writeFitResults(const QString &fname)
+{
+    QFile file(fname);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        MSG_ERR("BatchProcessor: cannot write " + fname);
+        m_exitCode = 1;
+        return;
+    }
+
+    QXmlStreamWriter w(&file);
+    w.setAutoFormatting(true);
+    w.writeStartDocument("1.0");
+    w.writeStartElement("LIISim");
+
+    for(int i = 0; i < m_pendingFits.size(); i++)
+        m_pendingFits[i]->writeToXML(w);
+
+    w.writeEndElement(); // LIISim
+    w.writeEndDocument();
+}
+
+
+void BatchProcessor::onExportFinished()
+{
+    if(m_state != EXPORT)
+        return;
+
+    m_current.exportTime = m_stepTimer.elapsed();
+    finishFile(true);
+}
+
+
+/**
+ * @brief BatchProcessor::onImportError reports import errors of the current file
+ * (the file is marked as failed)
+ */
+void BatchProcessor::onImportError(SignalIORequest source, SignalFileInfo file, QString error)
+{
+    Q_UNUSED(source);
+
+    if(m_state != IMPORT)
+        return;
+
+    m_current.errors++;
+    MSG_ERR(QString("BatchProcessor: import of %0 failed: %1").arg(file.filename).arg(error));
+}
+
+
+/**
+ * @brief BatchProcessor::startStep switches to the next step of the current
+ * file and restarts step timing and watchdog
+ * @param state
+ */
+void BatchProcessor::startStep(State state)
+{
+    m_state = state;
+    m_stepTimer.start();
+
+    if(m_timeout > 0)
+        m_watchdog.start(m_timeout * 1000);
+}
+
+
+/**
+ * @brief BatchProcessor::onStepTimeout cancels all work of the current step.
+ * The file is marked as failed. If the work does not stop within 30 s, the
+ * batch is aborted.
+ */
+void BatchProcessor::onStepTimeout()
+{
+    if(m_state == IDLE)
+        return;
+
+    MSG_ERR(QString("BatchProcessor: %0: step did not finish within %1 s, canceled")
+            .arg(m_current.fname).arg(m_timeout));
+
+    State state = m_state;
+    m_state = IDLE;
+
+    SignalManager* sm = Core::instance()->getSignalManager();
+    if(state == IMPORT)
+        IOBase::abort_flag = true;
+    else if(state == PROCESSING)
+        sm->cancelProcessingTasks();
+    else if(state == FITTING)
+        for(int i = 0; i < m_pendingFits.size(); i++)
+            m_pendingFits[i]->cancel();
+
+    for(int lane = 0; lane < TaskScheduler::laneCount; lane++)
+        TaskScheduler::instance()->cancelLane(TaskScheduler::Lane(lane));
+
+    if(!TaskScheduler::instance()->waitForDone(30000))
+    {
+        MSG_ERR("BatchProcessor: running tasks cannot be stopped, batch aborted");
+        m_current.errors++;
+        m_timings << m_current;
+        m_exitCode = 3;
+        finishBatch();
+        return;
+    }
+
+    m_current.errors++;
+    finishFile(false);
+}
+
+
+void BatchProcessor::finishFile(bool success)
+{
+    m_watchdog.stop();
+
+    m_current.success = success && m_current.failedRuns == 0 && m_current.errors == 0;
+    if(!m_current.success)
+        m_exitCode = 1;
+
+    m_timings << m_current;
+
+    MSG_NORMAL(QString("BatchProcessor: %0 done (%1, import %2 ms, processing %3 ms, fit %4 ms, export %5 ms)")
+               .arg(m_current.fname)
+               .arg(m_current.success ? "ok" : "failed")
+               .arg(m_current.importTime)
+               .arg(m_current.processingTime)
+               .arg(m_current.fitTime)
+               .arg(m_current.exportTime));
+
+    m_state = IDLE;
+
+    // continue after all pending events of this file have been handled
+    QTimer::singleShot(0, this, SLOT(nextFile()));
+}
+
+
+/**
+ * @brief BatchProcessor::finishBatch reports the timing of all files,
+ * writes the trace file and quits the batch
+ */
+void BatchProcessor::finishBatch()
+{
+    m_watchdog.stop();
+
+    report();
+
+    if(!m_traceFile.isEmpty())
+    {
+        ProfilingRecorder::setRecording(false);
+        if(ProfilingRecorder::writeChromeTrace(m_traceFile))
+            MSG_NORMAL("BatchProcessor: trace written to " + m_traceFile);
+        else
+            MSG_ERR("BatchProcessor: cannot write trace file " + m_traceFile);
+    }
+
+    m_state = IDLE;
+    emit finished(m_exitCode);
+}
+
+
+/**
+ * @brief BatchProcessor::clearDataModel removes all runs, groups and FitRuns
+ * (see IOxml::deleteAllRuns())
+ */
+void BatchProcessor::clearDataModel()
+{
+    DataModel* model = Core::instance()->dataModel();
+
+    QList<FitRun*> fitruns = model->fitRuns();
+    for(int i = 0; i < fitruns.size(); i++)
+    {
+        model->unregisterFitrun(fitruns[i]->id());
+        delete fitruns[i];
+    }
+    m_pendingFits.clear();
+
+    QList<MRun*> runs = model->mrunList();
+    for(int i = 0; i < runs.size(); i++)
+        delete runs[i];
+
+    QList<MRunGroup*> groups = model->groupList();
+    for(int i = 0; i < groups.size(); i++)
+        if(groups[i] != model->defaultGroup())
+            delete groups[i];
+}
+
+
+/**
+ * @brief BatchProcessor::report prints the timing of all files
+ * (tab separated, to standard output)
+ */
+void BatchProcessor::report()
+{
+    QTextStream out(stdout);
+
+    out << "file\tstatus\truns\tfailed_runs\timport_ms\tprocessing_ms\tfit_ms\texport_ms\n";
+
+    int failed = 0;
+    for(int i = 0; i < m_timings.size(); i++)
+    {
+        const FileTiming& t = m_timings.at(i);
+        if(!t.success)
+            failed++;
+
+        out << t.fname << "\t"
+            << (t.success ? "ok" : "failed") << "\t"
+            << t.runs << "\t"
+            << t.failedRuns << "\t"
+            << t.importTime << "\t"
+            << t.processingTime << "\t"
+            << t.fitTime << "\t"
+            << t.exportTime << "\n";
+    }
+    out.flush();
+
+    MSG_NORMAL(QString("BatchProcessor: %0 file(s) processed, %1 failed (total time %2 s)")
+               .arg(m_timings.size())
+               .arg(failed)
+               .arg(m_totalTimer.elapsed() / 1000.0, 0, 'f', 1));
+}
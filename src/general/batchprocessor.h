@@ -0,0 +1,127 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <QObject>
+#include <QStringList>
+#include <QMap>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include "../signal/signal.h"
+#include "../io/signaliorequest.h"
+
+class FitRun;
+
+/**
+ * @brief The BatchProcessor class runs LIISim without main window from the
+ * command line (e.g. for nightly reprocessing on compute nodes).
+ * @details Each input file (XML session or XML file containing SignalIORequest
+ * elements) is processed sequentially:
+ *  - import of all runs (SignalManager)
+ *  - optional: replacement of the processing chains by saved chains (ProcessingChain::load())
+ *  - signal processing of all runs (ProcessingTask)
+ *  - optional: refit of all FitRuns defined within the session
+ *  - export of the processed signals (IOcsv/IOmatlab) and fit results (FitRun::writeToXML())
+ *
+ * All runs are removed from the data model before the next file is imported.
+ * Timing of each step is reported at the end. Failed imports and canceled
+ * fits mark the file as failed. If a step does not finish within the step
+ * timeout ('--timeout'), all running work is canceled and the file fails; if
+ * the work cannot be stopped, the batch is aborted (exit code 3).
+ * The input file list can be
+ * sharded across machines with '--shard k/n'. With '--trace file' all profiling
+ * zones are written as Chrome trace file (see ProfilingRecorder).
+ *
+ * Usage: LIISim3 --batch [options] files (see LIISim3 --batch --help).
+ * If the program is built with 'qmake CONFIG+=liisim_batch' (LIISim3-batch),
+ * batch mode is always enabled.
+ */
+class BatchProcessor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BatchProcessor(QObject *parent = 0);
+    ~BatchProcessor();
+
+    static bool isBatchCall(int argc, char *argv[]);
+    static int exec(int argc, char *argv[]);
+
+    bool parseArguments(const QStringList &arguments);
+
+    inline int exitCode(){ return m_exitCode; }
+
+public slots:
+    void start();
+
+private:
+
+    enum State { IDLE, IMPORT, PROCESSING, FITTING, EXPORT };
+
+    /** @brief timing of all steps of one input file (ms) */
+    struct FileTiming
+    {
+        QString fname;
+        int runs;
+        int failedRuns;
+        qint64 importTime;
+        qint64 processingTime;
+        qint64 fitTime;
+        qint64 exportTime;
+        int errors;
+        bool success;
+    };
+
+    State m_state;
+    int m_exitCode;
+
+    // options
+    QStringList m_files;
+    QMap<Signal::SType, QString> m_chains;
+    QString m_settingsFile;
+    QString m_exportDir;
+    QString m_traceFile;
+    SignalIOType m_exportType;
+    int m_threads;
+    bool m_fit;
+    /** @brief max duration of a single step (import, processing, fit, export) [s], 0: no limit */
+    int m_timeout;
+
+    /** @brief stops steps which do not finish within m_timeout */
+    QTimer m_watchdog;
+
+    // state of current file
+    int m_fileIdx;
+    FileTiming m_current;
+    QElapsedTimer m_stepTimer;
+    QElapsedTimer m_totalTimer;
+    QList<FitRun*> m_pendingFits;
+
+    QList<FileTiming> m_timings;
+
+    bool readFileList(const QString &fname);
+    bool applyShard(const QString &shard);
+    bool importFile(const QString &fname);
+    void applyProcessingChains();
+    void startFits();
+    void startExport();
+    void writeFitResults(const QString &fname);
+    void startStep(State state);
+    void finishFile(bool success);
+    void finishBatch();
+    void clearDataModel();
+    void report();
+
+private slots:
+    void nextFile();
+    void onImportFinished();
+    void onProcessingFinished();
+    void onFitFinished();
+    void onExportFinished();
+    void onImportError(SignalIORequest source, SignalFileInfo file, QString error);
+    void onStepTimeout();
+
+signals:
+    void finished(int exitCode);
+};
+
+#endif // BATCHPROCESSOR_H
@@ -0,0 +1,869 @@
+#include "benchmark.h"
+
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <random>
+
+#include "../core.h"
+#include "headlessapplication.h"
+#include "../signal/mrun.h"
+#include "../signal/mpoint.h"
+#include "../signal/processing/processingchain.h"
+#include "../signal/processing/processingplugin.h"
+#include "../signal/processing/pluginfactory.h"
+#include "../calculations/temperature.h"
+#include "../calculations/numeric.h"
+#include "../calculations/heattransfermodel.h"
+#include "../calculations/fit/fitdata.h"
+#include "../settings/fitsettings.h"
+#include "../settings/numericsettings.h"
+#include "../settings/modelingsettings.h"
+#include "LIISimException.h"
+
+
+// parameters of the synthetic temperature trace
+static const double benchPeakTemperature = 3000.0;  // [K]
+static const double benchGasTemperature  = 1500.0;  // [K]
+static const double benchParticleSize    = 20.0;    // [nm]
+
+
+/**
+ * @brief Benchmark::Benchmark Constructor
+ * @param parent parent object
+ */
+Benchmark::Benchmark(QObject *parent) : QObject(parent)
+{
+    m_exitCode = 0;
+
+    m_shots = 10;
+    m_channels = 0;
+    m_samples = 1000;
+    m_dt = 1E-9;
+    m_noise = 0.01;
+    m_repeat = 5;
+    m_seed = 42;
+    m_settingsFile = Core::rootDir + "defaultSettings.ini";
+
+    m_C = 1.0;
+    m_mrun = 0;
+    m_tchid = 1;
+}
+
+
+Benchmark::~Benchmark()
+{
+    if(m_mrun)
+        delete m_mrun;
+}
+
+
+/**
+ * @brief Benchmark::isBenchmarkCall checks if the program should be started in benchmark mode
+ * @param argc number of command line arguments
+ * @param argv command line arguments
+ * @return true if '--benchmark' has been passed
+ */
+bool Benchmark::isBenchmarkCall(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; i++)
+        if(QString(argv[i]) == "--benchmark")
+            return true;
+    return false;
+}
+
+
+/**
+ * @brief Benchmark::exec runs all benchmarks (replaces the
+ * main window event loop, see main.cpp)
+ * @param argc number of command line arguments
+ * @param argv command line arguments
+ * @return exit code (0: success, 1: at least one benchmark failed,
+ * 2: invalid arguments)
+ */
+int Benchmark::exec(int argc, char *argv[])
+{
+    return HeadlessApplication::exec<Benchmark>(argc, argv);
+}
+
+
+/**
+ * @brief Benchmark::parseArguments parses the command line
+ * @param arguments command line arguments (QCoreApplication::arguments())
+ * @return false if arguments are invalid
+ */
+bool Benchmark::parseArguments(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("LIISim3 benchmark: times processing plugins, temperature calculation, "
+                                     "ODE solvers and fits on synthetic data.");
+    parser.addHelpOption();
+
+    QCommandLineOption benchmarkOption("benchmark", "Run benchmarks instead of main window.");
+    QCommandLineOption shotsOption("shots", "Number of shots (MPoints) of the synthetic MRun (default: 10).", "n");
+    QCommandLineOption channelsOption("channels", "Number of channels, first LIISettings of database with "
+                                      "this channel count is used (default: default LIISettings).", "n");
+    QCommandLineOption samplesOption("samples", "Number of samples per signal (default: 1000).", "n");
+    QCommandLineOption dtOption("dt", "Sample interval in s (default: 1E-9).", "s");
+    QCommandLineOption noiseOption("noise", "Standard deviation of noise relative to signal peak (default: 0.01).", "value");
+    QCommandLineOption repeatOption("repeat", "Repetitions of each benchmark (default: 5).", "n");
+    QCommandLineOption seedOption("seed", "Seed of the noise generator (default: 42).", "n");
+    QCommandLineOption liiSettingsOption("liisettings", "Name of LIISettings (database) used for channel wavelengths.", "name");
+    QCommandLineOption outputOption("output", "Write results to JSON file.", "file");
+    QCommandLineOption compareOption("compare", "Compare results with JSON file of a previous run.", "file");
+    QCommandLineOption settingsOption("settings", "Program settings file (default: defaultSettings.ini).", "file");
+
+    parser.addOption(benchmarkOption);
+    parser.addOption(shotsOption);
+    parser.addOption(channelsOption);
+    parser.addOption(samplesOption);
+    parser.addOption(dtOption);
+    parser.addOption(noiseOption);
+    parser.addOption(repeatOption);
+    parser.addOption(seedOption);
+    parser.addOption(liiSettingsOption);
+    parser.addOption(outputOption);
+    parser.addOption(compareOption);
+    parser.addOption(settingsOption);
+
+    if(!parser.parse(arguments))
+    {
+        MSG_ERR("Benchmark: " + parser.errorText());
+        return false;
+    }
+
+    if(parser.isSet("help"))
+    {
+        QTextStream(stdout) << parser.helpText();
+        return false;
+    }
+
+    bool ok = true;
+
+    if(parser.isSet(shotsOption))
+        m_shots = parser.value(shotsOption).toInt(&ok);
+    if(!ok || m_shots < 1)
+    {
+        MSG_ERR("Benchmark: invalid number of shots: " + parser.value(shotsOption));
+        return false;
+    }
+
+    if(parser.isSet(channelsOption))
+        m_channels = parser.value(channelsOption).toInt(&ok);
+    if(!ok || m_channels < 0)
+    {
+        MSG_ERR("Benchmark: invalid number of channels: " + parser.value(channelsOption));
+        return false;
+    }
+
+    if(parser.isSet(samplesOption))
+        m_samples = parser.value(samplesOption).toInt(&ok);
+    if(!ok || m_samples < 10)
+    {
+        MSG_ERR("Benchmark: invalid number of samples (minimum: 10): " + parser.value(samplesOption));
+        return false;
+    }
+
+    if(parser.isSet(dtOption))
+        m_dt = parser.value(dtOption).toDouble(&ok);
+    if(!ok || m_dt <= 0.0)
+    {
+        MSG_ERR("Benchmark: invalid sample interval: " + parser.value(dtOption));
+        return false;
+    }
+
+    if(parser.isSet(noiseOption))
+        m_noise = parser.value(noiseOption).toDouble(&ok);
+    if(!ok || m_noise < 0.0)
+    {
+        MSG_ERR("Benchmark: invalid noise level: " + parser.value(noiseOption));
+        return false;
+    }
+
+    if(parser.isSet(repeatOption))
+        m_repeat = parser.value(repeatOption).toInt(&ok);
+    if(!ok || m_repeat < 1)
+    {
+        MSG_ERR("Benchmark: invalid number of repetitions: " + parser.value(repeatOption));
+        return false;
+    }
+
+    if(parser.isSet(seedOption))
+        m_seed = parser.value(seedOption).toUInt(&ok);
+    if(!ok)
+    {
+        MSG_ERR("Benchmark: invalid seed: " + parser.value(seedOption));
+        return false;
+    }
+
+    m_liiSettingsName = parser.value(liiSettingsOption);
+    m_outputFile = parser.value(outputOption);
+    m_compareFile = parser.value(compareOption);
+
+    if(parser.isSet(settingsOption))
+        m_settingsFile = parser.value(settingsOption);
+
+    return true;
+}
+
+
+/**
+ * @brief Benchmark::start loads the program settings, generates the
+ * synthetic data and runs all benchmarks
+ */
+void Benchmark::start()
+{
+    Core* core = Core::instance();
+    core->loadProgramSettings(m_settingsFile);
+
+    if(!selectLIISettings())
+    {
+        m_exitCode = 2;
+        emit finished(m_exitCode);
+        return;
+    }
+
+    m_material = core->modelingSettings->materialSpec();
+    selectSourceEm();
+
+    MSG_NORMAL(QString("Benchmark: %0 shot(s), %1 channel(s) (%2), %3 samples, noise %4, %5 repetition(s)")
+               .arg(m_shots)
+               .arg(m_channels)
+               .arg(m_liiSettings.name)
+               .arg(m_samples)
+               .arg(m_noise)
+               .arg(m_repeat));
+
+    generateMRun();
+
+    // plugins modify the post signals, which are used
+    // as input for the temperature calculation: run them last
+    benchmarkODESolvers();
+    benchmarkLevmar();
+    benchmarkTemperatureCalculation();
+    benchmarkPlugins(Signal::RAW);
+    benchmarkPlugins(Signal::ABS);
+
+    report();
+
+    if(!m_outputFile.isEmpty() && !writeJSON(m_outputFile))
+        m_exitCode = 1;
+
+    if(!m_compareFile.isEmpty())
+        compare(m_compareFile);
+
+    delete m_mrun;
+    m_mrun = 0;
+
+    emit finished(m_exitCode);
+}
+
+
+/**
+ * @brief Benchmark::selectLIISettings selects the LIISettings (channel wavelengths)
+ * for the synthetic data: by name, by channel count or default LIISettings
+ * @return false if no matching LIISettings are available
+ */
+bool Benchmark::selectLIISettings()
+{
+    DatabaseManager* dbm = Core::instance()->getDatabaseManager();
+    int count = dbm->getLIISettings()->size();
+
+    if(!m_liiSettingsName.isEmpty())
+    {
+        for(int i = 0; i < count; i++)
+        {
+            if(dbm->getLIISetting(i)->name == m_liiSettingsName)
+            {
+                m_liiSettings = *dbm->getLIISetting(i);
+                m_channels = m_liiSettings.channels.size();
+                return true;
+            }
+        }
+        MSG_ERR("Benchmark: LIISettings not found in database: " + m_liiSettingsName);
+        return false;
+    }
+
+    LIISettings defaultSettings = Core::instance()->modelingSettings->defaultLiiSettings();
+
+    if(m_channels == 0 || defaultSettings.channels.size() == m_channels)
+    {
+        m_liiSettings = defaultSettings;
+        m_channels = m_liiSettings.channels.size();
+        return m_channels > 0;
+    }
+
+    for(int i = 0; i < count; i++)
+    {
+        if(dbm->getLIISetting(i)->channels.size() == m_channels)
+        {
+            m_liiSettings = *dbm->getLIISetting(i);
+            return true;
+        }
+    }
+
+    MSG_ERR(QString("Benchmark: no LIISettings with %0 channels in database").arg(m_channels));
+    return false;
+}
+
+
+/**
+ * @brief Benchmark::selectSourceEm selects the first E(m) source which is
+ * available for all channels of the material (see Temperature::checkEmSource()).
+ * If no source is available, blackbody intensities are generated and the
+ * temperature calculation benchmarks are skipped.
+ */
+void Benchmark::selectSourceEm()
+{
+    QMap<int, Channel> channels;
+    for(int i = 0; i < m_liiSettings.channels.size(); i++)
+        channels.insert(i+1, m_liiSettings.channels.at(i));
+
+    // same order as TemperatureCalculator: default source first
+    QStringList sources;
+    sources << "function" << "values" << "from Drude theory";
+
+    m_sourceEm.clear();
+    for(int i = 0; i < sources.size(); i++)
+    {
+        if(Temperature::checkEmSource(m_material, sources.at(i), channels))
+        {
+            m_sourceEm = sources.at(i);
+            return;
+        }
+    }
+
+    MSG_WARN("Benchmark: no E(m) source available for material " + m_material.name
+             + ", temperature calculation benchmarks are skipped");
+}
+
+
+/**
+ * @brief Benchmark::planckIntensity intensity of the synthetic signals
+ * @param lambda_m wavelength [m]
+ * @param T temperature [K]
+ * @return intensity (scaled by m_C)
+ */
+double Benchmark::planckIntensity(double lambda_m, double T)
+{
+    if(!m_sourceEm.isEmpty())
+        return Temperature::calcPlanckIntensity(lambda_m, T, m_C, m_material, m_sourceEm);
+
+    return m_C / lambda_m
+            * Constants::c_1
+            / pow(lambda_m, 5)
+            / (exp(Constants::c_2 / lambda_m / T) - 1);
+}
+
+
+/**
+ * @brief Benchmark::generateMRun generates the synthetic MRun: raw and absolute
+ * signals of all channels are Planck intensities of an exponentially decaying
+ * temperature trace (peak at t = 0, 10% pre-trigger samples) with gaussian noise.
+ */
+void Benchmark::generateMRun()
+{
+    MRunGroup* group = Core::instance()->dataModel()->defaultGroup();
+
+    m_mrun = new MRun("Benchmark", m_channels, group);
+    m_mrun->setLiiSettings(m_liiSettings, true);
+
+    // scale intensities: peak of first channel = 1.0
+    double lambda0 = m_liiSettings.channels.at(0).wavelength * 1E-9;
+    m_C = 1.0;
+    m_C = 1.0 / planckIntensity(lambda0, benchPeakTemperature);
+
+    double startTime = -0.1 * m_samples * m_dt;
+    double tau = 0.25 * m_samples * m_dt;
+
+    QVector<double> temperature(m_samples);
+    for(int j = 0; j < m_samples; j++)
+    {
+        double t = startTime + j * m_dt;
+        if(t < 0.0)
+            temperature[j] = benchGasTemperature;
+        else
+            temperature[j] = benchGasTemperature
+                    + (benchPeakTemperature - benchGasTemperature) * exp(-t / tau);
+    }
+
+    QVector<QVector<double>> intensity(m_channels);
+    QVector<double> peak(m_channels);
+    for(int c = 0; c < m_channels; c++)
+    {
+        double lambda_m = m_liiSettings.channels.at(c).wavelength * 1E-9;
+        intensity[c].resize(m_samples);
+        for(int j = 0; j < m_samples; j++)
+            intensity[c][j] = planckIntensity(lambda_m, temperature.at(j));
+        peak[c] = planckIntensity(lambda_m, benchPeakTemperature);
+    }
+
+    std::mt19937 rng(m_seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+
+    for(int i = 0; i < m_shots; i++)
+    {
+        MPoint* pre = m_mrun->getCreatePre(i);
+        MPoint* post = m_mrun->getPost(i);
+
+        for(int c = 0; c < m_channels; c++)
+        {
+            Signal sig(m_samples, m_dt, startTime);
+            sig.channelID = c+1;
+
+            for(int j = 0; j < m_samples; j++)
+                sig.data[j] = intensity.at(c).at(j) + m_noise * peak.at(c) * gauss(rng);
+
+            sig.type = Signal::RAW;
+            pre->setSignal(sig, c+1, Signal::RAW);
+            post->setSignal(sig, c+1, Signal::RAW);
+
+            sig.type = Signal::ABS;
+            pre->setSignal(sig, c+1, Signal::ABS);
+            post->setSignal(sig, c+1, Signal::ABS);
+        }
+    }
+}
+
+
+/**
+ * @brief Benchmark::measure runs task m_repeat times and stores the runtime statistics
+ * @param group benchmark group
+ * @param name benchmark name
+ * @param task timed operation
+ * @param setup operation executed before each repetition (not timed)
+ */
+void Benchmark::measure(const QString &group, const QString &name,
+                        std::function<void()> task, std::function<void()> setup)
+{
+    Result res;
+    res.group = group;
+    res.name = name;
+    res.status = "ok";
+    res.min = 0.0;
+    res.median = 0.0;
+    res.mean = 0.0;
+
+    QElapsedTimer timer;
+
+    try
+    {
+        for(int r = 0; r < m_repeat; r++)
+        {
+            if(setup)
+                setup();
+
+            timer.start();
+            task();
+            res.times.append(timer.nsecsElapsed() * 1E-6);
+        }
+    }
+    catch(LIISimException e)
+    {
+        MSG_ERR(QString("Benchmark: %0/%1: %2").arg(group).arg(name).arg(e.what()));
+        res.status = "error";
+        m_exitCode = 1;
+    }
+
+    if(!res.times.isEmpty())
+    {
+        QVector<double> sorted = res.times;
+        std::sort(sorted.begin(), sorted.end());
+
+        int n = sorted.size();
+        res.min = sorted.first();
+        res.median = (n % 2) ? sorted.at(n/2) : 0.5 * (sorted.at(n/2 - 1) + sorted.at(n/2));
+
+        double sum = 0.0;
+        for(int i = 0; i < n; i++)
+            sum += sorted.at(i);
+        res.mean = sum / n;
+    }
+
+    m_results.append(res);
+}
+
+
+void Benchmark::skip(const QString &group, const QString &name)
+{
+    Result res;
+    res.group = group;
+    res.name = name;
+    res.status = "skipped";
+    res.min = 0.0;
+    res.median = 0.0;
+    res.mean = 0.0;
+
+    m_results.append(res);
+}
+
+
+/**
+ * @brief Benchmark::benchmarkPlugins times each available plugin of the
+ * processing chain (single plugin in chain, all MPoints, single thread)
+ * @param stype signal type of processing chain
+ */
+void Benchmark::benchmarkPlugins(Signal::SType stype)
+{
+    ProcessingChain* pchain = m_mrun->getProcessingChain(stype);
+    QStringList names = PluginFactory::getAvailablePluginNames(stype);
+    QString group = "plugin_" + Signal::stypeToString(stype).toLower();
+
+    int noMpoints = m_mrun->sizeAllMpoints();
+
+    for(int i = 0; i < names.size(); i++)
+    {
+        pchain->clearAll();
+
+        ProcessingPlugin* plugin = PluginFactory::createInstance(names.at(i), pchain);
+        if(!plugin)
+        {
+            skip(group, names.at(i));
+            continue;
+        }
+        pchain->addPlug(plugin);
+
+        measure(group, names.at(i),
+                [&](){
+                    plugin->prepareMPoints(0, noMpoints - 1);
+                    plugin->processMPoints(0, noMpoints - 1);
+                },
+                [&](){
+                    plugin->reset();
+                    pchain->initializeCalculation();
+                });
+    }
+
+    pchain->clearAll();
+}
+
+
+/**
+ * @brief Benchmark::benchmarkTemperatureCalculation times the TemperatureCalculator
+ * methods (Two-Color: channel 1 and 2, Spectrum: all channels) for all MPoints
+ */
+void Benchmark::benchmarkTemperatureCalculation()
+{
+    QString group = "temperature";
+
+    if(m_sourceEm.isEmpty() || m_channels < 2)
+    {
+        skip(group, "Two-Color");
+        skip(group, "Spectrum");
+        return;
+    }
+
+    measure(group, "Two-Color", [&](){
+        for(int i = 0; i < m_shots; i++)
+            Temperature::calcTemperatureFromTwoColor(m_liiSettings, m_material, m_sourceEm,
+                                                     m_mrun->getPost(i), 1, 2, Signal::ABS);
+    });
+
+    QList<bool> activeChannels;
+    for(int c = 0; c < m_channels; c++)
+        activeChannels << true;
+
+    measure(group, "Spectrum", [&](){
+        for(int i = 0; i < m_shots; i++)
+            Temperature::calcTemperatureFromSpectrum(m_liiSettings, m_material, m_sourceEm,
+                                                     m_mrun->getPost(i), Signal::ABS,
+                                                     &activeChannels,
+                                                     false, false, true, 50, 2500.0, 1.0);
+    });
+}
+
+
+/**
+ * @brief Benchmark::benchmarkODESolvers times Numeric::solveODE() of the current
+ * heat transfer model (ModelingSettings) for each ODE solver (m_samples steps)
+ */
+void Benchmark::benchmarkODESolvers()
+{
+    ModelingSettings* ms = Core::instance()->modelingSettings;
+    HeatTransferModel* htm = ms->heatTransferModel();
+
+    bool available = htm && htm->checkAvailability();
+
+    for(int i = 0; i < Numeric::SolverCount; i++)
+    {
+        QString name = Numeric::getODEName(i);
+
+        if(!available)
+        {
+            skip("ode", name);
+            continue;
+        }
+
+        NumericSettings ns;
+        ns.setOdeSolver(i);
+
+        measure("ode", name, [&](){
+            htm->setProcessConditions(ms->processPressure(), benchGasTemperature);
+            Numeric::solveODE(benchPeakTemperature, benchParticleSize, *htm, m_samples, m_dt, &ns);
+        });
+    }
+}
+
+
+/**
+ * @brief Benchmark::benchmarkLevmar times Numeric::levmar() for
+ * FitRun::TEMP (spectrum of one data point at signal peak) and FitRun::PSIZE
+ * (synthetic temperature trace of current heat transfer model with noise).
+ * FitRun::TEMP_CAL is experimental and not timed.
+ */
+void Benchmark::benchmarkLevmar()
+{
+    ModelingSettings* ms = Core::instance()->modelingSettings;
+
+    // ---- TEMP ----
+
+    if(m_sourceEm.isEmpty() || m_channels < 2)
+        skip("levmar", "TEMP");
+    else
+    {
+        MPoint* mp = m_mrun->getPost(0);
+        int peak = mp->getSignal(1, Signal::ABS).getMaxIndex();
+
+        QVector<double> wavelengths, intensities, stdev;
+        QVector<int> bandwidths;
+        for(int c = 0; c < m_channels; c++)
+        {
+            Channel ch = m_liiSettings.channels.at(c);
+            wavelengths.append(double(ch.wavelength));
+            bandwidths.append(ch.getHalfBandwidth());
+            intensities.append(mp->getSignal(c+1, Signal::ABS).data.at(peak));
+            stdev.append(1.0);
+        }
+
+        QList<FitParameter> fparams;
+        fparams << FitParameter(0, "Start temperature", "K", 2500.0, 1000.0, 5000.0, 500.0);
+        fparams << FitParameter(1, "C", "-", m_C * 2.0, 1E-30, 1E30, 10000.0);
+
+        FitSettings fs;
+        fs.setFitParameters(fparams);
+        fs.setBandpassIntegrationActive(false);
+        fs.setWeightingActive(false);
+        fs.setSourceEm(m_sourceEm);
+
+        // same settings as Temperature::calcTemperatureFromSpectrum()
+        NumericSettings ns;
+        ns.setIterations(50);
+        ns.lambda_init        = 0.1;
+        ns.lambda_decrease    = 0.5;
+        ns.lambda_increase    = 2.0;
+        ns.lambda_scaling     = 100;
+
+        FitData fd;
+        fd.initData(wavelengths, intensities, stdev);
+        fd.initBandwidth(bandwidths);
+
+        measure("levmar", "TEMP", [&](){
+            Numeric::levmar(FitRun::TEMP, &fd, ms, &fs, &ns);
+        },
+        [&](){
+            fd.clearResults();
+        });
+    }
+
+    // ---- PSIZE ----
+
+    HeatTransferModel* htm = ms->heatTransferModel();
+    if(!htm || !htm->checkAvailability())
+    {
+        skip("levmar", "PSIZE");
+        return;
+    }
+
+    m_tchid = m_mrun->addTemperatureChannel(1);
+
+    NumericSettings ns;
+    htm->setProcessConditions(ms->processPressure(), benchGasTemperature);
+    Signal tsig = Numeric::solveODE(benchPeakTemperature, benchParticleSize, *htm, m_samples, m_dt, &ns);
+    tsig.start_time = 0.0;
+    tsig.type = Signal::TEMPERATURE;
+    tsig.channelID = m_tchid;
+
+    std::mt19937 rng(m_seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    for(int j = 0; j < tsig.data.size(); j++)
+        tsig.data[j] += m_noise * benchPeakTemperature * gauss(rng);
+
+    m_mrun->getPost(0)->setSignal(tsig, m_tchid, Signal::TEMPERATURE);
+
+    // start values differ from the parameters of the synthetic trace
+    QList<FitParameter> fparams = FitSettings::availableFitParameters();
+    fparams[0].setValue(benchParticleSize * 1.5);
+    fparams[1].setValue(benchGasTemperature);
+    fparams[2].setValue(benchPeakTemperature * 0.9);
+
+    FitSettings fs;
+    fs.setFitParameters(fparams);
+
+    FitData fd(m_mrun->id(), 0, Signal::TEMPERATURE, m_tchid);
+
+    measure("levmar", "PSIZE", [&](){
+        Numeric::levmar(FitRun::PSIZE, &fd, ms, &fs, &ns);
+    },
+    [&](){
+        fd.clearResults();
+    });
+}
+
+
+/**
+ * @brief Benchmark::report prints the results (tab separated, to standard output)
+ */
+void Benchmark::report()
+{
+    QTextStream out(stdout);
+
+    out << "group\tname\tstatus\trepeat\tmin_ms\tmedian_ms\tmean_ms\n";
+
+    for(int i = 0; i < m_results.size(); i++)
+    {
+        const Result& r = m_results.at(i);
+        out << r.group << "\t"
+            << r.name << "\t"
+            << r.status << "\t"
+            << r.times.size() << "\t"
+            << QString::number(r.min, 'f', 4) << "\t"
+            << QString::number(r.median, 'f', 4) << "\t"
+            << QString::number(r.mean, 'f', 4) << "\n";
+    }
+    out.flush();
+}
+
+
+/**
+ * @brief Benchmark::writeJSON writes configuration, build information and results to file
+ * @param fname output file
+ */
+bool Benchmark::writeJSON(const QString &fname)
+{
+    QJsonObject build;
+    build.insert("version", Core::LIISIM_VERSION);
+    build.insert("qt", QString(QT_VERSION_STR));
+    build.insert("date", QString(__DATE__) + " " + QString(__TIME__));
+#ifdef QT_DEBUG
+    build.insert("mode", QString("debug"));
+#else
+    build.insert("mode", QString("release"));
+#endif
+
+    QJsonObject config;
+    config.insert("shots", m_shots);
+    config.insert("channels", m_channels);
+    config.insert("samples", m_samples);
+    config.insert("dt", m_dt);
+    config.insert("noise", m_noise);
+    config.insert("repeat", m_repeat);
+    config.insert("seed", double(m_seed));
+    config.insert("liisettings", m_liiSettings.name);
+    config.insert("material", m_material.name);
+    config.insert("sourceEm", m_sourceEm);
+    config.insert("heatTransferModel", Core::instance()->modelingSettings->heatTransferModel()
+                  ? Core::instance()->modelingSettings->heatTransferModel()->name : QString());
+
+    QJsonArray results;
+    for(int i = 0; i < m_results.size(); i++)
+    {
+        const Result& r = m_results.at(i);
+
+        QJsonArray times;
+        for(int k = 0; k < r.times.size(); k++)
+            times.append(r.times.at(k));
+
+        QJsonObject res;
+        res.insert("group", r.group);
+        res.insert("name", r.name);
+        res.insert("status", r.status);
+        res.insert("min_ms", r.min);
+        res.insert("median_ms", r.median);
+        res.insert("mean_ms", r.mean);
+        res.insert("times_ms", times);
+        results.append(res);
+    }
+
+    QJsonObject root;
+    root.insert("build", build);
+    root.insert("config", config);
+    root.insert("timestamp", QDateTime::currentDateTime().toString(Qt::ISODate));
+    root.insert("results", results);
+
+    QFile file(fname);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        MSG_ERR("Benchmark: cannot write " + fname);
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+
+    MSG_NORMAL("Benchmark: results written to " + fname);
+    return true;
+}
+
+
+/**
+ * @brief Benchmark::compare prints the median runtime relative
+ * to the results of a previous run (JSON file, see writeJSON())
+ * @param fname JSON file of previous run
+ */
+void Benchmark::compare(const QString &fname)
+{
+    QFile file(fname);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        MSG_ERR("Benchmark: cannot read " + fname);
+        m_exitCode = 1;
+        return;
+    }
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+
+    QJsonObject config = root.value("config").toObject();
+    if(config.value("shots").toInt() != m_shots ||
+       config.value("channels").toInt() != m_channels ||
+       config.value("samples").toInt() != m_samples)
+        MSG_WARN("Benchmark: configuration of " + fname + " differs (shots/channels/samples)");
+
+    QMap<QString, double> baseline;
+    QJsonArray results = root.value("results").toArray();
+    for(int i = 0; i < results.size(); i++)
+    {
+        QJsonObject res = results.at(i).toObject();
+        if(res.value("status").toString() == "ok")
+            baseline.insert(res.value("group").toString() + "/" + res.value("name").toString(),
+                            res.value("median_ms").toDouble());
+    }
+
+    QTextStream out(stdout);
+    out << "\ncomparison with " << fname
+        << " (" << root.value("build").toObject().value("version").toString() << ")\n";
+    out << "group\tname\tbaseline_median_ms\tmedian_ms\tratio\n";
+
+    for(int i = 0; i < m_results.size(); i++)
+    {
+        const Result& r = m_results.at(i);
+        QString key = r.group + "/" + r.name;
+
+        if(r.status != "ok" || !baseline.contains(key))
+            continue;
+
+        double base = baseline.value(key);
+        out << r.group << "\t"
+            << r.name << "\t"
+            << QString::number(base, 'f', 4) << "\t"
+            << QString::number(r.median, 'f', 4) << "\t"
+            << (base > 0.0 ? QString::number(r.median / base, 'f', 3) : QString("-")) << "\n";
+    }
+    out.flush();
+}
@@ -0,0 +1,117 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "../signal/signal.h"
+#include "../database/structure/liisettings.h"
+#include "../database/structure/material.h"
+
+class MRun;
+
+/**
+ * @brief The Benchmark class measures the runtime of the computational core
+ * of LIISim on synthetic data (no input files needed).
+ * @details A synthetic MRun (configurable number of shots, channels, samples
+ * and noise level) is generated from a decaying temperature trace
+ * (Planck intensities of the channel wavelengths of the selected LIISettings).
+ * Following operations are timed (repeated --repeat times each):
+ *  - each available ProcessingPlugin of the raw and absolute processing chain
+ *    (single plugin in chain, all MPoints)
+ *  - TemperatureCalculator methods (Temperature::calcTemperatureFromTwoColor()/
+ *    calcTemperatureFromSpectrum()) for all MPoints
+ *  - Numeric::solveODE() for each ODE solver
+ *  - Numeric::levmar() for FitRun::TEMP (single data point) and FitRun::PSIZE
+ *
+ * Results (minimum, median and mean runtime) are written tab separated to
+ * standard output and optionally as JSON file (--output), which can be
+ * compared with the results of a previous build (--compare).
+ * The random generator is initialized with a fixed seed (--seed), so all builds
+ * process identical data.
+ *
+ * Usage: LIISim3 --benchmark [options] (see LIISim3 --benchmark --help).
+ */
+class Benchmark : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Benchmark(QObject *parent = 0);
+    ~Benchmark();
+
+    static bool isBenchmarkCall(int argc, char *argv[]);
+    static int exec(int argc, char *argv[]);
+
+    bool parseArguments(const QStringList &arguments);
+
+    inline int exitCode(){ return m_exitCode; }
+
+public slots:
+    void start();
+
+private:
+
+    /** @brief runtime statistics of one benchmark case */
+    struct Result
+    {
+        QString group;
+        QString name;
+        QString status;     // "ok", "skipped" or "error"
+        QVector<double> times; // runtime of each repetition [ms]
+        double min;
+        double median;
+        double mean;
+    };
+
+    int m_exitCode;
+
+    // options
+    int m_shots;
+    int m_channels;
+    int m_samples;
+    double m_dt;
+    double m_noise;
+    int m_repeat;
+    unsigned int m_seed;
+    QString m_settingsFile;
+    QString m_liiSettingsName;
+    QString m_outputFile;
+    QString m_compareFile;
+
+    // synthetic data
+    LIISettings m_liiSettings;
+    Material m_material;
+    QString m_sourceEm;
+    double m_C;
+    MRun* m_mrun;
+    int m_tchid;
+
+    QList<Result> m_results;
+
+    bool selectLIISettings();
+    void selectSourceEm();
+    void generateMRun();
+    double planckIntensity(double lambda_m, double T);
+
+    void benchmarkPlugins(Signal::SType stype);
+    void benchmarkTemperatureCalculation();
+    void benchmarkODESolvers();
+    void benchmarkLevmar();
+
+    void measure(const QString &group, const QString &name,
+                 std::function<void()> task,
+                 std::function<void()> setup = std::function<void()>());
+    void skip(const QString &group, const QString &name);
+
+    void report();
+    bool writeJSON(const QString &fname);
+    void compare(const QString &fname);
+
+signals:
+    void finished(int exitCode);
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,22 @@
+#include "headlessapplication.h"
+
+#include "../logging/msghandlerbase.h"
+
+
+bool HeadlessApplication::s_active = false;
+
+
+/**
+ * @brief HeadlessApplication::prepare selects the offscreen platform
+ * (if no platform has been set) and installs the message handler,
+ * must be called before the QApplication is created
+ */
+void HeadlessApplication::prepare()
+{
+    if(qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    qInstallMessageHandler(&MsgHandlerBase::handleQtMessage);
+
+    s_active = true;
+}
@@ -0,0 +1,64 @@
+#ifndef HEADLESSAPPLICATION_H
+#define HEADLESSAPPLICATION_H
+
+#include <QApplication>
+#include <QTimer>
+
+#include "../core.h"
+#include "../logging/consoleouthandler.h"
+#include "taskscheduler.h"
+
+/**
+ * @brief The HeadlessApplication class runs LIISim without main window
+ * (command line modes, see BatchProcessor and Benchmark).
+ * @details exec() creates the QApplication (the processing code requires
+ * a QApplication, but no display), a console output handler and the runner,
+ * parses the command line and runs the event loop until the runner emits
+ * finished(int). Runner needs parseArguments(), a start() slot,
+ * a finished(int) signal and exitCode().
+ */
+class HeadlessApplication
+{
+public:
+    template<class Runner>
+    static int exec(int argc, char *argv[])
+    {
+        prepare();
+
+        QApplication app(argc, argv);
+
+        ConsoleOutHandler* outputHandler = new ConsoleOutHandler();
+
+        int res = 2;
+        {
+            Runner runner;
+
+            if(runner.parseArguments(app.arguments()))
+            {
+                QObject::connect(&runner, SIGNAL(finished(int)), &app, SLOT(quit()), Qt::QueuedConnection);
+                QTimer::singleShot(0, &runner, SLOT(start()));
+
+                app.exec();
+                res = runner.exitCode();
+
+                // workers which could not be stopped might still access the data model
+                if(TaskScheduler::instance()->isIdle())
+                    delete Core::instance();
+            }
+        }
+
+        delete outputHandler;
+
+        return res;
+    }
+
+    /** @brief true if LIISim runs without main window (no dialogs can be shown) */
+    static bool isActive() { return s_active; }
+
+private:
+    static void prepare();
+
+    static bool s_active;
+};
+
+#endif // HEADLESSAPPLICATION_H
@@ -0,0 +1,362 @@
+#include "profiling.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+
+/**
+ * @brief The ProfilingThreadBuffer class holds the recorded zones of one thread.
+ * Events are only appended by the owning thread, the mutex is only contended
+ * while results are collected.
+ */
+class ProfilingThreadBuffer
+{
+public:
+    int thread;
+    QString threadName;
+
+    QMutex mutex;
+    QVector<ProfilingEvent> events;
+
+    /** @brief accumulated duration of nested zones of all open zones (owning thread only) */
+    QVector<qint64> childTime;
+};
+
+
+/**
+ * @brief The ProfilingRegistry class owns the buffers of all threads
+ * which have recorded zones (buffers are kept until program exit).
+ */
+class ProfilingRegistry
+{
+public:
+    ~ProfilingRegistry()
+    {
+        qDeleteAll(buffers);
+    }
+
+    QMutex mutex;
+    QList<ProfilingThreadBuffer*> buffers;
+};
+
+
+static ProfilingRegistry& registry()
+{
+    static ProfilingRegistry reg;
+    return reg;
+}
+
+
+static thread_local ProfilingThreadBuffer* t_buffer = 0;
+
+std::atomic<bool> ProfilingRecorder::m_recording(false);
+
+
+/**
+ * @brief ProfilingRecorder::setRecording enables/disables the recording of profiling zones
+ * @param state
+ */
+void ProfilingRecorder::setRecording(bool state)
+{
+    m_recording.store(state, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief ProfilingRecorder::clear removes all recorded zones
+ */
+void ProfilingRecorder::clear()
+{
+    ProfilingRegistry& reg = registry();
+    QMutexLocker lock(&reg.mutex);
+
+    for(int i = 0; i < reg.buffers.size(); i++)
+    {
+        QMutexLocker bufferLock(&reg.buffers[i]->mutex);
+        reg.buffers[i]->events.clear();
+    }
+}
+
+
+/**
+ * @brief ProfilingRecorder::timestamp
+ * @return monotonic time [ns]
+ */
+qint64 ProfilingRecorder::timestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/**
+ * @brief ProfilingRecorder::threadBuffer returns the buffer of the
+ * calling thread (created on first call)
+ */
+ProfilingThreadBuffer* ProfilingRecorder::threadBuffer()
+{
+    if(t_buffer)
+        return t_buffer;
+
+    ProfilingThreadBuffer* buffer = new ProfilingThreadBuffer;
+
+    QThread* current = QThread::currentThread();
+    QCoreApplication* app = QCoreApplication::instance();
+
+    ProfilingRegistry& reg = registry();
+    QMutexLocker lock(&reg.mutex);
+
+    buffer->thread = reg.buffers.size();
+
+    if(app && current == app->thread())
+        buffer->threadName = "Main thread";
+    else if(current && !current->objectName().isEmpty())
+        buffer->threadName = current->objectName();
+    else
+        buffer->threadName = QString("Worker thread %0").arg(buffer->thread);
+
+    reg.buffers.append(buffer);
+    t_buffer = buffer;
+
+    return buffer;
+}
+
+
+QString ProfilingRecorder::threadName(int thread)
+{
+    ProfilingRegistry& reg = registry();
+    QMutexLocker lock(&reg.mutex);
+
+    if(thread < 0 || thread >= reg.buffers.size())
+        return QString();
+    return reg.buffers.at(thread)->threadName;
+}
+
+
+/**
+ * @brief ProfilingRecorder::events
+ * @return copy of the recorded zones of all threads (sorted by thread,
+ * events of a thread are stored in order of zone completion)
+ */
+QList<ProfilingEvent> ProfilingRecorder::events()
+{
+    QList<ProfilingEvent> res;
+
+    ProfilingRegistry& reg = registry();
+    QMutexLocker lock(&reg.mutex);
+
+    for(int i = 0; i < reg.buffers.size(); i++)
+    {
+        QMutexLocker bufferLock(&reg.buffers[i]->mutex);
+        const QVector<ProfilingEvent>& ev = reg.buffers.at(i)->events;
+        for(int k = 0; k < ev.size(); k++)
+            res.append(ev.at(k));
+    }
+    return res;
+}
+
+
+/**
+ * @brief ProfilingRecorder::summary accumulates all zones with same run, category and name
+ * @return list of entries in order of first occurrence
+ */
+QList<ProfilingSummaryEntry> ProfilingRecorder::summary()
+{
+    QList<ProfilingEvent> ev = events();
+
+    // sort by start time: entries are listed in order of execution
+    std::sort(ev.begin(), ev.end(), [](const ProfilingEvent& a, const ProfilingEvent& b){
+        return a.begin < b.begin;
+    });
+
+    QList<ProfilingSummaryEntry> res;
+    QHash<QString, int> index;
+
+    for(int i = 0; i < ev.size(); i++)
+    {
+        const ProfilingEvent& e = ev.at(i);
+        QString key = e.run + QChar(0) + e.category + QChar(0) + e.name;
+
+        double ms = e.duration * 1E-6;
+
+        int idx = index.value(key, -1);
+        if(idx < 0)
+        {
+            ProfilingSummaryEntry entry;
+            entry.run = e.run;
+            entry.category = e.category;
+            entry.name = e.name;
+            entry.count = 0;
+            entry.total = 0.0;
+            entry.self = 0.0;
+            entry.min = std::numeric_limits<double>::max();
+            entry.max = 0.0;
+
+            idx = res.size();
+            index.insert(key, idx);
+            res.append(entry);
+        }
+
+        ProfilingSummaryEntry& entry = res[idx];
+        entry.count++;
+        entry.total += ms;
+        entry.self += e.selfDuration * 1E-6;
+        entry.min = qMin(entry.min, ms);
+        entry.max = qMax(entry.max, ms);
+    }
+    return res;
+}
+
+
+/**
+ * @brief ProfilingRecorder::writeChromeTrace writes all recorded zones as
+ * Chrome trace event file (JSON, can be opened with chrome://tracing or
+ * https://ui.perfetto.dev)
+ * @param fname output file
+ * @return false if file could not be written
+ */
+bool ProfilingRecorder::writeChromeTrace(const QString &fname)
+{
+    QFile file(fname);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QList<ProfilingEvent> ev = events();
+
+    qint64 t0 = std::numeric_limits<qint64>::max();
+    QList<int> threads;
+    for(int i = 0; i < ev.size(); i++)
+    {
+        t0 = qMin(t0, ev.at(i).begin);
+        if(!threads.contains(ev.at(i).thread))
+            threads.append(ev.at(i).thread);
+    }
+
+    qint64 pid = QCoreApplication::applicationPid();
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+
+    // thread names (metadata events)
+    for(int i = 0; i < threads.size(); i++)
+    {
+        QJsonObject args;
+        args.insert("name", threadName(threads.at(i)));
+
+        QJsonObject obj;
+        obj.insert("name", QString("thread_name"));
+        obj.insert("ph", QString("M"));
+        obj.insert("pid", double(pid));
+        obj.insert("tid", threads.at(i));
+        obj.insert("args", args);
+
+        if(!first)
+            out << ",\n";
+        out << QJsonDocument(obj).toJson(QJsonDocument::Compact);
+        first = false;
+    }
+
+    // complete events, time in microseconds
+    for(int i = 0; i < ev.size(); i++)
+    {
+        const ProfilingEvent& e = ev.at(i);
+
+        QJsonObject obj;
+        obj.insert("name", e.name);
+        obj.insert("cat", QString(e.category));
+        obj.insert("ph", QString("X"));
+        obj.insert("ts", (e.begin - t0) * 1E-3);
+        obj.insert("dur", e.duration * 1E-3);
+        obj.insert("pid", double(pid));
+        obj.insert("tid", e.thread);
+
+        if(!e.run.isEmpty())
+        {
+            QJsonObject args;
+            args.insert("run", e.run);
+            obj.insert("args", args);
+        }
+
+        if(!first)
+            out << ",\n";
+        out << QJsonDocument(obj).toJson(QJsonDocument::Compact);
+        first = false;
+    }
+
+    out << "\n]}\n";
+    out.flush();
+
+    return file.error() == QFile::NoError;
+}
+
+
+// ---- ProfilingZone ----
+
+
+ProfilingZone::ProfilingZone(const char *category)
+    : m_category(category), m_buffer(0), m_begin(0), m_started(false)
+{
+    if(ProfilingRecorder::isRecording())
+        m_buffer = ProfilingRecorder::threadBuffer();
+}
+
+
+/**
+ * @brief ProfilingZone::begin starts the timer of this zone
+ * @param name name of zone (e.g. plugin name)
+ * @param run name of MRun
+ */
+void ProfilingZone::begin(const QString &name, const QString &run)
+{
+    if(!m_buffer || m_started)
+        return;
+
+    m_name = name;
+    m_run = run;
+    m_started = true;
+
+    m_buffer->childTime.append(0);
+    m_begin = ProfilingRecorder::timestamp();
+}
+
+
+ProfilingZone::~ProfilingZone()
+{
+    if(!m_started)
+        return;
+
+    qint64 duration = ProfilingRecorder::timestamp() - m_begin;
+
+    qint64 children = m_buffer->childTime.last();
+    m_buffer->childTime.removeLast();
+
+    // add duration to parent zone
+    if(!m_buffer->childTime.isEmpty())
+        m_buffer->childTime.last() += duration;
+
+    ProfilingEvent e;
+    e.category = m_category;
+    e.name = m_name;
+    e.run = m_run;
+    e.begin = m_begin;
+    e.duration = duration;
+    e.selfDuration = duration - children;
+    e.depth = m_buffer->childTime.size();
+    e.thread = m_buffer->thread;
+
+    QMutexLocker lock(&m_buffer->mutex);
+    m_buffer->events.append(e);
+}
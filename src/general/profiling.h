@@ -0,0 +1,139 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief The ProfilingEvent struct holds the timing of a single profiling zone
+ */
+struct ProfilingEvent
+{
+    /** @brief category of zone ("task", "chain", "plugin", "io", "numeric") */
+    const char* category;
+    QString name;
+    /** @brief name of MRun (empty if zone is not related to a single MRun) */
+    QString run;
+    /** @brief start time [ns] (see ProfilingRecorder::timestamp()) */
+    qint64 begin;
+    /** @brief duration [ns] */
+    qint64 duration;
+    /** @brief duration without nested zones [ns] */
+    qint64 selfDuration;
+    /** @brief nesting level within thread */
+    int depth;
+    /** @brief index of thread (see ProfilingRecorder::threadName()) */
+    int thread;
+};
+
+
+/**
+ * @brief The ProfilingSummaryEntry struct holds the accumulated
+ * timing of all zones with same run, category and name
+ */
+struct ProfilingSummaryEntry
+{
+    QString run;
+    QString category;
+    QString name;
+    int count;
+    double total;   // [ms]
+    double self;    // [ms]
+    double min;     // [ms]
+    double max;     // [ms]
+};
+
+
+class ProfilingThreadBuffer;
+
+
+/**
+ * @brief The ProfilingRecorder class collects the timing of all
+ * profiling zones (see PROFILE_ZONE) of all threads.
+ * @details Each thread writes to its own buffer, the buffers are only
+ * merged when results are requested (summary(), writeChromeTrace()).
+ * Zones are only recorded while recording is enabled (setRecording()).
+ * Profiling zones are compiled only if LIISIM_PROFILING is defined
+ * (debug builds or 'qmake CONFIG+=liisim_profiling'), otherwise
+ * PROFILE_ZONE expands to nothing.
+ */
+class ProfilingRecorder
+{
+public:
+
+    static inline bool isAvailable()
+    {
+#ifdef LIISIM_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static inline bool isRecording() { return m_recording.load(std::memory_order_relaxed); }
+    static void setRecording(bool state);
+
+    static void clear();
+
+    static qint64 timestamp();
+
+    static ProfilingThreadBuffer* threadBuffer();
+    static QString threadName(int thread);
+
+    static QList<ProfilingEvent> events();
+    static QList<ProfilingSummaryEntry> summary();
+
+    static bool writeChromeTrace(const QString &fname);
+
+private:
+    static std::atomic<bool> m_recording;
+};
+
+
+/**
+ * @brief The ProfilingZone class records the time between begin() and
+ * its destruction (use PROFILE_ZONE macro)
+ */
+class ProfilingZone
+{
+public:
+    explicit ProfilingZone(const char* category);
+    ~ProfilingZone();
+
+    /** @brief true if recording was enabled when the zone has been created */
+    inline bool isActive() const { return m_buffer != 0; }
+
+    void begin(const QString &name, const QString &run = QString());
+
+private:
+    const char* m_category;
+    ProfilingThreadBuffer* m_buffer;
+    QString m_name;
+    QString m_run;
+    qint64 m_begin;
+    bool m_started;
+};
+
+
+#define LIISIM_PROFILE_CONCAT2(a, b) a##b
+#define LIISIM_PROFILE_CONCAT(a, b) LIISIM_PROFILE_CONCAT2(a, b)
+
+/**
+ * @brief PROFILE_ZONE(category, name, run) records the remaining scope as profiling
+ * zone. The arguments name and run (QString) are only evaluated while recording.
+ * The macro expands to a declaration and a single expression (no if statement),
+ * it can be used within if/else branches without braces.
+ */
+#ifdef LIISIM_PROFILING
+    #define PROFILE_ZONE(category, name, run) \
+        ProfilingZone LIISIM_PROFILE_CONCAT(profilingZone_, __LINE__)(category); \
+        (LIISIM_PROFILE_CONCAT(profilingZone_, __LINE__).isActive() \
+            ? LIISIM_PROFILE_CONCAT(profilingZone_, __LINE__).begin(name, run) \
+            : (void)0)
+#else
+    #define PROFILE_ZONE(category, name, run) do {} while(0)
+#endif
+
+#endif // PROFILING_H
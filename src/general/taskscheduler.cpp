@@ -0,0 +1,393 @@
+#include "taskscheduler.h"
+
+#include <QMutexLocker>
+#include <QThread>
+#include <QElapsedTimer>
+
+#include "../logging/msghandlerbase.h"
+#include "LIISimException.h"
+
+
+/**
+ * @brief The TaskSchedulerRunnable class executes a single task
+ * within the thread pool and notifies the scheduler when done
+ */
+class TaskSchedulerRunnable : public QRunnable
+{
+public:
+    TaskSchedulerRunnable(TaskScheduler* scheduler, TaskScheduler::Lane lane, const TaskScheduler::Task &task)
+        : m_scheduler(scheduler), m_lane(lane), m_task(task)
+    {
+        setAutoDelete(true);
+    }
+
+    void run()
+    {
+        // background batches should not slow down the GUI
+        if(m_lane == TaskScheduler::INTERACTIVE)
+            QThread::currentThread()->setPriority(QThread::HighPriority);
+        else if(m_lane == TaskScheduler::FITTING)
+            QThread::currentThread()->setPriority(QThread::LowPriority);
+        else
+            QThread::currentThread()->setPriority(QThread::NormalPriority);
+
+        try
+        {
+            if(m_task.runnable)
+            {
+                bool autoDelete = m_task.runnable->autoDelete();
+                m_task.runnable->run();
+                if(autoDelete)
+                    delete m_task.runnable;
+            }
+            else if(!m_task.token.isCancelled())
+                m_task.function();
+        }
+        catch(LIISimException e)
+        {
+            MSG_ERR(QString("TaskScheduler (%0): %1")
+                    .arg(TaskScheduler::laneName(m_lane)).arg(e.what()));
+        }
+
+        if(!m_task.runnable)
+        {
+            if(m_task.token.isCancelled())
+                m_task.future.reportCanceled();
+            m_task.future.reportFinished();
+        }
+
+        m_scheduler->taskFinished(m_lane, m_task.id);
+    }
+
+private:
+    TaskScheduler* m_scheduler;
+    TaskScheduler::Lane m_lane;
+    TaskScheduler::Task m_task;
+};
+
+
+/**
+ * @brief TaskScheduler::TaskScheduler Constructor. Uses QThread::idealThreadCount() threads.
+ * @param parent
+ */
+TaskScheduler::TaskScheduler(QObject *parent) : QObject(parent)
+{
+    m_running = 0;
+    m_nextId = 0;
+    m_threadCount = qMax(1, QThread::idealThreadCount());
+
+    for(int i = 0; i < laneCount; i++)
+    {
+        m_lanes[i].running = 0;
+        m_lanes[i].finished = 0;
+        m_lanes[i].total = 0;
+        m_lanes[i].limit = m_threadCount;
+    }
+
+    // leave one thread for signal processing during long fits
+    m_lanes[FITTING].limit = qMax(1, m_threadCount - 1);
+
+    // one thread is reserved for interactive tasks
+    m_pool.setMaxThreadCount(m_threadCount + 1);
+    m_pool.setExpiryTimeout(30000);
+}
+
+
+/**
+ * @brief TaskScheduler::instance
+ * @return global scheduler (created on first call, thread-safe, never deleted:
+ * tasks might still be running while static objects are destroyed)
+ */
+TaskScheduler* TaskScheduler::instance()
+{
+    static TaskScheduler* scheduler = new TaskScheduler;
+    return scheduler;
+}
+
+
+QString TaskScheduler::laneName(Lane lane)
+{
+    switch(lane)
+    {
+        case INTERACTIVE: return "interactive";
+        case PROCESSING: return "processing";
+        case IO: return "io";
+        case FITTING: return "fitting";
+    }
+    return QString();
+}
+
+
+/**
+ * @brief TaskScheduler::start submits a QRunnable. Runnables are always
+ * executed (they have to check for cancellation themselves), autoDelete()
+ * is respected.
+ * @param runnable
+ * @param lane
+ * @param priority higher priorities are started first within lane
+ */
+void TaskScheduler::start(QRunnable *runnable, Lane lane, int priority)
+{
+    Task task;
+    task.runnable = runnable;
+    task.priority = priority;
+    enqueue(lane, task);
+}
+
+
+/**
+ * @brief TaskScheduler::run submits a function
+ * @param lane
+ * @param task function to execute
+ * @param priority higher priorities are started first within lane
+ * @param token the task is skipped if the token has been cancelled before the task has been started
+ * @return future, which is canceled if the task has been skipped
+ */
+QFuture<void> TaskScheduler::run(Lane lane,
+                                 std::function<void()> task,
+                                 int priority,
+                                 const TaskCancellationToken &token)
+{
+    Task t;
+    t.runnable = 0;
+    t.function = task;
+    t.token = token;
+    t.priority = priority;
+    t.future.reportStarted();
+
+    QFuture<void> future = t.future.future();
+    enqueue(lane, t);
+    return future;
+}
+
+
+void TaskScheduler::enqueue(Lane lane, const Task &task)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+
+        // insert behind all tasks with same or higher priority
+        QList<Task>& pending = m_lanes[lane].pending;
+        int pos = pending.size();
+        while(pos > 0 && pending.at(pos-1).priority < task.priority)
+            pos--;
+        pending.insert(pos, task);
+        pending[pos].id = m_nextId++;
+
+        m_lanes[lane].total++;
+    }
+
+    dispatch();
+    emitProgress(lane);
+}
+
+
+/**
+ * @brief TaskScheduler::dispatch starts pending tasks while threads are available
+ */
+void TaskScheduler::dispatch()
+{
+    QMutexLocker lock(&m_mutex);
+
+    for(int l = 0; l < laneCount; l++)
+    {
+        LaneState& lane = m_lanes[l];
+
+        // the reserved thread is only available for interactive tasks
+        int budget = (l == INTERACTIVE) ? m_threadCount + 1 : m_threadCount;
+
+        while(!lane.pending.isEmpty() && lane.running < lane.limit && m_running < budget)
+        {
+            Task task = lane.pending.takeFirst();
+
+            lane.running++;
+            m_running++;
+            if(!task.runnable)
+                lane.runningTokens.insert(task.id, task.token);
+
+            m_pool.start(new TaskSchedulerRunnable(this, Lane(l), task));
+        }
+    }
+}
+
+
+void TaskScheduler::taskFinished(Lane lane, quint64 id)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+
+        LaneState& state = m_lanes[lane];
+        state.running--;
+        state.finished++;
+        state.runningTokens.remove(id);
+        m_running--;
+
+        if(isIdleLocked())
+            m_idleCondition.wakeAll();
+    }
+
+    dispatch();
+    emitProgress(lane);
+}
+
+
+void TaskScheduler::emitProgress(Lane lane)
+{
+    int laneFinished, laneTotal;
+    int finished = 0, total = 0;
+    bool idle = true;
+    {
+        QMutexLocker lock(&m_mutex);
+
+        laneFinished = m_lanes[lane].finished;
+        laneTotal = m_lanes[lane].total;
+
+        for(int i = 0; i < laneCount; i++)
+        {
+            finished += m_lanes[i].finished;
+            total += m_lanes[i].total;
+            if(m_lanes[i].running > 0 || !m_lanes[i].pending.isEmpty())
+                idle = false;
+        }
+
+        // progress starts again with next submission
+        if(idle)
+        {
+            for(int i = 0; i < laneCount; i++)
+            {
+                m_lanes[i].finished = 0;
+                m_lanes[i].total = 0;
+            }
+        }
+    }
+
+    emit laneProgressChanged(lane, laneFinished, laneTotal);
+    emit progressChanged(finished, total);
+}
+
+
+/**
+ * @brief TaskScheduler::cancelLane cancels the tokens of all pending
+ * and running function tasks of the lane
+ * @param lane
+ */
+void TaskScheduler::cancelLane(Lane lane)
+{
+    QMutexLocker lock(&m_mutex);
+
+    LaneState& state = m_lanes[lane];
+    for(int i = 0; i < state.pending.size(); i++)
+        if(!state.pending.at(i).runnable)
+            state.pending[i].token.cancel();
+
+    for(QHash<quint64, TaskCancellationToken>::iterator it = state.runningTokens.begin();
+        it != state.runningTokens.end(); ++it)
+        it.value().cancel();
+}
+
+
+/**
+ * @brief TaskScheduler::setThreadCount sets the max. number of
+ * concurrently running tasks (plus one thread reserved for interactive tasks)
+ * @param count
+ */
+void TaskScheduler::setThreadCount(int count)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_threadCount = qMax(1, count);
+        m_pool.setMaxThreadCount(m_threadCount + 1);
+    }
+    dispatch();
+}
+
+
+int TaskScheduler::threadCount()
+{
+    QMutexLocker lock(&m_mutex);
+    return m_threadCount;
+}
+
+
+/**
+ * @brief TaskScheduler::setLaneLimit sets the max. number of concurrently running tasks of a lane
+ * @param lane
+ * @param limit
+ */
+void TaskScheduler::setLaneLimit(Lane lane, int limit)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_lanes[lane].limit = qMax(1, limit);
+    }
+    dispatch();
+}
+
+
+int TaskScheduler::laneLimit(Lane lane)
+{
+    QMutexLocker lock(&m_mutex);
+    return qMin(m_lanes[lane].limit, lane == INTERACTIVE ? m_threadCount + 1 : m_threadCount);
+}
+
+
+int TaskScheduler::pendingTasks(Lane lane)
+{
+    QMutexLocker lock(&m_mutex);
+    return m_lanes[lane].pending.size();
+}
+
+
+int TaskScheduler::runningTasks(Lane lane)
+{
+    QMutexLocker lock(&m_mutex);
+    return m_lanes[lane].running;
+}
+
+
+bool TaskScheduler::isIdle()
+{
+    QMutexLocker lock(&m_mutex);
+    return isIdleLocked();
+}
+
+
+/**
+ * @brief TaskScheduler::isIdleLocked (m_mutex must be locked)
+ * @return true if no task is running or pending
+ */
+bool TaskScheduler::isIdleLocked() const
+{
+    if(m_running > 0)
+        return false;
+    for(int i = 0; i < laneCount; i++)
+        if(!m_lanes[i].pending.isEmpty())
+            return false;
+    return true;
+}
+
+
+/**
+ * @brief TaskScheduler::waitForDone waits until all submitted tasks have been finished
+ * @param msecs timeout (-1: no timeout)
+ * @return false on timeout
+ */
+bool TaskScheduler::waitForDone(int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker lock(&m_mutex);
+    while(!isIdleLocked())
+    {
+        if(msecs < 0)
+            m_idleCondition.wait(&m_mutex);
+        else
+        {
+            qint64 remaining = msecs - timer.elapsed();
+            if(remaining <= 0 || !m_idleCondition.wait(&m_mutex, remaining))
+                return isIdleLocked();
+        }
+    }
+    return true;
+}
@@ -0,0 +1,159 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <QObject>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QHash>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QSharedPointer>
+
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief The TaskCancellationToken class is a shared cancellation flag.
+ * Copies of a token refer to the same flag. Tasks should check
+ * isCancelled() regularly and return early.
+ */
+class TaskCancellationToken
+{
+public:
+    TaskCancellationToken() : m_flag(new std::atomic<bool>(false)) {}
+
+    inline void cancel() { m_flag->store(true, std::memory_order_relaxed); }
+    inline bool isCancelled() const { return m_flag->load(std::memory_order_relaxed); }
+
+private:
+    QSharedPointer<std::atomic<bool>> m_flag;
+};
+
+
+class TaskSchedulerRunnable;
+
+
+/**
+ * @brief The TaskScheduler class executes all background work of LIISim
+ * (signal processing, import/export, fitting) on a dedicated thread pool.
+ * @details Tasks are submitted to lanes. Free threads are assigned to the
+ * pending tasks of the lanes in order of lane priority
+ * (INTERACTIVE > PROCESSING > IO > FITTING), within a lane in order of task
+ * priority (FIFO for equal priority). Each lane has its own concurrency limit,
+ * the total number of running tasks is limited by threadCount(). One additional
+ * thread is reserved for the INTERACTIVE lane: work on the currently displayed
+ * run starts immediately, even if all threads are busy with background tasks.
+ * Running tasks are never interrupted, function tasks (run()) can be cancelled
+ * by TaskCancellationToken (pending tasks with cancelled token are skipped).
+ * Progress (finished/submitted tasks) is aggregated per lane and for all lanes
+ * until the scheduler becomes idle.
+ */
+class TaskScheduler : public QObject
+{
+    Q_OBJECT
+
+    friend class TaskSchedulerRunnable;
+
+public:
+    enum Lane
+    {
+        /** @brief work requested for the currently displayed data */
+        INTERACTIVE = 0,
+        /** @brief signal processing of (multiple) runs */
+        PROCESSING = 1,
+        /** @brief import/export */
+        IO = 2,
+        /** @brief model fitting */
+        FITTING = 3
+    };
+
+    static const int laneCount = 4;
+
+    static TaskScheduler* instance();
+
+    static QString laneName(Lane lane);
+
+    void start(QRunnable* runnable, Lane lane, int priority = 0);
+
+    QFuture<void> run(Lane lane,
+                      std::function<void()> task,
+                      int priority = 0,
+                      const TaskCancellationToken &token = TaskCancellationToken());
+
+    void cancelLane(Lane lane);
+
+    void setThreadCount(int count);
+    int threadCount();
+
+    void setLaneLimit(Lane lane, int limit);
+    int laneLimit(Lane lane);
+
+    int pendingTasks(Lane lane);
+    int runningTasks(Lane lane);
+    bool isIdle();
+
+    bool waitForDone(int msecs = -1);
+
+private:
+    explicit TaskScheduler(QObject *parent = 0);
+
+    /** @brief task waiting for a free thread */
+    struct Task
+    {
+        QRunnable* runnable;
+        std::function<void()> function;
+        QFutureInterface<void> future;
+        TaskCancellationToken token;
+        int priority;
+        quint64 id;
+    };
+
+    struct LaneState
+    {
+        QList<Task> pending;
+        /** @brief tokens of running function tasks (by task id) */
+        QHash<quint64, TaskCancellationToken> runningTokens;
+        int running;
+        int limit;
+        int finished;
+        int total;
+    };
+
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    /** @brief woken if the last running task has finished (see waitForDone()) */
+    QWaitCondition m_idleCondition;
+
+    LaneState m_lanes[laneCount];
+    int m_threadCount;
+    int m_running;
+    quint64 m_nextId;
+
+    void enqueue(Lane lane, const Task &task);
+    void dispatch();
+    void taskFinished(Lane lane, quint64 id);
+    bool isIdleLocked() const;
+    void emitProgress(Lane lane);
+
+signals:
+
+    /**
+     * @brief laneProgressChanged is emitted if a task of the lane has been submitted or finished
+     * @param lane Lane
+     * @param finished number of finished tasks (since scheduler became idle)
+     * @param total number of submitted tasks (since scheduler became idle)
+     */
+    void laneProgressChanged(int lane, int finished, int total);
+
+    /**
+     * @brief progressChanged accumulated progress of all lanes
+     * @param finished number of finished tasks (since scheduler became idle)
+     * @param total number of submitted tasks (since scheduler became idle)
+     */
+    void progressChanged(int finished, int total);
+};
+
+#endif // TASKSCHEDULER_H
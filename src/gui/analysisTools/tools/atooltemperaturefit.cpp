@@ -51,6 +51,7 @@ AToolTemperatureFit::AToolTemperatureFit(QWidget *parent) : SignalPlotTool(paren
     statResY  = 500;
 
     currentMPoint = NULL;
+    currentMPointIdx = 0;
 
     // TODO
 
@@ -725,8 +726,14 @@ void AToolTemperatureFit::processDataInterval()
 
         t_signal = getCurrentTChannel(mp);
 
+        // fit history of selected data point
+        FitHistoryStore::Trace history = run->fitHistory()->trace(currentMPointIdx, tempChannelID);
+
         // check if signal is empty
         int idx = t_signal.indexAt(x);
+        int step = history.indexAt(x);
+        if(history.iterationCount(step) == 0)
+            idx = -1;
 
         if(idx == -1)
         {
@@ -751,7 +758,11 @@ void AToolTemperatureFit::processDataInterval()
 
             qDebug() << "AToolTemp: " << material_spec.name;
 
-            fir = t_signal.fitData.at(t_signal.indexAt(x));
+            fir = history.iterations(step);
+
+            firIterations.clear();
+            for(int i = 0; i < fir.size(); i++)
+                firIterations.append(history.iterationNumber(step, i) + 1);
 
 
             // select last iteration in result table
@@ -858,6 +869,9 @@ void AToolTemperatureFit::processDataInterval()
                 val.sprintf("%g",fir.at(i).at(1)); // lambda: res[1]
                 fitResultTableWidget->setItem(i,5,new QTableWidgetItem(val));
 
+                // row header: iteration number (fit history may skip iterations)
+                fitResultTableWidget->setVerticalHeaderItem(i, new QTableWidgetItem(QString::number(firIterations.at(i))));
+
                 if(C < xmin)
                     statXData.append(xmin);
                 else if (C > xmax)
@@ -988,9 +1002,13 @@ void AToolTemperatureFit::processDataInterval()
                         tmaterial = Material(*Core::instance()->getDatabaseManager()->getMaterial(k));
                 }
 
-                QList<FitIterationResult> tfir = tt_signal.fitData.at(tt_signal.indexAt(x));
-                T = tfir.last().at(2); // res[2]
-                C = tfir.last().at(4); // res[4]
+                FitHistoryStore::Trace tt_history = run->fitHistory()->trace(currentMPointIdx, availableTChannels.at(j));
+                int tt_step = tt_history.indexAt(x);
+                if(tt_history.iterationCount(tt_step) == 0)
+                    continue;
+
+                T = tt_history.finalValue(tt_step, 2); // res[2]
+                C = tt_history.finalValue(tt_step, 4); // res[4]
 
                 QColor color = cmap->color(j, 0, availableTChannels.size());
 
@@ -1213,7 +1231,7 @@ void AToolTemperatureFit::plotResultsIterations(int idx)
 
             for(int i = 0; i < fir.size(); i++)
             {
-                xData.append(i+1);
+                xData.append(firIterations.at(i));
                 yData.append(fir.at(i).at(2));
             }
 
@@ -1226,7 +1244,7 @@ void AToolTemperatureFit::plotResultsIterations(int idx)
 
             for(int i = 0; i < fir.size(); i++)
             {
-                xData.append(i+1);
+                xData.append(firIterations.at(i));
                 yData.append(fir.at(i).at(4));
             }
 
@@ -1239,7 +1257,7 @@ void AToolTemperatureFit::plotResultsIterations(int idx)
 
             for(int i = 0; i < fir.size(); i++)
             {
-                xData.append(i+1);
+                xData.append(firIterations.at(i));
                 yData.append(fir.at(i).at(0));
             }
 
@@ -1252,7 +1270,7 @@ void AToolTemperatureFit::plotResultsIterations(int idx)
 
             for(int i = 0; i < fir.size(); i++)
             {
-                xData.append(i+1);
+                xData.append(firIterations.at(i));
                 yData.append(fir.at(i).at(1));
             }
 
@@ -1285,9 +1303,7 @@ void AToolTemperatureFit::plotResultsFinal(int idx)
     if(tempChannelID < 1)
         return;
 
-    Signal signal = currentMPoint->getSignal(tempChannelID, Signal::TEMPERATURE);
-
-    QList<FitIterationResult> fitResults;
+    FitHistoryStore::Trace history = currentMRun->fitHistory()->trace(currentMPointIdx, tempChannelID);
 
     switch(idx)
     {
@@ -1296,12 +1312,10 @@ void AToolTemperatureFit::plotResultsFinal(int idx)
             resultPlot->setYLogScale(false);
             resultPlot->setPlotAxisTitles("Time / ns", "Temperature / K");
 
-            for(int i = 0; i < signal.data.size(); i++)
+            for(int i = 0; i < history.steps(); i++)
             {
-                fitResults = signal.fitData.at(i);
-
-                xData.append(signal.time(i)*1E9);
-                yData.append(fitResults.last().at(2)); // res[2];
+                xData.append((history.start_time + i * history.dt)*1E9);
+                yData.append(history.finalValue(i, 2)); // res[2];
             }
 
         break;
@@ -1311,12 +1325,10 @@ void AToolTemperatureFit::plotResultsFinal(int idx)
             resultPlot->setYLogScale(false);
             resultPlot->setPlotAxisTitles("Time / ns", "Fit scaling factor C / -");
 
-            for(int i = 0; i < signal.data.size(); i++)
+            for(int i = 0; i < history.steps(); i++)
             {
-                fitResults = signal.fitData.at(i);
-
-                xData.append(signal.time(i)*1E9);
-                yData.append(fitResults.last().at(4)); // res[4];
+                xData.append((history.start_time + i * history.dt)*1E9);
+                yData.append(history.finalValue(i, 4)); // res[4];
             }
 
         break;
@@ -1326,12 +1338,10 @@ void AToolTemperatureFit::plotResultsFinal(int idx)
             resultPlot->setYLogScale(true);
             resultPlot->setPlotAxisTitles("Time / ns", "Chisquare / -");
 
-            for(int i = 0; i < signal.data.size(); i++)
+            for(int i = 0; i < history.steps(); i++)
             {
-                fitResults = signal.fitData.at(i);
-
-                xData.append(signal.time(i)*1E9);
-                yData.append(fitResults.last().at(0)); // res[0];
+                xData.append((history.start_time + i * history.dt)*1E9);
+                yData.append(history.finalValue(i, 0)); // res[0];
             }
 
         break;
@@ -1341,12 +1351,10 @@ void AToolTemperatureFit::plotResultsFinal(int idx)
             resultPlot->setYLogScale(true);
             resultPlot->setPlotAxisTitles("Time / ns", "Damping factor Lambda / -");
 
-            for(int i = 0; i < signal.data.size(); i++)
+            for(int i = 0; i < history.steps(); i++)
             {
-                fitResults = signal.fitData.at(i);
-
-                xData.append(signal.time(i)*1E9);
-                yData.append(fitResults.last().at(1)); // res[1];
+                xData.append((history.start_time + i * history.dt)*1E9);
+                yData.append(history.finalValue(i, 1)); // res[1];
             }
 
         break;
@@ -1841,6 +1849,7 @@ void AToolTemperatureFit::onComboboxMRunIndexChanged()
 
         qDebug() << "AToolTemperatureFit: only first MPoint is used for calculation";
         currentMPoint = currentMRun->getPost(0);
+        currentMPointIdx = 0;
 
         fitPlot->clearText();
         fitPlot->addText(currentMRun->name);
@@ -1862,7 +1871,7 @@ void AToolTemperatureFit::onComboboxMRunIndexChanged()
         {
             chID = currentMPoint->channelIDs(Signal::TEMPERATURE).at(i);
 
-            if(currentMPoint->isValidFitTChannelID(chID))
+            if(currentMRun->fitHistory()->contains(currentMPointIdx, chID))
             {
                     cbTChannel->addItem(QString::number(chID));
 
@@ -23,6 +23,8 @@ class AToolTemperatureFit : public SignalPlotTool
     private:
         MRun *currentMRun;
         MPoint *currentMPoint;
+        /** @brief index of currentMPoint (fit history, see MRun::fitHistory()) */
+        int currentMPointIdx;
         Material material_spec;
 
         int tempChannelID;
@@ -72,8 +74,10 @@ class AToolTemperatureFit : public SignalPlotTool
         QPointF plot_selection;
         int it_selection;
 
-        // container for current fit results
+        // container for current fit results (stored iterations of selected data point)
         QList<FitIterationResult> fir;
+        // iteration numbers of fir (1, 2, ...)
+        QList<int> firIterations;
 
         QComboBox *comboboxMRun;
 
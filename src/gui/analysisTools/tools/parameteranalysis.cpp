@@ -210,10 +210,11 @@ void ParameterAnalysisUpdater::run()
                 {
                     for(int mpointIndex = 0; mpointIndex < mruns.at(runIndex)->sizeValidMpoints(); mpointIndex++)
                     {
-                        Signal signal = mruns.at(runIndex)->getValidPost(mpointIndex)->getSignal(0, Signal::TEMPERATURE);
+                        int realIdx = mruns.at(runIndex)->getRealIdxFromValidList(mpointIndex);
+                        FitHistoryStore::Trace history = mruns.at(runIndex)->fitHistory()->trace(realIdx, 0);
 
-                        if(!signal.fitData.isEmpty())
-                            xDataTemp.push_back(signal.fitData.last().last().at(4)); // scaling factor: res[4]
+                        if(!history.isEmpty())
+                            xDataTemp.push_back(history.finalValue(history.steps()-1, 4)); // scaling factor: res[4]
                     }
                 }
                 catch(LIISimException e)
@@ -371,19 +372,18 @@ void ParameterAnalysisUpdater::run()
                     {
 
                         // this is only for first t-channel
-                        Signal signal = mruns.at(runIndex)->getValidPost(mpointIndex)->getSignal(1, Signal::TEMPERATURE);
+                        int realIdx = mruns.at(runIndex)->getRealIdxFromValidList(mpointIndex);
+                        FitHistoryStore::Trace history = mruns.at(runIndex)->fitHistory()->trace(realIdx, 1);
 
-                        if(!signal.fitData.isEmpty())
+                        if(!history.isEmpty())
                         {
-                            //yDataTemp.push_back(signal.fitData.last().last().at(1));
-
                             double sum = 0.0;
                             int count = 0;
 
-                            for(int i = signal.indexAt(pa->xStart); i < signal.indexAt(pa->xEnd); i++)
+                            for(int i = history.indexAt(pa->xStart); i < history.indexAt(pa->xEnd); i++)
                             {
                                 // sum up all fit scaling factors in range
-                                sum += signal.fitData.at(i).last().at(4); // scaling factor: res[4]
+                                sum += history.finalValue(i, 4); // scaling factor: res[4]
                                 count++;
                             }
                             yDataTemp.push_back(sum/double(count));
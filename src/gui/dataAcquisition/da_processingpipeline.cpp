@@ -0,0 +1,210 @@
+#include "da_processingpipeline.h"
+
+#include "../../core.h"
+#include "../../signal/processing/processingtask.h"
+#include "../../general/taskscheduler.h"
+#include "../../io/iocsv.h"
+#include "../../io/iomatlab.h"
+#include "../../io/ioxml.h"
+
+
+DA_ProcessingPipeline::DA_ProcessingPipeline(QObject *parent) : QObject(parent)
+{
+    m_capacity = defaultCapacity;
+    m_saving = false;
+}
+
+
+/**
+ * @brief DA_ProcessingPipeline::enqueue starts the processing of an acquired run
+ * @param run acquired run (signal data has to be complete)
+ * @param save save run after processing
+ * @param rq export request (generated by DA_ExportSettingsWidget)
+ */
+void DA_ProcessingPipeline::enqueue(MRun *run, bool save, const SignalIORequest &rq)
+{
+    if(!run)
+        return;
+
+    Entry entry;
+    entry.run = run;
+    entry.save = save;
+    entry.rq = rq;
+    entry.processed = false;
+
+    m_entries.append(entry);
+
+    // check/update run's calculation status
+    run->updateCalculationStatus();
+
+    if(run->isBusy() || run->calculationStatus()->isError())
+    {
+        MSG_WARN(QString("Acquisition: %0 has not been processed").arg(run->getName()));
+        m_entries.last().processed = true;
+        saveNext();
+        return;
+    }
+
+    ProcessingTask* task = new ProcessingTask(run, Signal::RAW);
+    task->setAutoDelete(true);
+
+    connect(task, SIGNAL(finished(MRun*)),
+            this, SLOT(onProcessingFinished(MRun*)),
+            Qt::QueuedConnection);
+
+    connect(task, SIGNAL(signal_msg(QString,LIISimMessageType)),
+            Core::instance()->getSignalManager(), SLOT(onMessageReceive(QString,LIISimMessageType)),
+            Qt::QueuedConnection);
+
+    TaskScheduler::instance()->start(task, TaskScheduler::PROCESSING);
+}
+
+
+/**
+ * @brief DA_ProcessingPipeline::setCapacity sets the max. number of
+ * runs within the pipeline (at least one)
+ * @param capacity
+ */
+void DA_ProcessingPipeline::setCapacity(int capacity)
+{
+    m_capacity = qMax(1, capacity);
+}
+
+
+int DA_ProcessingPipeline::indexOf(MRun *run)
+{
+    for(int i = 0; i < m_entries.size(); i++)
+        if(m_entries.at(i).run == run)
+            return i;
+    return -1;
+}
+
+
+void DA_ProcessingPipeline::onProcessingFinished(MRun *run)
+{
+    int idx = indexOf(run);
+    if(idx < 0)
+        return;
+
+    m_entries[idx].processed = true;
+
+    if(!run->calculationStatus()->isError() && !run->calculationStatus()->isCancelled())
+        run->calculationStatus()->setProcessingFinishedSuccessful();
+
+    emit run->processingFinished();
+
+    reportResult(run);
+    emit runProcessed(run);
+
+    saveNext();
+}
+
+
+/**
+ * @brief DA_ProcessingPipeline::reportResult shows the number of valid
+ * signals and the peak temperature of the run (lab feedback)
+ * @param run
+ */
+void DA_ProcessingPipeline::reportResult(MRun *run)
+{
+    QString msg = QString("Acquisition: %0 processed (%1/%2 valid signals")
+            .arg(run->getName())
+            .arg(run->sizeValidMpoints())
+            .arg(run->sizeAllMpoints());
+
+    QList<int> chIDs = run->channelIDs(Signal::TEMPERATURE);
+    if(!chIDs.isEmpty() && run->sizeAllMpoints() > 0)
+    {
+        Signal tsig = run->getPost(0)->getSignal(chIDs.first(), Signal::TEMPERATURE);
+        if(tsig.size() > 0)
+            msg.append(QString(", peak temperature: %0 K").arg(tsig.getMaxValue(), 0, 'f', 0));
+    }
+    msg.append(")");
+
+    MSG_NORMAL(msg);
+    MSG_STATUS(msg);
+}
+
+
+/**
+ * @brief DA_ProcessingPipeline::saveNext saves the oldest run,
+ * if it has been processed and no other export is running
+ */
+void DA_ProcessingPipeline::saveNext()
+{
+    while(!m_saving && !m_entries.isEmpty() && m_entries.first().processed)
+    {
+        Entry& entry = m_entries.first();
+
+        if(!entry.save || !entry.run)
+        {
+            finishFirst();
+            continue;
+        }
+
+        IOBase* io = 0;
+        if(entry.rq.itype == CSV)
+            io = new IOcsv();
+        else if(entry.rq.itype == MAT)
+            io = new IOmatlab();
+        else if(entry.rq.itype == XML)
+            io = new IOxml();
+
+        if(!io)
+        {
+            MSG_WARN("Acquisition: export type not supported, run has not been saved");
+            finishFirst();
+            continue;
+        }
+
+        m_saving = true;
+
+        // keeps the run from being deleted/processed during export
+        entry.run->setBusy(true);
+
+        io->setAutoDelete(true);
+        connect(io, SIGNAL(exportFinished(double)), SLOT(onExportFinished(double)));
+
+        try
+        {
+            io->exportSignals(entry.rq);
+        }
+        catch(LIISimException e)
+        {
+            MESSAGE(e.what(), e.type());
+            m_saving = false;
+            entry.run->setBusy(false);
+            io->deleteLater();
+            finishFirst();
+        }
+    }
+}
+
+
+void DA_ProcessingPipeline::onExportFinished(double time)
+{
+    if(!m_entries.isEmpty() && m_entries.first().run)
+    {
+        m_entries.first().run->setBusy(false);
+        MSG_STATUS(QString("Acquisition: %0 saved (%1 s)")
+                   .arg(m_entries.first().run->getName()).arg(time));
+    }
+
+    m_saving = false;
+    finishFirst();
+    saveNext();
+}
+
+
+void DA_ProcessingPipeline::finishFirst()
+{
+    if(m_entries.isEmpty())
+        return;
+
+    Entry entry = m_entries.takeFirst();
+
+    if(entry.run)
+        emit runFinished(entry.run);
+
+    emit slotAvailable();
+}
@@ -0,0 +1,76 @@
+#ifndef DA_PROCESSINGPIPELINE_H
+#define DA_PROCESSINGPIPELINE_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+
+#include "../../signal/mrun.h"
+#include "../../io/signaliorequest.h"
+
+
+/**
+ * @brief The DA_ProcessingPipeline class processes and saves acquired
+ * runs in background, while the next block is captured.
+ * @details Each run passes two stages:
+ *  1) signal processing of all chains (ProcessingTask, TaskScheduler::PROCESSING lane),
+ *     runs are processed concurrently
+ *  2) saving (if requested), one export at a time in order of acquisition
+ * The number of runs within the pipeline is limited by capacity(). The
+ * DataAcquisitionWindow does not start the next capture while the pipeline
+ * is full (backpressure), slotAvailable() is emitted if a run has left the pipeline.
+ */
+class DA_ProcessingPipeline : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DA_ProcessingPipeline(QObject *parent = 0);
+
+    /** @brief default number of runs within the pipeline */
+    static const int defaultCapacity = 2;
+
+    void enqueue(MRun* run, bool save, const SignalIORequest &rq = SignalIORequest());
+
+    inline int capacity(){return m_capacity;}
+    void setCapacity(int capacity);
+
+    inline int pendingRuns(){return m_entries.size();}
+    inline bool isFull(){return m_entries.size() >= m_capacity;}
+    inline bool isIdle(){return m_entries.isEmpty();}
+
+private:
+
+    struct Entry
+    {
+        QPointer<MRun> run;
+        bool save;
+        SignalIORequest rq;
+        bool processed;
+    };
+
+    /** @brief runs in order of acquisition */
+    QList<Entry> m_entries;
+    int m_capacity;
+
+    /** @brief an export of the first entry is running */
+    bool m_saving;
+
+    int indexOf(MRun* run);
+    void finishFirst();
+    void reportResult(MRun* run);
+
+signals:
+    /** @brief runProcessed emitted if all processing chains of the run have been calculated */
+    void runProcessed(MRun* run);
+    /** @brief runFinished emitted if the run has been processed and saved */
+    void runFinished(MRun* run);
+    /** @brief slotAvailable emitted if a run has left the pipeline */
+    void slotAvailable();
+
+private slots:
+    void onProcessingFinished(MRun* run);
+    void onExportFinished(double time);
+    void saveNext();
+};
+
+#endif // DA_PROCESSINGPIPELINE_H
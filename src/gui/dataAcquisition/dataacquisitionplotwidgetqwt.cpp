@@ -23,6 +23,7 @@
 
 // custom for this class
 #include "../utils/customQwtPlot/signalplotcurve.h"
+#include "../utils/customQwtPlot/signalseriesdata.h"
 
 #include "signal/streampoint.h"
 #include "da_referencewidget.h"
@@ -191,13 +192,8 @@ void DataAcquisitionPlotWidget::addSignal(const Signal &signal,const QString & c
     if(curveRenderAntialiased)
         curve->setRenderHint(QwtPlotItem::RenderAntialiased);
 
-    // generate time axis!
-    QVector<double> xData;
-    for(int i=0;i<signal.data.size(); i++)
-    {
-        xData.push_back((signal.start_time+i*signal.dt)*1e9);
-    }
-    curve->setSamples(xData,signal.data);
+    // attach data (time axis is generated on demand, see SignalSeriesData)
+    curve->setData(new SignalSeriesData(signal));
 
     // set visibility state of channel based on channel checkbox selection
     for(int i = 0; i < channelCBs.size(); i++)
@@ -404,13 +400,8 @@ void DataAcquisitionPlotWidget::addStreamSignal(const Signal &signal, const QStr
     if(curveRenderAntialiased)
         curve->setRenderHint(QwtPlotItem::RenderAntialiased);
 
-    //generate time axis!
-    QVector<double> xData;
-    for(int i=0;i<signal.data.size(); i++)
-    {
-        xData.push_back((signal.start_time+i*signal.dt)*1e9);
-    }
-    curve->setSamples(xData,signal.data);
+    // attach data (time axis is generated on demand, see SignalSeriesData)
+    curve->setData(new SignalSeriesData(signal));
     curve->setPaintAttribute(QwtPlotCurve::FilterPoints);
 }
 
@@ -622,13 +613,8 @@ void DataAcquisitionPlotWidget::addReferenceSignal(const Signal &signal, const Q
     if(curveRenderAntialiased)
         curve->setRenderHint(QwtPlotItem::RenderAntialiased);
 
-    //generate time axis!
-    QVector<double> xData;
-    for(int i=0;i<signal.data.size(); i++)
-    {
-        xData.push_back((signal.start_time+i*signal.dt)*1e9);
-    }
-    curve->setSamples(xData,signal.data);
+    // attach data (time axis is generated on demand, see SignalSeriesData)
+    curve->setData(new SignalSeriesData(signal));
     curve->setPaintAttribute(QwtPlotCurve::FilterPoints);
 }
 
@@ -746,13 +732,8 @@ void DataAcquisitionPlotWidget::addStaticSignal(const Signal &signal, const QStr
     if(curveRenderAntialiased)
         curve->setRenderHint(QwtPlotItem::RenderAntialiased);
 
-    //generate time axis!
-    QVector<double> xData;
-    for(int i=0;i<signal.data.size(); i++)
-    {
-        xData.push_back((signal.start_time+i*signal.dt)*1e9);
-    }
-    curve->setSamples(xData,signal.data);
+    // attach data (time axis is generated on demand, see SignalSeriesData)
+    curve->setData(new SignalSeriesData(signal));
     curve->setPaintAttribute(QwtPlotCurve::FilterPoints);
     curve->setZ(-5.0);
 
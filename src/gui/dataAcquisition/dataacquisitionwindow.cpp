@@ -7,15 +7,19 @@
 #include <QFileDialog>
 #include <QSpacerItem>
 #include <QMessageBox>
+#include <QDir>
+#include <QDateTime>
+#include <QFileInfo>
 
 #include "./core.h"
 #include "./logging/statusmessagewidget.h"
 #include "da_triggerdialog.h"
 #include "../deviceManager/devicemanagerwidget.h"
 #include "../signalEditor/memusagewidget.h"
+#include "../../general/taskscheduler.h"
 
 
-DataAcquisitionWindow::DataAcquisitionWindow(QWidget *parent) : QWidget(parent), blockSequenceWorker(this)
+DataAcquisitionWindow::DataAcquisitionWindow(QWidget *parent) : QWidget(parent), blockSequenceWorker(this), processingPipeline(this)
 {
     MSG_DETAIL_1("init DataAcquisitionWindow");
 
@@ -43,6 +47,16 @@ DataAcquisitionWindow::DataAcquisitionWindow(QWidget *parent) : QWidget(parent),
     rbtStreamingMode->addAction(actionStopStreaming, 1, 0);
     rbtStreamingMode->addAction(actionClearStreamingAvg, 2, 0);
 
+    actionRecordStreaming = new QAction("Record to Disk", this);
+    actionRecordStreaming->setCheckable(true);
+    actionRecordStreaming->setToolTip("Writes all streaming frames (raw ADC counts) to the export directory");
+    actionImportRecording = new QAction("Import Recording", this);
+    actionImportRecording->setToolTip("Imports a stream recording as run");
+    labelRecording = new QLabel("", this);
+    rbtStreamingMode->addAction(actionRecordStreaming, 0, 4);
+    rbtStreamingMode->addAction(actionImportRecording, 1, 4);
+    rbtStreamingMode->addWidget(labelRecording, 2, 4);
+
     //groupStreamingMode = new QGroupBox(this);
     buttongroupStreamingMode = new QButtonGroup(this);
     rbStreamingSingleMeasurement = new QRadioButton("Show Single", this);
@@ -384,6 +398,9 @@ DataAcquisitionWindow::DataAcquisitionWindow(QWidget *parent) : QWidget(parent),
 
     // do everything that needed the PicoScope instance
     connect(actionClearStreamingAvg, SIGNAL(triggered(bool)), picoscope, SLOT(clearStreamingAvg()));
+    connect(actionRecordStreaming, SIGNAL(toggled(bool)), SLOT(onRecordStreamingToggled(bool)));
+    connect(actionImportRecording, SIGNAL(triggered(bool)), SLOT(onImportRecording()));
+    connect(picoscope->streamRecorder(), SIGNAL(error(QString)), SLOT(onStreamRecorderError(QString)), Qt::QueuedConnection);
 
 
     QSplitter* tableSplitter = new QSplitter(Qt::Vertical);
@@ -436,6 +453,9 @@ DataAcquisitionWindow::DataAcquisitionWindow(QWidget *parent) : QWidget(parent),
     connect(&blockSequenceWorker, SIGNAL(workerStopped()), SLOT(onBlockSequenceWorkerStopped()));
     connect(&blockSequenceWorker, SIGNAL(status(QString)), SLOT(onBlockSequenceWorkerStatusChanged(QString)));
 
+    connect(&processingPipeline, SIGNAL(runProcessed(MRun*)), SLOT(onPipelineRunProcessed(MRun*)));
+    connect(&processingPipeline, SIGNAL(slotAvailable()), SLOT(onPipelineSlotAvailable()));
+
     connect(dataTreeView, SIGNAL(visualEnabledItemsChanged(QList<QTreeWidgetItem*>)), SLOT(onTreeViewVisualEnabledItemsChanged(QList<QTreeWidgetItem*>)));
 
     connect(psSettingsWidget, SIGNAL(switchStreamSignalLayer(uint,bool)), signalPlot, SLOT(switchStreamSignalLayer(uint,bool)));
@@ -529,6 +549,171 @@ void DataAcquisitionWindow::onAveragingBufferSizeChanged(int value)
 }
 
 
+/**
+ * @brief DataAcquisitionWindow::onRecordStreamingToggled starts/stops the recording
+ * of all streaming frames. Recordings are written to the export directory,
+ * named by run name and start time.
+ * @param checked
+ */
+void DataAcquisitionWindow::onRecordStreamingToggled(bool checked)
+{
+    StreamRecorder *recorder = picoscope->streamRecorder();
+
+    if(!checked)
+    {
+        recorder->close();
+        labelRecording->setStyleSheet("QLabel { color : black }");
+        return;
+    }
+
+    QDir dir(exportSettingsWidget->exportDirectory());
+    if(!dir.exists() && !dir.mkpath("."))
+    {
+        MSG_ERR(QString("Record to disk: cannot create directory %0").arg(dir.absolutePath()));
+        actionRecordStreaming->setChecked(false);
+        return;
+    }
+
+    QString fileName = dir.absoluteFilePath(QString("%0_%1.%2")
+                                            .arg(exportSettingsWidget->getRunname())
+                                            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"))
+                                            .arg(StreamRecorder::fileSuffix()));
+
+    if(!recorder->open(fileName))
+    {
+        actionRecordStreaming->setChecked(false);
+        return;
+    }
+
+    labelRecording->setText("0 frames");
+    labelRecording->setStyleSheet("QLabel { color : red }");
+    MSG_STATUS(QString("Recording streaming frames to %0").arg(fileName));
+}
+
+
+void DataAcquisitionWindow::onStreamRecorderError(QString message)
+{
+    MSG_ERR(message);
+    actionRecordStreaming->setChecked(false);
+}
+
+
+/**
+ * @brief DataAcquisitionWindow::onImportRecording imports a stream recording
+ * as new run (group, LII-settings and run details of next run are used).
+ * Frames are read in background, see onRecordingImported().
+ */
+void DataAcquisitionWindow::onImportRecording()
+{
+    if(importingRun)
+        return;
+
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Import Stream Recording"),
+                                                    exportSettingsWidget->exportDirectory(),
+                                                    QString("Stream recordings (*.%0)").arg(StreamRecorder::fileSuffix()));
+    if(fileName.isEmpty())
+        return;
+
+    if(fileName == picoscope->streamRecorder()->fileName() && picoscope->streamRecorder()->isRecording())
+    {
+        MSG_WARN("Import recording: recording is still in progress");
+        return;
+    }
+
+    // all frames are kept as ADC counts within the run (approx. the size of the recording)
+    MemUsageMonitor *memMonitor = Core::instance()->getSignalManager()->memUsageMonitor();
+    memMonitor->updateMemInfo();
+    quint64 recordingSize = quint64(QFileInfo(fileName).size());
+    if(memMonitor->physicalMemoryUsed() + recordingSize > memMonitor->physicalMemory())
+    {
+        QString msg = QString("Import recording: not enough memory available (recording: %0 MB)")
+                .arg(MemUsageMonitor::toMB(recordingSize), 0, 'f', 0);
+        MSG_ERR(msg);
+        MSG_STATUS(msg);
+        return;
+    }
+
+    LIISettings liiSettings = cbliisettings->currentLIISettings();
+
+    MRunGroup *group = 0;
+    importingRunNewGroup = false;
+
+    if(runSettingsWidget->cbMRunGroup->currentData().toInt() == -1)
+    {
+        group = new MRunGroup("New Group");
+        Core::instance()->dataModel()->registerGroup(group);
+        importingRunNewGroup = true;
+    }
+    else
+        group = Core::instance()->dataModel()->group(runSettingsWidget->cbMRunGroup->currentData().toInt());
+
+    MRun *run = new MRun(QFileInfo(fileName).completeBaseName(), liiSettings.channels.size(), group);
+
+    run->setLiiSettings(liiSettings, true);
+    run->setDescription(runSettingsWidget->leDescription->toPlainText(), true);
+    run->setFilter(runSettingsWidget->cbFilter->currentText(), true);
+    run->setLaserFluence(runSettingsWidget->getLaserFluence(), true);
+    run->userDefinedParameters = runSettingsWidget->getParameterList();
+    run->setAcquisitionMode("Streaming Recording");
+
+    importingRun = run;
+    importedFrames = 0;
+    importError.clear();
+    actionImportRecording->setEnabled(false);
+
+    MSG_STATUS_CONST(QString("Importing recording %0...").arg(fileName));
+
+    TaskScheduler::instance()->run(TaskScheduler::IO, [this, run, fileName]()
+    {
+        try
+        {
+            importedFrames = StreamRecorder::readRecording(fileName, run);
+        }
+        catch(LIISimException e)
+        {
+            importError = e.what();
+        }
+        QMetaObject::invokeMethod(this, "onRecordingImported", Qt::QueuedConnection);
+    });
+}
+
+
+void DataAcquisitionWindow::onRecordingImported()
+{
+    MRun *run = importingRun;
+    importingRun = 0;
+    actionImportRecording->setEnabled(true);
+
+    if(!run)
+        return;
+
+    if(!importError.isEmpty() || importedFrames == 0)
+    {
+        QString msg = importError.isEmpty() ? QString("Import recording: no frames found") : importError;
+        MSG_ERR(msg);
+        MSG_STATUS(msg);
+
+        MRunGroup *group = dynamic_cast<MRunGroup*>(run->parentItem());
+        delete run;
+        if(importingRunNewGroup && group)
+            group->deleteLater();
+        return;
+    }
+
+    if(run->parentItem())
+        run->parentItem()->insertChild(run);
+
+    dataModel->registerMRun(run);
+
+    QString msg = QString("Import recording: %0 frames imported to run %1").arg(importedFrames).arg(run->getName());
+    MSG_NORMAL(msg);
+    MSG_STATUS(msg);
+
+    selectedRun = run;
+    updateToSelectedRun();
+}
+
+
 /**
  * @brief DataAcquisitionWindow::liisettingschanged This slot is execueted when
  * the selection of the current liisettings has changed
@@ -961,6 +1146,12 @@ void DataAcquisitionWindow::saveCircularBuffer()
 
 void DataAcquisitionWindow::runBlock()
 {
+    if(processingPipeline.isFull())
+    {
+        MSG_STATUS("Cannot capture block (processing of previous blocks pending)");
+        return;
+    }
+
     isBusy = true;
 
     unsigned int channelCount = 0;
@@ -1294,7 +1485,8 @@ void DataAcquisitionWindow::processBlockReady()
     run->setPSSampleInterval(picoscopeSettings->sampleInterval());
     run->setPSPresample(picoscopeSettings->presamplePercentage());
 
-    picoscope->getRun(run, psSettingsWidget->averageCaptures(), exportSettingsWidget->saveStdev());
+    picoscope->getRun(run, psSettingsWidget->averageCaptures(), exportSettingsWidget->saveStdev(),
+                      psSettingsWidget->compactRawSignals());
 
     /*float gainA = psSettingsWidget->gainA();
     float gainB = psSettingsWidget->gainB();
@@ -1389,6 +1581,29 @@ void DataAcquisitionWindow::processBlockProcessingFinished(MRun *run)
     selectedRun = run;
     updateToSelectedRun();
 
+    // pipelined mode (block sequences only): process/save in background and capture next block
+    if(blockSequenceWorker.isRunning() && psSettingsWidget->getBlockSequencePipelined())
+    {
+        SignalIORequest rq;
+        if(exportSettingsWidget->autoSave())
+            rq = exportSettingsWidget->generateExportRequest(run, exportSettingsWidget->saveStdev());
+
+        processingPipeline.enqueue(run, exportSettingsWidget->autoSave(), rq);
+
+        isBusy = false;
+
+        if(autoStartStreaming)
+            picoscope->startStreaming();
+
+        // backpressure: wait until processing has caught up
+        if(processingPipeline.isFull())
+            blockReleasePending = true;
+        else
+            emit blockAcquisitionFinished();
+
+        return;
+    }
+
     // process single signal
     SignalManager * sigManager = Core::instance()->getSignalManager();
     QList<MRun*> runs;
@@ -1419,6 +1634,32 @@ void DataAcquisitionWindow::processBlockProcessingFinished(MRun *run)
 }
 
 
+/**
+ * @brief DataAcquisitionWindow::onPipelineRunProcessed shows
+ * the processed run, if it is still selected
+ * @param run
+ */
+void DataAcquisitionWindow::onPipelineRunProcessed(MRun *run)
+{
+    if(run == selectedRun)
+        updateToSelectedRun();
+}
+
+
+/**
+ * @brief DataAcquisitionWindow::onPipelineSlotAvailable starts
+ * the next block, if it has been held back by a full pipeline
+ */
+void DataAcquisitionWindow::onPipelineSlotAvailable()
+{
+    if(blockReleasePending && !processingPipeline.isFull())
+    {
+        blockReleasePending = false;
+        emit blockAcquisitionFinished();
+    }
+}
+
+
 /**
  * @brief DataAcquisitionWindow::onPsSettingsObjChanged Called when any settings have changed so the ui
  * shows these (-> loading settings)
@@ -1719,6 +1960,12 @@ void DataAcquisitionWindow::onStreamingData(StreamPoint point)
 
     avgCounterLabel->setText(QString("Cache %0 / ").arg(point.averageBufferFilling));
 
+    StreamRecorder *recorder = picoscope->streamRecorder();
+    if(recorder->isRecording())
+        labelRecording->setText(QString("%0 frames, %1 MB")
+                                .arg(recorder->framesRecorded())
+                                .arg(double(recorder->bytesWritten()) / (1024.0 * 1024.0), 0, 'f', 0));
+
     QString ofText("Overflow:");
     bool ofEnable = false;
     if(point.overflowA)
@@ -1758,6 +2005,9 @@ void DataAcquisitionWindow::onBlockSequenceWorkerStopped()
     pbRunBlockSequence->setText("Run Block Sequence");
     pbRunBlockSequence->setStyleSheet("QPushButton { color: black }");
 
+    // the sequence does not wait for the pipeline anymore
+    blockReleasePending = false;
+
     runSettingsWidget->setEnabled(true);
     exportSettingsWidget->setEnabled(true);
     psSettingsWidget->setEnabled(true);
@@ -36,6 +36,7 @@
 #include "signal/streampoint.h"
 #include "da_referencewidget.h"
 #include "da_blocksequence.h"
+#include "da_processingpipeline.h"
 #include "dataacquisitionplotwidgetqwt.h"
 
 #define TEST_2
@@ -73,7 +74,10 @@ private:
     QAction *actionStartStreaming;
     QAction *actionStopStreaming;
     QAction *actionClearStreamingAvg;
+    QAction *actionRecordStreaming;
+    QAction *actionImportRecording;
     QLabel *avgCounterLabel;
+    QLabel *labelRecording;
 
     QGroupBox *groupStreamingMode;
     QButtonGroup *buttongroupStreamingMode;
@@ -161,6 +165,17 @@ private:
 
     DA_BlockSequenceWorker blockSequenceWorker;
 
+    /** @brief processes/saves acquired blocks in background (block sequence option) */
+    DA_ProcessingPipeline processingPipeline;
+    /** @brief next block is started when the pipeline has a free slot */
+    bool blockReleasePending = false;
+
+    /** @brief run which is filled from a stream recording (background) */
+    MRun *importingRun = 0;
+    bool importingRunNewGroup = false;
+    int importedFrames = 0;
+    QString importError;
+
     QList<int> runIdsToPlotWhileStreaming;
     bool runIdsToPlotWhileStreamingChanged;
 
@@ -177,6 +192,10 @@ private slots:
     void startStreaming(bool checked);
     void stopStreaming(bool checked);
     void onAveragingBufferSizeChanged(int value);
+    void onRecordStreamingToggled(bool checked);
+    void onImportRecording();
+    void onRecordingImported();
+    void onStreamRecorderError(QString message);
 
     void plotZoomSelection();
     void errorClicked(bool clicked);
@@ -199,6 +218,8 @@ private slots:
     void saveCircularBuffer();
     void processBlockReady();
     void processBlockProcessingFinished(MRun *run);
+    void onPipelineRunProcessed(MRun *run);
+    void onPipelineSlotAvailable();
 
     void onPsSettingsObjChanged();
 
@@ -228,6 +228,13 @@ PicoScopeSettingsWidget::PicoScopeSettingsWidget(PicoScopeSettings *psSettings,P
     labelBlockSequenceSamplesLeft = new QLabel("-", this);
     setCellWidget(13, 6, labelBlockSequenceSamplesLeft);
 
+    setItem(14,5,new QTableWidgetItem("Background processing"));
+    item(14,5)->setFlags(Qt::ItemIsEnabled);
+
+    checkboxBlockSequencePipelined = new QCheckBox(this);
+    checkboxBlockSequencePipelined->setToolTip("Process and save acquired blocks in background while the next block is captured");
+    setCellWidget(14, 6, checkboxBlockSequencePipelined);
+
     labelGainINChannelA = new QLabel("-", this);
     labelGainINChannelB = new QLabel("-", this);
     labelGainINChannelC = new QLabel("-", this);
@@ -360,6 +367,14 @@ PicoScopeSettingsWidget::PicoScopeSettingsWidget(PicoScopeSettings *psSettings,P
     setCellWidget(11, 2, sbpresample);
     setSpan(11, 2, 1, 2);
 
+    setItem(12, 0, new QTableWidgetItem("Raw storage"));
+    item(12, 0)->setFlags(Qt::ItemIsEnabled);
+    setSpan(12, 0, 1, 2);
+    checkboxCompactRaw = new QCheckBox("ADC counts", this);
+    checkboxCompactRaw->setToolTip("Keeps single captures as 16 bit ADC counts (4x less memory), signals are converted on access");
+    setCellWidget(12, 2, checkboxCompactRaw);
+    setSpan(12, 2, 1, 2);
+
 
 
     // CONNECTIONS
@@ -421,10 +436,12 @@ PicoScopeSettingsWidget::PicoScopeSettingsWidget(PicoScopeSettings *psSettings,P
 
     connect(linkChannelSettings, SIGNAL(stateChanged(int)), SLOT(onLinkSettingsStateChanged(int)));
     connect(checkboxAverageCaptures, SIGNAL(stateChanged(int)), SLOT(onAverageCapturesStateChanged()));
+    connect(checkboxCompactRaw, SIGNAL(stateChanged(int)), SLOT(onCompactRawStateChanged()));
 
     connect(comboboxBlockSequenceBlockNumber, SIGNAL(currentIndexChanged(int)), SLOT(onBlockSequenceBlockNumber(int)));
     connect(spinboxBlockSequenceDecrement, SIGNAL(valueChanged(double)), SLOT(onBlockSequenceDecrementChanged(double)));
     connect(spinboxBlockSequenceDelay, SIGNAL(valueChanged(double)), SLOT(onBlockSequenceDelayChanged(double)));
+    connect(checkboxBlockSequencePipelined, SIGNAL(toggled(bool)), SLOT(onBlockSequencePipelinedChanged(bool)));
 
     connect(psSettings, SIGNAL(rangeChanged(PSChannel)), SLOT(onSettingsRangeChanged(PSChannel)));
     connect(Core::instance()->ioSettings, SIGNAL(settingsChanged()), SLOT(onIOSettingsChanged()));
@@ -538,6 +555,16 @@ float PicoScopeSettingsWidget::getBlockSequenceDelaySec()
 }
 
 
+/**
+ * @brief PicoScopeSettingsWidget::getBlockSequencePipelined
+ * @return true if acquired blocks should be processed and saved in background (see DA_ProcessingPipeline)
+ */
+bool PicoScopeSettingsWidget::getBlockSequencePipelined()
+{
+    return checkboxBlockSequencePipelined->isChecked();
+}
+
+
 // ---------------------------------------------
 // SLOTS TO UPDATE SETTINGS BASED ON GUI CHANGES
 // ---------------------------------------------
@@ -1346,6 +1373,12 @@ void PicoScopeSettingsWidget::onBlockSequenceDelayChanged(double value)
 }
 
 
+void PicoScopeSettingsWidget::onBlockSequencePipelinedChanged(bool state)
+{
+    Core::instance()->ioSettings->setValue("blockSequence", "pipelined", state);
+}
+
+
 void PicoScopeSettingsWidget::onIOSettingsChanged()
 {
     if(Core::instance()->ioSettings->hasEntry("deviceManager", "StepSizeAnalogOut"))
@@ -1379,6 +1412,9 @@ void PicoScopeSettingsWidget::onIOSettingsChanged()
 
     if(Core::instance()->ioSettings->hasEntry("blockSequence", "delay"))
         spinboxBlockSequenceDelay->setValue(Core::instance()->ioSettings->value("blockSequence", "delay").toDouble());
+
+    if(Core::instance()->ioSettings->hasEntry("blockSequence", "pipelined"))
+        checkboxBlockSequencePipelined->setChecked(Core::instance()->ioSettings->value("blockSequence", "pipelined").toBool());
 }
 
 
@@ -1563,6 +1599,9 @@ void PicoScopeSettingsWidget::onGUISettingsChanged()
 
     if(Core::instance()->guiSettings->hasEntry("picoscopewidget", "averagecaptures"))
         checkboxAverageCaptures->setChecked(Core::instance()->guiSettings->value("picoscopewidget", "averagecaptures").toBool());
+
+    if(Core::instance()->guiSettings->hasEntry("picoscopewidget", "compactraw"))
+        checkboxCompactRaw->setChecked(Core::instance()->guiSettings->value("picoscopewidget", "compactraw").toBool());
 }
 
 
@@ -1578,6 +1617,22 @@ void PicoScopeSettingsWidget::onAverageCapturesStateChanged()
 }
 
 
+/**
+ * @brief PicoScopeSettingsWidget::compactRawSignals
+ * @return true if single captures should be stored as ADC counts (see CompactSignal)
+ */
+bool PicoScopeSettingsWidget::compactRawSignals()
+{
+    return checkboxCompactRaw->isChecked();
+}
+
+
+void PicoScopeSettingsWidget::onCompactRawStateChanged()
+{
+    Core::instance()->guiSettings->setValue("picoscopewidget", "compactraw", checkboxCompactRaw->isChecked());
+}
+
+
 int PicoScopeSettingsWidget::getNoCaptures()
 {
     return sbcaptures->value();
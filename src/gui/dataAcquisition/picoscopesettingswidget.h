@@ -44,10 +44,12 @@ public:
     int getBlockSequenceBlockNumber();
     float getBlockSequenceVoltageDecrement();
     float getBlockSequenceDelaySec();
+    bool getBlockSequencePipelined();
 
     bool focusNextPrevChild(bool next);
 
     bool averageCaptures();
+    bool compactRawSignals();
 
     int getNoCaptures();
 
@@ -105,10 +107,12 @@ private:
     QSpinBox  *sbpresample;
 
     QCheckBox *checkboxAverageCaptures;
+    QCheckBox *checkboxCompactRaw;
 
     QComboBox *comboboxBlockSequenceBlockNumber;
     QDoubleSpinBox *spinboxBlockSequenceDecrement;
     QDoubleSpinBox *spinboxBlockSequenceDelay;
+    QCheckBox *checkboxBlockSequencePipelined;
 
     bool offsetBoundsInitialUpdated;
 
@@ -169,10 +173,12 @@ private slots:
 
     void onSettingsRangeChanged(PSChannel channel);
     void onAverageCapturesStateChanged();
+    void onCompactRawStateChanged();
 
     void onBlockSequenceBlockNumber(int idx);
     void onBlockSequenceDecrementChanged(double value);
     void onBlockSequenceDelayChanged(double value);
+    void onBlockSequencePipelinedChanged(bool state);
 
     void onIOSettingsChanged();
     void onGUISettingsChanged();
@@ -780,6 +780,14 @@ void DataItemTreeView::onContextMenuRequested(const QPoint &point)
 
                 connect(liiSettingsMenu,SIGNAL(triggered(QAction*)), SLOT(onContextMenuSetLIISettings(QAction*)));
 
+                // single precision processing (raw/absolute signals)
+                QAction* acSinglePrecision = menu.addAction("Single precision processing");
+                acSinglePrecision->setCheckable(true);
+                acSinglePrecision->setToolTip("Store raw/absolute signals and intermediate processing steps as float (half the memory)");
+                MRun* clickedRun = Core::instance()->dataModel()->mrun(id);
+                acSinglePrecision->setChecked(clickedRun && clickedRun->singlePrecision());
+                connect(acSinglePrecision, SIGNAL(toggled(bool)), SLOT(onContextMenuSetSinglePrecision(bool)));
+
                 menu.addSeparator();
                 menu.addAction(acDelete);
             }
@@ -1187,6 +1195,27 @@ void DataItemTreeView::onContextMenuSetLIISettings(QAction *action)
 }
 
 
+/**
+ * @brief DataItemTreeView::onContextMenuSetSinglePrecision This slot is executed
+ * when the user toggled the single precision processing of one or multiple runs
+ * via the context menu (see MRun::setSinglePrecision())
+ * @param state
+ */
+void DataItemTreeView::onContextMenuSetSinglePrecision(bool state)
+{
+    QList<QTreeWidgetItem*> selection = m_treeWidget->selectedItems();
+    for(int i = 0; i < selection.size(); i++)
+    {
+        int runId = selection[i]->data(0,Qt::UserRole+1).toInt();
+
+        MRun* mrun = Core::instance()->dataModel()->mrun(runId);
+        if(!mrun)
+            continue;
+        mrun->setSinglePrecision(state);
+    }
+}
+
+
 void DataItemTreeView::onContextMenuDependantSelectorLIISettings(QAction* action)
 {
     QTreeWidgetItem* item = m_treeWidget->itemAt(selectionPoint);
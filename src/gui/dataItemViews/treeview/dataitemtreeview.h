@@ -169,6 +169,7 @@ private slots:
     void onActionDelete();
     void onAcAdd();
     void onContextMenuSetLIISettings(QAction* action);
+    void onContextMenuSetSinglePrecision(bool state);
 
     void onContextMenuDependantSelectorLIISettings(QAction* action);
     void onContextMenuDependantSelectorFilter(QAction *action);
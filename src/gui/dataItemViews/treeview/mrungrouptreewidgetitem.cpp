@@ -153,6 +153,18 @@ void MRunGroupTWI::deleteData()
         return;
     }
 
+    QList<MRun*> runs = static_cast<MRunGroup*>(DataItemObserverObject::data)->mruns();
+    for(int i = 0; i < runs.size(); i++)
+    {
+        if(runs.at(i)->isBusy())
+        {
+            QString msg = "cannot delete group (active backgroud tasks!)";
+            MSG_NORMAL(msg);
+            MSG_STATUS(msg);
+            return;
+        }
+    }
+
     if(DataItemObserverObject::data->childCount() > 0)
     {
         QMessageBox msgBox;
@@ -330,7 +330,8 @@ void MRunTreeWidgetItem::handleTreeItemModified(int col)
 void MRunTreeWidgetItem::deleteData()
 {
     // check if deletion is allowed
-    if(Core::instance()->getSignalManager()->isBusy())
+    // runs of the acquisition pipeline are processed/saved without the SignalManager
+    if(Core::instance()->getSignalManager()->isBusy() || (m_mrun && m_mrun->isBusy()))
     {
         QString msg = "cannot delete measurement run (active backgroud tasks!)";
         MSG_NORMAL(msg);
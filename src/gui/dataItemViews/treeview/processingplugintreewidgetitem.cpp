@@ -546,7 +546,7 @@ void PPTreeWidgetItem::updateLinkStateLabel()
 
 void PPTreeWidgetItem::deleteData()
 {
-    if(Core::instance()->getSignalManager()->isBusy())
+    if(Core::instance()->getSignalManager()->isBusy() || m_plugin->processingChain()->mrun()->isBusy())
     {
         QString msg = "Cannot remove processing step (active background tasks!)";
         MSG_NORMAL(msg);
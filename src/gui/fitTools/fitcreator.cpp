@@ -512,12 +512,16 @@ void FitCreator::onFitButtonReleased()
     numSettings->setOdeSolverStepSizeFactor(numparamTable->ODE_stepSizeFactor());
     //numSettings->setStepSize(); // not used by fitting, is defined by experimental data
 
+    if(numparamTable->batchMode())
+        numSettings->setStagnationIterations(numparamTable->stagnationIterations());
+
     FitRun* fitrun = new FitRun(FitRun::PSIZE);
     fitrun->blockSignals(true);
 
     fitrun->setFitData(data);
     fitrun->setFitSettings(fitSettings);
     fitrun->setNumericSettings(numSettings);
+    fitrun->setBatchMode(numparamTable->batchMode());
 
     if(runPlot->rangeValid())
         fitrun->setSection(runPlot->getRangeStart(), runPlot->getRangeEnd());
@@ -580,7 +584,9 @@ void FitCreator::onSimButtonReleased()
  */
 void FitCreator::onCancelButtonReleased()
 {
-    Numeric::canceled = true;
+    // cancel fit runs only (spectral temperature fits of signal processing are not affected)
+    for(FitRun* fitrun : Core::instance()->dataModel()->fitRuns())
+        fitrun->cancel();
 }
 
 
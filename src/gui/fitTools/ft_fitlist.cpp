@@ -232,6 +232,11 @@ void FT_FitList::onTreeWidgetItemClicked(QTreeWidgetItem *item, int column)
     else if(item->type() == QTreeWidgetItem::UserType+10)
     {
         FT_FitRunTreeItem *fitRunItem = dynamic_cast<FT_FitRunTreeItem*>(item);
+
+        // FitRun loaded from session: results are loaded when opened
+        if(fitRunItem->childCount() == 0 && !fitRunItem->mFitRun->resultsLoaded())
+            fitRunItem->createChildItems();
+
         dataVisualization->clearDataTable();
         dataVisualization->update(fitRunItem->mFitRun);
     }
@@ -67,13 +67,25 @@ void FT_FitRunTreeItem::cleanup()
 
 void FT_FitRunTreeItem::onFitFinished()
 {
+    createChildItems();
+    emit treeWidget()->itemClicked(this, 0);
+}
+
+
+/**
+ * @brief FT_FitRunTreeItem::createChildItems creates an item for each FitData,
+ * results of FitRuns loaded from session are read from the sidecar file first
+ */
+void FT_FitRunTreeItem::createChildItems()
+{
+    mFitRun->loadResults();
+
     for(int i = 0; i < mFitRun->count(); i++)
     {
         FT_RunListFitDataItem *item = new FT_RunListFitDataItem(mVisualizationWidget, mFitRun->at(i), this);
         connect(item, SIGNAL(stateChanged()), SLOT(onChildStateChanged()));
         item->setChecked(true);
     }
-    emit treeWidget()->itemClicked(this, 0);
 }
 
 
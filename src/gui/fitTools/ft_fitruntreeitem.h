@@ -18,6 +18,7 @@ public:
 
 private:
     void cleanup();
+    void createChildItems();
 
     FitRun *mFitRun;
     FT_ResultVisualization *mVisualizationWidget;
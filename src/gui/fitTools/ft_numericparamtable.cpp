@@ -18,6 +18,8 @@ FT_NumericParamTable::FT_NumericParamTable(QWidget *parent) : QWidget(parent)
     gsk_it     = "iter";
     gsk_ode    = "ODE";
     gsk_ode_stepSizeFactor = "ODE_step";
+    gsk_batchMode = "batch";
+    gsk_stagnation = "stagnation";
 
     // init max iterations row
     QLabel *labelIterations = new QLabel("Max iterations", this);
@@ -75,6 +77,35 @@ FT_NumericParamTable::FT_NumericParamTable(QWidget *parent) : QWidget(parent)
         cbODE_stepSizeFactor->addItem(QString("%0 times more accurate").arg(acc));
     }
 
+    // batch mode (warm start)
+    checkBatchMode = new QCheckBox("Batch mode (warm start)", this);
+    checkBatchMode->setToolTip(QString("Fitting of many single-shot signals:\n"
+                                       " - shots of each run are fitted in chunks of %0 by a limited number of workers\n"
+                                       " - each fit is started from the result of the previous shot of its chunk\n"
+                                       " - fits are stopped if the residual does not improve anymore")
+                               .arg(FitRun::batchChunkSize));
+    mainLayout->addWidget(checkBatchMode, 2, 0, 1, 2);
+
+    // stagnation criterion of batch mode
+    QLabel *labelStagnation = new QLabel("Stagnation iterations", this);
+    mainLayout->addWidget(labelStagnation, 2, 2);
+
+    le_stagnation = new NumberLineEdit(NumberLineEdit::INTEGER);
+    le_stagnation->setMinValue(0);
+    le_stagnation->setMaxValue(2000);
+
+    ttip = QString("Batch mode: a fit is stopped if the residual did not improve\n"
+                   "significantly within this number of iterations\n"
+                   "(0: disabled)");
+    le_stagnation->setToolTip(ttip);
+    labelStagnation->setToolTip(ttip);
+    mainLayout->addWidget(le_stagnation, 2, 3);
+
+    connect(checkBatchMode, SIGNAL(toggled(bool)), le_stagnation, SLOT(setEnabled(bool)));
+    connect(checkBatchMode, SIGNAL(toggled(bool)), labelStagnation, SLOT(setEnabled(bool)));
+    labelStagnation->setEnabled(false);
+    le_stagnation->setEnabled(false);
+
     QWidget *spacer = new QWidget;
     spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     mainLayout->addWidget(spacer, 0, 4);
@@ -98,6 +129,8 @@ FT_NumericParamTable::~FT_NumericParamTable()
     gs->setValue(gs_group, gsk_it, le_it->getValue());    
     gs->setValue(gs_group, gsk_ode, cbODE->currentIndex());
     gs->setValue(gs_group, gsk_ode_stepSizeFactor, cbODE_stepSizeFactor->currentIndex());
+    gs->setValue(gs_group, gsk_batchMode, checkBatchMode->isChecked());
+    gs->setValue(gs_group, gsk_stagnation, le_stagnation->getValue());
 }
 
 
@@ -119,6 +152,12 @@ void FT_NumericParamTable::onGuiSettingsChanged()
 
     // ODE step size
     cbODE_stepSizeFactor->setCurrentIndex(gs->value(gs_group, gsk_ode_stepSizeFactor, 0).toInt());
+
+    // batch mode
+    checkBatchMode->setChecked(gs->value(gs_group, gsk_batchMode, false).toBool());
+    le_stagnation->setValue(gs->value(gs_group, gsk_stagnation,
+                                      NumericSettings::defaultStagnationIterations()).toInt());
+    le_stagnation->setEnabled(checkBatchMode->isChecked());
 }
 
 
@@ -177,3 +216,22 @@ int FT_NumericParamTable::ODE_stepSizeFactor()
     return pow(2, cbODE_stepSizeFactor->currentIndex());
 }
 
+
+/**
+ * @brief FT_NumericParamTable::batchMode
+ * @return true if single-shot fits should be performed in batch mode (see FitRun::setBatchMode())
+ */
+bool FT_NumericParamTable::batchMode()
+{
+    return checkBatchMode->isChecked();
+}
+
+
+/**
+ * @brief FT_NumericParamTable::stagnationIterations
+ * @return stagnation criterion of batch mode (see NumericSettings::stagnationIterations())
+ */
+int FT_NumericParamTable::stagnationIterations()
+{
+    return (int)le_stagnation->getValue();
+}
@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include <QComboBox>
+#include <QCheckBox>
 
 class NumberLineEdit;
 
@@ -20,6 +21,8 @@ public:
     int iterations();
     int ODE();
     int ODE_stepSizeFactor();
+    bool batchMode();
+    int stagnationIterations();
 
 private:
     NumberLineEdit* le_it;
@@ -27,11 +30,16 @@ private:
     QComboBox *cbODE;
     QComboBox *cbODE_stepSizeFactor;
 
+    QCheckBox *checkBatchMode;
+    NumberLineEdit *le_stagnation;
+
     // GUI settings keys
     QString gs_group;
     QString gsk_it;    
     QString gsk_ode;
     QString gsk_ode_stepSizeFactor;
+    QString gsk_batchMode;
+    QString gsk_stagnation;
 
 private slots:
     void onGuiSettingsChanged();
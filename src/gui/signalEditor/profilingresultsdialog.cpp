@@ -0,0 +1,161 @@
+#include "profilingresultsdialog.h"
+
+#include <QApplication>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+#include "../../core.h"
+
+
+ProfilingResultsDialog::ProfilingResultsDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    resize(900,500);
+    setWindowTitle("Profiling Results");
+    setWindowFlags(Qt::WindowSystemMenuHint | Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    QHBoxLayout* topLayout = new QHBoxLayout;
+    mainLayout->addLayout(topLayout);
+
+    topLayout->addWidget(new QLabel("Run:"));
+
+    comboboxRun = new QComboBox;
+    comboboxRun->setMinimumWidth(200);
+    connect(comboboxRun, SIGNAL(currentIndexChanged(int)), SLOT(updateTable()));
+    topLayout->addWidget(comboboxRun);
+
+    labelInfo = new QLabel;
+    topLayout->addWidget(labelInfo);
+    topLayout->addStretch(1);
+
+    table = new QTableWidget;
+    table->setColumnCount(9);
+    table->setHorizontalHeaderLabels(QStringList() << "Run" << "Category" << "Zone" << "Calls"
+                                     << "Total [ms]" << "Self [ms]" << "Mean [ms]"
+                                     << "Min [ms]" << "Max [ms]");
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    mainLayout->addWidget(table);
+
+    QHBoxLayout* bottomLayout = new QHBoxLayout;
+    mainLayout->addLayout(bottomLayout);
+
+    buttonRefresh = new QPushButton("Refresh");
+    buttonExport = new QPushButton("Export trace...");
+    buttonExport->setToolTip("Export all recorded zones as Chrome trace file\n"
+                             "(open with chrome://tracing or ui.perfetto.dev)");
+    buttonClose = new QPushButton("Close");
+
+    bottomLayout->addWidget(buttonRefresh);
+    bottomLayout->addWidget(buttonExport);
+    bottomLayout->addStretch(1);
+    bottomLayout->addWidget(buttonClose);
+
+    connect(buttonRefresh, SIGNAL(released()), SLOT(updateSummary()));
+    connect(buttonExport, SIGNAL(released()), SLOT(onButtonExportReleased()));
+    connect(buttonClose, SIGNAL(released()), SLOT(accept()));
+
+    updateSummary();
+}
+
+
+/**
+ * @brief ProfilingResultsDialog::updateSummary reads the current results
+ * from ProfilingRecorder and updates the run selection
+ */
+void ProfilingResultsDialog::updateSummary()
+{
+    m_summary = ProfilingRecorder::summary();
+
+    QString currentRun = comboboxRun->currentData().toString();
+
+    QStringList runs;
+    for(int i = 0; i < m_summary.size(); i++)
+        if(!m_summary.at(i).run.isEmpty() && !runs.contains(m_summary.at(i).run))
+            runs << m_summary.at(i).run;
+
+    comboboxRun->blockSignals(true);
+    comboboxRun->clear();
+    comboboxRun->addItem("All runs", QString());
+    for(int i = 0; i < runs.size(); i++)
+        comboboxRun->addItem(runs.at(i), runs.at(i));
+    comboboxRun->setCurrentIndex(qMax(0, comboboxRun->findData(currentRun)));
+    comboboxRun->blockSignals(false);
+
+    if(!ProfilingRecorder::isAvailable())
+        labelInfo->setText("  Profiling zones are not available in this build (LIISIM_PROFILING)");
+    else if(m_summary.isEmpty())
+        labelInfo->setText("  No results recorded (enable 'Record' and start calculation)");
+    else
+        labelInfo->setText(QString("  %0 zones, %1 runs").arg(m_summary.size()).arg(runs.size()));
+
+    updateTable();
+}
+
+
+/**
+ * @brief ProfilingResultsDialog::updateTable shows all entries of the selected run
+ * (entries without run, e.g. fits, are always shown)
+ */
+void ProfilingResultsDialog::updateTable()
+{
+    QString run = comboboxRun->currentData().toString();
+
+    table->setSortingEnabled(false);
+    table->setRowCount(0);
+
+    for(int i = 0; i < m_summary.size(); i++)
+    {
+        const ProfilingSummaryEntry& e = m_summary.at(i);
+
+        if(!run.isEmpty() && !e.run.isEmpty() && e.run != run)
+            continue;
+
+        int row = table->rowCount();
+        table->insertRow(row);
+
+        QList<QVariant> values;
+        values << e.run << e.category << e.name << e.count
+               << e.total << e.self << e.total / e.count
+               << e.min << e.max;
+
+        for(int c = 0; c < values.size(); c++)
+        {
+            QTableWidgetItem* item = new QTableWidgetItem;
+            if(values.at(c).type() == QVariant::Double)
+            {
+                // rounded to microseconds
+                item->setData(Qt::DisplayRole, double(qRound64(values.at(c).toDouble() * 1000.0)) / 1000.0);
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            }
+            else
+                item->setData(Qt::DisplayRole, values.at(c));
+            table->setItem(row, c, item);
+        }
+    }
+
+    table->setSortingEnabled(true);
+    table->resizeColumnsToContents();
+}
+
+
+void ProfilingResultsDialog::onButtonExportReleased()
+{
+    QString fname = QFileDialog::getSaveFileName(QApplication::focusWidget(),
+                                                 "Export Chrome trace",
+                                                 Core::rootDir + "trace.json",
+                                                 "Trace files (*.json)");
+    if(fname.isEmpty())
+        return;
+
+    if(ProfilingRecorder::writeChromeTrace(fname))
+        MSG_NORMAL("Profiling: trace written to " + fname);
+    else
+        MSG_ERR("Profiling: cannot write trace file " + fname);
+}
@@ -0,0 +1,42 @@
+#ifndef PROFILINGRESULTSDIALOG_H
+#define PROFILINGRESULTSDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+
+#include "../../general/profiling.h"
+
+/**
+ * @brief The ProfilingResultsDialog class shows the accumulated runtime of
+ * all recorded profiling zones per run and zone (ProcessingTask, processing
+ * chains, plugins, import/export and fits) and exports the recorded zones
+ * as Chrome/Perfetto trace file.
+ */
+class ProfilingResultsDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    ProfilingResultsDialog(QWidget *parent = 0);
+
+private:
+
+    QComboBox* comboboxRun;
+    QLabel* labelInfo;
+    QTableWidget* table;
+    QPushButton* buttonRefresh;
+    QPushButton* buttonExport;
+    QPushButton* buttonClose;
+
+    QList<ProfilingSummaryEntry> m_summary;
+
+private slots:
+
+    void updateSummary();
+    void updateTable();
+    void onButtonExportReleased();
+};
+
+#endif // PROFILINGRESULTSDIALOG_H
@@ -0,0 +1,76 @@
+#include "profilingwidget.h"
+
+#include "../../core.h"
+#include "../../general/profiling.h"
+#include "profilingresultsdialog.h"
+
+
+ProfilingWidget::ProfilingWidget(QWidget *parent)
+    : RibbonToolBox("PROFILING", parent)
+{
+    buttonRecord = new QToolButton(this);
+    buttonRecord->setIcon(QIcon(Core::rootDir + "resources/icons/bullet_red.png"));
+    buttonRecord->setIconSize(QSize(16,16));
+    buttonRecord->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+    buttonRecord->setText("Record");
+    buttonRecord->setToolTip("Record the runtime of processing tasks, plugins,\n"
+                             "import/export and fits (all threads)");
+    buttonRecord->setCheckable(true);
+    buttonRecord->setMinimumWidth(75);
+
+    buttonResults = new QToolButton(this);
+    buttonResults->setIcon(QIcon(Core::rootDir + "resources/icons/table.png"));
+    buttonResults->setIconSize(QSize(16,16));
+    buttonResults->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+    buttonResults->setText("Results");
+    buttonResults->setToolTip("Show recorded runtime per run and plugin,\nexport Chrome/Perfetto trace");
+    buttonResults->setMinimumWidth(75);
+
+    buttonClear = new QToolButton(this);
+    buttonClear->setIcon(QIcon(Core::rootDir + "resources/icons/bullet_delete.png"));
+    buttonClear->setIconSize(QSize(16,16));
+    buttonClear->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+    buttonClear->setText("Clear");
+    buttonClear->setToolTip("Remove all recorded results");
+    buttonClear->setMinimumWidth(75);
+
+    addWidget(buttonRecord, 0, 0);
+    addWidget(buttonResults, 1, 0);
+    addWidget(buttonClear, 2, 0);
+
+    buttonRecord->setChecked(ProfilingRecorder::isRecording());
+
+    connect(buttonRecord, SIGNAL(toggled(bool)), SLOT(onRecordToggled(bool)));
+    connect(buttonResults, SIGNAL(clicked()), SLOT(onResultsClicked()));
+    connect(buttonClear, SIGNAL(clicked()), SLOT(onClearClicked()));
+}
+
+
+ProfilingWidget::~ProfilingWidget()
+{
+
+}
+
+
+void ProfilingWidget::onRecordToggled(bool state)
+{
+    ProfilingRecorder::setRecording(state);
+
+    if(state)
+        MSG_STATUS("Profiling: recording started");
+    else
+        MSG_STATUS("Profiling: recording stopped");
+}
+
+
+void ProfilingWidget::onResultsClicked()
+{
+    ProfilingResultsDialog dialog(this);
+    dialog.exec();
+}
+
+
+void ProfilingWidget::onClearClicked()
+{
+    ProfilingRecorder::clear();
+}
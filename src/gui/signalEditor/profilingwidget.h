@@ -0,0 +1,34 @@
+#ifndef PROFILINGWIDGET_H
+#define PROFILINGWIDGET_H
+
+#include <QToolButton>
+
+#include "../utils/ribbontoolbox.h"
+
+/**
+ * @brief The ProfilingWidget class is a toolbox to start/stop the
+ * recording of profiling zones (see ProfilingRecorder) and to
+ * show the results (ProfilingResultsDialog)
+ */
+class ProfilingWidget : public RibbonToolBox
+{
+    Q_OBJECT
+
+public:
+    explicit ProfilingWidget(QWidget *parent = 0);
+    ~ProfilingWidget();
+
+private:
+
+    QToolButton* buttonRecord;
+    QToolButton* buttonResults;
+    QToolButton* buttonClear;
+
+private slots:
+
+    void onRecordToggled(bool state);
+    void onResultsClicked();
+    void onClearClicked();
+};
+
+#endif // PROFILINGWIDGET_H
@@ -15,6 +15,7 @@
 #include "../../general/LIISimException.h"
 #include "../utils/ribbontoolbox.h"
 #include "memusagewidget.h"
+#include "profilingwidget.h"
 #include "../utils/mrundetailswidget.h"
 
 #include "../utils/calculationtoolbox.h"
@@ -207,6 +208,13 @@ SignalProcessingEditor::SignalProcessingEditor(QWidget *parent) : QWidget(parent
             SLOT(handleImportStateChanged(bool)));
     connect(m_sigManager,SIGNAL(processingStateChanged(bool)),
             SLOT(handleProcessingStateChanged(bool)));
+    connect(m_sigManager,SIGNAL(previewFinished(MRun*,int)),
+            SLOT(onPreviewFinished(MRun*,int)));
+
+    m_previewTimer = new QTimer(this);
+    m_previewTimer->setSingleShot(true);
+    m_previewTimer->setInterval(0);
+    connect(m_previewTimer, SIGNAL(timeout()), SLOT(onPreviewTimeout()));
 
     initToolBars();
 
@@ -365,6 +373,18 @@ void SignalProcessingEditor::initToolBars()
     MemUsageWidget* memw = new MemUsageWidget;
     memw->setObjectName("SPE_MEMORY_BOX");
     m_ribbonToolbar->addWidget(memw);    
+
+#ifdef LIISIM_PROFILING
+    // -----------------------
+    // 'PROFILING' Toolbox
+    // -----------------------
+
+    m_ribbonToolbar->addSeparator();
+
+    ProfilingWidget* profw = new ProfilingWidget;
+    profw->setObjectName("SPE_PROFILING_BOX");
+    m_ribbonToolbar->addWidget(profw);
+#endif
 }
 
 // -----------------------
@@ -428,6 +448,9 @@ void SignalProcessingEditor::onMRunSelectionChanged(QList<QTreeWidgetItem*> sele
     if(m_mrun)
     {
         m_mrun->disconnect(this);
+        m_mrun->getProcessingChain(Signal::RAW)->disconnect(this);
+        m_mrun->getProcessingChain(Signal::ABS)->disconnect(this);
+        m_mrun->getProcessingChain(Signal::TEMPERATURE)->disconnect(this);
     }
 
     if(userData == 2)
@@ -448,6 +471,10 @@ void SignalProcessingEditor::onMRunSelectionChanged(QList<QTreeWidgetItem*> sele
         connect(m_mrun,SIGNAL(channelCountChanged(Signal::SType,int)),
                 SLOT(onMRunChannelCountChanged(Signal::SType,int)));
 
+        connect(m_mrun->getProcessingChain(Signal::RAW), SIGNAL(pluginModified()), SLOT(onPluginModified()));
+        connect(m_mrun->getProcessingChain(Signal::ABS), SIGNAL(pluginModified()), SLOT(onPluginModified()));
+        connect(m_mrun->getProcessingChain(Signal::TEMPERATURE), SIGNAL(pluginModified()), SLOT(onPluginModified()));
+
         mrunDetailsView->setRun(m_mrun);
     }
 
@@ -563,6 +590,7 @@ void SignalProcessingEditor::updateItemColors()
     if(!m_mrun)
         return;
 
+    bool muted = m_mutePPTWIchanges;
     m_mutePPTWIchanges = true;
     DataItemTreeView* curTree;
     for(int p = 0; p < 3; p++)
@@ -654,7 +682,7 @@ void SignalProcessingEditor::updateItemColors()
             }
         }
     }
-    m_mutePPTWIchanges = false;
+    m_mutePPTWIchanges = muted;
 }
 
 
@@ -722,8 +750,13 @@ void SignalProcessingEditor::handleProcessingStateChanged(bool state)
 {
     if(state)
     {
-        setCursor(Qt::WaitCursor);
+        // plugin modifications are applied after processing
+        // (see ProcessingPlugin::setParameters())
         m_mutePPTWIchanges = true;
+
+        // keep editor responsive during reprocessing after preview
+        if(!m_sigManager->isBackgroundProcessing())
+            setCursor(Qt::WaitCursor);
     }
     else
     {
@@ -757,6 +790,22 @@ void SignalProcessingEditor::handleExportStateChanged(bool state)
 }
 
 
+/**
+ * @brief SignalProcessingEditor::onPreviewFinished shows the preview
+ * of the current signal (see SignalManager::requestPreview())
+ * @param mrun
+ * @param mpIdx
+ */
+void SignalProcessingEditor::onPreviewFinished(MRun *mrun, int mpIdx)
+{
+    if(mrun != m_mrun || mpIdx != m_curMPoint)
+        return;
+
+    replot();
+    updateItemColors();
+}
+
+
 // ---------------------------------
 // HANDLE CHANGES OF DATAMODEL
 // ---------------------------------
@@ -816,6 +865,26 @@ void SignalProcessingEditor::onMRunDestroyed()
 }
 
 
+/**
+ * @brief SignalProcessingEditor::onPluginModified is executed if a plugin of the
+ * current run has been modified. All modifications within the current event
+ * loop iteration are previewed at once.
+ */
+void SignalProcessingEditor::onPluginModified()
+{
+    m_previewTimer->start();
+}
+
+
+void SignalProcessingEditor::onPreviewTimeout()
+{
+    if(!m_mrun || !isVisible())
+        return;
+
+    m_sigManager->requestPreview(m_mrun, m_curMPoint);
+}
+
+
 void SignalProcessingEditor::onMRunChannelCountChanged(Signal::SType stype, int count)
 {
     if(!m_mrun)
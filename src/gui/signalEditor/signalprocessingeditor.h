@@ -20,6 +20,7 @@
 #include <QToolButton>
 #include <QProgressBar>
 #include <QRadioButton>
+#include <QTimer>
 #include "gridablesplitter.h"
 #include "../../models/datamodel.h"
 #include "../utils/signalplotwidgetqwt.h"
@@ -115,6 +116,9 @@ class SignalProcessingEditor : public QWidget
 
         QToolBar* m_ribbonToolbar;
 
+        /** @brief coalesces plugin modifications to a single preview request */
+        QTimer* m_previewTimer;
+
         // PRIVATE HELPERS
         void initToolBars();
         void plotCurrentPlugins();
@@ -146,11 +150,14 @@ class SignalProcessingEditor : public QWidget
         void onMRunDestroyed();
         void onMRunDataChanged();
         void onMRunChannelCountChanged(Signal::SType stype, int count);
+        void onPluginModified();
+        void onPreviewTimeout();
 
         // SLOTS HANDLING SIGNALMANAGER STATE CHANGES
         void handleImportStateChanged(bool state);
         void handleProcessingStateChanged(bool state);
         void handleExportStateChanged(bool state);
+        void onPreviewFinished(MRun* mrun, int mpIdx);
 
         // PLOT STUFF
         void onCurrentPlotToolChanged(BasePlotWidgetQwt::PlotZoomMode mode);
@@ -10,6 +10,7 @@ CalculationToolbox::CalculationToolbox(QWidget *parent) : RibbonToolBox("CALCULA
     identifier_calcAbs = "calcAbs";
     identifier_calcTemp = "calcTemp";
     identifier_dbscan = "rescanDBBeforeCalculation";
+    identifier_livePreview = "livePreview";
 
     buttonRecalc = new QToolButton(this);
     buttonRecalc->setIcon(QIcon(Core::rootDir + "resources/icons/calculator.png"));
@@ -61,6 +62,9 @@ CalculationToolbox::CalculationToolbox(QWidget *parent) : RibbonToolBox("CALCULA
     checkboxRescanDBAtRecalc = new QCheckBox("Rescan database before calculation", this);
     checkboxRescanDBAtRecalc->setToolTip("Rescan database files before calculating processing chain (if text files are edited manually)");
 
+    checkboxLivePreview = new QCheckBox("Live preview", this);
+    checkboxLivePreview->setToolTip("Process current signal immediately if a processing step is modified,\nrecalculate the run in background afterwards");
+
     layoutGrid->setContentsMargins(10,5,10,5);
     layoutGrid->setColumnMinimumWidth(0,90);
     layoutGrid->setColumnMinimumWidth(1,90);
@@ -85,6 +89,8 @@ CalculationToolbox::CalculationToolbox(QWidget *parent) : RibbonToolBox("CALCULA
 
     addWidget(materialComboBox, 2, 3);
 
+    addWidget(checkboxLivePreview, 0, 4);
+
     connect(buttonRecalc, SIGNAL(clicked(bool)), SLOT(onRecalcClicked()));
     connect(buttonReset, SIGNAL(clicked(bool)), SLOT(onResetClicked()));
     connect(buttonCancel, SIGNAL(clicked(bool)), SLOT(onCancelClicked()));
@@ -96,6 +102,7 @@ CalculationToolbox::CalculationToolbox(QWidget *parent) : RibbonToolBox("CALCULA
     connect(checkboxCalcTemp, SIGNAL(stateChanged(int)), SLOT(onCheckboxCalcTypeChanged()));
 
     connect(checkboxRescanDBAtRecalc, SIGNAL(stateChanged(int)), SLOT(onCheckboxRescanDBChanged()));
+    connect(checkboxLivePreview, SIGNAL(stateChanged(int)), SLOT(onCheckboxLivePreviewChanged()));
 
     connect(Core::instance()->getSignalManager(), SIGNAL(processingStateChanged(bool)), SLOT(onProcessingStateChanged(bool)));
 
@@ -207,6 +214,17 @@ void CalculationToolbox::onCheckboxRescanDBChanged()
 }
 
 
+/**
+ * @brief CalculationToolbox::onCheckboxLivePreviewChanged This slot is executed when the user
+ * changes the state of the "Live preview"-checkbox. Saves the state in the GuiSettings.
+ */
+void CalculationToolbox::onCheckboxLivePreviewChanged()
+{
+    Core::instance()->getSignalManager()->setLivePreview(checkboxLivePreview->isChecked());
+    Core::instance()->guiSettings->setValue(identifier_settings_group, identifier_livePreview, checkboxLivePreview->isChecked(), true);
+}
+
+
 /**
  * @brief CalculationToolbox::onProcessingStateChanged Connected with the SignalManager to
  * be notified when the processing state changes. Enables/disables ui elements.
@@ -266,6 +284,12 @@ void CalculationToolbox::onGuiSettingsChanged(QString subgroup, QString key, QVa
             checkboxRescanDBAtRecalc->setChecked(value.toBool());
             checkboxRescanDBAtRecalc->blockSignals(false);
         }
+        else if(key == identifier_livePreview)
+        {
+            checkboxLivePreview->blockSignals(true);
+            checkboxLivePreview->setChecked(value.toBool());
+            checkboxLivePreview->blockSignals(false);
+        }
     }
 }
 
@@ -295,6 +319,13 @@ void CalculationToolbox::onGuiSettingsChanged()
     checkboxRescanDBAtRecalc->setChecked(gs->value(identifier_settings_group, identifier_dbscan, false).toBool());
     checkboxRescanDBAtRecalc->blockSignals(false);
 
+    bool livePreview = gs->value(identifier_settings_group, identifier_livePreview, true).toBool();
+    Core::instance()->getSignalManager()->setLivePreview(livePreview);
+
+    checkboxLivePreview->blockSignals(true);
+    checkboxLivePreview->setChecked(livePreview);
+    checkboxLivePreview->blockSignals(false);
+
     checkboxCalcRaw->blockSignals(true);
     checkboxCalcAbs->blockSignals(true);
     checkboxCalcTemp->blockSignals(true);
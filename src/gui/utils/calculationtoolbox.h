@@ -37,6 +37,7 @@ private:
 
     MaterialComboBox* materialComboBox;
     QCheckBox *checkboxRescanDBAtRecalc;
+    QCheckBox *checkboxLivePreview;
 
     QString identifier_settings_group;
     QString identifier_calcMode;
@@ -44,6 +45,7 @@ private:
     QString identifier_calcAbs;
     QString identifier_calcTemp;
     QString identifier_dbscan;
+    QString identifier_livePreview;
 
 signals:
     void recalc(QList<Signal::SType> typeList);
@@ -56,6 +58,7 @@ private slots:
     void onCalcModeToggled(QAbstractButton *button, bool state);
     void onCheckboxCalcTypeChanged();
     void onCheckboxRescanDBChanged();
+    void onCheckboxLivePreviewChanged();
 
     void onProcessingStateChanged(bool state);
 
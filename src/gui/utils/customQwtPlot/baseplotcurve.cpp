@@ -2,6 +2,11 @@
 
 
 #include <qwt_scale_map.h>
+#include <qwt_painter.h>
+#include <qwt_symbol.h>
+#include <cmath>
+
+#include "signalseriesdata.h"
 
 BasePlotCurve::BasePlotCurve(
         const QString &title)  : QwtPlotCurve(title)
@@ -28,3 +33,34 @@ bool BasePlotCurve::isFixedStyle()
 {
     return  m_fixedStyle;
 }
+
+
+/**
+ * @brief BasePlotCurve::drawSeries draws the curve. If the curve data is a
+ * SignalSeriesData and the visible range contains (much) more data points than
+ * pixels, only the min/max decimated representation is drawn.
+ * Curves with symbols or other styles than Lines are always drawn with all data points.
+ */
+void BasePlotCurve::drawSeries(QPainter *painter,
+                               const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                               const QRectF &canvasRect, int from, int to) const
+{
+    const SignalSeriesData* lod = dynamic_cast<const SignalSeriesData*>(data());
+
+    if(lod && style() == QwtPlotCurve::Lines && (!symbol() || symbol()->style() == QwtSymbol::NoSymbol))
+    {
+        QPolygonF points;
+        if(lod->levelOfDetail(xMap.s1(), xMap.s2(), int(fabs(xMap.p2() - xMap.p1())), points))
+        {
+            for(int i = 0; i < points.size(); i++)
+                points[i] = QPointF(xMap.transform(points.at(i).x()),
+                                    yMap.transform(points.at(i).y()));
+
+            painter->setPen(pen());
+            QwtPainter::drawPolyline(painter, points);
+            return;
+        }
+    }
+
+    QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+}
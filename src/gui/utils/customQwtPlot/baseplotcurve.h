@@ -20,6 +20,10 @@ class BasePlotCurve : public QwtPlotCurve
     protected:
         bool m_fixedStyle;
 
+        virtual void drawSeries(QPainter *painter,
+                                const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                                const QRectF &canvasRect, int from, int to) const;
+
 
 };
 
@@ -1,5 +1,12 @@
 #include "signalplotintervalcurve.h"
 
+#include <cmath>
+#include <QPainter>
+#include <qwt_scale_map.h>
+#include <qwt_painter.h>
+
+#include "signalseriesdata.h"
+
 SignalPlotIntervalCurve::SignalPlotIntervalCurve(
         const QString &title,
         const Signal &signal)  : QwtPlotIntervalCurve(title)
@@ -8,3 +15,54 @@ SignalPlotIntervalCurve::SignalPlotIntervalCurve(
 }
 
 SignalPlotIntervalCurve::~SignalPlotIntervalCurve() {}
+
+
+/**
+ * @brief SignalPlotIntervalCurve::drawSeries draws the standard deviation tube.
+ * For dense data the min/max decimated envelope of SignalIntervalSeriesData is used
+ * (see BasePlotCurve::drawSeries()).
+ */
+void SignalPlotIntervalCurve::drawSeries(QPainter *painter,
+                                         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                                         const QRectF &canvasRect, int from, int to) const
+{
+    const SignalIntervalSeriesData* lod = dynamic_cast<const SignalIntervalSeriesData*>(data());
+
+    if(lod && style() == QwtPlotIntervalCurve::Tube)
+    {
+        QPolygonF upper;
+        QPolygonF lower;
+        if(lod->levelOfDetail(xMap.s1(), xMap.s2(), int(fabs(xMap.p2() - xMap.p1())), upper, lower))
+        {
+            int n = upper.size();
+            QPolygonF polygon(2 * n);
+
+            for(int i = 0; i < n; i++)
+            {
+                upper[i] = QPointF(xMap.transform(upper.at(i).x()), yMap.transform(upper.at(i).y()));
+                lower[i] = QPointF(xMap.transform(lower.at(i).x()), yMap.transform(lower.at(i).y()));
+
+                polygon[i] = upper.at(i);
+                polygon[2 * n - 1 - i] = lower.at(i);
+            }
+
+            if(brush().style() != Qt::NoBrush)
+            {
+                painter->setPen(QPen(Qt::NoPen));
+                painter->setBrush(brush());
+                QwtPainter::drawPolygon(painter, polygon);
+            }
+
+            if(pen().style() != Qt::NoPen)
+            {
+                painter->setPen(pen());
+                painter->setBrush(Qt::NoBrush);
+                QwtPainter::drawPolyline(painter, upper);
+                QwtPainter::drawPolyline(painter, lower);
+            }
+            return;
+        }
+    }
+
+    QwtPlotIntervalCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+}
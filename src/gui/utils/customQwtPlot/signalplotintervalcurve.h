@@ -12,6 +12,11 @@ class SignalPlotIntervalCurve : public QwtPlotIntervalCurve
         ~SignalPlotIntervalCurve();
         inline int chID(){ return m_chid; }
 
+    protected:
+        virtual void drawSeries(QPainter *painter,
+                                const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                                const QRectF &canvasRect, int from, int to) const;
+
     private:
         int m_chid;
 };
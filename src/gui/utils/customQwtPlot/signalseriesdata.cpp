@@ -0,0 +1,356 @@
+#include "signalseriesdata.h"
+
+#include <cmath>
+
+
+MinMaxPyramid::MinMaxPyramid() {}
+
+
+/**
+ * @brief MinMaxPyramid::build builds all levels of the pyramid
+ * @param lower lower bound of each data point (data or data - stdev)
+ * @param upper upper bound of each data point (data or data + stdev)
+ * @param n number of data points
+ */
+void MinMaxPyramid::build(const double *lower, const double *upper, int n)
+{
+    clear();
+
+    if(n < 2)
+        return;
+
+    const double* lo = lower;
+    const double* hi = upper;
+    int size = n;
+
+    while(size > 1)
+    {
+        int buckets = (size + factor - 1) / factor;
+
+        QVector<double> bmin(buckets);
+        QVector<double> bmax(buckets);
+
+        for(int j = 0; j < buckets; j++)
+        {
+            int i = j * factor;
+            int end = qMin(i + factor, size);
+
+            double vmin = lo[i];
+            double vmax = hi[i];
+            for(i++; i < end; i++)
+            {
+                vmin = qMin(vmin, lo[i]);
+                vmax = qMax(vmax, hi[i]);
+            }
+            bmin[j] = vmin;
+            bmax[j] = vmax;
+        }
+
+        m_min.append(bmin);
+        m_max.append(bmax);
+
+        lo = m_min.last().constData();
+        hi = m_max.last().constData();
+        size = buckets;
+    }
+}
+
+
+void MinMaxPyramid::clear()
+{
+    m_min.clear();
+    m_max.clear();
+}
+
+
+/**
+ * @brief MinMaxPyramid::bucketSize
+ * @param level pyramid level
+ * @return number of data points combined in one bucket of this level
+ */
+int MinMaxPyramid::bucketSize(int level) const
+{
+    int b = 1;
+    for(int k = 0; k < level; k++)
+        b *= factor;
+    return b;
+}
+
+
+/**
+ * @brief MinMaxPyramid::selectLevel selects the coarsest level which
+ * still has at least one bucket per pixel
+ * @param visibleSamples number of visible data points
+ * @param pixels available pixel width
+ * @return level (0: raw data should be used)
+ */
+int MinMaxPyramid::selectLevel(int visibleSamples, int pixels) const
+{
+    if(pixels <= 0)
+        return 0;
+
+    int samplesPerPixel = visibleSamples / pixels;
+    int level = 0;
+    int b = factor;
+
+    while(level + 1 < levels() && b <= samplesPerPixel)
+    {
+        level++;
+        b *= factor;
+    }
+    return level;
+}
+
+
+/**
+ * @brief visibleBuckets determines level and bucket range for the visible x-range
+ * @return false if raw data should be drawn
+ */
+static bool visibleBuckets(const MinMaxPyramid &pyramid, int n, double startTime, double dt,
+                           double x1, double x2, int pixels, int &level, int &j0, int &j1)
+{
+    if(x1 > x2)
+        qSwap(x1, x2);
+
+    double t0 = startTime * 1e9;
+    double dx = dt * 1e9;
+
+    double i0 = qBound(0.0, floor((x1 - t0) / dx), n - 1.0);
+    double i1 = qBound(0.0, ceil((x2 - t0) / dx), n - 1.0);
+
+    level = pyramid.selectLevel(int(i1 - i0) + 1, pixels);
+    if(level < 1)
+        return false;
+
+    int b = pyramid.bucketSize(level);
+
+    // one additional bucket at each side, curve continues to plot border
+    j0 = qMax(0, int(i0) / b - 1);
+    j1 = qMin(pyramid.min(level).size() - 1, int(i1) / b + 1);
+
+    return true;
+}
+
+
+/**
+ * @brief bucketX
+ * @return x-value (ns) of bucket center
+ */
+static inline double bucketX(int j, int b, int n, double startTime, double dt)
+{
+    double i = qMin(j * b + (b - 1) * 0.5, n - 1.0);
+    return (startTime + i * dt) * 1e9;
+}
+
+
+// ---- SignalSeriesData ----
+
+
+SignalSeriesData::SignalSeriesData(const Signal &signal)
+{
+    m_data = signal.data;
+    m_startTime = signal.start_time;
+    m_dt = signal.dt;
+}
+
+
+size_t SignalSeriesData::size() const
+{
+    return m_data.size();
+}
+
+
+QPointF SignalSeriesData::sample(size_t i) const
+{
+    return QPointF((m_startTime + i * m_dt) * 1e9, m_data.at(int(i)));
+}
+
+
+QRectF SignalSeriesData::boundingRect() const
+{
+    if(d_boundingRect.width() < 0.0)
+    {
+        int n = m_data.size();
+        if(n == 0)
+            return d_boundingRect;
+
+        double ymin = m_data.first();
+        double ymax = m_data.first();
+
+        if(n > 1)
+        {
+            buildPyramid();
+            ymin = m_pyramid.min(m_pyramid.levels() - 1).first();
+            ymax = m_pyramid.max(m_pyramid.levels() - 1).first();
+        }
+
+        double xmin = sample(0).x();
+        double xmax = sample(n - 1).x();
+
+        d_boundingRect = QRectF(xmin, ymin, xmax - xmin, ymax - ymin);
+    }
+    return d_boundingRect;
+}
+
+
+/**
+ * @brief SignalSeriesData::levelOfDetail generates the decimated
+ * representation (minimum and maximum of each bucket) of the visible range
+ * @param x1 start of visible x-range (ns)
+ * @param x2 end of visible x-range (ns)
+ * @param pixels pixel width of the visible range
+ * @param points output (data coordinates)
+ * @return false if the raw data should be drawn
+ */
+bool SignalSeriesData::levelOfDetail(double x1, double x2, int pixels, QPolygonF &points) const
+{
+    int n = m_data.size();
+
+    if(n < MinMaxPyramid::factor * 2 || pixels <= 0 || m_dt <= 0.0)
+        return false;
+
+    // do not build the pyramid if the visible range is not dense enough
+    if(fabs(x2 - x1) / (m_dt * 1e9) < MinMaxPyramid::factor * pixels)
+        return false;
+
+    buildPyramid();
+
+    int level, j0, j1;
+    if(!visibleBuckets(m_pyramid, n, m_startTime, m_dt, x1, x2, pixels, level, j0, j1))
+        return false;
+
+    int b = m_pyramid.bucketSize(level);
+    const double* bmin = m_pyramid.min(level).constData();
+    const double* bmax = m_pyramid.max(level).constData();
+
+    points.resize(2 * (j1 - j0 + 1));
+    QPointF* p = points.data();
+
+    for(int j = j0; j <= j1; j++)
+    {
+        double x = bucketX(j, b, n, m_startTime, m_dt);
+        *p++ = QPointF(x, bmin[j]);
+        *p++ = QPointF(x, bmax[j]);
+    }
+    return true;
+}
+
+
+void SignalSeriesData::buildPyramid() const
+{
+    if(m_pyramid.isEmpty())
+        m_pyramid.build(m_data.constData(), m_data.constData(), m_data.size());
+}
+
+
+// ---- SignalIntervalSeriesData ----
+
+
+SignalIntervalSeriesData::SignalIntervalSeriesData(const Signal &signal)
+{
+    m_data = signal.data;
+    m_stdev = signal.stdev;
+    m_size = qMin(m_data.size(), m_stdev.size());
+    m_startTime = signal.start_time;
+    m_dt = signal.dt;
+}
+
+
+size_t SignalIntervalSeriesData::size() const
+{
+    return m_size;
+}
+
+
+QwtIntervalSample SignalIntervalSeriesData::sample(size_t i) const
+{
+    double v = m_data.at(int(i));
+    double s = m_stdev.at(int(i));
+    return QwtIntervalSample((m_startTime + i * m_dt) * 1e9, QwtInterval(v - s, v + s));
+}
+
+
+QRectF SignalIntervalSeriesData::boundingRect() const
+{
+    if(d_boundingRect.width() < 0.0)
+    {
+        if(m_size == 0)
+            return d_boundingRect;
+
+        double ymin = m_data.first() - m_stdev.first();
+        double ymax = m_data.first() + m_stdev.first();
+
+        if(m_size > 1)
+        {
+            buildPyramid();
+            ymin = m_pyramid.min(m_pyramid.levels() - 1).first();
+            ymax = m_pyramid.max(m_pyramid.levels() - 1).first();
+        }
+
+        // x-values on horizontal axis (see QwtPlotIntervalCurve, vertical orientation)
+        double xmin = (m_startTime) * 1e9;
+        double xmax = (m_startTime + (m_size - 1) * m_dt) * 1e9;
+
+        d_boundingRect = QRectF(xmin, ymin, xmax - xmin, ymax - ymin);
+    }
+    return d_boundingRect;
+}
+
+
+/**
+ * @brief SignalIntervalSeriesData::levelOfDetail generates the decimated
+ * upper and lower bound of the visible range
+ * @param x1 start of visible x-range (ns)
+ * @param x2 end of visible x-range (ns)
+ * @param pixels pixel width of the visible range
+ * @param upper output, maximum of upper bound (data coordinates)
+ * @param lower output, minimum of lower bound (data coordinates)
+ * @return false if the raw data should be drawn
+ */
+bool SignalIntervalSeriesData::levelOfDetail(double x1, double x2, int pixels,
+                                             QPolygonF &upper, QPolygonF &lower) const
+{
+    if(m_size < MinMaxPyramid::factor * 2 || pixels <= 0 || m_dt <= 0.0)
+        return false;
+
+    if(fabs(x2 - x1) / (m_dt * 1e9) < MinMaxPyramid::factor * pixels)
+        return false;
+
+    buildPyramid();
+
+    int level, j0, j1;
+    if(!visibleBuckets(m_pyramid, m_size, m_startTime, m_dt, x1, x2, pixels, level, j0, j1))
+        return false;
+
+    int b = m_pyramid.bucketSize(level);
+    const double* bmin = m_pyramid.min(level).constData();
+    const double* bmax = m_pyramid.max(level).constData();
+
+    upper.resize(j1 - j0 + 1);
+    lower.resize(j1 - j0 + 1);
+
+    for(int j = j0; j <= j1; j++)
+    {
+        double x = bucketX(j, b, m_size, m_startTime, m_dt);
+        upper[j - j0] = QPointF(x, bmax[j]);
+        lower[j - j0] = QPointF(x, bmin[j]);
+    }
+    return true;
+}
+
+
+void SignalIntervalSeriesData::buildPyramid() const
+{
+    if(!m_pyramid.isEmpty())
+        return;
+
+    // bounds are only needed temporarily for building level 1
+    QVector<double> lo(m_size);
+    QVector<double> hi(m_size);
+    for(int i = 0; i < m_size; i++)
+    {
+        lo[i] = m_data.at(i) - m_stdev.at(i);
+        hi[i] = m_data.at(i) + m_stdev.at(i);
+    }
+    m_pyramid.build(lo.constData(), hi.constData(), m_size);
+}
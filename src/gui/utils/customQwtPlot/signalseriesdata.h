@@ -0,0 +1,107 @@
+#ifndef SIGNALSERIESDATA_H
+#define SIGNALSERIESDATA_H
+
+#include <QVector>
+#include <QPolygonF>
+#include <qwt_series_data.h>
+
+#include "../../../signal/signal.h"
+
+
+/**
+ * @brief The MinMaxPyramid class is a multi-resolution min/max
+ * representation of equidistant data.
+ * @ingroup GUI-Utilities
+ * @details Level 0 is the raw data (not stored), level k contains the
+ * minimum and maximum of buckets of factor^k consecutive data points.
+ * The pyramid is built once and used to draw long signals with
+ * (at most a few) points per pixel while keeping all peaks visible.
+ */
+class MinMaxPyramid
+{
+public:
+    MinMaxPyramid();
+
+    /** @brief number of buckets of a level which are combined on the next level */
+    static const int factor = 4;
+
+    void build(const double *lower, const double *upper, int n);
+    void clear();
+
+    inline bool isEmpty() const { return m_min.isEmpty(); }
+    inline int levels() const { return m_min.size() + 1; }
+
+    int bucketSize(int level) const;
+    int selectLevel(int visibleSamples, int pixels) const;
+
+    inline const QVector<double> & min(int level) const { return m_min.at(level - 1); }
+    inline const QVector<double> & max(int level) const { return m_max.at(level - 1); }
+
+private:
+    /** @brief bucket minima/maxima of level 1 to levels()-1 */
+    QVector<QVector<double>> m_min;
+    QVector<QVector<double>> m_max;
+};
+
+
+/**
+ * @brief The SignalSeriesData class provides the data of a Signal to
+ * a QwtPlotCurve without copying the data or generating a time axis.
+ * @ingroup GUI-Utilities
+ * @details sample() always returns the full resolution data (used by
+ * data cursor, data table and tools). For drawing, BasePlotCurve requests
+ * a decimated representation via levelOfDetail().
+ */
+class SignalSeriesData : public QwtSeriesData<QPointF>
+{
+public:
+    SignalSeriesData(const Signal &signal);
+
+    virtual size_t size() const;
+    virtual QPointF sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+
+    bool levelOfDetail(double x1, double x2, int pixels, QPolygonF &points) const;
+
+private:
+    QVector<double> m_data;
+    double m_startTime;
+    double m_dt;
+
+    mutable MinMaxPyramid m_pyramid;
+
+    void buildPyramid() const;
+};
+
+
+/**
+ * @brief The SignalIntervalSeriesData class provides the standard deviation
+ * envelope (data +/- stdev) of a Signal to a QwtPlotIntervalCurve.
+ * @ingroup GUI-Utilities
+ * @details Same concept as SignalSeriesData, the decimated representation
+ * contains the minimum of the lower and the maximum of the upper bound.
+ */
+class SignalIntervalSeriesData : public QwtSeriesData<QwtIntervalSample>
+{
+public:
+    SignalIntervalSeriesData(const Signal &signal);
+
+    virtual size_t size() const;
+    virtual QwtIntervalSample sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+
+    bool levelOfDetail(double x1, double x2, int pixels, QPolygonF &upper, QPolygonF &lower) const;
+
+private:
+    QVector<double> m_data;
+    QVector<double> m_stdev;
+    int m_size;
+    double m_startTime;
+    double m_dt;
+
+    mutable MinMaxPyramid m_pyramid;
+
+    void buildPyramid() const;
+};
+
+#endif // SIGNALSERIESDATA_H
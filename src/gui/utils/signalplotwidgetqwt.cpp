@@ -22,6 +22,7 @@
 // custom for this class
 #include "customQwtPlot/signalplotcurve.h"
 #include "customQwtPlot/signalplotintervalcurve.h"
+#include "customQwtPlot/signalseriesdata.h"
 
 /**
  * @brief SignalPlotWidgetQwt::SignalPlotWidgetQwt Constructor
@@ -277,22 +278,6 @@ void SignalPlotWidgetQwt::addSignal(const Signal &signal,const QString & curveNa
     if(curveRenderAntialiased)
         curve->setRenderHint(QwtPlotItem::RenderAntialiased);
 
-    // generate time axis!
-    QVector<double> xData;
-    QVector<QwtIntervalSample> rangeData;
-
-    for(int i = 0; i < signal.data.size(); i++)
-    {
-        xData.push_back((signal.start_time + i * signal.dt) * 1e9);
-
-        if(signal.stdev.size() > 0)
-        {
-            rangeData.push_back(QwtIntervalSample( xData.at(i),
-                                               QwtInterval( signal.data.at(i) - signal.stdev.at(i),
-                                                            signal.data.at(i) + signal.stdev.at(i)) ));
-        }
-    }
-
     // draw evelope function of standard deviation
     if(signal.stdev.size() > 0)
     {
@@ -305,7 +290,8 @@ void SignalPlotWidgetQwt::addSignal(const Signal &signal,const QString & curveNa
       intervalCurve->setBrush( QBrush( bg ) );
       intervalCurve->setStyle( QwtPlotIntervalCurve::Tube );
 
-      intervalCurve->setSamples(rangeData);
+      // curve data owns a min/max pyramid which is used for dense data
+      intervalCurve->setData(new SignalIntervalSeriesData(signal));
       intervalCurve->setVisible(actionShowStdev->isChecked());
       intervalCurve->setItemAttribute(QwtPlotItem::Legend, actionShowStdev->isChecked());
       intervalCurve->attach(qwtPlot);
@@ -313,8 +299,8 @@ void SignalPlotWidgetQwt::addSignal(const Signal &signal,const QString & curveNa
       stdev_curves.append(intervalCurve);
     }
 
-    // attach data
-    curve->setSamples(xData,signal.data);
+    // attach data (time axis is generated on demand, signal data is shared)
+    curve->setData(new SignalSeriesData(signal));
 
     // set visibility state of channel based on channel checkbox selection
     for(int i = 0; i < channelCBs.size(); i++)
@@ -0,0 +1,319 @@
+#include "fitresultfile.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+#include "../general/taskscheduler.h"
+#include "../logging/msghandlerbase.h"
+
+
+static const char fitResultMagic[8] = {'L', 'I', 'I', 'F', 'I', 'T', '\0', '\0'};
+static const quint32 blockMagic = 0x4B4C4246; // "FBLK"
+
+
+/**
+ * @brief The FitResultFileHeader struct (see FitResultFile file layout)
+ */
+struct FitResultFileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+    quint32 blockCount;
+    char reserved[12];
+};
+
+
+/**
+ * @brief The FitResultBlockHeader struct (see FitResultFile file layout)
+ */
+struct FitResultBlockHeader
+{
+    quint32 magic;
+    quint32 iterations;
+    quint32 params;
+    quint32 reserved;
+};
+
+static_assert(sizeof(FitResultFileHeader) == FitResultFile::headerSize,
+              "FitResultFile: unexpected file header size");
+static_assert(sizeof(FitResultBlockHeader) == FitResultFile::blockHeaderSize,
+              "FitResultFile: unexpected block header size");
+
+
+/** @brief guards writeGeneration (writeAsync()) */
+static QMutex writeMutex;
+/** @brief latest requested write of each file */
+static QHash<QString, quint64> writeGeneration;
+/** @brief serializes writing and removing of sidecar files */
+static QMutex fileMutex;
+/** @brief write tasks which have not finished yet (guarded by writeMutex) */
+static QList<QFuture<void>> pendingWrites;
+
+
+/**
+ * @brief blockParams number of values per iteration of a FitData
+ * (size of the largest iteration result)
+ */
+static int blockParams(const QList<FitIterationResult> &iterations)
+{
+    int params = 0;
+    for(int i = 0; i < iterations.size(); i++)
+        params = qMax(params, iterations.at(i).size());
+    return params;
+}
+
+
+/**
+ * @brief FitResultFile::sidecarFileName
+ * @param sessionFile session XML file
+ * @param number number of FitRun
+ * @return sidecar file next to the session file (<session>.fitrunN.liifit)
+ */
+QString FitResultFile::sidecarFileName(const QString &sessionFile, int number)
+{
+    QFileInfo info(sessionFile);
+    return info.dir().filePath(QString("%0.fitrun%1.%2")
+                               .arg(info.completeBaseName())
+                               .arg(number)
+                               .arg(fileSuffix()));
+}
+
+
+/**
+ * @brief FitResultFile::layout calculates the position of all blocks
+ * (the layout is known before the file has been written)
+ * @param results iteration results of each FitData
+ * @return block of each FitData
+ */
+QList<FitResultFile::Block> FitResultFile::layout(const QList<QList<FitIterationResult>> &results)
+{
+    QList<Block> blocks;
+
+    qint64 offset = headerSize;
+    for(int i = 0; i < results.size(); i++)
+    {
+        Block block;
+        block.offset = offset;
+        block.iterations = results.at(i).size();
+        block.params = blockParams(results.at(i));
+        blocks.append(block);
+
+        offset += blockHeaderSize + qint64(block.iterations) * block.params * sizeof(double);
+    }
+    return blocks;
+}
+
+
+/**
+ * @brief FitResultFile::write writes the sidecar file, the file is replaced
+ * only if it has been written completely
+ * @param fileName
+ * @param results iteration results of each FitData
+ * @return true on success
+ */
+bool FitResultFile::write(const QString &fileName, const QList<QList<FitIterationResult>> &results)
+{
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        MESSAGE(QString("FitResultFile: cannot write %0 (%1)").arg(fileName).arg(file.errorString()), ERR_IO);
+        return false;
+    }
+
+    FitResultFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, fitResultMagic, sizeof(fitResultMagic));
+    header.version = fileVersion;
+    header.headerSize = headerSize;
+    header.blockCount = results.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    QVector<double> values;
+
+    for(int i = 0; i < results.size(); i++)
+    {
+        const QList<FitIterationResult> &iterations = results.at(i);
+        const int params = blockParams(iterations);
+
+        FitResultBlockHeader bh;
+        memset(&bh, 0, sizeof(bh));
+        bh.magic = blockMagic;
+        bh.iterations = iterations.size();
+        bh.params = params;
+        file.write(reinterpret_cast<const char*>(&bh), sizeof(bh));
+
+        values.fill(0.0, iterations.size() * params);
+        for(int j = 0; j < iterations.size(); j++)
+            std::copy(iterations.at(j).constBegin(), iterations.at(j).constEnd(), values.begin() + j * params);
+
+        file.write(reinterpret_cast<const char*>(values.constData()), values.size() * sizeof(double));
+    }
+
+    if(!file.commit())
+    {
+        MESSAGE(QString("FitResultFile: cannot write %0 (%1)").arg(fileName).arg(file.errorString()), ERR_IO);
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief FitResultFile::writeAsync writes the sidecar file on the IO lane
+ * of the TaskScheduler. If the same file is requested again before the
+ * write started, only the latest results are written.
+ * @param fileName
+ * @param results iteration results of each FitData (implicitly shared)
+ */
+void FitResultFile::writeAsync(const QString &fileName, const QList<QList<FitIterationResult>> &results)
+{
+    QMutexLocker lock(&writeMutex);
+    quint64 generation = ++writeGeneration[fileName];
+
+    for(int i = pendingWrites.size() - 1; i >= 0; i--)
+        if(pendingWrites.at(i).isFinished())
+            pendingWrites.removeAt(i);
+
+    pendingWrites << TaskScheduler::instance()->run(TaskScheduler::IO, [fileName, results, generation]
+    {
+        // writes of the same file are serialized, outdated requests are skipped
+        QMutexLocker fileLock(&fileMutex);
+        {
+            QMutexLocker lock(&writeMutex);
+            if(writeGeneration.value(fileName) != generation)
+                return;
+        }
+        write(fileName, results);
+    });
+}
+
+
+/**
+ * @brief FitResultFile::waitForPendingWrites blocks until all sidecar files
+ * requested by writeAsync() have been written (program exit, the TaskScheduler's
+ * threads are not joined)
+ */
+void FitResultFile::waitForPendingWrites()
+{
+    QList<QFuture<void>> writes;
+    {
+        QMutexLocker lock(&writeMutex);
+        writes = pendingWrites;
+        pendingWrites.clear();
+    }
+
+    for(int i = 0; i < writes.size(); i++)
+        writes[i].waitForFinished();
+}
+
+
+/**
+ * @brief FitResultFile::removeUnreferenced removes all sidecar files of a session
+ * which are not referenced by the session anymore (eg. deleted FitRuns).
+ * Pending writes of the removed files are skipped.
+ * @param sessionFile session XML file
+ * @param referenced sidecar files referenced by the session
+ */
+void FitResultFile::removeUnreferenced(const QString &sessionFile, const QStringList &referenced)
+{
+    QFileInfo info(sessionFile);
+    QDir dir = info.dir();
+
+    QStringList filter;
+    filter << QString("%0.fitrun*.%1").arg(info.completeBaseName()).arg(fileSuffix());
+
+    for(const QString &name : dir.entryList(filter, QDir::Files))
+    {
+        QString fileName = dir.filePath(name);
+        if(referenced.contains(fileName))
+            continue;
+
+        {
+            QMutexLocker lock(&writeMutex);
+            ++writeGeneration[fileName];
+        }
+
+        QMutexLocker fileLock(&fileMutex);
+        if(QFile::remove(fileName))
+            MSG_DETAIL_1(QString("FitResultFile: removed unreferenced file %0").arg(fileName));
+    }
+}
+
+
+/**
+ * @brief FitResultFile::readHeader checks the file header
+ * @param file opened sidecar file
+ * @return true if file is a valid sidecar file
+ */
+bool FitResultFile::readHeader(QFile &file)
+{
+    FitResultFileHeader header;
+    if(!file.seek(0)
+            || file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+            || memcmp(header.magic, fitResultMagic, sizeof(fitResultMagic)) != 0)
+    {
+        MSG_WARN(QString("FitResultFile: %0 is not a fit result file").arg(file.fileName()));
+        return false;
+    }
+
+    if(header.version > quint32(fileVersion))
+    {
+        MSG_WARN(QString("FitResultFile: unsupported version of %0 (%1)")
+                 .arg(file.fileName()).arg(header.version));
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief FitResultFile::readBlock reads the iteration results of one FitData
+ * @param file opened sidecar file
+ * @param block position of the results (from session file)
+ * @param results iteration results (output)
+ * @return true on success
+ */
+bool FitResultFile::readBlock(QFile &file, const Block &block, QList<FitIterationResult> &results)
+{
+    results.clear();
+
+    FitResultBlockHeader bh;
+    if(!file.seek(block.offset)
+            || file.read(reinterpret_cast<char*>(&bh), sizeof(bh)) != sizeof(bh)
+            || bh.magic != blockMagic
+            || int(bh.iterations) != block.iterations
+            || int(bh.params) != block.params)
+    {
+        MSG_WARN(QString("FitResultFile: %0: invalid block at %1 (file does not match session)")
+                 .arg(file.fileName()).arg(block.offset));
+        return false;
+    }
+
+    QVector<double> values(block.iterations * block.params);
+    qint64 bytes = qint64(values.size()) * sizeof(double);
+    if(file.read(reinterpret_cast<char*>(values.data()), bytes) != bytes)
+    {
+        MSG_WARN(QString("FitResultFile: %0: incomplete block at %1").arg(file.fileName()).arg(block.offset));
+        return false;
+    }
+
+    results.reserve(block.iterations);
+    for(int j = 0; j < block.iterations; j++)
+    {
+        FitIterationResult fres(block.params);
+        std::copy(values.constBegin() + j * block.params,
+                  values.constBegin() + (j + 1) * block.params,
+                  fres.begin());
+        results.append(fres);
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef FITRESULTFILE_H
+#define FITRESULTFILE_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "../calculations/fit/fititerationresult.h"
+
+
+/**
+ * @brief The FitResultFile class stores the iteration results of a FitRun
+ * in a binary sidecar file (*.liifit) next to the session file.
+ * @details The session XML only contains the FitRun settings and for each
+ * FitData the position of its results within the sidecar (see FitRun::writeToXML()),
+ * results are loaded when the FitRun is opened (FitRun::loadResults()).
+ *
+ * File layout (native byte order):
+ *  - file header (headerSize bytes): magic "LIIFIT", version, header size, block count
+ *  - one block per FitData, consisting of
+ *     - block header (blockHeaderSize bytes): magic, iteration count, values per iteration
+ *     - iteration values (double), iteration after iteration
+ * @ingroup IO
+ */
+class FitResultFile
+{
+public:
+    static const int fileVersion = 1;
+    static const int headerSize = 32;
+    static const int blockHeaderSize = 16;
+
+    /** @brief file suffix of sidecar files */
+    static QString fileSuffix() { return "liifit"; }
+
+    /** @brief position of the results of one FitData within the file */
+    struct Block
+    {
+        qint64 offset;
+        int iterations;
+        int params;
+    };
+
+    static QString sidecarFileName(const QString &sessionFile, int number);
+
+    static QList<Block> layout(const QList<QList<FitIterationResult>> &results);
+
+    static bool write(const QString &fileName, const QList<QList<FitIterationResult>> &results);
+    static void writeAsync(const QString &fileName, const QList<QList<FitIterationResult>> &results);
+    static void waitForPendingWrites();
+    static void removeUnreferenced(const QString &sessionFile, const QStringList &referenced);
+
+    static bool readHeader(QFile &file);
+    static bool readBlock(QFile &file, const Block &block, QList<FitIterationResult> &results);
+};
+
+#endif // FITRESULTFILE_H
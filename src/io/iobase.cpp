@@ -1,11 +1,12 @@
 #include "iobase.h"
 
-#include <QtConcurrent/qtconcurrentrun.h>
 #include <QApplication>
 #include "../core.h"
 #include "../signal/mrungroup.h"
 #include "../settings/mrunsettings.h"
 #include "consistencycheck.h"
+#include "../general/profiling.h"
+#include "../general/taskscheduler.h"
 
 bool IOBase::abort_flag = false;
 
@@ -91,9 +92,9 @@ void IOBase::importSignals(const SignalIORequest & irq)
         // (implementation can be found in subclasses)
         m_timer.start();
         if(m_concurrency)
-            QtConcurrent::run(this,&IOBase::setupImport);
+            TaskScheduler::instance()->run(TaskScheduler::IO, [this]{ profiledSetupImport(); });
         else
-            setupImport();
+            profiledSetupImport();
     }
     catch(LIISimException e)
     {
@@ -116,9 +117,9 @@ void IOBase::importSignals(const QList<SignalIORequest> &irq)
         {
             m_timer.start();
             if(m_concurrency)
-                QtConcurrent::run(this, &IOBase::setupImport);
+                TaskScheduler::instance()->run(TaskScheduler::IO, [this]{ profiledSetupImport(); });
             else
-                setupImport();
+                profiledSetupImport();
         }
         catch(LIISimException e)
         {
@@ -152,11 +153,25 @@ void IOBase::exportSignals(const SignalIORequest &rq)
 
     e_flag_matlab_compression = rq.userData.value(35, false).toBool();
 
-    QtConcurrent::run(this,&IOBase::exportImplementation,rq);
+    setupExport(rq);
+
+    TaskScheduler::instance()->run(TaskScheduler::IO, [this, rq]{ profiledExportImplementation(rq); });
    // exportImplementation(rq);
 }
 
 
+/**
+ * @brief IOBase::profiledExportImplementation calls exportImplementation()
+ * within a profiling zone (see ProfilingRecorder)
+ * @param irq
+ */
+void IOBase::profiledExportImplementation(const SignalIORequest &irq)
+{
+    PROFILE_ZONE("io", QString("%0::exportImplementation").arg(metaObject()->className()), irq.runname);
+    exportImplementation(irq);
+}
+
+
 /**
  * @brief IOBase::onExportImplementationFinished This
  * slot is executed when an exportImplementation (in subclass)
@@ -324,9 +339,12 @@ void IOBase::onImportSetupFinished()
             if(p_mode == PM_PERMRUN)    // make one call per mrun
             {              
                 if(m_concurrency)
-                    QtConcurrent::run(this,&IOBase::importStep,mrun,irq.flist);
+                {
+                    SignalFileInfoList files = irq.flist;
+                    TaskScheduler::instance()->run(TaskScheduler::IO, [this, mrun, files]{ profiledImportStep(mrun, files); });
+                }
                 else
-                    importStep(mrun,irq.flist);
+                    profiledImportStep(mrun,irq.flist);
             }
             else if(p_mode == PM_PERCHANNEL)    // make one call mrun-channel
             {               
@@ -352,9 +370,12 @@ void IOBase::onImportSetupFinished()
                 for(int c = 0; c < channelList.size(); c++)
                 {
                     if(m_concurrency)
-                        QtConcurrent::run(this,&IOBase::importStep,mrun,channelList.at(c));
+                    {
+                        SignalFileInfoList files = channelList.at(c);
+                        TaskScheduler::instance()->run(TaskScheduler::IO, [this, mrun, files]{ profiledImportStep(mrun, files); });
+                    }
                     else
-                        importStep(mrun,channelList.at(c));
+                        profiledImportStep(mrun,channelList.at(c));
                 }
             }
             else if(p_mode == PM_PERFILE)   // make one call per file
@@ -365,9 +386,9 @@ void IOBase::onImportSetupFinished()
                     sList << irq.flist.at(j);
 
                     if(m_concurrency)
-                        QtConcurrent::run(this,&IOBase::importStep,mrun,sList);
+                        TaskScheduler::instance()->run(TaskScheduler::IO, [this, mrun, sList]{ profiledImportStep(mrun, sList); });
                     else
-                        importStep(mrun,sList);
+                        profiledImportStep(mrun,sList);
                 }
             }
 
@@ -400,6 +421,30 @@ void IOBase::onImportSetupFinished()
 }
 
 
+/**
+ * @brief IOBase::profiledSetupImport calls setupImport()
+ * within a profiling zone (see ProfilingRecorder)
+ */
+void IOBase::profiledSetupImport()
+{
+    PROFILE_ZONE("io", QString("%0::setupImport").arg(metaObject()->className()), m_initialRequest.runname);
+    setupImport();
+}
+
+
+/**
+ * @brief IOBase::profiledImportStep calls importStep()
+ * within a profiling zone (see ProfilingRecorder)
+ * @param mrun
+ * @param fileInfos
+ */
+void IOBase::profiledImportStep(MRun *mrun, SignalFileInfoList fileInfos)
+{
+    PROFILE_ZONE("io", QString("%0::importStep").arg(metaObject()->className()), mrun->getName());
+    importStep(mrun, fileInfos);
+}
+
+
 /**
  * @brief IOBase::onImportStepFinished This slot is executed when a importStep() has been finished.
  * If all importStep-calls are done the final IOBase::importFinished() signal is emitted (back to SignalManager)
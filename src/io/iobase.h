@@ -94,6 +94,18 @@ class IOBase : public QObject
          */
         virtual void exportImplementation(const SignalIORequest & irq) = 0;
 
+        /**
+         * @brief setupExport This method is executed within the GUI thread before
+         * exportImplementation() is scheduled. Derived classes can take a snapshot
+         * of data here which must not be accessed concurrently to the GUI thread.
+         * @param irq
+         */
+        virtual void setupExport(const SignalIORequest & irq) { Q_UNUSED(irq) }
+
+        void profiledSetupImport();
+        void profiledImportStep(MRun* mrun, SignalFileInfoList fileInfos);
+        void profiledExportImplementation(const SignalIORequest & irq);
+
 
         /// @brief holds the signal io request which has been passed from gui
         SignalIORequest m_initialRequest;
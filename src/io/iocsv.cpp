@@ -4,8 +4,8 @@
 #include <QDirIterator>
 #include <QStack>
 #include <QStringList>
-#include <QThreadPool>
 #include "../core.h"
+#include "../general/taskscheduler.h"
 #include <iostream>
 #include "../signal/processing/processingchain.h"
 #include "../signal/processing/temperatureprocessingchain.h"
@@ -39,7 +39,7 @@ void IOcsv::setupImport()
         else
             throw LIISimException("IOcsv: cannot handle SignalIORequest: wrong IOtype!");
 
-        if(m_generatedRequests.size() > QThreadPool::globalInstance()->maxThreadCount())
+        if(m_generatedRequests.size() > TaskScheduler::instance()->laneLimit(TaskScheduler::IO))
             p_mode = PM_PERMRUN;
     }
     catch(LIISimException e)
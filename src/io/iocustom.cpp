@@ -8,6 +8,7 @@
 
 #include "../core.h"
 #include "../settings/mrunsettings.h"
+#include "numerictableparser.h"
 
 IOcustom::IOcustom(QObject *parent) :   IOBase(parent)
 {
@@ -795,153 +796,76 @@ int IOcustom::loadFromCustomFile(MRun *mRun, SignalFileInfo fi)
         return 0;
 
     QFile file(filename);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (file.open(QIODevice::ReadOnly))
     {
-        // first line: col description
-        QString line = file.readLine();
+        // read complete file at once, parsing is done in memory
+        QByteArray content = file.readAll();
+        file.close();
 
         // check file ...
-        if(line.isEmpty())
+        if(content.isEmpty())
         {
             emit importError(mRun->importRequest(), fi, "File empty");
             throw LIISimException("Custom-Import: empty file ("+filename+")", ERR_IO);
         }
 
-        // split by any whitespace
-        if(fi.delimiter == "tab")
-            fi.delimiter = "\\s+";
-
         // set time unit modifier
         double tmod = 1.0;
         if(fi.timeunit == "ns") tmod = 1E-9;
         else if(fi.timeunit == "µs") tmod = 1E-6;
         else if(fi.timeunit == "ms") tmod = 1E-3;
 
-        QStringList strings;
-        double t1, t2, dt;
-        int linecount = 0;
+        // time column + one column for each channel
+        NumericTableParser parser(noChannels + 1, fi.delimiter, fi.decimal);
+        parser.headerLines = fi.headerlines;
+        parser.autoHeader = fi.autoheader;
+
+        if(!parser.parse(content))
+            throw LIISimException("IOCustom: not enough cols ("+filename+")", ERR_IO);
+
         QVector<Signal> sig_raw;
         QVector<Signal> sig_abs;
 
         sig_raw.resize(noChannels);
         sig_abs.resize(noChannels);
 
-        // timebase
-        QString str = "^[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?";
-
-        // for each channel
         for(int i=0; i<noChannels; i++)
         {
-            str = str + "["
-                    + fi.delimiter
-                    + "]{1}"
-                    + "[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?";
+            sig_raw[i].channelID = i+1;
+            sig_raw[i].type = Signal::RAW;
+            sig_raw[i].data = parser.column(i+1);
+
+            // ABS = RAW
+            sig_abs[i].channelID = i+1;
+            sig_abs[i].type = Signal::ABS;
+            sig_abs[i].data = parser.column(i+1);
         }
-        // end of line
-        str = str + "\\s?$";
-
-        //line should match the following RegExp
-        QRegExp reg_exp = QRegExp(str);
-        //qDebug() << reg_exp.pattern();
 
-        int count_header = 0;
-
-        while (!file.atEnd())
+        if(parser.rowCount() > 1)
         {
-            // read line by line (first line is read already above/check for empty file)
-            if(linecount > 0)
-                line = file.readLine();
-
-            //skip header lines
-            if(linecount < fi.headerlines)
-            {
-                linecount++;
-                count_header++;
-                continue;
-            }
-
-            // workaround
-            line.replace("Infinity","0.0");
-
-            // removes whitespace and replace with single whitespace
-            line = line.simplified();
-
-            // replace comma by dot
-            if(fi.decimal == ",")
-                line.replace(',',".");
-
-            // auto detect header lines
-            if(fi.autoheader == true)
-            {
-                if(reg_exp.indexIn(line) == -1)
-                {                    
-                    //emit logMessage(fi.sfname +" - "+line);
-                    fi.headerlines++;
-                    linecount++;
-                    count_header++;
-                    continue;
-                }
-            }
-
-            // split line
-            strings = line.split(QRegExp(fi.delimiter));
-
-            if(strings.size() < noChannels+1)
-                throw LIISimException("IOCustom: not enough cols ("+filename+")", ERR_IO);
+            double t1 = parser.column(0).at(0)*tmod;
+            double t2 = parser.column(0).at(1)*tmod;
 
-            //do this for the first line after header
-            if(linecount == fi.headerlines)
-            {
-                t1 = strings.at(0).toDouble()*tmod;
-
-                for(int i=0; i<noChannels; i++)
-                {
-                    sig_raw[i].channelID = i+1;
-                    sig_raw[i].type = Signal::RAW;
-
-
-                    sig_abs[i].channelID = i+1;
-                    sig_abs[i].type = Signal::ABS;
-
-                }
-            }
-            else if(linecount == fi.headerlines+1)
-            {
-                t2 = strings.at(0).toDouble()*tmod;
+            // adjust dt to 0.1 ns precision
+            t1 = round(t1 * 1E10);
+            t1 = t1 *1E-10;
 
-                // adjust dt to 0.1 ns precision
-                t1 = round(t1 * 1E10);
-                t1 = t1 *1E-10;
+            t2 = round(t2 * 1E10);
+            t2 = t2 *1E-10;
 
-                t2 = round(t2 * 1E10);
-                t2 = t2 *1E-10;
+            double dt = round((t2-t1)*1E10);
+            dt = dt*1E-10;
 
-                dt = round((t2-t1)*1E10);
-                dt = dt*1E-10;
-
-                //qDebug() << QString::number(t2) << " - " << QString::number(t1) << " = " << QString::number(dt);
-
-                emit logMessage("IOCustom: Signal:" + filename + " calculated dt: " + QString::number(dt));
-
-                for(int i=0; i<noChannels; i++)
-                {
-                    sig_raw[i].dt = dt;
-                    sig_raw[i].start_time = t2;
-
-                    sig_abs[i].dt = dt;
-                    sig_abs[i].start_time = t2;
-                }
-            }
+            emit logMessage("IOCustom: Signal:" + filename + " calculated dt: " + QString::number(dt));
 
             for(int i=0; i<noChannels; i++)
             {
-                sig_raw[i].data.push_back(strings.at(i+1).toDouble());
-                // ABS = RAW
-                sig_abs[i].data.push_back(strings.at(i+1).toDouble());
-            }
+                sig_raw[i].dt = dt;
+                sig_raw[i].start_time = t2;
 
-            linecount++;
-            strings.clear();
+                sig_abs[i].dt = dt;
+                sig_abs[i].start_time = t2;
+            }
         }
 
         if(noChannels == 1)
@@ -987,7 +911,7 @@ int IOcustom::loadFromCustomFile(MRun *mRun, SignalFileInfo fi)
                 mp->setSignal(sig_abs[i],i+1,Signal::ABS);
             }
         }
-        //qDebug() << (fi.shortFilename() +" - ID("+QString::number(fi.signalId) + "): Header: removed " + QString::number(count_header) + " lines");
+        //qDebug() << (fi.shortFilename() +" - ID("+QString::number(fi.signalId) + "): Header: removed " + QString::number(parser.skippedLines()) + " lines");
         return 1; //number of imported signals
     }
     return 0;
@@ -3,12 +3,17 @@
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include <QFile>
+#include <QSaveFile>
 #include <QDateTime>
 #include <QDir>
+#include <QBuffer>
+#include <QFileInfo>
 
 #include "../core.h"
 #include "iocsv.h"
 #include "iocustom.h"
+#include "fitresultfile.h"
+#include "sessionautosaver.h"
 #include "../signal/mrungroup.h"
 #include "../signal/processing/processingchain.h"
 #include "../signal/processing/pluginfactory.h"
@@ -38,6 +43,7 @@ IOxml::IOxml(QObject *parent) :   IOBase(parent)
 
     mProgressCounter = 0;
     mRelativePaths = false;
+    mSaveRunSettings = true;
     mXMLfname = "";
 
 }
@@ -126,6 +132,9 @@ void IOxml::setupImport()
  */
 void IOxml::m_onImportSetupFinished()
 {
+    // observers are notified once after the session has been created
+    DataModelUpdateScope update(Core::instance()->dataModel());
+
     // read file in app thread to ease object creation !!!
     try
     {
@@ -216,7 +225,7 @@ void IOxml::m_onImportSetupFinished()
                 if(r.name() == "FitRun")
                 {
                     FitRun* fr = new FitRun();
-                    fr->readFromXml(r);
+                    fr->readFromXml(r, QFileInfo(mXMLfname).absolutePath());
                 }
             }
         }
@@ -323,6 +332,71 @@ void IOxml::m_onMrunLoadingStepFinished(MRun *mrun)
 }
 
 
+/**
+ * @brief IOxml::setupExport Implements IOBase::setupExport(), serializes
+ * the FitRuns within the GUI thread: iteration results may be loaded
+ * (FitRun::loadResults()) or appended by fitting workers concurrently.
+ * FitRuns which are currently fitted are not saved.
+ * Iteration results are written to binary sidecar files in background.
+ * @param rq SignalIORequest of XML-Session
+ */
+void IOxml::setupExport(const SignalIORequest &rq)
+{
+    mFitRunFragments.clear();
+    mFitRunFiles.clear();
+
+    // an auto-save may still write the same session and sidecar files
+    if(Core::instance()->getSessionAutoSaver())
+        Core::instance()->getSessionAutoSaver()->waitForPendingWrite();
+
+    if(!rq.userData.value(12,false).toBool())
+        return;
+
+    QString fname = rq.userData.value(0,"").toString();
+
+    QList<FitRun*> fitruns = Core::instance()->dataModel()->fitRuns();
+    for(int i = 0; i < fitruns.size(); i++)
+    {
+        if(fitruns[i]->isFitting())
+        {
+            MSG_WARN(QString("XML-Session Export: FitRun '%0' is not saved (fit still running)")
+                     .arg(fitruns[i]->name()));
+            continue;
+        }
+
+        // same file names as SessionAutoSaver
+        QString resultsFile = fitruns[i]->resultsFileName(fname);
+
+        QByteArray fragment;
+        QBuffer buffer(&fragment);
+        buffer.open(QIODevice::WriteOnly);
+        QXmlStreamWriter w(&buffer);
+        fitruns[i]->writeToXML(w, resultsFile);
+        buffer.close();
+
+        mFitRunFragments << fragment;
+        mFitRunFiles << resultsFile;
+    }
+}
+
+
+/**
+ * @brief IOxml::writeFragment copies a serialized XML element to the writer
+ * @param w
+ * @param fragment
+ */
+void IOxml::writeFragment(QXmlStreamWriter &w, const QByteArray &fragment)
+{
+    QXmlStreamReader r(fragment);
+    while(!r.atEnd())
+    {
+        r.readNext();
+        if(r.isStartElement() || r.isEndElement() || (r.isCharacters() && !r.isWhitespace()))
+            w.writeCurrentToken(r);
+    }
+}
+
+
 /**
  * @brief IOxml::exportImplementation Implementation of a XML-File Export.
  * Saves the current program session to a XML-File.
@@ -372,7 +446,8 @@ void IOxml::exportImplementation(const SignalIORequest &rq)
         pchainDirname.append("tmp/");
 
 
-        QFile xfile(mXMLfname);
+        // previous session file is kept until the new file is complete
+        QSaveFile xfile(mXMLfname);
         if(!xfile.open(QIODevice::WriteOnly) )
         {
             throw LIISimException( QString("IOxml: cannot write " )
@@ -407,9 +482,23 @@ void IOxml::exportImplementation(const SignalIORequest &rq)
             }
         }
 
-        // TODO: SAVE FITRUNS HERE
+        // fit runs: serialized within GUI thread (see setupExport())
+        if(saveData)
+        {
+            for(int i = 0; i < mFitRunFragments.size(); i++)
+                writeFragment(w, mFitRunFragments.at(i));
+        }
 
         w.writeEndElement(); // LIISim
+
+        if(w.hasError() || !xfile.commit())
+        {
+            throw LIISimException( QString("IOxml: cannot write " )
+                 .append(mXMLfname),ERR_IO);
+        }
+
+        if(saveData)
+            FitResultFile::removeUnreferenced(mXMLfname, mFitRunFiles);
     }
     catch(LIISimException e)
     {
@@ -426,6 +515,50 @@ void IOxml::checkFiles()
 }
 
 
+/**
+ * @brief IOxml::setSessionFile sets the session file used by mrunToXML()
+ * (paths of signal files are stored relative to this file)
+ * @param fname session file
+ * @param relativePaths
+ */
+void IOxml::setSessionFile(const QString &fname, bool relativePaths)
+{
+    mXMLfname = fname;
+    mRelativePaths = relativePaths;
+}
+
+
+/**
+ * @brief IOxml::setSaveRunSettings defines if the run settings files are
+ * (over)written when a run is written to XML (default: true, see GuiSettings 'rundetails/overwrite')
+ * @param save
+ */
+void IOxml::setSaveRunSettings(bool save)
+{
+    mSaveRunSettings = save;
+}
+
+
+/**
+ * @brief IOxml::mrunToXML writes the 'MRun' token of a run to a XML fragment
+ * (used by SessionAutoSaver)
+ * @param m MRun
+ * @return XML fragment
+ */
+QByteArray IOxml::mrunToXML(MRun *m)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    QXmlStreamWriter w(&buffer);
+    w.setAutoFormatting(true);
+    writeMRun(w, m);
+
+    return data;
+}
+
+
 /**
  * @brief IOxml::writeGroup Helper method for XML-Session Export, writes 'Group' token
  * @param w QXmlStreamWriter
@@ -513,7 +646,7 @@ void IOxml::writeMRun(QXmlStreamWriter &w, MRun *m)
         xdir = mXMLfname;
 
     // save run settings if enabled
-    if(Core::instance()->guiSettings->value("rundetails","overwrite","true").toBool())
+    if(mSaveRunSettings && Core::instance()->guiSettings->value("rundetails","overwrite","true").toBool())
     {
 
         // check if a runsettings file exists
@@ -785,6 +918,13 @@ void IOxml::readProcessingPlugin(QXmlStreamReader &r, ProcessingChain* parentCha
 
     ProcessingPluginInputList l0 = p->getInputs();
 
+    // inputs which are not part of older files keep the previous behavior
+    for(int j=0; j < l0.size(); j++)
+    {
+        if(l0.at(j).legacyValue.isValid())
+            l0[j].value = l0.at(j).legacyValue;
+    }
+
     for(int j=0; j < l.size(); j++)
     {
         l0.setValue(l.at(j).identifier, l.at(j).value);
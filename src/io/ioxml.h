@@ -6,6 +6,7 @@
 #include <QVector>
 #include <QList>
 #include <QMap>
+#include <QStringList>
 
 class ProcessingPluginConnector;
 
@@ -33,10 +34,16 @@ public:
 
     void checkFiles();
 
+    void setSessionFile(const QString &fname, bool relativePaths);
+    void setSaveRunSettings(bool save);
+    QByteArray mrunToXML(MRun *m);
+
 protected:
 
     // implementation of abstract IOBase methods
 
+    void setupExport(const SignalIORequest & rq);
+
     void setupImport();
 
     void importStep(MRun* mrun, SignalFileInfoList  fileInfos);
@@ -45,11 +52,17 @@ private:
 
     int mProgressCounter;
     bool mRelativePaths;
+    bool mSaveRunSettings;
     QString mXMLfname;
     QList<ProcessingPluginConnector*> initGlobalPPCs;
 
     QMap<int,ProcessingPluginConnector*> readPlugConnectorsMap;
 
+    /** @brief XML of each FitRun, serialized within GUI thread (see setupExport()) */
+    QList<QByteArray> mFitRunFragments;
+    /** @brief sidecar files referenced by mFitRunFragments */
+    QStringList mFitRunFiles;
+
     // private helpers
 
     void writeGroup(QXmlStreamWriter& w, MRunGroup* g, QList<MRun *>& checkedRuns);
@@ -63,6 +76,8 @@ private:
 
     void readProcessingPlugin(QXmlStreamReader& r, ProcessingChain *parentChain);
 
+    void writeFragment(QXmlStreamWriter& w, const QByteArray& fragment);
+
     QList<ProcessingPluginConnector*> findGlobalPPCs();
     void deleteAllProcessingSteps();
     void deleteAllRuns();
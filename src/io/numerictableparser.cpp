@@ -0,0 +1,424 @@
+#include "numerictableparser.h"
+
+#include <cstring>
+#include <QList>
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrent/qtconcurrentrun.h>
+
+
+// exactly representable powers of ten (used for fast number conversion)
+static const double pow10Table[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+
+/**
+ * @brief NumericTableParser::NumericTableParser Constructor
+ * @param noColumns number of columns which should be read (time + channels)
+ * @param delimiter column delimiter (single character or "tab"/"\\s+" for any whitespace)
+ * @param decimal decimal mark
+ */
+NumericTableParser::NumericTableParser(int noColumns, const QString &delimiter, const QString &decimal)
+{
+    m_noColumns = noColumns;
+
+    m_whitespaceDelimiter = (delimiter == "tab" || delimiter == "\\s+"
+                             || delimiter == " " || delimiter.isEmpty());
+    m_delimiter = m_whitespaceDelimiter ? ' ' : delimiter.at(0).toLatin1();
+    m_decimal = decimal.isEmpty() ? '.' : decimal.at(0).toLatin1();
+
+    headerLines = 0;
+    autoHeader = false;
+
+    m_data = 0;
+    m_size = 0;
+    m_rows = 0;
+    m_skippedLines = 0;
+    m_errorLine = -1;
+}
+
+
+/**
+ * @brief NumericTableParser::parse parses the complete table
+ * @param buffer file content
+ * @return false if a row has not enough columns (see errorLine())
+ */
+bool NumericTableParser::parse(const QByteArray &buffer)
+{
+    m_data = buffer.constData();
+    m_size = buffer.size();
+    m_rows = 0;
+    m_errorLine = -1;
+
+    splitLines();
+
+    int noLines = m_lineStarts.size();
+    int first = qMin(qMax(headerLines, 0), noLines);
+
+    // header detection: skip lines until the first valid row
+    if(autoHeader)
+    {
+        QVector<double> values(m_noColumns);
+        while(first < noLines
+              && !parseRow(m_data + m_lineStarts.at(first), m_data + lineEnd(first), values.data(), true))
+            first++;
+    }
+
+    int bodyLines = noLines - first;
+
+    // allocate column buffers for all body lines,
+    // chunks write their rows at their line offset
+    m_columns.resize(m_noColumns);
+    m_columnPtr.resize(m_noColumns);
+    for(int c = 0; c < m_noColumns; c++)
+    {
+        m_columns[c].resize(bodyLines);
+        m_columnPtr[c] = m_columns[c].data();
+    }
+
+    int noChunks = qBound(1, bodyLines / minChunkLines, QThread::idealThreadCount());
+
+    QVector<Chunk> chunks(noChunks);
+    for(int k = 0; k < noChunks; k++)
+    {
+        chunks[k].firstLine = first + int(qint64(bodyLines) * k / noChunks);
+        chunks[k].lastLine  = first + int(qint64(bodyLines) * (k+1) / noChunks) - 1;
+        chunks[k].rows = 0;
+        chunks[k].errorLine = -1;
+    }
+
+    if(noChunks == 1)
+    {
+        parseChunk(&chunks[0], 0);
+    }
+    else
+    {
+        QList<QFuture<void>> futures;
+        for(int k = 0; k < noChunks; k++)
+            futures << QtConcurrent::run(this, &NumericTableParser::parseChunk,
+                                         &chunks[k], chunks[k].firstLine - first);
+
+        for(int k = 0; k < futures.size(); k++)
+            futures[k].waitForFinished();
+    }
+
+    for(int k = 0; k < noChunks; k++)
+    {
+        if(chunks.at(k).errorLine != -1)
+        {
+            m_errorLine = chunks.at(k).errorLine;
+            return false;
+        }
+    }
+
+    // remove gaps of skipped lines between chunks
+    int rows = 0;
+    for(int k = 0; k < noChunks; k++)
+    {
+        int offset = chunks.at(k).firstLine - first;
+        if(offset != rows && chunks.at(k).rows > 0)
+        {
+            for(int c = 0; c < m_noColumns; c++)
+                memmove(m_columnPtr[c] + rows, m_columnPtr[c] + offset, chunks.at(k).rows * sizeof(double));
+        }
+        rows += chunks.at(k).rows;
+    }
+
+    for(int c = 0; c < m_noColumns; c++)
+        m_columns[c].resize(rows);
+
+    m_rows = rows;
+    m_skippedLines = noLines - rows;
+
+    return true;
+}
+
+
+/**
+ * @brief NumericTableParser::splitLines determines the start offset of all lines
+ */
+void NumericTableParser::splitLines()
+{
+    m_lineStarts.clear();
+
+    if(m_size == 0)
+        return;
+
+    m_lineStarts.reserve(m_size / 16);
+    m_lineStarts.append(0);
+
+    const char* p = m_data;
+    const char* end = m_data + m_size;
+    while((p = static_cast<const char*>(memchr(p, '\n', end - p))) != 0)
+    {
+        p++;
+        if(p == end)
+            break;
+        m_lineStarts.append(int(p - m_data));
+    }
+}
+
+
+/**
+ * @brief NumericTableParser::lineEnd
+ * @param line line index
+ * @return offset of line end (without line break)
+ */
+int NumericTableParser::lineEnd(int line) const
+{
+    int end = (line + 1 < m_lineStarts.size()) ? m_lineStarts.at(line + 1) : m_size;
+    if(end > m_lineStarts.at(line) && m_data[end - 1] == '\n')
+        end--;
+    return end;
+}
+
+
+/**
+ * @brief NumericTableParser::parseChunk parses a range of lines.
+ * This method is executed concurrently, it only writes to the
+ * column buffer range starting at rowOffset and to the chunk.
+ * @param chunk line range
+ * @param rowOffset first row index in column buffers
+ */
+void NumericTableParser::parseChunk(Chunk *chunk, int rowOffset)
+{
+    QVector<double> values(m_noColumns);
+    double* v = values.data();
+    int rows = 0;
+
+    for(int line = chunk->firstLine; line <= chunk->lastLine; line++)
+    {
+        if(!parseRow(m_data + m_lineStarts.at(line), m_data + lineEnd(line), v, autoHeader))
+        {
+            if(autoHeader)
+                continue;
+
+            chunk->errorLine = line;
+            break;
+        }
+
+        for(int c = 0; c < m_noColumns; c++)
+            m_columnPtr[c][rowOffset + rows] = v[c];
+        rows++;
+    }
+    chunk->rows = rows;
+}
+
+
+/**
+ * @brief NumericTableParser::parseRow splits a line into tokens and converts the first
+ * columnCount() tokens
+ * @param begin line start
+ * @param end line end
+ * @param values output (columnCount() values)
+ * @param strict true: row must consist of exactly columnCount() valid numbers,
+ * false: row needs at least columnCount() tokens, invalid numbers are read as 0.0
+ * @return true if row is valid
+ */
+bool NumericTableParser::parseRow(const char *begin, const char *end, double *values, bool strict) const
+{
+    const char* p = begin;
+    int col = 0;
+
+    while(true)
+    {
+        const char* tb;
+        const char* te;
+
+        if(m_whitespaceDelimiter)
+        {
+            while(p < end && isSpace(*p))
+                p++;
+            if(p == end)
+                break;
+            tb = p;
+            while(p < end && !isSpace(*p))
+                p++;
+            te = p;
+        }
+        else
+        {
+            tb = p;
+            while(p < end && *p != m_delimiter)
+                p++;
+            te = p;
+            // trim token
+            while(tb < te && isSpace(*tb))
+                tb++;
+            while(te > tb && isSpace(*(te-1)))
+                te--;
+        }
+
+        if(col < m_noColumns)
+        {
+            double v;
+            if(!parseNumber(tb, te, v))
+            {
+                if(strict)
+                    return false;
+
+                // same behavior as QString::toDouble(): 0.0 if conversion fails
+                QByteArray token(tb, int(te - tb));
+                if(m_decimal != '.')
+                    token.replace(m_decimal, '.');
+                v = token.toDouble();
+            }
+            values[col] = v;
+        }
+        else if(strict)
+            return false;
+
+        col++;
+
+        if(!strict && col == m_noColumns)
+            return true;
+
+        if(!m_whitespaceDelimiter)
+        {
+            if(p == end)
+                break;
+            p++; // skip delimiter
+        }
+    }
+
+    return col == m_noColumns || (!strict && col > m_noColumns);
+}
+
+
+/**
+ * @brief NumericTableParser::parseNumber converts a token of the format
+ * [-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)? to double (or 'Infinity', which is read as 0.0).
+ * Values with up to 15 significant digits and a decimal exponent up to 22 are converted exactly
+ * by a single floating point operation, others are converted by QByteArray::toDouble().
+ * @param begin token start
+ * @param end token end
+ * @param value result
+ * @return false if the token is not a valid number
+ */
+bool NumericTableParser::parseNumber(const char *begin, const char *end, double &value) const
+{
+    const char* p = begin;
+
+    if(p == end)
+        return false;
+
+    bool negative = false;
+    if(*p == '-' || *p == '+')
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // workaround: "Infinity" is replaced by 0.0
+    if(end - p == 8 && memcmp(p, "Infinity", 8) == 0)
+    {
+        value = negative ? -0.0 : 0.0;
+        return true;
+    }
+
+    quint64 mantissa = 0;
+    int sigDigits = 0;
+    int exp10 = 0;
+    int intDigits = 0;
+    int fracDigits = 0;
+
+    while(p < end && isDigit(*p))
+    {
+        if(sigDigits < 19)
+        {
+            mantissa = mantissa * 10 + quint64(*p - '0');
+            if(mantissa > 0)
+                sigDigits++;
+        }
+        else
+            exp10++;
+        intDigits++;
+        p++;
+    }
+
+    bool hasDecimal = false;
+    if(p < end && (*p == '.' || *p == m_decimal))
+    {
+        hasDecimal = true;
+        p++;
+        while(p < end && isDigit(*p))
+        {
+            if(sigDigits < 19)
+            {
+                mantissa = mantissa * 10 + quint64(*p - '0');
+                if(mantissa > 0)
+                    sigDigits++;
+                exp10--;
+            }
+            fracDigits++;
+            p++;
+        }
+    }
+
+    if((hasDecimal && fracDigits == 0) || (!hasDecimal && intDigits == 0))
+        return false;
+
+    if(p < end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool expNegative = false;
+        if(p < end && (*p == '-' || *p == '+'))
+        {
+            expNegative = (*p == '-');
+            p++;
+        }
+        if(p == end || !isDigit(*p))
+            return false;
+
+        int e = 0;
+        while(p < end && isDigit(*p))
+        {
+            if(e < 100000)
+                e = e * 10 + (*p - '0');
+            p++;
+        }
+        exp10 += expNegative ? -e : e;
+    }
+
+    if(p != end)
+        return false;
+
+    if(mantissa == 0)
+    {
+        value = negative ? -0.0 : 0.0;
+        return true;
+    }
+
+    if(sigDigits <= 15 && exp10 >= -22 && exp10 <= 22)
+    {
+        double m = double(mantissa);
+        value = exp10 < 0 ? m / pow10Table[-exp10] : m * pow10Table[exp10];
+    }
+    else
+    {
+        QByteArray token(begin, int(end - begin));
+        if(m_decimal != '.')
+            token.replace(m_decimal, '.');
+        value = token.toDouble();
+        return true;
+    }
+
+    if(negative)
+        value = -value;
+
+    return true;
+}
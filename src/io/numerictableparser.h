@@ -0,0 +1,89 @@
+#ifndef NUMERICTABLEPARSER_H
+#define NUMERICTABLEPARSER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The NumericTableParser class is a tokenizer for numeric
+ * text tables (one row per line, whitespace or character delimited columns)
+ * as used by IOcustom.
+ * @details The header is detected once from the first lines, afterwards
+ * the table body is split into line-aligned chunks which are parsed
+ * in parallel directly into per-column buffers. Numbers are parsed
+ * without regular expressions and independent of the system locale.
+ *
+ * Row semantics (compatible with the previous QRegExp-based import):
+ * - autoHeader disabled: the first headerLines lines are skipped, every
+ *   following line needs at least noColumns tokens (parse() fails otherwise),
+ *   unparsable tokens are read as 0.0
+ * - autoHeader enabled: lines which do not consist of exactly noColumns
+ *   numeric tokens are skipped (header lines and empty lines)
+ * - "Infinity" is read as 0.0
+ */
+class NumericTableParser
+{
+public:
+    NumericTableParser(int noColumns, const QString & delimiter, const QString & decimal);
+
+    /** @brief number of lines which are skipped at file start */
+    int headerLines;
+
+    /** @brief skip all lines which are not valid numeric rows */
+    bool autoHeader;
+
+    bool parse(const QByteArray & buffer);
+
+    inline int rowCount() const { return m_rows; }
+    inline int columnCount() const { return m_noColumns; }
+    inline const QVector<double> & column(int idx) const { return m_columns.at(idx); }
+
+    /** @brief number of lines which have been skipped (header) */
+    inline int skippedLines() const { return m_skippedLines; }
+
+    /** @brief index of first line with too few columns (if parse() failed) */
+    inline int errorLine() const { return m_errorLine; }
+
+    /** @brief minimal number of lines per parallel chunk */
+    static const int minChunkLines = 16384;
+
+private:
+
+    struct Chunk
+    {
+        int firstLine;  // index of first line in m_lineStarts
+        int lastLine;   // index of last line (inclusive)
+        int rows;       // number of parsed rows
+        int errorLine;  // line number of first invalid row (-1: no error)
+    };
+
+    int m_noColumns;
+
+    /** @brief true: columns are separated by any whitespace */
+    bool m_whitespaceDelimiter;
+    char m_delimiter;
+    char m_decimal;
+
+    const char* m_data;
+    int m_size;
+
+    /** @brief offset of each line start within buffer */
+    QVector<int> m_lineStarts;
+
+    QVector<QVector<double>> m_columns;
+    QVector<double*> m_columnPtr;
+
+    int m_rows;
+    int m_skippedLines;
+    int m_errorLine;
+
+    void splitLines();
+    int lineEnd(int line) const;
+
+    void parseChunk(Chunk *chunk, int rowOffset);
+    bool parseRow(const char *begin, const char *end, double *values, bool strict) const;
+    bool parseNumber(const char *begin, const char *end, double &value) const;
+};
+
+#endif // NUMERICTABLEPARSER_H
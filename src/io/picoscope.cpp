@@ -120,9 +120,16 @@ bool PicoScope::internalOpen()
 }
 
 
-void PicoScope::getRun(MRun *run, bool averageCaptures, bool calculateStdev)
+/**
+ * @brief PicoScope::getRun fetches the captures of the last block run (asynchronous, see processingFinished())
+ * @param run
+ * @param averageCaptures store the average of all captures
+ * @param calculateStdev calculate standard deviation over all captures
+ * @param compactRaw store single captures as ADC counts (see CompactSignal)
+ */
+void PicoScope::getRun(MRun *run, bool averageCaptures, bool calculateStdev, bool compactRaw)
 {
-    QFuture<void> future = QtConcurrent::run(this, &PicoScope::blockWorker, run, averageCaptures, calculateStdev);
+    QFuture<void> future = QtConcurrent::run(this, &PicoScope::blockWorker, run, averageCaptures, calculateStdev, compactRaw);
 }
 
 
@@ -806,6 +813,9 @@ void PicoScope::handleStreamingReady(PICO_STATUS status)
         return;
     }
 
+    if(recorder.isRecording())
+        recordStreamingFrame(samplesInOut);
+
     if(circularBufferChannelA.capacity() != settings->getAveragingBufferSize())
     {
         circularBufferChannelA.set_capacity(settings->getAveragingBufferSize());
@@ -1081,7 +1091,155 @@ void PicoScope::streamingWorker()
 }
 
 
-void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev)
+/**
+ * @brief The CaptureStatistics struct holds the per-sample statistics
+ * over all captures (rapid block mode) of a single channel
+ */
+struct CaptureStatistics
+{
+    /** @brief samples per tile (sums of a tile fit into L1 cache) */
+    static const uint32_t tileSize = 1024;
+
+    int16_t **buffer = 0;
+    uint32_t captures = 0;
+    uint32_t samples = 0;
+    /** @brief [counts/V] */
+    double rangeFactor = 1.0;
+    bool calcMean = false;
+    bool calcStdev = false;
+
+    /** @brief result: mean [V] */
+    QVector<double> mean;
+    /** @brief result: standard deviation [V] */
+    QVector<double> stdev;
+
+    void calculate();
+};
+
+
+/**
+ * @brief convertCounts converts raw ADC counts to volts
+ * @param counts
+ * @param samples
+ * @param rangeFactor [counts/V]
+ * @param result is resized to samples
+ */
+static void convertCounts(const int16_t *counts, uint32_t samples, double rangeFactor, QVector<double> &result)
+{
+    result.resize(int(samples));
+    double *values = result.data();
+    const double factor = 1.0 / rangeFactor;
+    for(uint32_t j = 0; j < samples; j++)
+        values[j] = counts[j] * factor;
+}
+
+
+/**
+ * @brief setCaptureSignal stores a single capture as raw and absolute signal
+ * @param mp
+ * @param signal signal meta data (dt, start time, stdev, ...)
+ * @param channelID
+ * @param counts raw ADC counts
+ * @param samples
+ * @param rangeFactor [counts/V]
+ * @param compact keep ADC counts (CompactSignal, shared by raw and absolute signal)
+ */
+static void setCaptureSignal(MPoint *mp, Signal &signal, int channelID, const int16_t *counts,
+                             uint32_t samples, double rangeFactor, bool compact)
+{
+    if(compact)
+    {
+        CompactSignal compactSignal(counts, int(samples), 1.0 / rangeFactor);
+
+        signal.type = Signal::RAW;
+        mp->setSignalCounts(signal, compactSignal, channelID, Signal::RAW);
+
+        signal.type = Signal::ABS;
+        mp->setSignalCounts(signal, compactSignal, channelID, Signal::ABS);
+        return;
+    }
+
+    convertCounts(counts, samples, rangeFactor, signal.data);
+
+    signal.type = Signal::RAW;
+    mp->setSignal(signal, channelID, Signal::RAW);
+
+    signal.type = Signal::ABS;
+    mp->setSignal(signal, channelID, Signal::ABS);
+}
+
+
+/**
+ * @brief CaptureStatistics::calculate calculates mean and standard deviation
+ * of each sample over all captures in one pass.
+ * @details The capture buffers are processed in tiles of tileSize samples:
+ * for each tile, all captures are read sequentially (contiguous memory) and
+ * the deviations from the first capture are accumulated as integers
+ * (shifted data algorithm: exact sums, no cancellation for signals with large offset).
+ */
+void CaptureStatistics::calculate()
+{
+    if(calcMean)
+        mean.resize(int(samples));
+    if(calcStdev)
+        stdev.resize(int(samples));
+
+    if(captures == 0)
+        return;
+
+    const double N = captures;
+    const uint32_t tile = tileSize;
+
+    qint64 sum[tileSize];
+    qint64 sum2[tileSize];
+
+    for(uint32_t t0 = 0; t0 < samples; t0 += tile)
+    {
+        const uint32_t n = qMin(tile, samples - t0);
+        const int16_t *ref = buffer[0] + t0;
+
+        memset(sum, 0, n * sizeof(qint64));
+        memset(sum2, 0, n * sizeof(qint64));
+
+        // capture 0 is the reference (deviation 0)
+        for(uint32_t j = 1; j < captures; j++)
+        {
+            const int16_t *x = buffer[j] + t0;
+
+            if(calcStdev)
+            {
+                for(uint32_t i = 0; i < n; i++)
+                {
+                    const qint64 d = int32_t(x[i]) - int32_t(ref[i]);
+                    sum[i] += d;
+                    sum2[i] += d * d;
+                }
+            }
+            else
+            {
+                for(uint32_t i = 0; i < n; i++)
+                    sum[i] += int32_t(x[i]) - int32_t(ref[i]);
+            }
+        }
+
+        for(uint32_t i = 0; i < n; i++)
+        {
+            const double s = double(sum[i]);
+
+            if(calcMean)
+                mean[t0 + i] = (ref[i] + s / N) / rangeFactor;
+
+            if(calcStdev)
+            {
+                double var = captures > 1 ? (double(sum2[i]) - s * s / N) / (N - 1.0) : 0.0;
+                stdev[t0 + i] = sqrt(qMax(0.0, var)) / rangeFactor;
+            }
+        }
+    }
+}
+
+
+void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev, bool compactRaw)
 {
     isProcessing(true);
     PICO_STATUS status;
@@ -1160,65 +1318,40 @@ void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev
         return;
     }
 
-    //calculate standard deviation
+    // mean (average mode) and standard deviation over all captures, channels in parallel
     QVector<double> stdevA;
     QVector<double> stdevB;
     QVector<double> stdevC;
     QVector<double> stdevD;
 
-    if(calculateStdev)
-    {
-        for(int i = 0; i < samplesInOut; i++)
-        {
-            //channel A
-            if(settings->channel(PSChannel::A))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::A));
-
-                StandardDeviation stdev;
-
-                for(int j = 0; j < settings->captures(); j++)
-                    stdev.addValue(bufferA[j][i] / rangeFactor);
-
-                stdevA.push_back(stdev.getStandardDeviation());
-            }
-
-            if(settings->channel(PSChannel::B))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::B));
+    CaptureStatistics statistics[4];
 
-                StandardDeviation stdev;
-
-                for(int j = 0; j < settings->captures(); j++)
-                    stdev.addValue(bufferB[j][i] / rangeFactor);
-
-                stdevB.push_back(stdev.getStandardDeviation());
-            }
-
-            if(settings->channel(PSChannel::C))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::C));
-
-                StandardDeviation stdev;
-
-                for(int j = 0; j < settings->captures(); j++)
-                    stdev.addValue(bufferC[j][i] / rangeFactor);
-
-                stdevC.push_back(stdev.getStandardDeviation());
-            }
-
-            if(settings->channel(PSChannel::D))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::D));
+    if(averageCaptures || calculateStdev)
+    {
+        PSChannel psChannels[4] = { PSChannel::A, PSChannel::B, PSChannel::C, PSChannel::D };
+        int16_t **buffers[4] = { bufferA, bufferB, bufferC, bufferD };
 
-                StandardDeviation stdev;
+        QList<CaptureStatistics*> jobs;
+        for(int c = 0; c < 4; c++)
+        {
+            if(!settings->channel(psChannels[c]))
+                continue;
+
+            statistics[c].buffer = buffers[c];
+            statistics[c].captures = settings->captures();
+            statistics[c].samples = samplesInOut;
+            statistics[c].rangeFactor = getRangeFactor(settings->range(psChannels[c]));
+            statistics[c].calcMean = averageCaptures;
+            statistics[c].calcStdev = calculateStdev;
+            jobs.append(&statistics[c]);
+        }
 
-                for(int j = 0; j < settings->captures(); j++)
-                    stdev.addValue(bufferD[j][i] / rangeFactor);
+        QtConcurrent::blockingMap(jobs, [](CaptureStatistics *job) { job->calculate(); });
 
-                stdevD.push_back(stdev.getStandardDeviation());
-            }
-        }
+        stdevA = statistics[0].stdev;
+        stdevB = statistics[1].stdev;
+        stdevC = statistics[2].stdev;
+        stdevD = statistics[3].stdev;
     }
 
     /***************
@@ -1231,72 +1364,14 @@ void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev
         Signal signalChannelC(0, (double)settings->timeInterval() * pow(10, -9), 0);
         Signal signalChannelD(0, (double)settings->timeInterval() * pow(10, -9), 0);
 
-        for(unsigned int i = 0; i < settings->captures(); i++)
-        {
-            if(settings->channel(PSChannel::A))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::A));
-                bool vectorIsEmpty = signalChannelA.data.isEmpty();
-
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    if(vectorIsEmpty)
-                        signalChannelA.data.append((bufferA[i][j] / rangeFactor) / settings->captures());
-                    else if(j < signalChannelA.data.size())
-                        signalChannelA.data.replace(j, signalChannelA.data[j] + ((bufferA[i][j] / rangeFactor) / settings->captures()));
-                }
-
-                signalChannelA.stdev = stdevA;
-            }
-
-            if(settings->channel(PSChannel::B))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::B));
-                bool vectorIsEmpty = signalChannelB.data.isEmpty();
-
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    if(vectorIsEmpty)
-                        signalChannelB.data.append((bufferB[i][j] / rangeFactor) / settings->captures());
-                    else if(j < signalChannelB.data.size())
-                        signalChannelB.data.replace(j, signalChannelB.data[j] + ((bufferB[i][j] / rangeFactor) / settings->captures()));
-                }
-
-                signalChannelB.stdev = stdevB;
-            }
-
-            if(settings->channel(PSChannel::C))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::C));
-                bool vectorIsEmpty = signalChannelC.data.isEmpty();
-
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    if(vectorIsEmpty)
-                        signalChannelC.data.append((bufferC[i][j] / rangeFactor) / settings->captures());
-                    else if(j < signalChannelC.data.size())
-                        signalChannelC.data.replace(j, signalChannelC.data[j] + ((bufferC[i][j] / rangeFactor) / settings->captures()));
-                }
-
-                signalChannelC.stdev = stdevC;
-            }
-
-            if(settings->channel(PSChannel::D))
-            {
-                double rangeFactor = getRangeFactor(settings->range(PSChannel::D));
-                bool vectorIsEmpty = signalChannelD.data.isEmpty();
-
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    if(vectorIsEmpty)
-                        signalChannelD.data.append((bufferD[i][j] / rangeFactor) / settings->captures());
-                    else if(j < signalChannelD.data.size())
-                        signalChannelD.data.replace(j, signalChannelD.data[j] + ((bufferD[i][j] / rangeFactor) / settings->captures()));
-                }
-
-                signalChannelD.stdev = stdevD;
-            }
-        }
+        signalChannelA.data = statistics[0].mean;
+        signalChannelA.stdev = stdevA;
+        signalChannelB.data = statistics[1].mean;
+        signalChannelB.stdev = stdevB;
+        signalChannelC.data = statistics[2].mean;
+        signalChannelC.stdev = stdevC;
+        signalChannelD.data = statistics[3].mean;
+        signalChannelD.stdev = stdevD;
 
         MPoint *mp = run->getCreatePre(0);
         int channelCounter = 1;
@@ -1395,14 +1470,7 @@ void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev
 
                 double rangeFactor = getRangeFactor(settings->range(PSChannel::A));
 
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    signal.data.append(bufferA[i][j] / rangeFactor);
-                }
-                mp->setSignal(signal, channelCounter, Signal::RAW);
-
-                signal.type = Signal::ABS;
-                mp->setSignal(signal, channelCounter, Signal::ABS);
+                setCaptureSignal(mp, signal, channelCounter, bufferA[i], samplesInOut, rangeFactor, compactRaw);
 
                 channelCounter++;
             }
@@ -1423,14 +1491,7 @@ void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev
 
                 double rangeFactor = getRangeFactor(settings->range(PSChannel::B));
 
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    signal.data.append(bufferB[i][j] / rangeFactor);
-                }
-                mp->setSignal(signal, channelCounter, Signal::RAW);
-
-                signal.type = Signal::ABS;
-                mp->setSignal(signal, channelCounter, Signal::ABS);
+                setCaptureSignal(mp, signal, channelCounter, bufferB[i], samplesInOut, rangeFactor, compactRaw);
 
                 channelCounter++;
             }
@@ -1451,14 +1512,7 @@ void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev
 
                 double rangeFactor = getRangeFactor(settings->range(PSChannel::C));
 
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    signal.data.append(bufferC[i][j] / rangeFactor);
-                }
-                mp->setSignal(signal, channelCounter, Signal::RAW);
-
-                signal.type = Signal::ABS;
-                mp->setSignal(signal, channelCounter, Signal::ABS);
+                setCaptureSignal(mp, signal, channelCounter, bufferC[i], samplesInOut, rangeFactor, compactRaw);
 
                 channelCounter++;
             }
@@ -1479,14 +1533,7 @@ void PicoScope::blockWorker(MRun *run, bool averageCaptures, bool calculateStdev
 
                 double rangeFactor = getRangeFactor(settings->range(PSChannel::D));
 
-                for(unsigned int j = 0; j < samplesInOut; j++)
-                {
-                    signal.data.append(bufferD[i][j] / rangeFactor);
-                }
-                mp->setSignal(signal, channelCounter, Signal::RAW);
-
-                signal.type = Signal::ABS;
-                mp->setSignal(signal, channelCounter, Signal::ABS);
+                setCaptureSignal(mp, signal, channelCounter, bufferD[i], samplesInOut, rangeFactor, compactRaw);
             }
         }
 
@@ -1864,6 +1911,36 @@ void PicoScope::getStreamBufferContent(MRun *run, bool asAverage)
 }
 
 
+/**
+ * @brief PicoScope::recordStreamingFrame passes the raw ADC counts of the
+ * current streaming frame and the channel settings to the StreamRecorder
+ * @param samples number of samples per channel
+ */
+void PicoScope::recordStreamingFrame(uint32_t samples)
+{
+    int16_t* channels[4] = { bufferA[0], bufferB[0], bufferC[0], bufferD[0] };
+    PSChannel psChannels[4] = { PSChannel::A, PSChannel::B, PSChannel::C, PSChannel::D };
+
+    quint32 channelMask = 0;
+    double range[4];
+    double rangeFactor[4];
+    double offset[4];
+
+    for(int c = 0; c < 4; c++)
+    {
+        if(settings->channel(psChannels[c]))
+            channelMask |= (1u << c);
+        range[c] = PicoScopeCommon::PSRangeToDouble(settings->range(psChannels[c]));
+        rangeFactor[c] = getRangeFactor(settings->range(psChannels[c]));
+        offset[c] = settings->offset(psChannels[c]);
+    }
+
+    recorder.appendFrame(channels, channelMask, samples,
+                         (double)settings->timeInterval() * pow(10, -9),
+                         range, rangeFactor, offset);
+}
+
+
 QString PicoScope::picoStatusAsString(PICO_STATUS status)
 {
     switch(status)
@@ -10,6 +10,7 @@
 #include "../signal/signal.h"
 #include "../signal/mrun.h"
 #include "../signal/streampoint.h"
+#include "streamrecorder.h"
 
 #include "../externalLibraries/picoscope6000/include/ps6000Api.h"
 #include <externalLibraries/boost/boost/circular_buffer.hpp>
@@ -49,7 +50,7 @@ public:
     void close();
 
     bool run();
-    void getRun(MRun *run, bool averageCaptures, bool calculateStdev);
+    void getRun(MRun *run, bool averageCaptures, bool calculateStdev, bool compactRaw = false);
 
     bool isOpen();
     bool isStreaming();
@@ -71,6 +72,9 @@ public:
 
     void getStreamBufferContent(MRun *run, bool asAverage);
 
+    /** @brief writes all streaming frames to disk while recording */
+    inline StreamRecorder* streamRecorder() { return &recorder; }
+
     /* for testing purpose */
     void streamingTest(bool start = true);
 
@@ -148,7 +152,7 @@ private:
     QString lastError;
 
     void streamingWorker();
-    void blockWorker(MRun *run, bool averageCaptures, bool calculateStdev);
+    void blockWorker(MRun *run, bool averageCaptures, bool calculateStdev, bool compactRaw);
 
     double getRangeFactor(PSRange range);
     PS6000_COUPLING getCoupling(PSCoupling coupling);
@@ -156,6 +160,10 @@ private:
 
     void calculateAverage();
 
+    void recordStreamingFrame(uint32_t samples);
+
+    StreamRecorder recorder;
+
     AverageCalculator *calculationThreads[4];
 
     boost::circular_buffer<Signal> circularBufferChannelA;
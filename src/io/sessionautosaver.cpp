@@ -0,0 +1,274 @@
+#include "sessionautosaver.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QXmlStreamWriter>
+
+#include "../core.h"
+#include "../models/datamodel.h"
+#include "../signal/mrun.h"
+#include "../signal/mrungroup.h"
+#include "../signal/processing/processingchain.h"
+#include "../calculations/fit/fitrun.h"
+#include "../general/taskscheduler.h"
+#include "fitresultfile.h"
+#include "ioxml.h"
+
+
+SessionAutoSaver::SessionAutoSaver(DataModel *dataModel, QObject *parent) : QObject(parent)
+{
+    m_dataModel = dataModel;
+
+    m_writer = new IOxml(this);
+    m_writer->setSaveRunSettings(false);
+
+    connect(m_dataModel, SIGNAL(mrunAdded(MRun*)), SLOT(onMRunAdded(MRun*)));
+    connect(m_dataModel, SIGNAL(groupAdded(MRunGroup*)), SLOT(onGroupAdded(MRunGroup*)));
+    connect(m_dataModel, SIGNAL(newFitRunRegistered(FitRun*)), SLOT(onFitRunRegistered(FitRun*)));
+}
+
+
+SessionAutoSaver::~SessionAutoSaver()
+{
+}
+
+
+/**
+ * @brief SessionAutoSaver::save takes a snapshot of the session and writes
+ * it in background (skipped if the previous write has not finished yet or
+ * nothing changed since the last save)
+ */
+void SessionAutoSaver::save()
+{
+    if(m_pendingWrite.isRunning())
+    {
+        MSG_DETAIL_1("SessionAutoSaver: previous auto-save still running, skipped");
+        return;
+    }
+
+    // full session save (IOxml) in progress, writes the same files
+    if(Core::instance()->getSignalManager()->isExporting())
+    {
+        MSG_DETAIL_1("SessionAutoSaver: export in progress, skipped");
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // paths within the fragments are relative to the session file
+    QString fileName = Core::instance()->generalSettings->initDataStateFilePath();
+    if(fileName != m_fileName)
+    {
+        m_fileName = fileName;
+        m_writer->setSessionFile(m_fileName, true);
+        m_runFragments.clear();
+        m_fitRunFragments.clear();
+        m_lastSession.clear();
+    }
+
+    QByteArray session;
+    session.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!--LIISim startup data-->\n");
+    session.append(QString("<LIISim relativePaths=\"1\" materialSpec=\"%0\">\n")
+                   .arg(Core::instance()->modelingSettings->materialSpec().filename.toHtmlEscaped())
+                   .toUtf8());
+
+    // groups and runs
+    QSet<int> runIDs;
+    int serialized = 0;
+
+    DataItem* rootItem = m_dataModel->rootItem();
+    for(int i = 0; i < rootItem->childCount(); i++)
+    {
+        MRunGroup* group = dynamic_cast<MRunGroup*>(rootItem->childAt(i));
+        if(!group)
+            continue;
+
+        QList<MRun*> runs = group->mruns();
+        if(runs.isEmpty())
+            continue;
+
+        session.append(QString("<Group name=\"%0\">\n").arg(group->title().toHtmlEscaped()).toUtf8());
+
+        for(MRun* run : runs)
+        {
+            runIDs.insert(run->id());
+
+            auto it = m_runFragments.find(run->id());
+            if(it == m_runFragments.end())
+            {
+                it = m_runFragments.insert(run->id(), m_writer->mrunToXML(run));
+                serialized++;
+            }
+            session.append(it.value());
+        }
+
+        session.append("\n</Group>\n");
+    }
+
+    // remove fragments of closed runs
+    for(auto it = m_runFragments.begin(); it != m_runFragments.end();)
+    {
+        if(runIDs.contains(it.key()))
+            ++it;
+        else
+            it = m_runFragments.erase(it);
+    }
+
+    // fit runs (running fits are saved after they have finished)
+    QSet<int> fitRunIDs;
+    QStringList resultFiles;
+    for(FitRun* fitrun : m_dataModel->fitRuns())
+    {
+        if(fitrun->isFitting())
+            continue;
+
+        fitRunIDs.insert(fitrun->id());
+
+        QString resultsFile = fitrun->resultsFileName(m_fileName);
+        resultFiles << resultsFile;
+
+        auto it = m_fitRunFragments.find(fitrun->id());
+        if(it == m_fitRunFragments.end())
+        {
+            QByteArray fragment;
+            QBuffer buffer(&fragment);
+            buffer.open(QIODevice::WriteOnly);
+            QXmlStreamWriter w(&buffer);
+            w.setAutoFormatting(true);
+            fitrun->writeToXML(w, resultsFile);
+            buffer.close();
+
+            it = m_fitRunFragments.insert(fitrun->id(), fragment);
+            serialized++;
+        }
+        session.append(it.value());
+    }
+
+    // remove fragments of deleted and running FitRuns
+    for(auto it = m_fitRunFragments.begin(); it != m_fitRunFragments.end();)
+    {
+        if(fitRunIDs.contains(it.key()))
+            ++it;
+        else
+            it = m_fitRunFragments.erase(it);
+    }
+
+    session.append("\n</LIISim>\n");
+
+    if(session == m_lastSession)
+    {
+        MSG_DETAIL_1("SessionAutoSaver: session unchanged, nothing to save");
+        return;
+    }
+    m_lastSession = session;
+
+    MSG_DETAIL_1(QString("SessionAutoSaver: snapshot taken in %0 ms (%1 of %2 runs/FitRuns serialized)")
+                 .arg(timer.elapsed()).arg(serialized).arg(runIDs.size() + fitRunIDs.size()));
+
+    m_pendingWrite = TaskScheduler::instance()->run(TaskScheduler::IO, [fileName, session, resultFiles]
+    {
+        QSaveFile file(fileName);
+        if(!file.open(QIODevice::WriteOnly)
+                || file.write(session) != session.size()
+                || !file.commit())
+        {
+            MESSAGE(QString("SessionAutoSaver: cannot write %0 (%1)").arg(fileName).arg(file.errorString()), ERR_IO);
+            return;
+        }
+        MSG_DETAIL_1(QString("SessionAutoSaver: session saved to %0").arg(fileName));
+
+        FitResultFile::removeUnreferenced(fileName, resultFiles);
+    });
+}
+
+
+/**
+ * @brief SessionAutoSaver::waitForPendingWrite blocks until the last auto-save
+ * has been written (called before the session is saved by IOxml, see IOxml::setupExport())
+ */
+void SessionAutoSaver::waitForPendingWrite()
+{
+    m_pendingWrite.waitForFinished();
+}
+
+
+/**
+ * @brief SessionAutoSaver::invalidate removes the cached fragment of a run
+ * @param run
+ */
+void SessionAutoSaver::invalidate(MRun *run)
+{
+    if(run)
+        m_runFragments.remove(run->id());
+}
+
+
+void SessionAutoSaver::onMRunAdded(MRun *run)
+{
+    if(!run)
+        return;
+
+    connect(run, SIGNAL(dataChanged(int,QVariant)), SLOT(onRunModified()));
+    connect(run, SIGNAL(LIISettingsChanged()), SLOT(onRunModified()));
+    connect(run, SIGNAL(MRunDetailsChanged()), SLOT(onRunModified()));
+    connect(run, SIGNAL(channelCountChanged(Signal::SType,int)), SLOT(onRunModified()));
+
+    QList<Signal::SType> stypes;
+    stypes << Signal::RAW << Signal::ABS << Signal::TEMPERATURE;
+    for(Signal::SType stype : stypes)
+    {
+        ProcessingChain* chain = run->getProcessingChain(stype);
+        connect(chain, SIGNAL(pluginGoneDirty()), SLOT(onChainModified()));
+        connect(chain, SIGNAL(pluginModified()), SLOT(onChainModified()));
+        connect(chain, SIGNAL(childInserted(DataItem*,int)), SLOT(onChainModified()));
+        connect(chain, SIGNAL(childRemoved(DataItem*)), SLOT(onChainModified()));
+    }
+}
+
+
+void SessionAutoSaver::onGroupAdded(MRunGroup *group)
+{
+    if(group)
+        connect(group, SIGNAL(dataChanged(int,QVariant)), SLOT(onGroupModified()));
+}
+
+
+void SessionAutoSaver::onRunModified()
+{
+    invalidate(qobject_cast<MRun*>(sender()));
+
+    // FitData reference the run by name
+    m_fitRunFragments.clear();
+}
+
+
+void SessionAutoSaver::onGroupModified()
+{
+    // FitData reference the group by name
+    m_fitRunFragments.clear();
+}
+
+
+void SessionAutoSaver::onChainModified()
+{
+    ProcessingChain* chain = qobject_cast<ProcessingChain*>(sender());
+    if(chain)
+        invalidate(chain->mrun());
+}
+
+
+void SessionAutoSaver::onFitRunRegistered(FitRun *fitrun)
+{
+    if(fitrun)
+        connect(fitrun, SIGNAL(modified()), SLOT(onFitRunModified()));
+}
+
+
+void SessionAutoSaver::onFitRunModified()
+{
+    FitRun* fitrun = qobject_cast<FitRun*>(sender());
+    if(fitrun)
+        m_fitRunFragments.remove(fitrun->id());
+}
@@ -0,0 +1,71 @@
+#ifndef SESSIONAUTOSAVER_H
+#define SESSIONAUTOSAVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+class DataModel;
+class FitRun;
+class IOxml;
+class MRun;
+class MRunGroup;
+
+/**
+ * @brief The SessionAutoSaver class saves the session (runs, groups,
+ * processing chains, plugin parameters, FitRuns) to the init session file
+ * (GeneralSettings::initDataStateFilePath()) without blocking the GUI.
+ * @details save() takes a snapshot of the data model within the GUI thread:
+ * the XML fragment of each run is cached and only regenerated if the run,
+ * one of its processing chains or plugins has been modified since the last
+ * snapshot. The session file is assembled from the fragments and written on
+ * the IO lane of the TaskScheduler (QSaveFile, the previous file is kept until
+ * the new file is complete). FitRun fragments are cached the same way (FitData
+ * reference runs and groups by name, renaming invalidates them), iteration results
+ * are only written to their sidecar files (see FitResultFile) if they changed.
+ * Signal data is not part of the session, the snapshot can therefore
+ * be taken while runs are processed or fitted.
+ * @ingroup IO
+ */
+class SessionAutoSaver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SessionAutoSaver(DataModel *dataModel, QObject *parent = 0);
+    ~SessionAutoSaver();
+
+    void save();
+    void waitForPendingWrite();
+
+private:
+    DataModel *m_dataModel;
+
+    /** @brief used for serialization of runs (no run settings files are written) */
+    IOxml *m_writer;
+    QString m_fileName;
+
+    /** @brief cached XML fragment of each run (key: run id) */
+    QHash<int, QByteArray> m_runFragments;
+    /** @brief cached XML fragment of each FitRun (key: FitRun id) */
+    QHash<int, QByteArray> m_fitRunFragments;
+
+    /** @brief last written session file */
+    QByteArray m_lastSession;
+    QFuture<void> m_pendingWrite;
+
+    void invalidate(MRun *run);
+
+private slots:
+    void onMRunAdded(MRun *run);
+    void onGroupAdded(MRunGroup *group);
+    void onRunModified();
+    void onGroupModified();
+    void onChainModified();
+    void onFitRunRegistered(FitRun *fitrun);
+    void onFitRunModified();
+};
+
+#endif // SESSIONAUTOSAVER_H
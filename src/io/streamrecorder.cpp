@@ -0,0 +1,497 @@
+#include "streamrecorder.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <cstring>
+
+#include "../general/LIISimException.h"
+#include "../logging/msghandlerbase.h"
+
+
+static const char recordingMagic[8] = {'L', 'I', 'I', 'S', 'T', 'R', 'M', '\0'};
+static const quint32 frameMagic = 0x4D52464C; // "LFRM"
+
+
+/**
+ * @brief The StreamRecorderFileHeader struct (see StreamRecorder file layout)
+ */
+struct StreamRecorderFileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+    /** @brief start of recording [ms since epoch] */
+    qint64 startTime;
+    char reserved[40];
+};
+
+
+/**
+ * @brief The StreamRecorderFrameHeader struct (see StreamRecorder file layout)
+ */
+struct StreamRecorderFrameHeader
+{
+    quint32 magic;
+    quint32 channelMask;
+    quint32 samples;
+    quint32 reserved;
+    /** @brief time since start of recording [us] */
+    qint64 time;
+    /** @brief sample interval [s] */
+    double dt;
+    double range[4];
+    double rangeFactor[4];
+    double offset[4];
+};
+
+static_assert(sizeof(StreamRecorderFileHeader) == StreamRecorder::headerSize,
+              "StreamRecorder: unexpected file header size");
+static_assert(sizeof(StreamRecorderFrameHeader) == StreamRecorder::frameHeaderSize,
+              "StreamRecorder: unexpected frame header size");
+
+
+static int channelCount(quint32 channelMask)
+{
+    int count = 0;
+    for(int c = 0; c < 4; c++)
+        if(channelMask & (1u << c))
+            count++;
+    return count;
+}
+
+
+/**
+ * @brief frameDataSize
+ * @return size of the sample data of a frame including padding [bytes]
+ */
+static qint64 frameDataSize(quint32 channelMask, quint32 samples)
+{
+    qint64 size = qint64(channelCount(channelMask)) * samples * sizeof(int16_t);
+    return (size + 7) & ~qint64(7);
+}
+
+
+StreamRecorder::StreamRecorder(QObject *parent)
+    : QThread(parent),
+      m_startTime(0),
+      m_recording(false),
+      m_stopRequested(false),
+      m_frames(0),
+      m_bytesWritten(0),
+      m_dropped(0)
+{
+    setObjectName("Stream recorder");
+    m_current.data = 0;
+    m_current.size = 0;
+}
+
+
+StreamRecorder::~StreamRecorder()
+{
+    close();
+}
+
+
+/**
+ * @brief StreamRecorder::open creates a new recording (an existing file
+ * will be overwritten) and starts the writer thread
+ * @param fileName
+ * @return false if the file could not be opened
+ */
+bool StreamRecorder::open(const QString &fileName)
+{
+    close();
+
+    QMutexLocker producerLock(&m_producerMutex);
+
+    m_file.setFileName(fileName);
+    if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+    {
+        MSG_ERR(QString("StreamRecorder: cannot open file %0 (%1)").arg(fileName).arg(m_file.errorString()));
+        return false;
+    }
+
+    m_fileName = fileName;
+    m_frames = 0;
+    m_bytesWritten = 0;
+    m_dropped = 0;
+    m_stopRequested = false;
+
+    {
+        QMutexLocker lock(&m_mutex);
+        for(int i = 0; i < bufferCount; i++)
+        {
+            Buffer buffer;
+            buffer.data = static_cast<char*>(qMallocAligned(bufferSize, bufferAlignment));
+            buffer.size = 0;
+            m_free.append(buffer);
+        }
+        m_current = m_free.takeFirst();
+    }
+
+    m_startTime = QDateTime::currentMSecsSinceEpoch();
+    m_clock.start();
+
+    StreamRecorderFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, recordingMagic, sizeof(recordingMagic));
+    header.version = fileVersion;
+    header.headerSize = headerSize;
+    header.startTime = m_startTime;
+
+    memcpy(m_current.data, &header, sizeof(header));
+    m_current.size = sizeof(header);
+
+    start(QThread::HighPriority);
+    m_recording.store(true, std::memory_order_release);
+
+    MSG_NORMAL(QString("StreamRecorder: recording to %0").arg(fileName));
+    return true;
+}
+
+
+/**
+ * @brief StreamRecorder::close writes all pending frames,
+ * stops the writer thread and closes the file
+ */
+void StreamRecorder::close()
+{
+    {
+        QMutexLocker producerLock(&m_producerMutex);
+
+        if(!m_recording.load(std::memory_order_acquire) && !isRunning())
+            return;
+
+        m_recording.store(false, std::memory_order_release);
+        submitCurrent();
+
+        QMutexLocker lock(&m_mutex);
+        m_stopRequested = true;
+        m_wake.wakeAll();
+    }
+
+    wait();
+
+    m_file.close();
+    releaseBuffers();
+
+    MSG_NORMAL(QString("StreamRecorder: %0 frames recorded to %1 (%2 MB, %3 frames dropped)")
+               .arg(framesRecorded())
+               .arg(m_fileName)
+               .arg(double(bytesWritten()) / (1024.0 * 1024.0), 0, 'f', 1)
+               .arg(framesDropped()));
+}
+
+
+/**
+ * @brief StreamRecorder::appendFrame copies a captured frame to the current
+ * write buffer. Called by the streaming thread, does not block on file access.
+ * @param channels raw ADC counts of channel A..D (only enabled channels are accessed)
+ * @param channelMask enabled channels (bit 0: A ... bit 3: D)
+ * @param samples samples per channel
+ * @param dt sample interval [s]
+ * @param range input range of channel A..D [V]
+ * @param rangeFactor conversion factor of channel A..D [counts/V]
+ * @param offset analog offset of channel A..D [V]
+ */
+void StreamRecorder::appendFrame(int16_t *const channels[4],
+                                 quint32 channelMask,
+                                 quint32 samples,
+                                 double dt,
+                                 const double range[4],
+                                 const double rangeFactor[4],
+                                 const double offset[4])
+{
+    if(!isRecording())
+        return;
+
+    QMutexLocker producerLock(&m_producerMutex);
+
+    if(!isRecording())
+        return;
+
+    qint64 frameSize = frameHeaderSize + frameDataSize(channelMask, samples);
+
+    if(frameSize > bufferSize)
+    {
+        m_recording.store(false, std::memory_order_release);
+        emit error(QString("StreamRecorder: frame size (%0 bytes) exceeds write buffer, recording stopped")
+                   .arg(frameSize));
+        return;
+    }
+
+    // hand over current buffer to writer thread if frame does not fit
+    if(m_current.data && m_current.size + frameSize > bufferSize)
+        submitCurrent();
+
+    if(!m_current.data && !takeFreeBuffer(m_current))
+    {
+        // all buffers are waiting for the disk
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    StreamRecorderFrameHeader header;
+    header.magic = frameMagic;
+    header.channelMask = channelMask;
+    header.samples = samples;
+    header.reserved = 0;
+    header.time = m_clock.nsecsElapsed() / 1000;
+    header.dt = dt;
+    for(int c = 0; c < 4; c++)
+    {
+        header.range[c] = range[c];
+        header.rangeFactor[c] = rangeFactor[c];
+        header.offset[c] = offset[c];
+    }
+
+    char* pos = m_current.data + m_current.size;
+    memcpy(pos, &header, sizeof(header));
+    pos += sizeof(header);
+
+    for(int c = 0; c < 4; c++)
+    {
+        if(!(channelMask & (1u << c)))
+            continue;
+        memcpy(pos, channels[c], samples * sizeof(int16_t));
+        pos += samples * sizeof(int16_t);
+    }
+
+    // zero padding
+    memset(pos, 0, m_current.data + m_current.size + frameSize - pos);
+    m_current.size += frameSize;
+
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief StreamRecorder::submitCurrent passes the current buffer
+ * to the writer thread (m_producerMutex has to be locked)
+ */
+void StreamRecorder::submitCurrent()
+{
+    if(!m_current.data)
+        return;
+
+    QMutexLocker lock(&m_mutex);
+    if(m_current.size > 0)
+        m_full.append(m_current);
+    else
+        m_free.append(m_current);
+    m_wake.wakeAll();
+
+    m_current.data = 0;
+    m_current.size = 0;
+}
+
+
+bool StreamRecorder::takeFreeBuffer(Buffer &buffer)
+{
+    QMutexLocker lock(&m_mutex);
+    if(m_free.isEmpty())
+        return false;
+    buffer = m_free.takeFirst();
+    buffer.size = 0;
+    return true;
+}
+
+
+void StreamRecorder::releaseBuffers()
+{
+    QMutexLocker lock(&m_mutex);
+    for(int i = 0; i < m_full.size(); i++)
+        qFreeAligned(m_full.at(i).data);
+    for(int i = 0; i < m_free.size(); i++)
+        qFreeAligned(m_free.at(i).data);
+    m_full.clear();
+    m_free.clear();
+}
+
+
+/**
+ * @brief StreamRecorder::run writer thread: writes full buffers
+ * in order until close() has been called
+ */
+void StreamRecorder::run()
+{
+    bool failed = false;
+
+    while(true)
+    {
+        Buffer buffer;
+        {
+            QMutexLocker lock(&m_mutex);
+            while(m_full.isEmpty() && !m_stopRequested)
+                m_wake.wait(&m_mutex);
+
+            if(m_full.isEmpty())
+                break;
+
+            buffer = m_full.takeFirst();
+        }
+
+        if(!failed)
+        {
+            qint64 written = m_file.write(buffer.data, buffer.size);
+            if(written != buffer.size)
+            {
+                // keep draining the buffers, but stop recording
+                failed = true;
+                m_recording.store(false, std::memory_order_release);
+                emit error(QString("StreamRecorder: writing to %0 failed (%1), recording stopped")
+                           .arg(m_fileName).arg(m_file.errorString()));
+            }
+            else
+                m_bytesWritten.fetch_add(written, std::memory_order_relaxed);
+        }
+
+        buffer.size = 0;
+        QMutexLocker lock(&m_mutex);
+        m_free.append(buffer);
+    }
+}
+
+
+/**
+ * @brief StreamRecorder::readRecording imports all frames of a recording
+ * as pre-processing signals (raw and absolute) of the run, one MPoint per frame.
+ * The ADC counts are kept (CompactSignal) and converted to volts on access.
+ * The file is read in blocks of bufferSize, a truncated last frame
+ * (e.g. application crashed during recording) is ignored.
+ * @param fileName
+ * @param run run with LII-settings (number of channels has to match the recorded channels)
+ * @return number of imported frames
+ */
+int StreamRecorder::readRecording(const QString &fileName, MRun *run)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+        throw LIISimException(QString("StreamRecorder: cannot open file %0 (%1)")
+                              .arg(fileName).arg(file.errorString()));
+
+    StreamRecorderFileHeader header;
+    if(file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+            || memcmp(header.magic, recordingMagic, sizeof(recordingMagic)) != 0)
+        throw LIISimException(QString("StreamRecorder: %0 is not a stream recording").arg(fileName));
+
+    if(header.version > quint32(fileVersion))
+        throw LIISimException(QString("StreamRecorder: unsupported version of recording %0 (%1)")
+                              .arg(fileName).arg(header.version));
+
+    file.seek(header.headerSize);
+
+    int runChannels = run->getNoChannels(Signal::RAW);
+
+    // unparsed data of the current block starts at pos
+    QByteArray block;
+    int pos = 0;
+
+    // makes sure that the next size bytes are within the block
+    auto fetch = [&](qint64 size) -> bool
+    {
+        if(block.size() - pos >= size)
+            return true;
+
+        block.remove(0, pos);
+        pos = 0;
+
+        int available = block.size();
+        block.resize(available + bufferSize);
+        qint64 bytes = file.read(block.data() + available, bufferSize);
+        block.resize(available + int(qMax(bytes, qint64(0))));
+
+        return block.size() >= size;
+    };
+
+    quint32 channelMask = 0;
+    int frames = 0;
+
+    while(true)
+    {
+        if(!fetch(sizeof(StreamRecorderFrameHeader)))
+        {
+            if(block.size() > pos)
+                MSG_WARN(QString("StreamRecorder: %0: incomplete frame header ignored").arg(fileName));
+            break;
+        }
+
+        StreamRecorderFrameHeader frame;
+        memcpy(&frame, block.constData() + pos, sizeof(frame));
+
+        if(frame.magic != frameMagic)
+            throw LIISimException(QString("StreamRecorder: %0: invalid frame %1").arg(fileName).arg(frames));
+
+        if(frames == 0)
+        {
+            channelMask = frame.channelMask;
+
+            if(channelMask == 0 || (channelMask & ~quint32(0xF)))
+                throw LIISimException(QString("StreamRecorder: %0: invalid channel mask (%1)")
+                                      .arg(fileName).arg(channelMask));
+
+            if(channelCount(channelMask) != runChannels)
+                throw LIISimException(QString("StreamRecorder: %0 contains %1 channel(s), but the LII-Settings define %2 channel(s)")
+                                      .arg(fileName).arg(channelCount(channelMask)).arg(runChannels));
+        }
+        else if(frame.channelMask != channelMask)
+            throw LIISimException(QString("StreamRecorder: %0: channels changed at frame %1")
+                                  .arg(fileName).arg(frames));
+
+        // frames never exceed a write buffer (see appendFrame())
+        qint64 dataSize = frameDataSize(frame.channelMask, frame.samples);
+        if(frameHeaderSize + dataSize > bufferSize)
+            throw LIISimException(QString("StreamRecorder: %0: invalid size of frame %1").arg(fileName).arg(frames));
+
+        if(!fetch(frameHeaderSize + dataSize))
+        {
+            MSG_WARN(QString("StreamRecorder: %0: incomplete frame ignored").arg(fileName));
+            break;
+        }
+        pos += frameHeaderSize;
+
+        if(frames == 0)
+        {
+            int channelID = 1;
+            for(int c = 0; c < 4; c++)
+            {
+                if(!(frame.channelMask & (1u << c)))
+                    continue;
+                run->setPSRange(channelID, frame.range[c]);
+                run->setPSOffset(channelID, frame.offset[c]);
+                channelID++;
+            }
+        }
+
+        MPoint* mp = run->getCreatePre(frames);
+        const int16_t* counts = reinterpret_cast<const int16_t*>(block.constData() + pos);
+
+        int channelID = 1;
+        for(int c = 0; c < 4; c++)
+        {
+            if(!(frame.channelMask & (1u << c)))
+                continue;
+
+            Signal signal;
+            signal.dt = frame.dt;
+            signal.start_time = 0.0;
+            signal.channelID = channelID;
+
+            CompactSignal compactSignal(counts, int(frame.samples), 1.0 / frame.rangeFactor[c]);
+            counts += frame.samples;
+
+            signal.type = Signal::RAW;
+            mp->setSignalCounts(signal, compactSignal, channelID, Signal::RAW);
+
+            signal.type = Signal::ABS;
+            mp->setSignalCounts(signal, compactSignal, channelID, Signal::ABS);
+
+            channelID++;
+        }
+
+        pos += int(dataSize);
+        frames++;
+    }
+
+    return frames;
+}
@@ -0,0 +1,122 @@
+#ifndef STREAMRECORDER_H
+#define STREAMRECORDER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <atomic>
+
+#include "../signal/mrun.h"
+
+
+/**
+ * @brief The StreamRecorder class writes every frame captured in streaming
+ * mode to an append-only binary file (*.liistream) within its own thread.
+ * @details Frames are stored as raw int16 ADC counts together with the
+ * range/offset metadata needed for the conversion to volts, recordings are
+ * therefore only limited by disk space (not by the streaming buffer).
+ * appendFrame() copies the frame into a large, page aligned buffer; full
+ * buffers are handed over to the writer thread, which writes them with an
+ * unbuffered file handle. If all buffers are waiting to be written
+ * (disk too slow), frames are dropped and counted.
+ *
+ * File layout (native byte order):
+ *  - file header (headerSize bytes): magic "LIISTRM", version, header size,
+ *    recording start (ms since epoch)
+ *  - frames, each consisting of
+ *     - frame header (frameHeaderSize bytes): magic, channel mask (bit 0: A ... bit 3: D),
+ *       samples per channel, time since recording start [us], sample interval [s],
+ *       range [V], range factor [counts/V] and offset [V] of all four channels
+ *     - int16 counts of the enabled channels (channel after channel),
+ *       padded to a multiple of 8 bytes
+ * Recordings can be imported as regular runs by readRecording().
+ * @ingroup IO
+ */
+class StreamRecorder : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit StreamRecorder(QObject *parent = 0);
+    ~StreamRecorder();
+
+    /** @brief size of a single write buffer [bytes] */
+    static const int bufferSize = 8 * 1024 * 1024;
+    /** @brief number of write buffers */
+    static const int bufferCount = 4;
+    /** @brief alignment of write buffers [bytes] */
+    static const int bufferAlignment = 4096;
+
+    static const int fileVersion = 1;
+    static const int headerSize = 64;
+    static const int frameHeaderSize = 128;
+
+    /** @brief file suffix of recordings */
+    static QString fileSuffix() { return "liistream"; }
+
+    bool open(const QString &fileName);
+    void close();
+
+    inline bool isRecording() { return m_recording.load(std::memory_order_acquire); }
+    inline QString fileName() { return m_fileName; }
+
+    void appendFrame(int16_t *const channels[4],
+                     quint32 channelMask,
+                     quint32 samples,
+                     double dt,
+                     const double range[4],
+                     const double rangeFactor[4],
+                     const double offset[4]);
+
+    inline quint64 framesRecorded() { return m_frames.load(std::memory_order_relaxed); }
+    inline quint64 bytesWritten() { return m_bytesWritten.load(std::memory_order_relaxed); }
+    inline quint64 framesDropped() { return m_dropped.load(std::memory_order_relaxed); }
+
+    static int readRecording(const QString &fileName, MRun *run);
+
+protected:
+    void run();
+
+private:
+    struct Buffer
+    {
+        char* data;
+        int size;
+    };
+
+    QFile m_file;
+    QString m_fileName;
+    qint64 m_startTime;
+    QElapsedTimer m_clock;
+
+    std::atomic<bool> m_recording;
+    std::atomic<bool> m_stopRequested;
+
+    std::atomic<quint64> m_frames;
+    std::atomic<quint64> m_bytesWritten;
+    std::atomic<quint64> m_dropped;
+
+    /** @brief guards m_current (appendFrame() vs. open()/close()) */
+    QMutex m_producerMutex;
+    /** @brief buffer currently filled by appendFrame() */
+    Buffer m_current;
+
+    /** @brief guards m_free and m_full */
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QList<Buffer> m_free;
+    QList<Buffer> m_full;
+
+    bool takeFreeBuffer(Buffer &buffer);
+    void submitCurrent();
+    void releaseBuffers();
+
+signals:
+    void error(QString message);
+};
+
+#endif // STREAMRECORDER_H
@@ -0,0 +1,306 @@
+#include "asynclogwriter.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <algorithm>
+
+#include "msghandlerbase.h"
+
+
+// ---- AsyncLogQueue ----
+
+
+AsyncLogQueue::AsyncLogQueue()
+    : m_head(0), m_tail(0), m_dropped(0)
+{
+}
+
+
+/**
+ * @brief AsyncLogQueue::push appends a record (producer thread only)
+ * @param record
+ * @return false if queue is full (record is dropped)
+ */
+bool AsyncLogQueue::push(const AsyncLogRecord &record)
+{
+    unsigned int head = m_head.load(std::memory_order_relaxed);
+    unsigned int next = (head + 1) % capacity;
+
+    if(next == m_tail.load(std::memory_order_acquire))
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_records[head] = record;
+    m_head.store(next, std::memory_order_release);
+    return true;
+}
+
+
+/**
+ * @brief AsyncLogQueue::pop removes the oldest record (consumer thread only)
+ * @param record
+ * @return false if queue is empty
+ */
+bool AsyncLogQueue::pop(AsyncLogRecord &record)
+{
+    unsigned int tail = m_tail.load(std::memory_order_relaxed);
+
+    if(tail == m_head.load(std::memory_order_acquire))
+        return false;
+
+    record = m_records[tail];
+    // release string data within consumer thread
+    m_records[tail].text = QString();
+    m_records[tail].context = QString();
+
+    m_tail.store((tail + 1) % capacity, std::memory_order_release);
+    return true;
+}
+
+
+/**
+ * @brief AsyncLogQueue::takeDropped
+ * @return number of dropped records since last call
+ */
+int AsyncLogQueue::takeDropped()
+{
+    return m_dropped.exchange(0, std::memory_order_relaxed);
+}
+
+
+// ---- AsyncLogWriter ----
+
+
+/**
+ * @brief The AsyncLogThreadQueue struct links a posting thread to its queue
+ * of the current writer (queues of deleted writers are never accessed,
+ * since writer ids are unique)
+ */
+struct AsyncLogThreadQueue
+{
+    quint64 writer;
+    AsyncLogQueue* queue;
+};
+
+static thread_local AsyncLogThreadQueue t_queue = { 0, 0 };
+
+static std::atomic<quint64> s_writerIds(0);
+static std::atomic<quint64> s_sequence(0);
+
+
+static qint64 monotonicTime()
+{
+    static QElapsedTimer timer;
+    static bool started = (timer.start(), true);
+    Q_UNUSED(started);
+    return timer.elapsed();
+}
+
+
+AsyncLogWriter::AsyncLogWriter(QTextStream *stream, QObject *parent)
+    : QThread(parent),
+      m_stream(stream),
+      m_id(++s_writerIds),
+      m_stopRequested(false),
+      m_hasLast(false),
+      m_repeated(0)
+{
+    setObjectName("Log writer");
+    monotonicTime();
+}
+
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    stop();
+    qDeleteAll(m_queues);
+}
+
+
+/**
+ * @brief AsyncLogWriter::threadQueue returns the queue of the
+ * calling thread (created on first call)
+ */
+AsyncLogQueue* AsyncLogWriter::threadQueue()
+{
+    if(t_queue.writer == m_id)
+        return t_queue.queue;
+
+    AsyncLogQueue* queue = new AsyncLogQueue;
+    {
+        QMutexLocker lock(&m_queueMutex);
+        m_queues.append(queue);
+    }
+
+    t_queue.writer = m_id;
+    t_queue.queue = queue;
+
+    return queue;
+}
+
+
+/**
+ * @brief AsyncLogWriter::enqueue posts a message to the writer thread.
+ * Can be called from any thread, does not block (besides the first call of a thread).
+ * @param type message type
+ * @param msg text
+ * @param context formatted log context
+ */
+void AsyncLogWriter::enqueue(LIISimMessageType type, const QString &msg, const QString &context)
+{
+    if(m_stopRequested.load(std::memory_order_relaxed))
+        return;
+
+    AsyncLogRecord record;
+    record.type = type;
+    record.text = msg;
+    record.context = context;
+    record.time = monotonicTime();
+    record.sequence = s_sequence.fetch_add(1, std::memory_order_relaxed);
+
+    threadQueue()->push(record);
+
+    // errors are written immediately
+    if(type == ERR || type == ERR_IO || type == ERR_CALC || type == ERR_NULL
+            || type == CRITICAL_QT || type == FATAL_QT)
+        m_wake.wakeOne();
+}
+
+
+/**
+ * @brief AsyncLogWriter::stop writes all pending messages and stops the writer thread
+ */
+void AsyncLogWriter::stop()
+{
+    m_stopRequested.store(true, std::memory_order_relaxed);
+    m_wake.wakeOne();
+    wait();
+}
+
+
+void AsyncLogWriter::run()
+{
+    qint64 lastFlush = monotonicTime();
+
+    while(!m_stopRequested.load(std::memory_order_relaxed))
+    {
+        bool urgent = drain();
+
+        // coalesced messages are finished after repeatInterval
+        if(m_repeated > 0 && monotonicTime() - m_last.time > repeatInterval)
+        {
+            writeRepeated();
+            m_hasLast = false;
+        }
+
+        if(urgent || monotonicTime() - lastFlush >= flushInterval)
+        {
+            m_stream->flush();
+            lastFlush = monotonicTime();
+        }
+
+        QMutexLocker lock(&m_waitMutex);
+        m_wake.wait(&m_waitMutex, 50);
+    }
+
+    // write remaining messages
+    drain();
+    writeRepeated();
+    m_stream->flush();
+}
+
+
+/**
+ * @brief AsyncLogWriter::drain writes the messages of all queues in order of posting
+ * @return true if an error message has been written
+ */
+bool AsyncLogWriter::drain()
+{
+    QList<AsyncLogQueue*> queues;
+    {
+        QMutexLocker lock(&m_queueMutex);
+        queues = m_queues;
+    }
+
+    QVector<AsyncLogRecord> batch;
+    int dropped = 0;
+
+    AsyncLogRecord record;
+    for(int i = 0; i < queues.size(); i++)
+    {
+        while(queues[i]->pop(record))
+            batch.append(record);
+        dropped += queues[i]->takeDropped();
+    }
+
+    std::sort(batch.begin(), batch.end(), [](const AsyncLogRecord& a, const AsyncLogRecord& b){
+        return a.sequence < b.sequence;
+    });
+
+    bool urgent = false;
+    for(int i = 0; i < batch.size(); i++)
+    {
+        write(batch.at(i));
+
+        LIISimMessageType type = batch.at(i).type;
+        if(type == ERR || type == ERR_IO || type == ERR_CALC || type == ERR_NULL
+                || type == CRITICAL_QT || type == FATAL_QT)
+            urgent = true;
+    }
+
+    if(dropped > 0)
+    {
+        writeRepeated();
+        m_hasLast = false;
+        *m_stream << QString("Warning: %0 messages dropped (log queue full)\r\n").arg(dropped);
+    }
+
+    return urgent;
+}
+
+
+/**
+ * @brief AsyncLogWriter::write writes a single message to the stream
+ * (or counts it, if it repeats the previous message)
+ * @param record
+ */
+void AsyncLogWriter::write(const AsyncLogRecord &record)
+{
+    if(m_hasLast
+            && record.type == m_last.type
+            && record.time - m_last.time <= repeatInterval
+            && record.text == m_last.text
+            && record.context == m_last.context)
+    {
+        m_repeated++;
+        return;
+    }
+
+    writeRepeated();
+
+    *m_stream << MsgHandlerBase::msgTypeToString(record.type);
+    if(!record.context.isEmpty())
+        *m_stream << record.context;
+    *m_stream << ": " << record.text << "\r\n";
+
+    m_last = record;
+    m_hasLast = true;
+}
+
+
+/**
+ * @brief AsyncLogWriter::writeRepeated writes the number of
+ * coalesced repetitions of the previous message
+ */
+void AsyncLogWriter::writeRepeated()
+{
+    if(m_repeated == 0)
+        return;
+
+    *m_stream << QString("(last message repeated %0 times)\r\n").arg(m_repeated);
+    m_repeated = 0;
+}
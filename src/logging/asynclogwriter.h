@@ -0,0 +1,118 @@
+#ifndef ASYNCLOGWRITER_H
+#define ASYNCLOGWRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QString>
+#include <QTextStream>
+#include <atomic>
+
+#include "../general/LIISimMessageType.h"
+
+/**
+ * @brief The AsyncLogRecord struct holds a single message
+ * passed from the posting thread to the AsyncLogWriter
+ */
+struct AsyncLogRecord
+{
+    LIISimMessageType type;
+    QString text;
+    /** @brief formatted log context (qt-messages only) */
+    QString context;
+    /** @brief time of posting [ms] (monotonic) */
+    qint64 time;
+    /** @brief global posting order (one counter for all threads), used to merge the queues */
+    quint64 sequence;
+};
+
+
+/**
+ * @brief The AsyncLogQueue class is a bounded single-producer/single-consumer
+ * ring buffer. Each posting thread owns one queue, the AsyncLogWriter thread
+ * is the only consumer. Messages are dropped (and counted) if the queue is full.
+ */
+class AsyncLogQueue
+{
+public:
+    static const unsigned int capacity = 1024;
+
+    AsyncLogQueue();
+
+    bool push(const AsyncLogRecord &record);
+    bool pop(AsyncLogRecord &record);
+
+    int takeDropped();
+
+private:
+    AsyncLogRecord m_records[capacity];
+
+    /** @brief next index to write (producer) */
+    std::atomic<unsigned int> m_head;
+    /** @brief next index to read (consumer) */
+    std::atomic<unsigned int> m_tail;
+
+    std::atomic<int> m_dropped;
+};
+
+
+/**
+ * @brief The AsyncLogWriter class writes messages to a QTextStream
+ * within its own thread.
+ * @details enqueue() only appends the message to the lock-free queue of the
+ * calling thread, formatting and file access are done by the writer thread:
+ *  - messages of all queues are merged in order of posting and written in batches
+ *  - the stream is flushed periodically (flushInterval) and immediately after errors
+ *  - identical consecutive messages are written at most once per repeatInterval,
+ *    followed by the number of suppressed repetitions
+ * The stream must not be accessed by other threads until stop() has returned.
+ * @ingroup Logging
+ */
+class AsyncLogWriter : public QThread
+{
+public:
+    explicit AsyncLogWriter(QTextStream* stream, QObject *parent = 0);
+    ~AsyncLogWriter();
+
+    /** @brief time between flushes of the stream [ms] */
+    static const int flushInterval = 500;
+    /** @brief identical messages within this interval are coalesced [ms] */
+    static const int repeatInterval = 1000;
+
+    void enqueue(LIISimMessageType type, const QString &msg, const QString &context = QString());
+
+    void stop();
+
+protected:
+    void run();
+
+private:
+    QTextStream* m_stream;
+
+    /** @brief identifies this writer in thread local queue pointers */
+    quint64 m_id;
+
+    std::atomic<bool> m_stopRequested;
+
+    /** @brief all queues created for this writer (owned) */
+    QMutex m_queueMutex;
+    QList<AsyncLogQueue*> m_queues;
+
+    /** @brief only used to sleep/wake the writer thread */
+    QMutex m_waitMutex;
+    QWaitCondition m_wake;
+
+    // state of writer thread
+    AsyncLogRecord m_last;
+    bool m_hasLast;
+    int m_repeated;
+
+    AsyncLogQueue* threadQueue();
+
+    bool drain();
+    void write(const AsyncLogRecord &record);
+    void writeRepeated();
+};
+
+#endif // ASYNCLOGWRITER_H
@@ -1,6 +1,7 @@
 #include "logfilehandler.h"
 
 #include "../core.h";
+#include "asynclogwriter.h"
 
 LogFileHandler::LogFileHandler()
 {
@@ -8,6 +9,7 @@ LogFileHandler::LogFileHandler()
 
     file = new QFile(m_filename);
     stream = 0;
+    writer = 0;
 
     if (file->open(QFile::WriteOnly | QFile::Truncate))
     {
@@ -51,12 +53,23 @@ LogFileHandler::LogFileHandler()
         *stream << "\r\nMESSAGES:\r\r\n\n";
 
         stream->flush();
+
+        writer = new AsyncLogWriter(stream);
+        writer->start(QThread::LowPriority);
     }
 }
 
 
 LogFileHandler::~LogFileHandler()
 {
+    // no further messages, write pending messages
+    unregisterHandler();
+    if(writer)
+    {
+        writer->stop();
+        delete writer;
+    }
+
     if(stream) *stream << "Goodbye.\r\n";
 
     file->close();
@@ -67,23 +80,25 @@ LogFileHandler::~LogFileHandler()
 
 void LogFileHandler::handleMessage(LIISimMessageType type, const QString &msg, const QMessageLogContext &context)
 {
-    QMutexLocker lock(&msgMutex);
-    if(!stream) return;
+    if(!writer) return;
 
     // no status messages
     if(type == STATUS_5000 || type == STATUS_CONST)
         return;
 
-    *stream << msgTypeToString(type) ;
+    // context pointers are only valid during this call
+    QString ctx;
     if(type == DEBUG_QT || type == WARNING_QT || type == CRITICAL_QT || type == FATAL_QT)
     {
-        *stream << "["
-            << context.file << ": "
-            << context.line << ", "
-            << context.function << "] ";
+        ctx = QString("[%0: %1, %2] ")
+                .arg(context.file)
+                .arg(context.line)
+                .arg(context.function);
     }
 
-    *stream << ": " << msg << "\r\n";
+    writer->enqueue(type, msg, ctx);
 
-    stream->flush();
+    // program is aborted after fatal messages
+    if(type == FATAL_QT)
+        writer->stop();
 }
@@ -5,8 +5,12 @@
 #include <QFile>
 #include "msghandlerbase.h"
 
+class AsyncLogWriter;
+
 /**
  * @brief The LogFileHandler class writes received messages to a logfile...
+ * Messages are passed to an AsyncLogWriter, which formats, writes
+ * and flushes them within its own thread.
  * @ingroup Logging
  */
 class LogFileHandler : public MsgHandlerBase
@@ -26,6 +30,7 @@ private:
     QString m_filename;
     QFile* file;
     QTextStream* stream;
+    AsyncLogWriter* writer;
 };
 
 #endif // LOGFILEHANDLER_H
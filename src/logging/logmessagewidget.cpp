@@ -5,9 +5,10 @@ LogMessageWidget::LogMessageWidget(QWidget *parent) : QTextBrowser(parent)
     setToolTip("Program Log");
 
     // show message history
-    for(int i = 0;i < msgHistory.size(); i++)
+    QList<MsgContainterType> history = lastMessages();
+    for(int i = 0;i < history.size(); i++)
     {
-        MsgContainterType mc = msgHistory.at(i);
+        MsgContainterType mc = history.at(i);
         QMessageLogContext context;
         handleMessage(mc.type,mc.text,context);
     }
@@ -5,6 +5,8 @@
 #include <iostream>
 
 #include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
 #include <QMessageBox>
 
 #include "../core.h"
@@ -13,12 +15,16 @@
 QList<MsgHandlerBase*> MsgHandlerBase::registredHandlers = QList<MsgHandlerBase*>();
 QQueue<MsgContainterType> MsgHandlerBase::msgHistory = QQueue<MsgContainterType>();
 QMultiMap<QString,int> MsgHandlerBase::msgOnceIDs = QMultiMap<QString,int>();
+QMutex MsgHandlerBase::historyMutex;
+QMutex MsgHandlerBase::msgOnceMutex;
+QReadWriteLock MsgHandlerBase::handlerLock(QReadWriteLock::Recursive);
 
 /**
  * @brief MsgHandlerBase::MsgHandlerBase Constructor
  */
 MsgHandlerBase::MsgHandlerBase()
 {
+    QWriteLocker lock(&handlerLock);
     registredHandlers.append(this);
 }
 
@@ -27,9 +33,61 @@ MsgHandlerBase::MsgHandlerBase()
  */
 MsgHandlerBase::~MsgHandlerBase()
 {
+    unregisterHandler();
+}
+
+
+/**
+ * @brief MsgHandlerBase::unregisterHandler stops the delivery of messages to this handler.
+ * Waits until all running handleMessage() calls are finished. Subclasses, which
+ * release resources used by handleMessage() in their destructor, should call this first.
+ */
+void MsgHandlerBase::unregisterHandler()
+{
+    QWriteLocker lock(&handlerLock);
     registredHandlers.removeOne(this);
 }
 
+
+/**
+ * @brief MsgHandlerBase::dispatch sends message to all registered handlers
+ * and stores it to history
+ * @param type message type
+ * @param msg message text
+ * @param context log context
+ */
+void MsgHandlerBase::dispatch(LIISimMessageType type,
+                              const QString &msg,
+                              const QMessageLogContext &context)
+{
+    {
+        QReadLocker lock(&handlerLock);
+        for(int i = 0; i < registredHandlers.size(); i++)
+            registredHandlers[i]->handleMessage(type,msg,context);
+    }
+
+    // store message to history
+    MsgContainterType mc;
+    mc.type = type;
+    mc.text = msg;
+
+    QMutexLocker lock(&historyMutex);
+    msgHistory.enqueue(mc);
+    if(msgHistory.size() > 50)
+        msgHistory.dequeue();
+}
+
+
+/**
+ * @brief MsgHandlerBase::lastMessages
+ * @return copy of the last (max. 50) messages
+ */
+QList<MsgContainterType> MsgHandlerBase::lastMessages()
+{
+    QMutexLocker lock(&historyMutex);
+    return msgHistory;
+}
+
 /**
  * @brief MsgHandlerBase::handleQtMessage static method for posting a message.
  * This method can be used for installing a global message handler (see qInstallMessageHandler)
@@ -63,23 +121,22 @@ void MsgHandlerBase::handleQtMessage(QtMsgType type,
     {
         std::cout << msgTypeToString(mtype).toStdString()
                   << ": " <<msg.toStdString() << std::endl;
+
+        // store message to history
+        MsgContainterType mc;
+        mc.type = mtype;
+        mc.text = msg;
+
+        QMutexLocker lock(&historyMutex);
+        msgHistory.enqueue(mc);
+        if(msgHistory.size() > 50)
+            msgHistory.dequeue();
     }
     else
     {
         // send message to all registered handlers
-        for(int i = 0; i < registredHandlers.size(); i++)
-        {
-            registredHandlers[i]->handleMessage(mtype,msg,context);
-        }
+        dispatch(mtype, msg, context);
     }
-
-    // store message to history
-    MsgContainterType mc;
-    mc.type = mtype;
-    mc.text = msg;
-    msgHistory.enqueue(mc);
-    if(msgHistory.size() > 50)
-        msgHistory.dequeue();
 }
 
 /**
@@ -91,18 +148,7 @@ void MsgHandlerBase::handleQtMessage(QtMsgType type,
 void MsgHandlerBase::msg(const QString &msg,LIISimMessageType type)
 {
     // send message to all registered handlers
-    for(int i = 0; i < registredHandlers.size(); i++)
-    {
-        registredHandlers[i]->handleMessage(type,msg,QMessageLogContext());
-    }
-
-    // add message to history
-    MsgContainterType mc;
-    mc.type = type;
-    mc.text = msg;
-    msgHistory.enqueue(mc);
-    if(msgHistory.size() > 50)
-        msgHistory.dequeue();
+    dispatch(type, msg, QMessageLogContext());
 }
 
 
@@ -118,18 +164,24 @@ void MsgHandlerBase::msg(const QString &msg,LIISimMessageType type)
  */
 void MsgHandlerBase::msg_once(const QString &group, const int id, const QString &msg, LIISimMessageType type)
 {
-    if(!msgOnceIDs.contains(group, id))
     {
+        QMutexLocker lock(&msgOnceMutex);
+        if(msgOnceIDs.contains(group, id))
+            return;
         msgOnceIDs.insert(group, id);
-        MsgHandlerBase::msg(msg, type);
     }
+    MsgHandlerBase::msg(msg, type);
 }
 
 
 void MsgHandlerBase::msg_once_window(const QString &group, const int id, const QString &title, const QString &msg, LIISimMessageType type)
 {
     // show message in dialog window
-    if(!msgOnceIDs.contains(group, id))
+    msgOnceMutex.lock();
+    bool shown = msgOnceIDs.contains(group, id);
+    msgOnceMutex.unlock();
+
+    if(!shown)
     {
         QMessageBox msgBox;
         msgBox.setWindowTitle(QString("LIISim: %0").arg(title));
@@ -166,6 +218,7 @@ void MsgHandlerBase::msg_once_window(const QString &group, const int id, const Q
 
 void MsgHandlerBase::msg_once_reset(const QString &group, const int id)
 {
+    QMutexLocker lock(&msgOnceMutex);
     if(msgOnceIDs.contains(group, id))
         msgOnceIDs.remove(group, id);
 }
@@ -173,6 +226,7 @@ void MsgHandlerBase::msg_once_reset(const QString &group, const int id)
 
 void MsgHandlerBase::msg_once_reset_group(const QString &group)
 {
+    QMutexLocker lock(&msgOnceMutex);
     if(msgOnceIDs.contains(group))
         msgOnceIDs.remove(group);
 }
@@ -180,6 +234,7 @@ void MsgHandlerBase::msg_once_reset_group(const QString &group)
 
 void MsgHandlerBase::msg_once_reset_all()
 {
+    QMutexLocker lock(&msgOnceMutex);
     msgOnceIDs.clear();
 }
 
@@ -7,6 +7,7 @@
 #include <QList>
 #include <QQueue>
 #include <QMutex>
+#include <QReadWriteLock>
 
 /** @defgroup Logging
   * @brief Global message system and Classes/Widgets for Log-Visualization
@@ -32,6 +33,9 @@ public:
  * It's also possible to take control over the qDebug/qWarn/qCritical/qFatal messages:
  * Therefore install the global message handler: qInstallMessageHandler(&MsgHandlerBase::handleQtMessage);
  *
+ * Messages can be posted from any thread: the handler list, the message
+ * history and the MSG_ONCE ids are guarded by locks. Handlers are called
+ * within the posting thread and must not block (see LogFileHandler).
  */
 
 // Shortcuts for static method calls
@@ -90,8 +94,12 @@ public:
 
     static QString msgTypeToString(LIISimMessageType type);
 
+    static QList<MsgContainterType> lastMessages();
+
 protected:
 
+    void unregisterHandler();
+
     /**
      * @brief handleMessage abstract method for message handling.
      * Subclasses have to implement this method.
@@ -105,22 +113,30 @@ protected:
                                const QString &msg,
                                const QMessageLogContext &context) = 0;
 
+    QMutex msgMutex;
+
+
+private:
+
     /**
-     * @brief msgHistory holds last X messages
+     * @brief msgHistory holds last X messages (guarded by historyMutex)
      */
     static QQueue<MsgContainterType> msgHistory;
+    static QMutex historyMutex;
 
     static QMultiMap<QString,int> msgOnceIDs;
-
-    QMutex msgMutex;
-
-
-private:
+    static QMutex msgOnceMutex;
 
     /**
      * @brief registredHandlers global list of registered subclass instatnces
+     * (guarded by handlerLock: read while dispatching, write while (un)registering)
      */
     static QList<MsgHandlerBase*> registredHandlers;
+    static QReadWriteLock handlerLock;
+
+    static void dispatch(LIISimMessageType type,
+                         const QString &msg,
+                         const QMessageLogContext &context);
 
 };
 
@@ -75,13 +75,54 @@
 #include "gui/masterwindow.h"
 
 #include "signal/processing/pluginfactory.h"
+#include "models/dataitem.h"
 
 #include "io/ioxml.h"
+#include "io/fitresultfile.h"
 
 #include "general/singleinstanceguard.h"
 
+#include "general/batchprocessor.h"
+#include "general/benchmark.h"
+
+
+/**
+ * @brief registerMetaTypes register meta types (for signal/slot mechanism for multiple threads)
+ */
+static void registerMetaTypes()
+{
+    qRegisterMetaType<LIISimMessageType>("LIISimMessageType");
+    qRegisterMetaType<SignalFileInfoList>("SignalFileInfoList");
+    qRegisterMetaType<SignalFileInfo>("SignalFileInfo");
+    qRegisterMetaType<SignalIORequest>("SignalIORequest");
+    qRegisterMetaType<Signal::SType>("Signal::SType");
+    qRegisterMetaType<QTextBlock>("QTextBlock");
+    qRegisterMetaType<QTextCursor>("QTextCursor");
+    qRegisterMetaType<QTextCharFormat>("QTextCharFormat");
+    qRegisterMetaType<QList<SignalIORequest>>("QList<SignalIORequest>");
+    qRegisterMetaType<LogMessage>("LogMessage");
+    qRegisterMetaType<DataItemChangeSet>("DataItemChangeSet");
+}
+
+
 int main(int argc, char *argv[])
 {    
+    // benchmarks on synthetic data (see Benchmark), checked first:
+    // batch builds (LIISIM_BATCH) always take the batch branch
+    if(Benchmark::isBenchmarkCall(argc, argv))
+    {
+        registerMetaTypes();
+        return Benchmark::exec(argc, argv);
+    }
+
+    // command line batch processing without main window,
+    // multiple instances are allowed (see BatchProcessor)
+    if(BatchProcessor::isBatchCall(argc, argv))
+    {
+        registerMetaTypes();
+        return BatchProcessor::exec(argc, argv);
+    }
+
     SingleInstanceGuard guard("random_key");
     if(!guard.tryToRun())
     {
@@ -94,17 +135,7 @@ int main(int argc, char *argv[])
     }
 
 
-    // register meta types (for signal/slot mechanism for multiple threads)
-    qRegisterMetaType<LIISimMessageType>("LIISimMessageType");
-    qRegisterMetaType<SignalFileInfoList>("SignalFileInfoList");
-    qRegisterMetaType<SignalFileInfo>("SignalFileInfo");
-    qRegisterMetaType<SignalIORequest>("SignalIORequest");
-    qRegisterMetaType<Signal::SType>("Signal::SType");
-    qRegisterMetaType<QTextBlock>("QTextBlock");
-    qRegisterMetaType<QTextCursor>("QTextCursor");
-    qRegisterMetaType<QTextCharFormat>("QTextCharFormat");
-    qRegisterMetaType<QList<SignalIORequest>>("QList<SignalIORequest>");
-    qRegisterMetaType<LogMessage>("LogMessage");
+    registerMetaTypes();
 
     qInstallMessageHandler(&MsgHandlerBase::handleQtMessage);
 
@@ -163,7 +194,10 @@ int main(int argc, char *argv[])
             // manually process pending events (signals) in Eventloop
             // why? -> main eventloop is finished after 'app.exec()'!
             QApplication::processEvents();
-        }        
+        }
+
+        // fit results are written to the sidecar files in background
+        FitResultFile::waitForPendingWrites();
     }
     catch(LIISimException e)
     {
@@ -1,4 +1,5 @@
 #include "dataitem.h"
+#include "datamodel.h"
 #include "../logging/msghandlerbase.h"
 
 int DataItem::m_id_count = 0;
@@ -38,6 +39,8 @@ DataItem::~DataItem(){
     if(m_parent)
         m_parent->removeChild(this);
 
+    DataModel::discardChanges(this);
+
     emit destroyed(m_id);
 }
 
@@ -51,6 +54,8 @@ DataItem::~DataItem(){
  * data vector. The data vector is appended if position equals the length of
  * the data vector. If position is negative or exceeds the data vector size
  * no changes to the data vector are made.
+ * The dataChanged() signal is emitted immediately, observers are notified
+ * by the (coalesced) dataChangeSetReady() signal.
  */
 bool DataItem::setData(int pos, QVariant value)
 {
@@ -64,10 +69,12 @@ bool DataItem::setData(int pos, QVariant value)
         m_data.append( value );
         // qDebug() << "DataItem::setData: appended data vector "<<pos;
         emit dataChanged(pos,value);
+        DataModel::recordChange(this, pos, value);
         return true;
     }
     m_data[pos] = value;
     emit dataChanged(pos,value);
+    DataModel::recordChange(this, pos, value);
     return true;
 }
 
@@ -5,6 +5,12 @@
 #include <QDebug>
 #include <QVariant>
 #include <QVector>
+#include <QMap>
+
+/**
+ * @brief DataItemChangeSet maps modified positions of the data vector to their latest value
+ */
+typedef QMap<int, QVariant> DataItemChangeSet;
 
 
 /**
@@ -12,6 +18,9 @@
  * @ingroup Hierachical-Data-Model
  * Each DataItem stores a vector of various types of data (QVariant).
  * If the data has been modified a dataChanged() signal is emitted.
+ * Observers (DataItemObserverObject/-Widget) are notified via dataChangeSetReady(),
+ * which is emitted once per frame (or at the end of an update scope, see
+ * DataModelUpdateScope) with all modified positions of the item.
  * A DataItem takes ownership of all children. This means that all children
  * will be destroyed if a DataItem is destroyed (via the QObject tree).
  * Further signals allow observers to handle certain events (child added/removed).
@@ -76,6 +85,13 @@ signals:
      */
     void dataChanged(int pos = -1, QVariant value = 0);
 
+    /**
+     * @brief dataChangeSetReady This signal is emitted (delayed) with the latest values
+     * of all positions which have been set since the last emission.
+     * @param changes modified positions and values
+     */
+    void dataChangeSetReady(const DataItemChangeSet &changes);
+
     /**
      * @brief childInserted This signal is emitted if a DataItem has been inserted to the children list
      * @param child pointer to child DataItem
@@ -15,7 +15,7 @@ DataItemObserverObject::DataItemObserverObject(DataItem *data, QObject *parent)
     {
         // connect oberserver slots
         connect(data,SIGNAL(destroyed()),SLOT(onDataDestroyed()));
-        connect(data,SIGNAL(dataChanged(int,QVariant)),SLOT(onDataChanged(int,QVariant)));
+        connect(data,SIGNAL(dataChangeSetReady(DataItemChangeSet)),SLOT(onDataChangeSet(DataItemChangeSet)));
         connect(data, SIGNAL(childInserted(DataItem*, int)), SLOT(onDataChildInserted(DataItem*, int)));
         connect(data, SIGNAL(childRemoved(DataItem*)),SLOT(onDataChildRemoved(DataItem*)));
 
@@ -44,7 +44,7 @@ void DataItemObserverObject::setDataItem(DataItem *dataItem)
     }
     // connect oberserver slots
     connect(dataItem,SIGNAL(destroyed()),SLOT(onDataDestroyed()));
-    connect(dataItem,SIGNAL(dataChanged(int,QVariant)),SLOT(onDataChanged(int,QVariant)));
+    connect(dataItem,SIGNAL(dataChangeSetReady(DataItemChangeSet)),SLOT(onDataChangeSet(DataItemChangeSet)));
     connect(dataItem, SIGNAL(childInserted(DataItem*, int)), SLOT(onDataChildInserted(DataItem*,int)));
     connect(dataItem, SIGNAL(childRemoved(DataItem*)),SLOT(onDataChildRemoved(DataItem*)));
 
@@ -64,6 +64,20 @@ void DataItemObserverObject::onDataChanged(int pos, QVariant value)
 }
 
 
+/**
+ * @brief DataItemObserverObject::onDataChangeSet handles the coalesced changes of the
+ * observed DataItem (see DataItem::dataChangeSetReady()). The default implementation
+ * calls onDataChanged() for each modified position. Reimplement this slot
+ * to update once for all changes.
+ * @param changes modified positions and their latest values
+ */
+void DataItemObserverObject::onDataChangeSet(const DataItemChangeSet &changes)
+{
+    for(DataItemChangeSet::const_iterator it = changes.constBegin(); it != changes.constEnd(); ++it)
+        onDataChanged(it.key(), it.value());
+}
+
+
 /**
  * @brief DataItemObserverObject::onDataChildInserted
  * @param child_data
@@ -48,6 +48,7 @@ protected slots:
 
 
     virtual void onDataChanged(int pos, QVariant value);
+    virtual void onDataChangeSet(const DataItemChangeSet &changes);
     virtual void onDataChildInserted( DataItem* child_data, int position);
     virtual void onDataChildRemoved( DataItem* child_data);
     virtual void onDataDestroyed();
@@ -9,6 +9,10 @@
 
 #include "../logging/msghandlerbase.h"
 
+#include <QThread>
+
+DataModel* DataModel::m_instance = 0;
+
 /**
  * @brief DataModel::DataModel Constructor
  * @param parent
@@ -17,6 +21,13 @@ DataModel::DataModel(QObject *parent) :   QObject(parent)
 {
     MSG_DETAIL_1("init DataModel");
 
+    m_updateDepth = 0;
+    m_changeTimer = new QTimer(this);
+    m_changeTimer->setSingleShot(true);
+    m_changeTimer->setInterval(changeFlushInterval);
+    connect(m_changeTimer, SIGNAL(timeout()), SLOT(flushChanges()));
+    m_instance = this;
+
     m_dataRoot = new DataItem();
     m_dataRoot->setData(0,"Root of All Evil");
 
@@ -52,6 +63,10 @@ DataModel::DataModel(QObject *parent) :   QObject(parent)
  */
 DataModel::~DataModel()
 {
+    // no change notifications while destroying the data tree
+    if(m_instance == this)
+        m_instance = 0;
+
     m_groups.clear();
     m_mruns.clear();
 
@@ -319,6 +334,8 @@ void DataModel::moveToGroupActionTriggered(QAction *action)
 
     QList<QVariant> m_ids = action->data().toList();
 
+    DataModelUpdateScope update(this);
+
     for(int i = 0; i < m_ids.size(); i++)
     {
         int m_id = m_ids.at(i).toInt();
@@ -351,6 +368,8 @@ void DataModel::onActionMoveToNewGroup()
 
     QList<QVariant> m_ids = m_actionMoveToNewGroup->data().toList();
 
+    DataModelUpdateScope update(this);
+
     for(int i = 0; i < m_ids.size(); i++)
     {
         int m_id = m_ids.at(i).toInt();
@@ -385,6 +404,8 @@ void DataModel::groupColorMapActionTriggered(QAction *action)
     int actionIndex = m_groupColorMapActions.indexOf(action);
     QColor col;
 
+    DataModelUpdateScope update(this);
+
     // ColorMapAction list is initialized in Constructor DataModel::DataModel()
     switch(actionIndex)
     {
@@ -420,8 +441,160 @@ void DataModel::groupColorMapActionTriggered(QAction *action)
 void DataModel::onActionCloseAllMRuns()
 {
     QList<MRun*> runs = m_mruns.values();
+
+    DataModelUpdateScope update(this);
+
     for(int i = 0; i < runs.size(); i++)
     {
         delete runs.at(i);
     }
 }
+
+
+/**
+ * @brief DataModel::beginUpdate starts an update scope. Changes of DataItems
+ * are collected until the outermost scope has been closed by endUpdate().
+ * Use DataModelUpdateScope to ensure that each call is paired with endUpdate().
+ */
+void DataModel::beginUpdate()
+{
+    QMutexLocker lock(&m_changeMutex);
+    m_updateDepth++;
+}
+
+
+/**
+ * @brief DataModel::endUpdate ends an update scope. If this was the outermost
+ * scope, all collected changes are delivered.
+ */
+void DataModel::endUpdate()
+{
+    {
+        QMutexLocker lock(&m_changeMutex);
+        if(m_updateDepth > 0)
+            m_updateDepth--;
+        if(m_updateDepth > 0 || m_changedItems.isEmpty())
+            return;
+    }
+
+    if(QThread::currentThread() == thread())
+        flushChanges();
+    else
+        QMetaObject::invokeMethod(this, "flushChanges", Qt::QueuedConnection);
+}
+
+
+/**
+ * @brief DataModel::isUpdating
+ * @return true if an update scope is active
+ */
+bool DataModel::isUpdating()
+{
+    QMutexLocker lock(&m_changeMutex);
+    return m_updateDepth > 0;
+}
+
+
+/**
+ * @brief DataModel::recordChange stores modified value of a DataItem
+ * (called by DataItem::setData(), thread-safe). If no DataModel exists,
+ * the change is delivered immediately.
+ * @param item modified item
+ * @param pos position in data vector
+ * @param value new value
+ */
+void DataModel::recordChange(DataItem *item, int pos, const QVariant &value)
+{
+    DataModel* model = m_instance;
+    if(!model)
+    {
+        DataItemChangeSet changes;
+        changes.insert(pos, value);
+        emit item->dataChangeSetReady(changes);
+        return;
+    }
+
+    bool startTimer = false;
+    {
+        QMutexLocker lock(&model->m_changeMutex);
+
+        if(!model->m_changes.contains(item))
+        {
+            // first change since last delivery
+            startTimer = model->m_changedItems.isEmpty() && model->m_updateDepth == 0;
+            model->m_changedItems.append(item);
+        }
+        // later values of same position replace earlier ones
+        model->m_changes[item].insert(pos, value);
+    }
+
+    if(!startTimer)
+        return;
+
+    if(QThread::currentThread() == model->thread())
+        model->startChangeTimer();
+    else
+        QMetaObject::invokeMethod(model, "startChangeTimer", Qt::QueuedConnection);
+}
+
+
+/**
+ * @brief DataModel::discardChanges removes pending changes of a destroyed DataItem
+ * @param item
+ */
+void DataModel::discardChanges(DataItem *item)
+{
+    DataModel* model = m_instance;
+    if(!model)
+        return;
+
+    QMutexLocker lock(&model->m_changeMutex);
+    if(model->m_changes.remove(item) > 0)
+        model->m_changedItems.removeOne(item);
+}
+
+
+void DataModel::startChangeTimer()
+{
+    if(!m_changeTimer->isActive())
+        m_changeTimer->start();
+}
+
+
+/**
+ * @brief DataModel::flushChanges delivers all pending changes
+ * (one DataItem::dataChangeSetReady() signal per item)
+ */
+void DataModel::flushChanges()
+{
+    m_changeTimer->stop();
+
+    int n;
+    {
+        QMutexLocker lock(&m_changeMutex);
+        n = m_changedItems.size();
+    }
+
+    // changes made by observers during delivery are delivered in the next frame
+    for(int i = 0; i < n; i++)
+    {
+        DataItem* item;
+        DataItemChangeSet changes;
+        {
+            QMutexLocker lock(&m_changeMutex);
+
+            // changes made within a new update scope are delivered at its end
+            if(m_updateDepth > 0 || m_changedItems.isEmpty())
+                return;
+
+            // take items one by one: observers may modify or delete other items
+            item = m_changedItems.takeFirst();
+            changes = m_changes.take(item);
+        }
+        emit item->dataChangeSetReady(changes);
+    }
+
+    QMutexLocker lock(&m_changeMutex);
+    if(m_updateDepth == 0 && !m_changedItems.isEmpty())
+        m_changeTimer->start();
+}
@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QHash>
 #include <QAction>
+#include <QMutex>
+#include <QTimer>
 
 #include "dataitem.h"
 
@@ -16,6 +18,12 @@ class FitRun;
  * @ingroup Hierachical-Data-Model
  * programs main models (MRunGroup, MRun, ProcessingChain, ProcessingPlugin, etc.)
  * and provides functionality for data access.
+ *
+ * Modifications of DataItems (DataItem::setData()) are collected per item and
+ * position and delivered to observers as one DataItem::dataChangeSetReady()
+ * signal per item and frame (changeFlushInterval). Bulk operations should be
+ * enclosed by beginUpdate()/endUpdate() (see DataModelUpdateScope): all changes
+ * are delivered at the end of the outermost update scope.
  */
 class DataModel : public QObject
 {
@@ -58,6 +66,13 @@ public:
 
     inline QList<FitRun*> fitRuns(){return m_fitruns.values();}
 
+    /** @brief max. delay of change notifications outside of update scopes [ms] (one frame) */
+    static const int changeFlushInterval = 16;
+
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating();
+
 
 private:
 
@@ -88,6 +103,27 @@ private:
     /// @brief id of a default group for MRuns
     int m_default_group_id;
 
+    /// @brief model instance which collects DataItem changes
+    static DataModel* m_instance;
+
+    /// @brief guards pending changes and update depth (DataItems may be modified by worker threads)
+    QMutex m_changeMutex;
+
+    /// @brief items with pending changes (in order of first modification)
+    QList<DataItem*> m_changedItems;
+
+    /// @brief pending changes per item
+    QHash<DataItem*, DataItemChangeSet> m_changes;
+
+    /// @brief nesting level of update scopes
+    int m_updateDepth;
+
+    /// @brief delays delivery of changes outside of update scopes
+    QTimer* m_changeTimer;
+
+    static void recordChange(DataItem* item, int pos, const QVariant &value);
+    static void discardChanges(DataItem* item);
+
 signals:
 
     /**
@@ -121,9 +157,43 @@ private slots:
 
     void ungregisterDataItem(int id);
 
+    void startChangeTimer();
+    void flushChanges();
+
     void onActionCloseAllMRuns();
     void onActionMoveToNewGroup();
 
 };
 
+
+
+/**
+ * @brief The DataModelUpdateScope class encloses a bulk operation
+ * in DataModel::beginUpdate() / DataModel::endUpdate()
+ * @ingroup Hierachical-Data-Model
+ * Usage:
+ *      DataModelUpdateScope update(Core::instance()->dataModel());
+ *      for(...) mrun->setData(...);
+ */
+class DataModelUpdateScope
+{
+public:
+    explicit DataModelUpdateScope(DataModel* model) : m_model(model)
+    {
+        if(m_model)
+            m_model->beginUpdate();
+    }
+
+    ~DataModelUpdateScope()
+    {
+        if(m_model)
+            m_model->endUpdate();
+    }
+
+private:
+    DataModel* m_model;
+
+    Q_DISABLE_COPY(DataModelUpdateScope)
+};
+
 #endif // DATAMODEL_H
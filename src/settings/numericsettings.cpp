@@ -14,6 +14,7 @@ NumericSettings::NumericSettings(QObject *parent) : SettingsBase(parent)
     key_stepSize        = "stepSize";
     key_startTime       = "startTime";
     key_simLength       = "simLength";
+    key_stagnationIterations = "stagnationIterations";
 
     m_iterationsDefault     = defaultFitMaxIterations();
     m_iterations            = m_iterationsDefault;
@@ -26,6 +27,8 @@ NumericSettings::NumericSettings(QObject *parent) : SettingsBase(parent)
 
     m_odeSolver_stepSizeFactor  = 1;
 
+    m_stagnationIterations  = 0;
+
     init();
 }
 
@@ -41,6 +44,17 @@ int NumericSettings::defaultFitMaxIterations()
 }
 
 
+/**
+ * @brief NumericSettings::defaultStagnationIterations
+ * @return suggested value for the stagnation criterion of batch fits
+ * (see FT_NumericParamTable)
+ */
+int NumericSettings::defaultStagnationIterations()
+{
+    return 10;
+}
+
+
 /**
  * @brief NumericSettings::defaultStepSize
  * @return default value for fit stepsize [s]
@@ -66,6 +80,8 @@ void NumericSettings::init()
         settings.insert(key_startTime, 0.0f);
     if(!settings.contains(key_simLength))
         settings.insert(key_simLength, 2000.0f);
+    if(!settings.contains(key_stagnationIterations))
+        settings.insert(key_stagnationIterations, 0);
 }
 
 
@@ -93,6 +109,14 @@ void NumericSettings::setOdeSolverStepSizeFactor(int fac)
 }
 
 
+void NumericSettings::setStagnationIterations(int iterations)
+{
+    m_stagnationIterations = iterations;
+    settings.insert(key_stagnationIterations, m_stagnationIterations);
+    emit settingsChanged();
+}
+
+
 void NumericSettings::setStepSize(double stepSize)
 {
     m_stepSize = stepSize;
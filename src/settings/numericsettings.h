@@ -21,9 +21,14 @@ public:
 
     inline int odeSolverIdx() { return m_odeSolver; }
 
+    /** @brief levmar() stops if chisquare did not improve by more than
+     * stagnation_tolerance (relative) within this number of iterations (0: disabled) */
+    inline int stagnationIterations() const { return m_stagnationIterations; }
+
     void setIterations(int iterations);
     void setOdeSolver(int idx);
     void setOdeSolverStepSizeFactor(int fac);
+    void setStagnationIterations(int iterations);
 
     void setStepSize(double stepSize);
     void setStartTime(double startTime);
@@ -32,6 +37,7 @@ public:
     static int defaultFitMaxIterations();
     static double defaultStepSize();
     static int defaultODE();
+    static int defaultStagnationIterations();
 
     // default lambdas for levmar() can be overwritten
     double lambda_init = 0.1;       // 0.1
@@ -39,6 +45,9 @@ public:
     double lambda_increase = 2.0;   // 2.0
     double lambda_scaling = 5.0;    // 5.0
 
+    // relative chisquare improvement required within stagnationIterations()
+    double stagnation_tolerance = 1E-4;
+
 private:
     void init();
 
@@ -48,6 +57,7 @@ private:
     QString key_stepSize;
     QString key_startTime;
     QString key_simLength;
+    QString key_stagnationIterations;
 
     int m_iterations;
     int m_iterationsDefault;
@@ -57,6 +67,8 @@ private:
 
     int m_odeSolver_stepSizeFactor;
 
+    int m_stagnationIterations;
+
     double m_stepSize;
     double m_stepSizeDefault;
     double m_startTime;
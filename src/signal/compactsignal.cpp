@@ -0,0 +1,99 @@
+#include "compactsignal.h"
+
+#include <cstring>
+
+
+CompactSignal::CompactSignal()
+{
+    scale = 1.0;
+    offset = 0.0;
+}
+
+
+/**
+ * @brief CompactSignal::CompactSignal copies the ADC counts
+ * @param counts
+ * @param size number of samples
+ * @param scale [unit/count]
+ * @param offset [unit]
+ */
+CompactSignal::CompactSignal(const qint16 *counts, int size, double scale, double offset)
+{
+    this->counts.resize(size);
+    memcpy(this->counts.data(), counts, size * sizeof(qint16));
+    this->scale = scale;
+    this->offset = offset;
+}
+
+
+void CompactSignal::clear()
+{
+    counts.clear();
+    values.clear();
+    scale = 1.0;
+    offset = 0.0;
+}
+
+
+/**
+ * @brief CompactSignal::decode converts all counts/values to double
+ * @param result is resized to size()
+ */
+void CompactSignal::decode(QVector<double> &result) const
+{
+    if(counts.isEmpty())
+    {
+        toDouble(values, result);
+        return;
+    }
+
+    const int n = counts.size();
+    result.resize(n);
+
+    const qint16 *in = counts.constData();
+    double *out = result.data();
+    const double s = scale;
+    const double o = offset;
+
+    for(int i = 0; i < n; i++)
+        out[i] = in[i] * s + o;
+}
+
+
+/**
+ * @brief CompactSignal::fromValues
+ * @param data
+ * @return single precision copy of data
+ */
+CompactSignal CompactSignal::fromValues(const QVector<double> &data)
+{
+    CompactSignal result;
+    toSingle(data, result.values);
+    return result;
+}
+
+
+void CompactSignal::toSingle(const QVector<double> &data, QVector<float> &result)
+{
+    const int n = data.size();
+    result.resize(n);
+
+    const double *in = data.constData();
+    float *out = result.data();
+
+    for(int i = 0; i < n; i++)
+        out[i] = float(in[i]);
+}
+
+
+void CompactSignal::toDouble(const QVector<float> &data, QVector<double> &result)
+{
+    const int n = data.size();
+    result.resize(n);
+
+    const float *in = data.constData();
+    double *out = result.data();
+
+    for(int i = 0; i < n; i++)
+        out[i] = in[i];
+}
@@ -0,0 +1,44 @@
+#ifndef COMPACTSIGNAL_H
+#define COMPACTSIGNAL_H
+
+#include <QVector>
+
+/**
+ * @brief The CompactSignal class stores signal data as 16 bit ADC counts
+ * or as single precision values
+ * @ingroup Hierachical-Data-Model
+ * @details counts: value = counts * scale + offset. Used by SignalPair to keep
+ * the raw/absolute source data of acquired runs (a quarter of the memory of
+ * Signal::data) and the signals of runs processed in single precision mode
+ * (see MRun::setSinglePrecision()). The data is converted when the signal is
+ * requested (see MPoint::getSignal()). The vectors are implicitly shared, raw
+ * and absolute signal of an acquired MPoint use the same data.
+ */
+class CompactSignal
+{
+public:
+    CompactSignal();
+    CompactSignal(const qint16 *counts, int size, double scale, double offset = 0.0);
+
+    /** @brief ADC counts */
+    QVector<qint16> counts;
+    /** @brief single precision values (used if counts is empty) */
+    QVector<float> values;
+    /** @brief conversion factor [unit/count] */
+    double scale;
+    /** @brief conversion offset [unit] */
+    double offset;
+
+    inline bool isEmpty() const { return counts.isEmpty() && values.isEmpty(); }
+    inline int size() const { return counts.isEmpty() ? values.size() : counts.size(); }
+
+    void clear();
+
+    void decode(QVector<double> &result) const;
+
+    static CompactSignal fromValues(const QVector<double> &data);
+    static void toSingle(const QVector<double> &data, QVector<float> &result);
+    static void toDouble(const QVector<float> &data, QVector<double> &result);
+};
+
+#endif // COMPACTSIGNAL_H
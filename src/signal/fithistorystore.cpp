@@ -0,0 +1,371 @@
+#include "fithistorystore.h"
+
+#include <QMutexLocker>
+#include <QSet>
+#include <cmath>
+
+
+QString FitHistoryStore::retentionToString(Retention retention)
+{
+    switch(retention)
+    {
+    case FINAL:
+        return "Final iteration";
+    case EVERY_NTH:
+        return "Every n-th iteration";
+    default:
+        return "All iterations";
+    }
+}
+
+
+FitHistoryStore::Retention FitHistoryStore::retentionFromString(const QString &str)
+{
+    if(str == retentionToString(FINAL))
+        return FINAL;
+    if(str == retentionToString(FULL))
+        return FULL;
+    return EVERY_NTH;
+}
+
+
+// ------------------------------------------------------------------
+// Trace
+// ------------------------------------------------------------------
+
+
+FitHistoryStore::Trace::Trace()
+{
+    start_time = 0.0;
+    dt = 1.0;
+    retention = FULL;
+    interval = 1;
+    noParams = 0;
+    offsets.append(0);
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::setRetention sets the retention policy
+ * for following append() calls
+ * @param retention
+ * @param interval iteration interval (EVERY_NTH)
+ */
+void FitHistoryStore::Trace::setRetention(Retention retention, int interval)
+{
+    this->retention = retention;
+    this->interval = qMax(1, interval);
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::init clears the trace (retention policy is kept)
+ * @param start_time time of first step [s]
+ * @param dt time between steps [s]
+ */
+void FitHistoryStore::Trace::init(double start_time, double dt)
+{
+    this->start_time = start_time;
+    this->dt = dt;
+
+    noParams = 0;
+    offsets.clear();
+    offsets.append(0);
+    iterationNumbers.clear();
+    values.clear();
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::append adds the iterations of the next
+ * time step (filtered by the retention policy)
+ * @param iterations all iterations of the fit (see FitData::iterationResultList())
+ */
+void FitHistoryStore::Trace::append(const QList<FitIterationResult> &iterations)
+{
+    const int n = iterations.size();
+
+    if(noParams == 0 && n > 0)
+        noParams = iterations.first().size();
+
+    for(int i = 0; i < n; i++)
+    {
+        bool keep = (i == n - 1)
+                || retention == FULL
+                || (retention == EVERY_NTH && i % interval == 0);
+        if(!keep)
+            continue;
+
+        const FitIterationResult &res = iterations.at(i);
+        for(int p = 0; p < noParams; p++)
+            values.append(p < res.size() ? res.at(p) : 0.0);
+
+        iterationNumbers.append(i);
+    }
+
+    offsets.append(iterationNumbers.size());
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::indexAt
+ * @param time [s]
+ * @return index of time step or -1 if time is out of range
+ */
+int FitHistoryStore::Trace::indexAt(double time) const
+{
+    if(isEmpty() || dt <= 0.0)
+        return -1;
+
+    int idx = int(std::floor((time - start_time) / dt + 0.5));
+    if(idx < 0 || idx >= steps())
+        return -1;
+    return idx;
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::iterationCount
+ * @param step time step
+ * @return number of stored iterations of time step
+ */
+int FitHistoryStore::Trace::iterationCount(int step) const
+{
+    if(step < 0 || step >= steps())
+        return 0;
+    return offsets.at(step+1) - offsets.at(step);
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::iterationNumber
+ * @param step time step
+ * @param i stored iteration
+ * @return iteration number of the fit
+ */
+int FitHistoryStore::Trace::iterationNumber(int step, int i) const
+{
+    return iterationNumbers.at(offsets.at(step) + i);
+}
+
+
+double FitHistoryStore::Trace::value(int step, int i, int param) const
+{
+    return values.at((offsets.at(step) + i) * noParams + param);
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::finalValue
+ * @param step time step
+ * @param param index within FitIterationResult (0: chi-square, 1: lambda, 2: T, 4: C, ...)
+ * @return value of final iteration (0.0 if not available)
+ */
+double FitHistoryStore::Trace::finalValue(int step, int param) const
+{
+    if(iterationCount(step) == 0 || param >= noParams)
+        return 0.0;
+    return values.at((offsets.at(step+1) - 1) * noParams + param);
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::iterations
+ * @param step time step
+ * @return stored iterations of time step
+ */
+QList<FitIterationResult> FitHistoryStore::Trace::iterations(int step) const
+{
+    QList<FitIterationResult> res;
+
+    const int n = iterationCount(step);
+    for(int i = 0; i < n; i++)
+    {
+        FitIterationResult fir(noParams);
+        for(int p = 0; p < noParams; p++)
+            fir[p] = value(step, i, p);
+        res.append(fir);
+    }
+    return res;
+}
+
+
+FitIterationResult FitHistoryStore::Trace::finalIteration(int step) const
+{
+    FitIterationResult fir(noParams);
+    for(int p = 0; p < noParams; p++)
+        fir[p] = finalValue(step, p);
+    return fir;
+}
+
+
+/**
+ * @brief FitHistoryStore::Trace::memoryUsage
+ * @return size of stored data [bytes]
+ */
+quint64 FitHistoryStore::Trace::memoryUsage() const
+{
+    return quint64(values.capacity()) * sizeof(double)
+            + quint64(iterationNumbers.capacity() + offsets.capacity()) * sizeof(int);
+}
+
+
+// ------------------------------------------------------------------
+// FitHistoryStore
+// ------------------------------------------------------------------
+
+
+FitHistoryStore::FitHistoryStore()
+{
+}
+
+
+/**
+ * @brief FitHistoryStore::setTrace stores the fit history of a temperature signal
+ * @param mpIdx MPoint index
+ * @param chID temperature channel ID
+ * @param trace
+ */
+void FitHistoryStore::setTrace(int mpIdx, int chID, const Trace &trace)
+{
+    Trace t = trace;
+    t.values.squeeze();
+    t.iterationNumbers.squeeze();
+    t.offsets.squeeze();
+
+    QMutexLocker lock(&m_mutex);
+    m_traces.insert(qMakePair(mpIdx, chID), t);
+}
+
+
+/**
+ * @brief FitHistoryStore::copyTrace shares the history of a MPoint with
+ * another MPoint (MultiSignalAverage: one fit for all MPoints)
+ */
+void FitHistoryStore::copyTrace(int fromMpIdx, int toMpIdx, int chID)
+{
+    QMutexLocker lock(&m_mutex);
+
+    QPair<int,int> from = qMakePair(fromMpIdx, chID);
+    if(m_traces.contains(from))
+        m_traces.insert(qMakePair(toMpIdx, chID), m_traces.value(from));
+    else
+        m_traces.remove(qMakePair(toMpIdx, chID));
+}
+
+
+/**
+ * @brief FitHistoryStore::trace
+ * @param mpIdx MPoint index
+ * @param chID temperature channel ID
+ * @return fit history (empty trace if not available)
+ */
+FitHistoryStore::Trace FitHistoryStore::trace(int mpIdx, int chID) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_traces.value(qMakePair(mpIdx, chID));
+}
+
+
+bool FitHistoryStore::contains(int mpIdx, int chID) const
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_traces.constFind(qMakePair(mpIdx, chID));
+    return it != m_traces.constEnd() && !it.value().isEmpty();
+}
+
+
+/**
+ * @brief FitHistoryStore::channelTraces
+ * @param chID temperature channel ID
+ * @return histories of all MPoints of the channel (key: MPoint index)
+ */
+QMap<int, FitHistoryStore::Trace> FitHistoryStore::channelTraces(int chID) const
+{
+    QMutexLocker lock(&m_mutex);
+
+    QMap<int, Trace> res;
+    for(auto it = m_traces.constBegin(); it != m_traces.constEnd(); ++it)
+        if(it.key().second == chID)
+            res.insert(it.key().first, it.value());
+    return res;
+}
+
+
+/**
+ * @brief FitHistoryStore::setChannelTraces replaces the histories of all
+ * MPoints of a channel (see channelTraces())
+ * @param chID temperature channel ID
+ * @param traces key: MPoint index
+ */
+void FitHistoryStore::setChannelTraces(int chID, const QMap<int, Trace> &traces)
+{
+    QMutexLocker lock(&m_mutex);
+
+    auto it = m_traces.begin();
+    while(it != m_traces.end())
+    {
+        if(it.key().second == chID)
+            it = m_traces.erase(it);
+        else
+            ++it;
+    }
+
+    for(auto t = traces.constBegin(); t != traces.constEnd(); ++t)
+        m_traces.insert(qMakePair(t.key(), chID), t.value());
+}
+
+
+void FitHistoryStore::remove(int mpIdx, int chID)
+{
+    QMutexLocker lock(&m_mutex);
+    m_traces.remove(qMakePair(mpIdx, chID));
+}
+
+
+/**
+ * @brief FitHistoryStore::removeChannel removes the histories of all MPoints
+ * @param chID temperature channel ID
+ */
+void FitHistoryStore::removeChannel(int chID)
+{
+    QMutexLocker lock(&m_mutex);
+
+    auto it = m_traces.begin();
+    while(it != m_traces.end())
+    {
+        if(it.key().second == chID)
+            it = m_traces.erase(it);
+        else
+            ++it;
+    }
+}
+
+
+void FitHistoryStore::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_traces.clear();
+}
+
+
+/**
+ * @brief FitHistoryStore::memoryUsage
+ * @return size of all stored histories [bytes], shared traces are counted once
+ */
+quint64 FitHistoryStore::memoryUsage() const
+{
+    QMutexLocker lock(&m_mutex);
+
+    quint64 sum = 0;
+    QSet<const double*> counted;
+    for(auto it = m_traces.constBegin(); it != m_traces.constEnd(); ++it)
+    {
+        const double* ptr = it.value().values.constData();
+        if(counted.contains(ptr))
+            continue;
+        counted.insert(ptr);
+        sum += it.value().memoryUsage();
+    }
+    return sum;
+}
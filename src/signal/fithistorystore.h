@@ -0,0 +1,105 @@
+#ifndef FITHISTORYSTORE_H
+#define FITHISTORYSTORE_H
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include "../calculations/fit/fititerationresult.h"
+
+
+/**
+ * @brief The FitHistoryStore class keeps the iteration histories of the
+ * spectral temperature fits of a MRun (see Temperature::calcTemperatureFromSpectrum())
+ * @ingroup Hierachical-Data-Model
+ * @details For each MPoint and temperature channel one Trace is stored,
+ * all iterations of all time steps are kept within contiguous arrays
+ * (one row of FitIterationResult values per stored iteration: chi-square,
+ * lambda, parameters/deltas). The retention policy of a trace defines
+ * which iterations are kept: final iteration only, every n-th iteration
+ * (plus final iteration) or all iterations.
+ * All methods are thread safe, traces are implicitly shared.
+ */
+class FitHistoryStore
+{
+public:
+
+    enum Retention { FINAL, EVERY_NTH, FULL };
+
+    static QString retentionToString(Retention retention);
+    static Retention retentionFromString(const QString &str);
+
+    /**
+     * @brief The Trace class stores the fit history of one temperature signal
+     */
+    class Trace
+    {
+    public:
+        Trace();
+
+        void setRetention(Retention retention, int interval);
+        void init(double start_time, double dt);
+        void append(const QList<FitIterationResult> &iterations);
+
+        /** @brief number of time steps */
+        inline int steps() const { return offsets.size() - 1; }
+        inline bool isEmpty() const { return steps() <= 0; }
+
+        int indexAt(double time) const;
+
+        int iterationCount(int step) const;
+        int iterationNumber(int step, int i) const;
+        double value(int step, int i, int param) const;
+        double finalValue(int step, int param) const;
+
+        QList<FitIterationResult> iterations(int step) const;
+        FitIterationResult finalIteration(int step) const;
+
+        quint64 memoryUsage() const;
+
+        /** @brief time of first step [s] */
+        double start_time;
+        /** @brief time between steps [s] */
+        double dt;
+
+        Retention retention;
+        int interval;
+
+        /** @brief number of values per iteration row */
+        int noParams;
+
+        /** @brief index of first row of each step (size: steps()+1) */
+        QVector<int> offsets;
+        /** @brief iteration number of each row */
+        QVector<int> iterationNumbers;
+        /** @brief iteration values, row after row */
+        QVector<double> values;
+    };
+
+    FitHistoryStore();
+
+    void setTrace(int mpIdx, int chID, const Trace &trace);
+    void copyTrace(int fromMpIdx, int toMpIdx, int chID);
+    Trace trace(int mpIdx, int chID) const;
+    bool contains(int mpIdx, int chID) const;
+
+    QMap<int, Trace> channelTraces(int chID) const;
+    void setChannelTraces(int chID, const QMap<int, Trace> &traces);
+
+    void remove(int mpIdx, int chID);
+    void removeChannel(int chID);
+    void clear();
+
+    quint64 memoryUsage() const;
+
+private:
+    mutable QMutex m_mutex;
+
+    /** @brief key: (MPoint index, temperature channel ID) */
+    QMap<QPair<int,int>, Trace> m_traces;
+};
+
+#endif // FITHISTORYSTORE_H
@@ -1,6 +1,7 @@
 #include "memusagemonitor.h"
 
 #include "../core.h"
+#include "processing/ppresultcache.h"
 
 
 
@@ -71,6 +72,16 @@ bool MemUsageMonitor::checkIfProcessingIsAllowed()
 
     // qDebug() << "phys mem av: " << toMB(av) << "delta next " << toMB(d_est) << " res " << res;
 
+    // release buffered plugin results and check again
+    if(!res && PPResultCache::instance()->memoryUsage() > 0)
+    {
+        MSG_DETAIL_1(QString("%0: releasing buffered processing results (%1 MB)")
+                     .arg(msg_prefix)
+                     .arg(toMB(PPResultCache::instance()->memoryUsage())));
+        PPResultCache::instance()->clear();
+        return checkIfProcessingIsAllowed();
+    }
+
     return res;
 }
 
@@ -130,6 +141,9 @@ bool MemUsageMonitor::updateMemInfo()
 
     #endif
 
+    // buffered processing results may use 10% of the allowed memory
+    PPResultCache::instance()->setBudget(mem_allowed / 10);
+
 
     QString info = QString("%0(physical): "
                            "liisim %1 MB, "
@@ -286,22 +300,34 @@ uint64_t MemUsageMonitor::runDataEstimate()
     uint64_t sigdata = double(noDataPoints*8);
     uint64_t stepdata = double(( sb_d_r + sb_d_a + sb_d_t )*8);
 
+    // temperature fit histories
+    uint64_t fitdata = 0;
+    for(int i = 0; i < mruns.size(); i++)
+        fitdata += mruns[i]->fitHistory()->memoryUsage();
+
+    // buffered plugin results (see PPResultCache)
+    uint64_t cachedata = PPResultCache::instance()->memoryUsage();
+
     QString info = QString("%0(run estimate): "
                            "total %1 MB, "
                            "[signal data %2 MB, "
-                           "step buffer data %3 MB] %4 %5 %6 (shallow vector copies are not considered!!!)")
+                           "step buffer data %3 MB, "
+                           "fit history %7 MB, "
+                           "buffered results %8 MB] %4 %5 %6 (shallow vector copies are not considered!!!)")
             .arg(msg_prefix)
-            .arg(toMB(sigdata + stepdata))
+            .arg(toMB(sigdata + stepdata + fitdata + cachedata))
             .arg(toMB(sigdata))
             .arg(toMB(stepdata))
             .arg(toMB(sb_d_r*8))
             .arg(toMB(sb_d_a*8))
-            .arg(toMB(sb_d_t*8));
+            .arg(toMB(sb_d_t*8))
+            .arg(toMB(fitdata))
+            .arg(toMB(cachedata));
 
     MSG_DETAIL_1(info);
     // MSG_INFO(info);
 
-    return (sigdata + stepdata);
+    return (sigdata + stepdata + fitdata + cachedata);
 }
 
 
@@ -506,19 +532,24 @@ uint64_t MemUsageMonitor::estimateMemUsageForNextProcessingTask()
     uint64_t sigdata = (total_ppr_data + total_upr_data ) * 8;
     uint64_t stepdata = (sb_d_r + sb_d_a + sb_d_t )*8;
 
+    // buffered plugin results are kept (see PPResultCache)
+    uint64_t cachedata = PPResultCache::instance()->memoryUsage();
+
     QString info = QString("%0(next processing task estimate): "
                            "total %1 MB, "
                            "[signal data %2 MB, "
-                           "step buffer data %3 MB] (shallow vector copies are not considered!!!)")
+                           "step buffer data %3 MB, "
+                           "buffered results %4 MB] (shallow vector copies are not considered!!!)")
             .arg(msg_prefix)
-            .arg(toMB(sigdata + stepdata))
+            .arg(toMB(sigdata + stepdata + cachedata))
             .arg(toMB(sigdata))
-            .arg(toMB(stepdata));
+            .arg(toMB(stepdata))
+            .arg(toMB(cachedata));
 
     MSG_DETAIL_1(info);
     // MSG_INFO(info);
 
-    return (sigdata + stepdata);
+    return (sigdata + stepdata + cachedata);
 }
 
 
@@ -5,6 +5,10 @@
 #include <limits>
 
 
+/** @brief global data version counter (see MPoint::version()) */
+static std::atomic<quint64> versionCounter(0);
+
+
 /**
  * @brief MPoint::MPoint
  * @param channelCount_raw_abs number of raw/absolute signal channels.
@@ -31,6 +35,7 @@ MPoint::MPoint(int channelCount_raw_abs)
     this->channelCount_raw_abs = channelCount_raw_abs;
 
     trigger_time = 0;
+    updateVersion();
 
     rawValid = false;
     absValid = false;
@@ -85,11 +90,23 @@ Signal MPoint::getSignal(int chID, Signal::SType stype)
 
     if(stype == Signal::RAW)
     {
-        return chList.at(chID-1)->raw;
+        SignalPair* sp = chList.at(chID-1);
+        if(sp->rawCounts.isEmpty())
+            return sp->raw;
+
+        Signal s = sp->raw;
+        sp->rawCounts.decode(s.data);
+        return s;
     }
     else if(stype == Signal::ABS)
     {
-       return chList.at(chID-1)->absolute;
+        SignalPair* sp = chList.at(chID-1);
+        if(sp->absoluteCounts.isEmpty())
+            return sp->absolute;
+
+        Signal s = sp->absolute;
+        sp->absoluteCounts.decode(s.data);
+        return s;
     }
     else if(stype == Signal::TEMPERATURE)
     {
@@ -203,10 +220,10 @@ double MPoint::getMaxSignalTime(int chID)
     {
         for(int i = 0; i < chList.size(); i++)
         {
-            t = chList.at(i)->raw.maxTime();
+            t = chList.at(i)->maxTime(Signal::RAW);
             if( t > maxt)
                 maxt = t;
-            t = chList.at(i)->absolute.maxTime();
+            t = chList.at(i)->maxTime(Signal::ABS);
             if( t > maxt)
                 maxt = t;
         }
@@ -215,10 +232,10 @@ double MPoint::getMaxSignalTime(int chID)
     // check for valid channel id
     else if(isValidChannelID(chID,Signal::RAW))
     {
-        t = chList.at(chID)->raw.maxTime();
+        t = chList.at(chID)->maxTime(Signal::RAW);
         if( t > maxt)
             maxt = t;
-        t = chList.at(chID)->absolute.maxTime();
+        t = chList.at(chID)->maxTime(Signal::ABS);
         if( t > maxt)
             maxt = t;
     }
@@ -256,11 +273,11 @@ double MPoint::getMaxSignalTime(Signal::SType stype)
     {
         if(stype == Signal::RAW)
         {
-            t = chList.at(i)->raw.maxTime();
+            t = chList.at(i)->maxTime(Signal::RAW);
         }
         else if(stype == Signal::ABS)
         {
-           t = chList.at(i)->absolute.maxTime();
+           t = chList.at(i)->maxTime(Signal::ABS);
         }
         if( t > maxt)
             maxt = t;
@@ -287,14 +304,18 @@ void MPoint::setSignal(const Signal & s, int chID, Signal::SType stype)
         throw LIISimException(msg);
     }
 
+    updateVersion();
+
     if(stype == Signal::RAW)
     {
         chList.at(chID-1)->raw = s;
+        chList.at(chID-1)->rawCounts.clear();
         return;
     }
     else if(stype == Signal::ABS)
     {
         chList.at(chID-1)->absolute = s;
+        chList.at(chID-1)->absoluteCounts.clear();
         return;
     }
     else if(stype == Signal::TEMPERATURE)
@@ -306,6 +327,46 @@ void MPoint::setSignal(const Signal & s, int chID, Signal::SType stype)
 }
 
 
+/**
+ * @brief MPoint::setSignalCounts stores a raw or absolute signal as ADC counts
+ * (see CompactSignal), the data is converted on getSignal()
+ * @param s signal meta data (dt, start time, ...), s.data is ignored
+ * @param counts signal data
+ * @param chID channel ID (Real ID: 1,2,3,..)
+ * @param stype Signal type (RAW or ABS)
+ */
+void MPoint::setSignalCounts(const Signal &s, const CompactSignal &counts, int chID, Signal::SType stype)
+{
+    QMutexLocker lock(&mutexChList);
+    if(!isValidChannelID(chID, stype))
+    {
+        QString msg;
+        msg.sprintf("MPoint: setSignalCounts invalid channel ID: %d",chID);
+        throw LIISimException(msg);
+    }
+
+    updateVersion();
+
+    if(stype == Signal::RAW)
+    {
+        SignalPair* sp = chList.at(chID-1);
+        sp->raw = s;
+        sp->raw.data.clear();
+        sp->rawCounts = counts;
+        return;
+    }
+    else if(stype == Signal::ABS)
+    {
+        SignalPair* sp = chList.at(chID-1);
+        sp->absolute = s;
+        sp->absolute.data.clear();
+        sp->absoluteCounts = counts;
+        return;
+    }
+    throw LIISimException("MPoint: setSignalCounts requested invalid signal type!");
+}
+
+
 /**
  * @brief MPoint::channelCount returns number of channels for given Signal::SType
  * @param stype Signal type
@@ -335,6 +396,7 @@ int MPoint::addTemperatureChannel(int tchid)
     ts.type = Signal::TEMPERATURE;
     ts.channelID = tchid;
     tempSignals.insert(tchid,ts);
+    updateVersion();
 
     return tchid;
 }
@@ -347,6 +409,7 @@ int MPoint::addTemperatureChannel(int tchid)
 void MPoint::removeTemperatureChannel(int ch_id)
 {
     tempSignals.remove(ch_id);
+    updateVersion();
 }
 
 
@@ -388,22 +451,6 @@ bool MPoint::isValidChannelID(int id, Signal::SType stype, bool throwExcep)
 }
 
 
-/**
- * @brief MPoint::isValidFitTChannelID returns true if temperature signal has fitdata
- * @param chID temperature channel id
- * @return
- */
-bool MPoint::isValidFitTChannelID(int chID)
-{
-    if(isValidChannelID(chID, Signal::TEMPERATURE, false))
-    {
-        return (this->getSignal(chID, Signal::TEMPERATURE).fitData.size() > 0);
-    }
-    else
-        return false;
-}
-
-
 /**
  * @brief MPoint::channelIDs returns a list of all valid channel-IDs by Signal type
  * @param stype Signal::SType
@@ -444,3 +491,101 @@ double MPoint::getTriggerTime()
     return trigger_time;
 }
 
+
+/**
+ * @brief MPoint::setSignalSingle stores a raw or absolute signal
+ * in single precision (see MRun::setSinglePrecision())
+ * @param s signal
+ * @param chID channel ID (Real ID: 1,2,3,..)
+ * @param stype Signal type (RAW or ABS)
+ */
+void MPoint::setSignalSingle(const Signal &s, int chID, Signal::SType stype)
+{
+    setSignalCounts(s, CompactSignal::fromValues(s.data), chID, stype);
+}
+
+
+/**
+ * @brief MPoint::copySignal copies a signal of another MPoint in its stored
+ * representation (double or single precision). The data is implicitly shared,
+ * not copied (used to distribute the result of a MultiSignalAverage).
+ * @param source
+ * @param chID channel ID (Real ID: 1,2,3,..)
+ * @param stype Signal type
+ */
+void MPoint::copySignal(MPoint *source, int chID, Signal::SType stype)
+{
+    if(stype == Signal::TEMPERATURE)
+    {
+        setSignal(source->getSignal(chID, stype), chID, stype);
+        return;
+    }
+
+    Signal s;
+    CompactSignal counts;
+    {
+        QMutexLocker lock(&source->mutexChList);
+        if(!source->isValidChannelID(chID, stype))
+        {
+            QString msg;
+            msg.sprintf("MPoint: copySignal invalid channel ID: %d",chID);
+            throw LIISimException(msg);
+        }
+
+        SignalPair* sp = source->chList.at(chID-1);
+        s = (stype == Signal::RAW) ? sp->raw : sp->absolute;
+        counts = (stype == Signal::RAW) ? sp->rawCounts : sp->absoluteCounts;
+    }
+
+    if(counts.isEmpty())
+        setSignal(s, chID, stype);
+    else
+        setSignalCounts(s, counts, chID, stype);
+}
+
+
+/**
+ * @brief MPoint::convertToSinglePrecision converts the double precision
+ * raw/absolute data of all channels to single precision. Data stored as
+ * ADC counts is kept, raw and absolute signal sharing the same data
+ * also share the converted data.
+ */
+void MPoint::convertToSinglePrecision()
+{
+    QMutexLocker lock(&mutexChList);
+    updateVersion();
+
+    for(int i = 0; i < chList.size(); i++)
+    {
+        SignalPair* sp = chList.at(i);
+
+        bool shared = !sp->raw.data.isEmpty()
+                && sp->raw.data.constData() == sp->absolute.data.constData();
+
+        if(sp->rawCounts.isEmpty() && !sp->raw.data.isEmpty())
+        {
+            sp->rawCounts = CompactSignal::fromValues(sp->raw.data);
+            sp->raw.data.clear();
+        }
+
+        if(shared && sp->absoluteCounts.isEmpty())
+        {
+            sp->absoluteCounts = sp->rawCounts;
+            sp->absolute.data.clear();
+        }
+        else if(sp->absoluteCounts.isEmpty() && !sp->absolute.data.isEmpty())
+        {
+            sp->absoluteCounts = CompactSignal::fromValues(sp->absolute.data);
+            sp->absolute.data.clear();
+        }
+    }
+}
+
+
+/**
+ * @brief MPoint::updateVersion assigns a new data version (see version())
+ */
+void MPoint::updateVersion()
+{
+    m_version = ++versionCounter;
+}
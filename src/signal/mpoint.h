@@ -5,6 +5,7 @@
 #include <QList>
 #include <QMap>
 #include <QMutex>
+#include <atomic>
 
 
 #include "covmatrix.h"
@@ -32,6 +33,11 @@ class MPoint
 
     double trigger_time;
 
+    /** @brief data version (see version()) */
+    std::atomic<quint64> m_version;
+
+    void updateVersion();
+
 public:
 
     MPoint(int channelCount_raw_abs);
@@ -44,6 +50,10 @@ public:
     // get signal by channel id and signal type
     Signal getSignal(int chID, Signal::SType stype);
     void setSignal(const Signal & s,int chID, Signal::SType stype);
+    void setSignalCounts(const Signal & s, const CompactSignal & counts, int chID, Signal::SType stype);
+    void setSignalSingle(const Signal & s, int chID, Signal::SType stype);
+    void copySignal(MPoint* source, int chID, Signal::SType stype);
+    void convertToSinglePrecision();
 
     int addTemperatureChannel(int tchid = -1);
     void removeTemperatureChannel(int ch_id);
@@ -55,13 +65,20 @@ public:
 
     int channelCount(Signal::SType stype);
     bool isValidChannelID(int id, Signal::SType stype, bool throwExcep = true);
-    bool isValidFitTChannelID(int chID);
 
     QList<int> channelIDs(Signal::SType stype);
 
     void setTriggerTime(double triggerTime);
     double getTriggerTime();
 
+    /**
+     * @brief version of the signal data, changes whenever a signal is set or
+     * a channel is added/removed. Versions are unique within the application
+     * (also for deleted MPoints), used to identify the input of processing
+     * chains (see PPResultCache).
+     */
+    inline quint64 version() const { return m_version; }
+
     bool rawValid;
     bool absValid;
     bool tempValid;
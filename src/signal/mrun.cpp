@@ -22,6 +22,8 @@ MRun::MRun(QString name, QString filename, QString filenameBase, int channelCoun
 
     this->channelCount_raw_abs = channelCount_raw_abs;
     busy = false;
+    m_cancelRequested = false;
+    m_singlePrecision = false;
 
     pchainRaw = new ProcessingChain(this, Signal::RAW);
     pchainAbs = new ProcessingChain(this, Signal::ABS);
@@ -514,6 +516,7 @@ int MRun::addTemperatureChannel(int tchid)
 void MRun::removeTemperatureChannel(int ch_id)
 {
     temperatureChannelIDs.removeOne(ch_id);
+    m_fitHistory.removeChannel(ch_id);
     for(int i = 0; i < pre.size(); i++)
     {
         pre[i]->removeTemperatureChannel(ch_id);
@@ -580,6 +583,47 @@ ProcessingChain* MRun::getProcessingChain(Signal::SType stype)
 }
 
 
+/**
+ * @brief MRun::setSinglePrecision enables/disables the single precision
+ * processing mode. Raw/absolute source signals and the step buffers of the
+ * raw/absolute processing chains are then stored as float (half the memory),
+ * the plugins still calculate in double precision. Temperature signals and
+ * fits are not affected.
+ * @param state
+ * @details Enabling converts the source signals (data stored as ADC counts
+ * is kept), the conversion is not undone if the mode is disabled again.
+ * The raw/absolute processing chains are marked as dirty.
+ */
+void MRun::setSinglePrecision(bool state)
+{
+    if(m_singlePrecision == state)
+        return;
+
+    if(busy)
+    {
+        MSG_WARN(QString("%0: precision cannot be changed during processing").arg(name));
+        return;
+    }
+
+    m_singlePrecision = state;
+
+    if(m_singlePrecision)
+    {
+        QMutexLocker lock(&mutexMPointLists);
+        for(int i = 0; i < pre.size(); i++)
+            pre.at(i)->convertToSinglePrecision();
+    }
+
+    if(pchainRaw->noPlugs() > 0)
+        pchainRaw->getPlug(0)->setDirty(true);
+    if(pchainAbs->noPlugs() > 0)
+        pchainAbs->getPlug(0)->setDirty(true);
+
+    MSG_NORMAL(QString("%0: %1 precision processing").arg(name)
+               .arg(m_singlePrecision ? "single" : "double"));
+}
+
+
 /**
  * @brief MRun::getPre gets or creates a new MPoint object
  * @param idx index of requested MPoint
@@ -809,6 +853,36 @@ void MRun::updateValidList()
     }
 }
 
+/**
+ * @brief MRun::setBusy sets the busy state during processing (see ProcessingTask).
+ * Plugin modifications made while the run was busy are applied
+ * in the GUI thread afterwards (see ProcessingPlugin::setParameters()).
+ * @param state
+ */
+void MRun::setBusy(bool state)
+{
+    busy.store(state);
+
+    if(!state)
+        QMetaObject::invokeMethod(this, "applyPendingChanges", Qt::QueuedConnection);
+}
+
+
+/**
+ * @brief MRun::applyPendingChanges applies plugin modifications which
+ * have been queued during processing
+ */
+void MRun::applyPendingChanges()
+{
+    if(isBusy())
+        return;
+
+    pchainRaw->applyPendingChanges();
+    pchainAbs->applyPendingChanges();
+    pchainTemp->applyPendingChanges();
+}
+
+
 void MRun::copyProcessingStepsFrom(MRun *mrun)
 {
     if(isBusy())
@@ -8,6 +8,7 @@
 #include <QMutex>
 #include "mpoint.h"
 #include <QDebug>
+#include <atomic>
 
 
 #include "../io/signaliorequest.h"
@@ -15,6 +16,7 @@
 #include "../general/picoscopecommon.h"
 #include "mruncalculationstatus.h"
 #include "tempcalcmetadata.h"
+#include "fithistorystore.h"
 
 class ProcessingPluginConnector;
 class ProcessingChain;
@@ -88,7 +90,17 @@ private:
     /** @brief stores current calculation status and warn/error status messages*/
     MRunCalculationStatus* m_calcState;
 
-    bool busy;
+    /** @brief run is processed by a worker thread (see ProcessingTask) */
+    std::atomic<bool> busy;
+
+    /** @brief set to stop running ProcessingTasks of this run (see requestCancel()) */
+    std::atomic<bool> m_cancelRequested;
+
+    /** @brief raw/absolute signals are processed in single precision (see setSinglePrecision()) */
+    bool m_singlePrecision;
+
+    /** @brief iteration histories of spectral temperature fits */
+    FitHistoryStore m_fitHistory;
 
     /** @brief stores the import request which has been used to create this mrun */
     SignalIORequest m_importRequest;
@@ -182,8 +194,19 @@ public:
     MPoint* getPostPre(int idx);
     int sizeAllMpoints();
 
-    inline void setBusy(bool state){busy = state;}
-    inline bool isBusy(){return busy;}
+    void setBusy(bool state);
+    inline bool isBusy(){return busy.load();}
+
+    /** @brief requestCancel stops the processing of this run as soon as possible (thread safe) */
+    inline void requestCancel(){m_cancelRequested.store(true, std::memory_order_relaxed);}
+    inline void clearCancelRequest(){m_cancelRequested.store(false, std::memory_order_relaxed);}
+    inline bool cancelRequested(){return m_cancelRequested.load(std::memory_order_relaxed);}
+
+    /** @brief fitHistory iteration histories of spectral temperature fits (thread safe) */
+    inline FitHistoryStore* fitHistory(){return &m_fitHistory;}
+
+    inline bool singlePrecision(){return m_singlePrecision;}
+    void setSinglePrecision(bool state);
 
     ProcessingChain * getProcessingChain(Signal::SType stype);
 
@@ -284,6 +307,8 @@ signals:
 private slots:
     void onDBmodified(int id = -1);
 
+    void applyPendingChanges();
+
     void onPluginGoneDirty();
 };
 
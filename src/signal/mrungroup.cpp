@@ -116,6 +116,8 @@ MRun* MRunGroup::findMRun(QString runname)
  */
 void MRunGroup::assignMRunColors()
 {
+    DataModelUpdateScope update(Core::instance() ? Core::instance()->dataModel() : 0);
+
     int n = this->childCount();
     for(int i = 0; i < n; i++)
     {
@@ -23,6 +23,8 @@ Arithmetic::Arithmetic(ProcessingChain *parentChain) :   ProcessingPlugin(parent
     operation   = "multiplication";
     chId        = "all";
     calcvalue   = -1.0;
+    opType      = PointwiseOperation::MULTIPLY;
+    chIdValue   = -1;
 
     // create input fields;
     ProcessingPluginInput cbOperation;
@@ -95,6 +97,39 @@ void Arithmetic::setFromInputs()
     if(operation == "division" && calcvalue == 0)
         calcvalue = 1.0;
     // TODO: throw error
+
+    // resolve operation once, instead of comparing strings for every data point
+    if(operation == "multiplication")
+        opType = PointwiseOperation::MULTIPLY;
+    else if(operation == "division")
+        opType = PointwiseOperation::DIVIDE;
+    else if(operation == "addition")
+        opType = PointwiseOperation::ADD;
+    else if(operation == "subtraction")
+        opType = PointwiseOperation::SUBTRACT;
+    else
+        opType = PointwiseOperation::IDENTITY;
+
+    if(chId == "all")
+        chIdValue = -1;
+    else
+        chIdValue = chId.toInt();
+}
+
+
+/**
+ * @brief Arithmetic::pointwiseOperation implements virtual function
+ * @param chID channel id
+ * @param op operation
+ * @return true
+ */
+bool Arithmetic::pointwiseOperation(int chID, PointwiseOperation &op)
+{
+    if(chIdValue == -1 || chIdValue == chID)
+        op = PointwiseOperation(opType, calcvalue);
+    else
+        op = PointwiseOperation(PointwiseOperation::IDENTITY);
+    return true;
 }
 
 
@@ -106,29 +141,12 @@ void Arithmetic::setFromInputs()
  */
 bool Arithmetic::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
 {
-    // process selected channel only    
-    if(chId == "all" || (chId != "all" && in.channelID == chId.toInt()))
+    // process selected channel only
+    if(chIdValue == -1 || in.channelID == chIdValue)
     {
-        int noPts = in.data.size();
-        out.data.resize(noPts);
-
         // use arithmetic operation on every datapoint
-        for(int i = 0; i < noPts; i++)
-        {
-            double v;
-            if(operation == "multiplication")
-                v = in.data.at(i) * calcvalue;
-            else if(operation == "division")
-                v = in.data.at(i) / calcvalue;
-            else if(operation == "addition")
-                v = in.data.at(i) + calcvalue;
-            else if(operation == "subtraction")
-                v = in.data.at(i) - calcvalue;
-            else
-                v = in.data.at(i);
-
-            out.data[i] = v;
-        }
+        out.data = in.data;
+        PointwiseOperation(opType, calcvalue).apply(out.data.data(), out.data.size());
     }
     else
     {
@@ -38,12 +38,19 @@ class Arithmetic : public ProcessingPlugin
         void setFromInputs();
 
         QString getParameterPreview();
+        bool pointwiseOperation(int chID, PointwiseOperation & op);
 
     private:
 
         QString operation;
         QString chId;
         double calcvalue;
+
+        /** @brief operation type resolved from operation string (see setFromInputs()) */
+        PointwiseOperation::Type opType;
+
+        /** @brief selected channel id, -1: all channels */
+        int chIdValue;
 };
 
 #endif // ARITHMETIC_H
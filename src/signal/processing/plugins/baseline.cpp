@@ -2,6 +2,7 @@
 
 #include "../../mrun.h"
 #include <QDebug>
+#include <QDataStream>
 
 QString Baseline::descriptionFileName = "baseline.html"; // TODO
 QString Baseline::iconFileName = "iconfile"; // TODO
@@ -23,10 +24,10 @@ Baseline::Baseline(ProcessingChain *parentChain) :   ProcessingPlugin(parentChai
 
     // standard values
     operation   = "all signals";
+    offsetSource = ALL_SIGNALS;
     startAverage   = 0.0;
     endAverage     = 50.0;
 
-    offsetAvailable = false;
     offset.clear();
 
     // pass stdev to next processing step
@@ -98,102 +99,147 @@ void Baseline::setFromInputs()
     operation      = inputs.getValue("cbOperation").toString();
     startAverage   = inputs.getValue("inputStart").toDouble();
     endAverage     = inputs.getValue("inputEnd").toDouble();
+
+    if(operation == "LIISettings")
+        offsetSource = LIISETTINGS;
+    else if(operation == "each signal")
+        offsetSource = EACH_SIGNAL;
+    else
+        offsetSource = ALL_SIGNALS;
 }
 
 
 /**
- * @brief Baseline::processSignal implements virtual function
- * @param in  input signal
- * @param out output signal
- * @return true if the signal has passed validation
+ * @brief Baseline::pointwiseOperation implements virtual function.
+ * Only offsets from LIISettings are independent of the signal data.
+ * @param chID channel id
+ * @param op operation
+ * @return true if offset is taken from LIISettings
  */
-bool Baseline::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
-{        
-    // make sure to not have parallel processing
-    QMutexLocker lock(&variableMutex);
+bool Baseline::pointwiseOperation(int chID, PointwiseOperation &op)
+{
+    if(offsetSource != LIISETTINGS)
+        return false;
 
-    int noPoints = in.data.size();
+    LIISettings settings = mrun->liiSettings();
+    if(chID < 1 || chID > settings.channels.size())
+        return false;
 
-    if(noPoints == 0)
-        return true;
+    op = PointwiseOperation(PointwiseOperation::SUBTRACT,
+                            settings.channels.at(chID-1).offset,
+                            PointwiseOperation::STDEV_KEEP);
+    return true;
+}
 
 
-    if(!offsetAvailable)
-    {
-        // init offset container
-        if(offset.empty())
-        {
-            for(int i=0; i< mrun->getNoChannels(stype); i++)
-                offset.append(0.0);
-        }
+/**
+ * @brief Baseline::rangeAverage
+ * @param s signal
+ * @return average of signal within the selected time range
+ * (range is limited to the signal)
+ */
+double Baseline::rangeAverage(const Signal &s) const
+{
+    // copy input parameters, to avoid changing the user input!
+    double avg_start    = startAverage * 1E-9;   // [ns] -> [s]
+    double avg_end      = endAverage * 1E-9;     // [ns] -> [s]
 
-        if(operation == "LIISettings")
-        {            
-            for(int i=0; i< mrun->getNoChannels(stype); i++)
-                offset[i] =  mrun->liiSettings().channels.at(i).offset;
+    if(!s.hasDataAt(avg_end))
+        avg_end = s.maxTime();
 
-            offsetAvailable = true;
-        }
-        else
-        {
-            // copy input parameters, to avoid changing the user input!
-            double avg_start    = startAverage * 1E-9;   // [ns] -> [s]
-            double avg_end      = endAverage * 1E-9;     // [ns] -> [s]
+    // validate signal start time
+    if(!s.hasDataAt(avg_start))
+        avg_start = s.start_time;
+
+    Signal section = s;
+    return section.calcRangeAverage(avg_start, avg_end);
+}
 
-            if(!in.hasDataAt(avg_end))
-                avg_end = in.maxTime(); //convert [s] to [ns]
 
-            // validate signal start time
-            if(!in.hasDataAt(avg_start))
-                avg_start = in.start_time;
+/**
+ * @brief Baseline::prepareProcessing implements virtual function,
+ * determines the offset of each channel once per run
+ * (LIISettings or average of all valid signals of the previous step)
+ * @param mStart not used, the global offset is calculated from all MPoints
+ * @param mEnd not used
+ */
+void Baseline::prepareProcessing(int mStart, int mEnd)
+{
+    QList<int> chids = mrun->channelIDs(stype);
 
+    int size = 0;
+    for(int c = 0; c < chids.size(); c++)
+        size = qMax(size, chids.at(c));
 
-            //normal processing
-            if(operation == "each signal")
-            {
-                Signal s = in;
-                offset[in.channelID-1] =  s.calcRangeAverage(avg_start, avg_end);
-            }
-            //calculate global offset for all signals of this mrun
-            else
-            {
-                offsetAvailable = true;
+    offset.fill(0.0, size);
 
-                QList<int> chids = mrun->channelIDs(stype);
+    if(offsetSource == LIISETTINGS)
+    {
+        LIISettings settings = mrun->liiSettings();
+        for(int c = 0; c < chids.size(); c++)
+            if(chids.at(c) <= settings.channels.size())
+                offset[chids.at(c)-1] = settings.channels.at(chids.at(c)-1).offset;
+    }
+    //calculate global offset for all signals of this mrun
+    else if(offsetSource == ALL_SIGNALS)
+    {
+        // iterate through all channels
+        for( int c = 0; c < chids.size(); c++)
+        {
+            // set avg counter to zero
+            int counter = 0;
+            double sum = 0.0;
 
-                // iterate through all channels
-                for( int c = 0; c < chids.size(); c++)
+            // iterate through all available mpoints
+            for( int i = 0; i < mrun->sizeAllMpoints(); i++)
+            {
+                // include only signals which passed validation in previous step
+                if( validAtPreviousStep(i) )
                 {
-                    // set avg counter to zero
-                    int counter = 0;
-
-                    // iterate through all available mpoints
-                    for( int i = 0; i < mrun->sizeAllMpoints(); i++)
-                    {
-                        // include only signals which passed validation in previous step
-                        if( validAtPreviousStep(i) )
-                        {
-                            // get signal of mpoint i with channelId c+1 at previous position in chain
-                            Signal s = processedSignalPreviousStep(i, chids[c]);
-
-                            // sum avg value for all mpoints
-                            offset[c] += s.calcRangeAverage(avg_start, avg_end);
-                            counter++;
-                        }
-                    }
-                    offset[c] /= double(counter);
+                    // get signal of mpoint i with channelId chids[c] at previous position in chain
+                    Signal s = processedSignalPreviousStep(i, chids[c]);
+                    if(s.data.isEmpty())
+                        continue;
+
+                    // sum avg value for all mpoints
+                    sum += rangeAverage(s);
+                    counter++;
                 }
             }
+
+            if(counter > 0)
+                offset[chids[c]-1] = sum / double(counter);
         }
     }
+}
 
-    // subtract offset value from signal
-    for(int i = 0; i < noPoints; i++)
-    {
-        double v = in.data.at(i) - offset.at(in.channelID-1);
 
-        out.data.append(v);
-    }
+/**
+ * @brief Baseline::processSignal implements virtual function.
+ * Only reads the offsets calculated by prepareProcessing() and can therefore
+ * be executed in parallel.
+ * @param in  input signal
+ * @param out output signal
+ * @return true if the signal has passed validation
+ */
+bool Baseline::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
+{
+    int noPoints = in.data.size();
+
+    if(noPoints == 0)
+        return true;
+
+    double value = 0.0;
+
+    //normal processing
+    if(offsetSource == EACH_SIGNAL)
+        value = rangeAverage(in);
+    else if(in.channelID >= 1 && in.channelID <= offset.size())
+        value = offset.at(in.channelID-1);
+
+    // subtract offset value from signal
+    out.data = in.data;
+    PointwiseOperation(PointwiseOperation::SUBTRACT, value).apply(out.data.data(), noPoints);
 
     return true; // we do not make any validation here
 }
@@ -224,10 +270,8 @@ QString Baseline::getParameterPreview()
  */
 void Baseline::reset()
 {
-    QMutexLocker lock(&variableMutex);
     ProcessingPlugin::reset();
     offset.clear();
-    offsetAvailable = false;
 }
 
 
@@ -248,3 +292,17 @@ void Baseline::onOperationChanged()
     // signal 7: input fields modified (see also: ProcessingPlugin.h)
     emit dataChanged(7);
 }
+
+
+/**
+ * @brief Baseline::resultKeyData implements virtual function,
+ * adds the LIISettings if the offset is taken from the LIISettings
+ * @param stream key data
+ * @return true
+ */
+bool Baseline::resultKeyData(QDataStream &stream)
+{
+    if(offsetSource == LIISETTINGS)
+        writeLIISettingsKey(stream);
+    return true;
+}
@@ -37,18 +37,28 @@ class Baseline : public ProcessingPlugin
         void reset();
 
         QString getParameterPreview();
+        bool pointwiseOperation(int chID, PointwiseOperation & op);
+
+    protected:
+        void prepareProcessing(int mStart, int mEnd);
+        bool resultKeyData(QDataStream &stream);
 
     private:
 
+        enum OffsetSource { ALL_SIGNALS, EACH_SIGNAL, LIISETTINGS };
+
         QString operation;
+
+        /** @brief offset source resolved from operation string (see setFromInputs()) */
+        OffsetSource offsetSource;
         double startAverage;
         double endAverage;
 
-        /// @brief offset value for each channel
-        QList<double> offset;
+        /// @brief offset value for each channel (index: channel id - 1),
+        /// calculated by prepareProcessing() (not used for "each signal")
+        QVector<double> offset;
 
-        /// @brief flag indicating that the average signal has been calculated
-        bool offsetAvailable;
+        double rangeAverage(const Signal &s) const;
 
     private slots:
         void onOperationChanged();
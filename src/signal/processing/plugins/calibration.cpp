@@ -3,6 +3,7 @@
 #include "../../../core.h"
 #include "../../mrun.h"
 #include <QDebug>
+#include <QDataStream>
 
 QString Calibration::descriptionFileName = "calibration.html"; // TODO
 QString Calibration::iconFileName = "iconfile"; // TODO
@@ -27,6 +28,7 @@ Calibration::Calibration(ProcessingChain *parentChain) :   ProcessingPlugin(pare
 
     // standard values
     operation   = "gain (exp)";
+    calibrationType = GAIN_EXP;
     gainValuesFromRun = true;
     for(int i=1; i <= channelCount(); i++)
         calcvalue.append(mrun->pmtGainVoltage(i));
@@ -151,6 +153,15 @@ void Calibration::setFromInputs()
     // assign members
     operation   = inputs.getValue("cbOperation").toString();
 
+    if(operation == "gain (exp)")
+        calibrationType = GAIN_EXP;
+    else if(operation == "gain (log10)")
+        calibrationType = GAIN_LOG10;
+    else if(operation == "channel sensitivity")
+        calibrationType = SENSITIVITY;
+    else
+        calibrationType = NONE;
+
     QString gainValueSourceStr = inputs.getValue("gainValueSource").toString();
     bool new_gainValueState = true;
     if(gainValueSourceStr == "manual")
@@ -195,12 +206,38 @@ void Calibration::setFromInputs()
  * @return true if the signal has passed validation
  */
 bool Calibration::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
+{
+    PointwiseOperation op;
+    pointwiseOperation(in.channelID, op);
+
+    // use Calibration operation on every datapoint
+    out.data = in.data;
+    op.apply(out.data.data(), out.data.size());
+
+    //calculate stdev only if available
+    out.stdev = in.stdev;
+    op.applyToStdev(out.stdev);
+
+    // TODO: check if calibration exists for specific channel
+    return true; // we do not make any validation here
+}
+
+
+/**
+ * @brief Calibration::pointwiseOperation implements virtual function,
+ * resolves the correction factor for the given channel
+ * @param chID channel id
+ * @param op operation
+ * @return true
+ * @throws LIISimException if the channel is not defined in LIISettings
+ */
+bool Calibration::pointwiseOperation(int chID, PointwiseOperation &op)
 {
     double rel_gain_factor;
 
     LIISettings curSettings = mrun->liiSettings();
 
-    int idx = in.channelID-1;
+    int idx = chID-1;
 
     if(idx < 0)
         throw LIISimException("Calibration: invalid channel ID: " + QString::number(idx+1));
@@ -216,62 +253,39 @@ bool Calibration::processSignalImplementation(const Signal &in, Signal &out, int
 
     double cval = calcvalue.at(idx);
 
-    int noPts = in.data.size();
-
-    // y = 10^(A*log_10(x/xref))
-    if(operation == "gain (log10)")
-    {
-        rel_gain_factor = pow(10.0, (
-                              log10(cval / curChannel.pmt_gain)
-                              * curChannel.pmt_gain_formula_A
-                              ));
-    }
-    else if(operation == "gain (exp)")
-    {              
-        // y = exp(A*ln(x/xref))
-        rel_gain_factor = exp(
-                              log(cval / curChannel.pmt_gain)
-                              * curChannel.pmt_gain_formula_A);
-    }
-
-    if(rel_gain_factor == 0.0)
-        rel_gain_factor = 1.0;
-
-    // use Calibration operation on every datapoint
-    for(int i = 0; i < noPts; i++)
-    {
-        double v;
-        if(operation == "gain (log10)" || operation == "gain (exp)")
-            v = in.data.at(i) / rel_gain_factor;
-        else if(operation == "channel sensitivity")
-            v = in.data.at(i) * curChannel.calibration;
-        else
-            v = in.data.at(i);
-
-        out.data.append(v);
-    }
-    //calculate stdev only if available
-    if(!in.stdev.isEmpty())
+    switch(calibrationType)
     {
-        noPts = in.stdev.size();
-        double v;
-
-        for(int i = 0; i < noPts; i++)
-        {
-            if(operation == "gain (log10)" || operation == "gain (exp)")
-                v = in.stdev.at(i) / rel_gain_factor;
-            else if(operation == "channel sensitivity")
-                v = in.stdev.at(i) * curChannel.calibration;
-            else
-                v = in.stdev.at(i);
-
-            out.stdev.append(v);
-        }
+        case GAIN_LOG10:
+            // y = 10^(A*log_10(x/xref))
+            rel_gain_factor = pow(10.0, (
+                                  log10(cval / curChannel.pmt_gain)
+                                  * curChannel.pmt_gain_formula_A
+                                  ));
+            if(rel_gain_factor == 0.0)
+                rel_gain_factor = 1.0;
+
+            op = PointwiseOperation(PointwiseOperation::DIVIDE, rel_gain_factor, PointwiseOperation::STDEV_APPLY);
+            break;
+
+        case GAIN_EXP:
+            // y = exp(A*ln(x/xref))
+            rel_gain_factor = exp(
+                                  log(cval / curChannel.pmt_gain)
+                                  * curChannel.pmt_gain_formula_A);
+            if(rel_gain_factor == 0.0)
+                rel_gain_factor = 1.0;
+
+            op = PointwiseOperation(PointwiseOperation::DIVIDE, rel_gain_factor, PointwiseOperation::STDEV_APPLY);
+            break;
+
+        case SENSITIVITY:
+            op = PointwiseOperation(PointwiseOperation::MULTIPLY, curChannel.calibration, PointwiseOperation::STDEV_APPLY);
+            break;
+
+        default:
+            op = PointwiseOperation(PointwiseOperation::IDENTITY, 0.0, PointwiseOperation::STDEV_KEEP);
     }
-    //qDebug() << QString::number(curChannel.wavelength) << " - " << QString::number(curChannel.calibration);
-
-    // TODO: check if calibration exists for specific channel
-    return true; // we do not make any validation here
+    return true;
 }
 
 
@@ -319,3 +333,16 @@ void Calibration::onOperationChanged()
     // signal 7: input fields modified (see also: ProcessingPlugin.h)
     emit dataChanged(7);
 }
+
+
+/**
+ * @brief Calibration::resultKeyData implements virtual function,
+ * adds the channel settings of the LIISettings
+ * @param stream key data
+ * @return true
+ */
+bool Calibration::resultKeyData(QDataStream &stream)
+{
+    writeLIISettingsKey(stream);
+    return true;
+}
@@ -37,10 +37,19 @@ class Calibration : public ProcessingPlugin
         void setFromInputs();
 
         QString getParameterPreview();
+        bool pointwiseOperation(int chID, PointwiseOperation & op);
+
+    protected:
+        bool resultKeyData(QDataStream &stream);
 
     private:
 
+        enum CalibrationType { GAIN_EXP, GAIN_LOG10, SENSITIVITY, NONE };
+
         QString operation;
+
+        /** @brief calibration type resolved from operation string (see setFromInputs()) */
+        CalibrationType calibrationType;
         bool gainValuesFromRun;
         QList<double> calcvalue;
 
@@ -3,6 +3,7 @@
 #include "../../../core.h"
 #include "../../mrun.h"
 #include <QDebug>
+#include <QDataStream>
 
 QString FilterPlugin::descriptionFileName = "filter.html"; // TODO
 QString FilterPlugin::iconFileName = "iconfile"; // TODO
@@ -222,3 +223,17 @@ QString FilterPlugin::getParameterPreview()
     QString str = QString("(ID=%0)").arg(identifier);
     return str;
 }
+
+
+/**
+ * @brief FilterPlugin::resultKeyData implements virtual function,
+ * adds the filters of the LIISettings and the selected filter
+ * @param stream key data
+ * @return true
+ */
+bool FilterPlugin::resultKeyData(QDataStream &stream)
+{
+    writeLIISettingsKey(stream);
+    stream << identifier;
+    return true;
+}
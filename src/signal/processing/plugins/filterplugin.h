@@ -35,6 +35,9 @@ class FilterPlugin : public ProcessingPlugin
 
         QString getParameterPreview();
 
+    protected:
+        bool resultKeyData(QDataStream &stream);
+
     private:
         QString identifier;
 
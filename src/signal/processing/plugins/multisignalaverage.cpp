@@ -1,7 +1,7 @@
 #include "multisignalaverage.h"
 
-#include <QMutexLocker>
 #include <limits>
+#include <QDataStream>
 #include <boost/multi_array.hpp>
 
 #include "../../mrun.h"
@@ -20,7 +20,6 @@ MultiSignalAverage::MultiSignalAverage(ProcessingChain *parentChain) :   Process
     executeSyncronized = true;
     preserveStdev = true;
 
-    avgCalculated = false;
     avgSignalIdx = -1;
 
     startSignal = 1;
@@ -165,151 +164,170 @@ void MultiSignalAverage::initializeAvgSignals()
 
 
 /**
- * @brief MultiSignalAverage::processSignal implements virtual function
- * @param in  input signal
- * @param out output signal
- * @return true if the signal has passed validation
+ * @brief MultiSignalAverage::prepareProcessing implements virtual function,
+ * calculates the average signals, standard deviations and covariance matrices
+ * from all valid signals of the previous step (once per run)
+ * @param mStart index of the MPoint which receives the average signal
+ * @param mEnd not used
  */
-bool MultiSignalAverage::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
+void MultiSignalAverage::prepareProcessing(int mStart, int mEnd)
 {
-    QMutexLocker lock(&variableMutex);
+    // the average signal is only processed along with the first MPoint
+    // (see ProcessingPlugin::processMPoints(), msa mode)
+    if(mStart > 0)
+        return;
 
-    bool valid = true;
+    avgSignalIdx = mStart;
 
-    // calculate average signal (this is only done once and then avgCalculated is set to false)
-    if(!avgCalculated)
-    {
-        avgCalculated = true;
-        avgSignalIdx = mpIdx;
+    initializeAvgSignals();
+
+    QList<int> chids = mrun->channelIDs(stype);
+
+    // array for temporarily saving data for covariance matrix calculation
+    boost::multi_array<double,3> tempsignals(boost::extents[max_datasize][chids.size()][noMpoints]);
 
-        initializeAvgSignals();
+    // iterate through all channels
+    for( int c = 0; c < chids.size(); c++)
+    {
+        double avgs_t_start = avgSignals[c].start_time;
+        double avgs_dt      = avgSignals[c].dt;
+        int    avgs_data_sz = avgSignals[c].data.size();
 
-        QList<int> chids = mrun->channelIDs(stype);
+        double* sum  = avgSignals[c].data.data();
+        double* sum2 = avgSignals[c].stdev.data();
+        int* count   = counters[c].data();
 
-        // array for temporarily saving data for covariance matrix calculation
-        boost::multi_array<double,3> tempsignals(boost::extents[max_datasize][chids.size()][noMpoints]);
+        // signals of all MPoints usually share the time steps:
+        // indices/weights are only calculated if the time steps change
+        SignalResampler resampler;
 
-        // iterate through all channels
-        for( int c = 0; c < chids.size(); c++)
+        //process all measurement points  ...
+        for( int i = startSignal - 1; i < noMpoints; i++)
         {
-            double avgs_t_start = avgSignals[c].start_time;
-            double avgs_dt      = avgSignals[c].dt;
-            double avgs_data_sz = avgSignals[c].data.size();
-
-            //process all measurement points  ...
-            for( int i = startSignal - 1; i < noMpoints; i++)
+            // include only signals which passed validation in previous step
+            if( validAtPreviousStep(i) )
             {
-                // include only signals which passed validation in previous step
-                if( validAtPreviousStep(i) )
-                {
-                    // get signal of mpoint i with channelId c+1 at previous position in chain
-                    Signal s = processedSignalPreviousStep(i,chids[c]);
+                // get signal of mpoint i with channelId c+1 at previous position in chain
+                Signal s = processedSignalPreviousStep(i,chids[c]);
 
-                    double cur_t;
-                    for( int j = 0; j < avgs_data_sz; j++ )
-                    {
-                        cur_t = avgs_t_start + j * avgs_dt;
-
-                        if(s.hasDataAt(cur_t))
-                        {
-                            avgSignals[c].data[j]  += s.at(cur_t);        // sum of data
-                            avgSignals[c].stdev[j] += pow(s.at(cur_t),2); // sum of squares of data
-                            counters[c][j]++;
-
-                            // for each time step j,
-                            // and every channel c,
-                            //save the single shot values of mpoint i
-                            if(stype == Signal::ABS || stype == Signal::RAW)
-                                tempsignals[j][c][i] = s.at(cur_t);
-                        }
-                    }
+                if(!resampler.hasSource(s.start_time, s.dt, s.data.size()))
+                    resampler = SignalResampler(s.start_time, s.dt, s.data.size(),
+                                                avgs_t_start, avgs_dt, avgs_data_sz);
+
+                // signal at time steps of average signal
+                QVector<double> values = resampler.apply(s.data);
+                const double* v = values.constData();
+
+                for( int j = resampler.firstIndex(); j < resampler.lastIndex(); j++ )
+                {
+                    sum[j]  += v[j];        // sum of data
+                    sum2[j] += v[j] * v[j]; // sum of squares of data
+                    count[j]++;
                 }
-            }          
-        }
 
-        // calculate mean and standard deviation (iterate through all channels c)
-        for( int c = 0; c < avgSignals.size(); c++ )
-        {
+                // for each time step j,
+                // and every channel c,
+                //save the single shot values of mpoint i
+                if(stype == Signal::ABS || stype == Signal::RAW)
+                    for( int j = resampler.firstIndex(); j < resampler.lastIndex(); j++ )
+                        tempsignals[j][c][i] = v[j];
+            }
+        }          
+    }
 
-            // iterate through data points
-            for(int j = 0; j < avgSignals[c].data.size(); j++)
-            {                
-                double N = double(counters[c][j]);
+    // calculate mean and standard deviation (iterate through all channels c)
+    for( int c = 0; c < avgSignals.size(); c++ )
+    {
 
-                if( N > 0.0)
-                {
-                    double sum  = avgSignals[c].data[j];
-                    double sum2 = avgSignals[c].stdev[j];
+        // iterate through data points
+        for(int j = 0; j < avgSignals[c].data.size(); j++)
+        {                
+            double N = double(counters[c][j]);
 
-                    // calculate standard deviation
-                    //  https://en.wikipedia.org/wiki/Algebraic_formula_for_the_variance
-                    //  https://de.wikipedia.org/wiki/Verschiebungssatz_(Statistik)
-                    // sigma^2 = 1/(N-1) * [sum of squares - sum^2/N]
-                    avgSignals[c].stdev[j] = sqrt( 1/(N-1) * (sum2 - pow(sum,2)/N ));
+            if( N > 0.0)
+            {
+                double sum  = avgSignals[c].data[j];
+                double sum2 = avgSignals[c].stdev[j];
 
-                    // calculate mean
-                    avgSignals[c].data[j] /= N;
-                }
+                // calculate standard deviation
+                //  https://en.wikipedia.org/wiki/Algebraic_formula_for_the_variance
+                //  https://de.wikipedia.org/wiki/Verschiebungssatz_(Statistik)
+                // sigma^2 = 1/(N-1) * [sum of squares - sum^2/N]
+                avgSignals[c].stdev[j] = sqrt( 1/(N-1) * (sum2 - pow(sum,2)/N ));
+
+                // calculate mean
+                avgSignals[c].data[j] /= N;
             }
         }
+    }
 
-        // determine covariance matrix
-        if(stype == Signal::ABS || stype == Signal::RAW)
-        {
-            if(stype == Signal::RAW)
-                mrun->getPost(avgSignalIdx)->covar_list_raw.clear();
-            else
-                mrun->getPost(avgSignalIdx)->covar_list_abs.clear();
+    // determine covariance matrix
+    if(stype == Signal::ABS || stype == Signal::RAW)
+    {
+        if(stype == Signal::RAW)
+            mrun->getPost(avgSignalIdx)->covar_list_raw.clear();
+        else
+            mrun->getPost(avgSignalIdx)->covar_list_abs.clear();
 
-            int N;
-            double sum, avgA, avgB, cov;
+        int N;
+        double sum, avgA, avgB, cov;
 
-            // iterate through time steps
-            for(int t = 0; t < max_datasize; t++)
-            {
-                // initialize covariance matrix with R=NxN (N = channel number)
-                CovMatrix covar(chids.size());
+        // iterate through time steps
+        for(int t = 0; t < max_datasize; t++)
+        {
+            // initialize covariance matrix with R=NxN (N = channel number)
+            CovMatrix covar(chids.size());
 
-                // iterate through channels ( calculate lower triangular matrix sigma(i,j))
-                for(int i = 0; i < chids.size(); i++)
-                    for(int j = 0; j <= i; j++)
-                    {
+            // iterate through channels ( calculate lower triangular matrix sigma(i,j))
+            for(int i = 0; i < chids.size(); i++)
+                for(int j = 0; j <= i; j++)
+                {
 
-                        // average value of channel A/B at time t
-                        avgA = avgSignals[i].data[t];
-                        avgB = avgSignals[j].data[t];
+                    // average value of channel A/B at time t
+                    avgA = avgSignals[i].data[t];
+                    avgB = avgSignals[j].data[t];
 
-                        sum = 0.0;
+                    sum = 0.0;
 
-                        // number of shots
-                        N = tempsignals[t][i].size();
+                    // number of shots
+                    N = tempsignals[t][i].size();
 
-                        // iterate through single shots
-                        for(int k = 0; k < N; k++)
-                        {
-                            sum += (tempsignals[t][i][k] - avgA)*(tempsignals[t][j][k] - avgB);
-                        }
+                    // iterate through single shots
+                    for(int k = 0; k < N; k++)
+                    {
+                        sum += (tempsignals[t][i][k] - avgA)*(tempsignals[t][j][k] - avgB);
+                    }
 
-                        cov = (1.0 / N *  sum);
+                    cov = (1.0 / N *  sum);
 
-                        covar.set(i,j, cov);
-                    }
+                    covar.set(i,j, cov);
+                }
 
-                // store covariance matrix in mpoint with index avgSignalIdx
-                if(stype == Signal::RAW)
-                    mrun->getPost(avgSignalIdx)->covar_list_raw.append(covar);
-                else
-                    mrun->getPost(avgSignalIdx)->covar_list_abs.append(covar);
-            }
+            // store covariance matrix in mpoint with index avgSignalIdx
+            if(stype == Signal::RAW)
+                mrun->getPost(avgSignalIdx)->covar_list_raw.append(covar);
+            else
+                mrun->getPost(avgSignalIdx)->covar_list_abs.append(covar);
         }
-
-    }
-    else
-    {
-        // comment the following if-clause out, to disable validation done by average calculation
-        if( avgSignalIdx != mpIdx )
-            valid = false;
     }
+}
+
+
+/**
+ * @brief MultiSignalAverage::processSignal implements virtual function.
+ * Returns the average signal calculated by prepareProcessing()
+ * (can be executed in parallel).
+ * @param in  input signal
+ * @param out output signal
+ * @return true if the signal has passed validation
+ */
+bool MultiSignalAverage::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
+{
+    bool valid = true;
+
+    // comment the following if-clause out, to disable validation done by average calculation
+    if( avgSignalIdx != mpIdx )
+        valid = false;
 
     // return average signal by channel ID
     int idx = in.channelID-1;
@@ -333,9 +351,18 @@ QString MultiSignalAverage::getParameterPreview()
  */
 void MultiSignalAverage::reset()
 {
-    QMutexLocker lock(&variableMutex);
     ProcessingPlugin::reset();
     avgSignals.clear();
-    avgCalculated = false;
     avgSignalIdx = -1;
 }
+
+
+/**
+ * @brief MultiSignalAverage::resultKeyData implements virtual function,
+ * the covariance of the average signal is stored in the post MPoint
+ * @return false (results are not buffered)
+ */
+bool MultiSignalAverage::resultKeyData(QDataStream &stream)
+{
+    return false;
+}
@@ -29,7 +29,9 @@ public:
 
     QString getParameterPreview();
 
-
+protected:
+    void prepareProcessing(int mStart, int mEnd);
+    bool resultKeyData(QDataStream &stream);
 
 private:
 
@@ -38,10 +40,8 @@ private:
 
     int noMpoints;
 
-    /// @brief flag indicating that the average signal has been calculated
-    bool avgCalculated;
-
-    /// @brief index of the measurement point where the average calculation
+    /// @brief index of the measurement point which holds the average signal
+    /// (set by prepareProcessing(), -1 if the average has not been calculated)
     int  avgSignalIdx;
 
     /// @brief avgSignals stores an average signal for each channel
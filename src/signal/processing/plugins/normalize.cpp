@@ -23,6 +23,8 @@ Normalize::Normalize(ProcessingChain *parentChain) :   ProcessingPlugin(parentCh
     operation   = "peak";
     chId        = "all";
     value       = 0.0;
+    toPeak      = true;
+    chIdValue   = -1;
 
     // create input fields;
     ProcessingPluginInput cbOperation;
@@ -87,6 +89,37 @@ void Normalize::setFromInputs()
     operation   = inputs.getValue("cbOperation").toString();
     chId        = inputs.getValue("cbChannel").toString();
     value       = inputs.getValue("cValue").toDouble();
+
+    toPeak      = (operation == "peak");
+
+    if(chId == "all")
+        chIdValue = -1;
+    else
+        chIdValue = chId.toInt();
+}
+
+
+/**
+ * @brief Normalize::pointwiseOperation implements virtual function.
+ * Normalization to a fixed value is a pointwise operation, normalization
+ * to peak needs the complete signal.
+ * @param chID channel id
+ * @param op operation
+ * @return false for normalization to peak
+ */
+bool Normalize::pointwiseOperation(int chID, PointwiseOperation &op)
+{
+    if(chIdValue != -1 && chIdValue != chID)
+    {
+        op = PointwiseOperation(PointwiseOperation::IDENTITY);
+        return true;
+    }
+
+    if(toPeak)
+        return false;
+
+    op = PointwiseOperation(PointwiseOperation::DIVIDE, value);
+    return true;
 }
 
 /**
@@ -98,29 +131,18 @@ void Normalize::setFromInputs()
 bool Normalize::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
 {
     // process selected channel only
-    if(chId == "all" || (chId != "all" && in.channelID == chId.toInt()))
+    if(chIdValue == -1 || in.channelID == chIdValue)
     {
-        int noPts = in.data.size();
-
-        // get signal of mpoint mpIdx with channelId= chId_B at previous position in chain
-        //ProcessingChain* pchain = mrun->getProcessingChain(in.type);
-        //Signal s = pchain->getStepSignalPre(mpIdx, in.channelID, positionInChain-1);
-        Signal s = in;
-        double maxValue = s.getMaxValue();
-
-        // use normalize operation on every datapoint
-        for(int i = 0; i < noPts; i++)
+        double divisor = value;
+        if(toPeak)
         {
-            double v;
-            if(operation == "peak")
-                v = in.data.at(i) / maxValue;
-            else if(operation == "value")
-                v = in.data.at(i) / value;
-            else
-                v = in.data.at(i);
-
-            out.data.append(v);
+            Signal s = in;
+            divisor = s.getMaxValue();
         }
+
+        // use normalize operation on every datapoint
+        out.data = in.data;
+        PointwiseOperation(PointwiseOperation::DIVIDE, divisor).apply(out.data.data(), out.data.size());
     }
     else
     {
@@ -37,12 +37,19 @@ class Normalize : public ProcessingPlugin
         void setFromInputs();
 
         QString getParameterPreview();
+        bool pointwiseOperation(int chID, PointwiseOperation & op);
 
  private:
 
      QString operation;
      QString chId;
      double value;
+
+     /** @brief true: normalize to peak, false: normalize to value (resolved in setFromInputs()) */
+     bool toPeak;
+
+     /** @brief selected channel id, -1: all channels */
+     int chIdValue;
 };
 
 #endif // NORMALIZE_H
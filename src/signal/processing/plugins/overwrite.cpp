@@ -3,6 +3,7 @@
 #include "../../mrun.h"
 #include "../processingchain.h"
 #include <QDebug>
+#include <QDataStream>
 
 QString Overwrite::descriptionFileName = "overwrite.html"; // TODO
 QString Overwrite::iconFileName = "iconfile"; // TODO
@@ -165,3 +166,23 @@ QString Overwrite::getParameterPreview()
     QString str = "(A=%1;B=%2;source=%3)";
     return str.arg(chId_A).arg(chId_B).arg(source);
 }
+
+
+/**
+ * @brief Overwrite::resultKeyData implements virtual function,
+ * adds the result of the raw processing chain if raw signals are
+ * copied to the absolute chain
+ * @param stream key data
+ * @return false if the raw result is unknown
+ */
+bool Overwrite::resultKeyData(QDataStream &stream)
+{
+    if(source == "raw" && stype == Signal::ABS)
+    {
+        quint64 rawKey = mrun->getProcessingChain(Signal::RAW)->resultKey();
+        if(rawKey == 0)
+            return false;
+        stream << rawKey;
+    }
+    return true;
+}
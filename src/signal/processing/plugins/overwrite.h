@@ -37,6 +37,9 @@ class Overwrite : public ProcessingPlugin
 
         QString getParameterPreview();
 
+    protected:
+        bool resultKeyData(QDataStream &stream);
+
     private:
 
         QString source;
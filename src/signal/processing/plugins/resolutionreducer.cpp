@@ -15,6 +15,7 @@ ResolutionReducer::ResolutionReducer(ProcessingChain *parentChain) :   Processin
 
     range = 0.1;
     resolution = "8";
+    stepSize = range / pow(2.0, resolution.toDouble());
 
 
     ProcessingPluginInput cbResolution;
@@ -70,6 +71,21 @@ void ResolutionReducer::setFromInputs()
     // assign members
     resolution = inputs.getValue("cbResolution").toString();
     range      = inputs.getValue("cRange").toDouble();
+
+    stepSize   = range / pow(2.0, resolution.toDouble());
+}
+
+
+/**
+ * @brief ResolutionReducer::pointwiseOperation implements virtual function
+ * @param chID channel id
+ * @param op operation
+ * @return true
+ */
+bool ResolutionReducer::pointwiseOperation(int chID, PointwiseOperation &op)
+{
+    op = PointwiseOperation(PointwiseOperation::QUANTIZE, stepSize);
+    return true;
 }
 
 
@@ -81,20 +97,9 @@ void ResolutionReducer::setFromInputs()
  */
 bool ResolutionReducer::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
 {
-    int noPts = in.data.size();
-
-    // use arithmetic operation on every datapoint
-    for(int i = 0; i < noPts; i++)
-    {
-        double y, v;
-        y = in.data.at(i);
-
-        double stepSize = (range) / pow(2.0, resolution.toDouble());
-
-        v = round(y / stepSize) * stepSize;
-
-        out.data.append(v);
-    }
+    // map every datapoint to quantization step
+    out.data = in.data;
+    PointwiseOperation(PointwiseOperation::QUANTIZE, stepSize).apply(out.data.data(), out.data.size());
 
     return true;
 }
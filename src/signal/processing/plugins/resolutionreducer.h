@@ -33,10 +33,14 @@ class ResolutionReducer : public ProcessingPlugin
         void setFromInputs();
 
         QString getParameterPreview();
+        bool pointwiseOperation(int chID, PointwiseOperation & op);
 
     private:
         double range;
         QString resolution;
+
+        /** @brief quantization step size (see setFromInputs()) */
+        double stepSize;
 };
 
 #endif // RESOLUTIONREDUCER_H
@@ -2,6 +2,7 @@
 
 #include "../processingchain.h"
 #include "../../mrun.h"
+#include "../../../general/LIISimException.h"
 #include <QDebug>
 
 QString SignalArithmetic::descriptionFileName = "signalarithmetic.html"; // TODO
@@ -20,6 +21,9 @@ SignalArithmetic::SignalArithmetic(ProcessingChain *parentChain) :   ProcessingP
     operation   = "multiplication (A*B)";
     chId_A        = "1";
     chId_B        = "2";
+    opType        = PointwiseOperation::MULTIPLY_CHANNEL;
+    chIdValue_A   = 1;
+    chIdValue_B   = 2;
 
     // create input fields;
     ProcessingPluginInput cbOperation;
@@ -90,6 +94,41 @@ void SignalArithmetic::setFromInputs()
     operation   = inputs.getValue("cbOperation").toString();
     chId_A        = inputs.getValue("cbChannel_A").toString();
     chId_B        = inputs.getValue("cbChannel_B").toString();
+
+    chIdValue_A   = chId_A.toInt();
+    chIdValue_B   = chId_B.toInt();
+
+    // resolve operation once, instead of comparing strings for every data point
+    if(operation == "multiplication (A*B)")
+        opType = PointwiseOperation::MULTIPLY_CHANNEL;
+    else if(operation == "division (A/B)")
+        opType = PointwiseOperation::DIVIDE_BY_CHANNEL;
+    else if(operation == "division (B/A)")
+        opType = PointwiseOperation::DIVIDE_CHANNEL;
+    else if(operation == "addition (A+B)")
+        opType = PointwiseOperation::ADD_CHANNEL;
+    else if(operation == "subtraction (A-B)")
+        opType = PointwiseOperation::SUBTRACT_CHANNEL;
+    else if(operation == "subtraction (B-A)")
+        opType = PointwiseOperation::SUBTRACT_FROM_CHANNEL;
+    else
+        opType = PointwiseOperation::IDENTITY;
+}
+
+
+/**
+ * @brief SignalArithmetic::pointwiseOperation implements virtual function
+ * @param chID channel id
+ * @param op operation
+ * @return true
+ */
+bool SignalArithmetic::pointwiseOperation(int chID, PointwiseOperation &op)
+{
+    if(chID == chIdValue_A && opType != PointwiseOperation::IDENTITY)
+        op = PointwiseOperation::channelOperation(opType, chIdValue_B);
+    else
+        op = PointwiseOperation(PointwiseOperation::IDENTITY);
+    return true;
 }
 
 /**
@@ -101,35 +140,22 @@ void SignalArithmetic::setFromInputs()
 bool SignalArithmetic::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
 {
     // process selected channel only
-    if(in.channelID == chId_A.toInt())
+    if(in.channelID == chIdValue_A)
     {
-        int noPts = in.data.size();
-
         // get signal of mpoint mpIdx with channelId= chId_B at previous position in chain
         ProcessingChain* pchain = mrun->getProcessingChain(in.type);
-        Signal s = pchain->getStepSignalPre(mpIdx, chId_B.toInt(), positionInChain-1);
+        Signal s = pchain->getStepSignalPre(mpIdx, chIdValue_B, positionInChain-1);
+
+        if(s.data.size() < in.data.size())
+            throw LIISimException(QString("SignalArithmetic: signal of channel %0 is shorter than signal of channel %1")
+                                  .arg(chIdValue_B)
+                                  .arg(chIdValue_A));
 
         // use arithmetic operation on every datapoint
-        for(int i = 0; i < noPts; i++)
-        {
-            double v;
-            if(operation == "multiplication (A*B)")
-                v = in.data.at(i) * s.data.at(i);
-            else if(operation == "division (A/B)")
-                v = in.data.at(i) / s.data.at(i);
-            else if(operation == "division (B/A)")
-                v = s.data.at(i) / in.data.at(i);
-            else if(operation == "addition (A+B)")
-                v = in.data.at(i) + s.data.at(i);
-            else if(operation == "subtraction (A-B)")
-                v = in.data.at(i) - s.data.at(i);
-            else if(operation == "subtraction (B-A)")
-                v = s.data.at(i) - in.data.at(i);
-            else
-                v = in.data.at(i);
-
-            out.data.append(v);
-        }
+        out.data = in.data;
+        PointwiseOperation::channelOperation(opType, chIdValue_B).apply(out.data.data(),
+                                                                        s.data.constData(),
+                                                                        out.data.size());
     }
     else
     {
@@ -37,12 +37,18 @@ class SignalArithmetic : public ProcessingPlugin
        void setFromInputs();
 
        QString getParameterPreview();
+       bool pointwiseOperation(int chID, PointwiseOperation & op);
 
 private:
 
     QString operation;
     QString chId_A;
     QString chId_B;
+
+    /** @brief operation type resolved from operation string (see setFromInputs()) */
+    PointwiseOperation::Type opType;
+    int chIdValue_A;
+    int chIdValue_B;
 };
 
 #endif // SIGNALARITHMETIC_H
@@ -1,5 +1,17 @@
 #include "simpledatareducer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <QMutexLocker>
+
+#include "../../../calculations/constants.h"
+
+
+/** @brief filter taps per remaining data point (FIR) */
+static const int firTapsPerPhase = 8;
+
+/** @brief number of integrator/comb stages (CIC) */
+static const int cicOrder = 3;
 
 
 QString SimpleDataReducer::descriptionFileName = "simpleDataReducer.html"; // TODO
@@ -18,6 +30,7 @@ SimpleDataReducer::SimpleDataReducer(ProcessingChain *parentChain) :   Processin
     shortDescription = "Reduce the amout of datapoints by increasing the time step between data points";
 
     dtFactor = 2;
+    filter = FIR;
 
     // create input fields;
     ProcessingPluginInput inputDtFactor;
@@ -30,6 +43,20 @@ SimpleDataReducer::SimpleDataReducer(ProcessingChain *parentChain) :   Processin
     inputDtFactor.tooltip = "Define number of data points that are skipped";
 
     inputs << inputDtFactor; // add value to input list
+
+    ProcessingPluginInput cbFilter;
+    cbFilter.type = ProcessingPluginInput::COMBOBOX;
+    cbFilter.value = "FIR (anti-aliasing);None;FIR (anti-aliasing);CIC";
+    cbFilter.labelText = "Filter: ";
+    cbFilter.identifier = "cbFilter";
+    cbFilter.legacyValue = "None"; // sessions saved before the filter was added
+    cbFilter.tooltip = "None: data points are skipped (noise above the new Nyquist frequency is aliased)\n"
+                       "FIR (anti-aliasing): windowed-sinc low-pass filter (Blackman)\n"
+                       "CIC: cascaded moving average (3rd order, shorter filter)";
+
+    inputs << cbFilter;
+
+    coefficients = filterCoefficients(filter, dtFactor + 1);
 }
 
 
@@ -49,11 +76,94 @@ QString SimpleDataReducer::getName()
  */
 void SimpleDataReducer::setFromInputs()
 {
-    // assign members
-    dtFactor = inputs.getValue("dtFactor").toInt();
+    int factor = inputs.getValue("dtFactor").toInt();
 
     // avoid reset to one if necessary!
-    if(dtFactor < 0) dtFactor = 0;
+    if(factor < 0) factor = 0;
+
+    FilterType type;
+    QString str = inputs.getValue("cbFilter").toString();
+    if(str == "None")
+        type = SKIP;
+    else if(str == "CIC")
+        type = CIC;
+    else
+        type = FIR;
+
+    QVector<double> c = filterCoefficients(type, factor + 1);
+
+    // assign members (may be read by a ProcessingTask)
+    QMutexLocker lock(&variableMutex);
+    dtFactor = factor;
+    filter = type;
+    coefficients = c;
+}
+
+
+/**
+ * @brief SimpleDataReducer::filterCoefficients calculates the filter
+ * coefficients for a decimation factor (normalized to the
+ * time step of the signal, independent of dt)
+ * @param filter
+ * @param M decimation factor
+ * @return coefficients (empty: data points are skipped)
+ */
+QVector<double> SimpleDataReducer::filterCoefficients(FilterType filter, int M)
+{
+    QVector<double> coefficients;
+    if(filter == SKIP || M == 1)
+        return coefficients;
+
+    if(filter == CIC)
+    {
+        // impulse response of cicOrder moving averages of length M (normalized to M^N),
+        // padded to odd length to be centered
+        QVector<double> h(1, 1.0);
+        for(int n = 0; n < cicOrder; n++)
+        {
+            QVector<double> conv(h.size() + M - 1, 0.0);
+            for(int i = 0; i < h.size(); i++)
+                for(int j = 0; j < M; j++)
+                    conv[i + j] += h.at(i) / M;
+            h = conv;
+        }
+        if(h.size() % 2 == 0)
+        {
+            // average of two neighbouring taps (half sample delay)
+            QVector<double> odd(h.size() + 1, 0.0);
+            for(int i = 0; i < h.size(); i++)
+            {
+                odd[i]     += 0.5 * h.at(i);
+                odd[i + 1] += 0.5 * h.at(i);
+            }
+            h = odd;
+        }
+        return h;
+    }
+
+    // windowed-sinc low-pass, cutoff at new Nyquist frequency
+    const int half = firTapsPerPhase * M / 2;
+    const int size = 2 * half + 1;
+    const double fc = 0.5 / M;
+
+    coefficients.resize(size);
+
+    double sum = 0.0;
+    for(int i = 0; i < size; i++)
+    {
+        double n = i - half;
+        double sinc = (n == 0.0) ? 2.0 * fc : std::sin(2.0 * Constants::pi * fc * n) / (Constants::pi * n);
+        double window = 0.42
+                - 0.5  * std::cos(2.0 * Constants::pi * i / (size - 1))
+                + 0.08 * std::cos(4.0 * Constants::pi * i / (size - 1));
+        coefficients[i] = sinc * window;
+        sum += coefficients[i];
+    }
+
+    for(int i = 0; i < size; i++)
+        coefficients[i] /= sum;
+
+    return coefficients;
 }
 
 
@@ -65,17 +175,72 @@ void SimpleDataReducer::setFromInputs()
  */
 bool SimpleDataReducer::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
 {
-    int noPts = in.data.size();
+    // parameters can be changed within GUI thread during processing
+    QVector<double> coeffs;
+    int M;
+    {
+        QMutexLocker lock(&variableMutex);
+        coeffs = coefficients;
+        M = dtFactor + 1;
+    }
+
+    const int noPts = in.data.size();
+
+    // same data points as simple skipping (last data point is never used)
+    const int noOut = noPts > 1 ? (noPts - 2) / M + 1 : 0;
 
-    // okay, we could do something more special here than simply skipping
-    // data points :D ! TODO !!!
-    for(int i = 0; i < noPts-1; i += (dtFactor+1))
+    out.data.resize(noOut);
+    out.dt = in.dt * M;
+
+    const double* x = in.data.constData();
+    double* y = out.data.data();
+
+    if(coeffs.isEmpty())
     {
-        double v = in.data.at(i);
-        out.data.append(v);
+        for(int k = 0; k < noOut; k++)
+            y[k] = x[k * M];
+        return true; // we do not make any validation here
     }
 
-    out.dt = in.dt * (dtFactor+1);
+    // decimating FIR: only the remaining data points are calculated,
+    // filter is centered at the remaining data point (no time shift)
+    const int taps = coeffs.size();
+    const int half = taps / 2;
+    const double* h = coeffs.constData();
+
+    // data points without full filter support: edge values are repeated
+    auto filterAtEdge = [&](int center)
+    {
+        double sum = 0.0;
+        for(int j = 0; j < taps; j++)
+        {
+            int i = qBound(0, center - half + j, noPts - 1);
+            sum += h[j] * x[i];
+        }
+        return sum;
+    };
+
+    // first/last remaining data point with full filter support
+    const int lastFull = noPts - 1 - half;
+    const int kStart = std::min(noOut, (half + M - 1) / M);
+    const int kEnd   = lastFull < 0 ? kStart : std::max(kStart, std::min(noOut, lastFull / M + 1));
+
+    for(int k = 0; k < kStart; k++)
+        y[k] = filterAtEdge(k * M);
+
+    for(int k = kStart; k < kEnd; k++)
+    {
+        const double* xk = x + k * M - half;
+
+        double sum = 0.0;
+        for(int j = 0; j < taps; j++)
+            sum += h[j] * xk[j];
+        y[k] = sum;
+    }
+
+    for(int k = kEnd; k < noOut; k++)
+        y[k] = filterAtEdge(k * M);
+
     return true; // we do not make any validation here
 }
 
@@ -83,7 +248,8 @@ bool SimpleDataReducer::processSignalImplementation(const Signal &in, Signal &ou
 QString SimpleDataReducer::getParameterPreview()
 {
     QString str ;
-    str.sprintf("(skip=%d)",dtFactor);
+    str.sprintf("(skip=%d;%s)", dtFactor,
+                filter == FIR ? "FIR" : (filter == CIC ? "CIC" : "no filter"));
 
     return str;
 }
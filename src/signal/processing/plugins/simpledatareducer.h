@@ -8,6 +8,9 @@
  * @brief Example ProcessingPlugin which reduces the amount of
  * signal data points by changing the signal's time step.
  * @ingroup ProcessingPlugin-Implementations
+ * @details The signal is low-pass filtered before the data points are
+ * skipped (anti-aliasing), only the remaining data points are calculated.
+ * Filter coefficients are calculated when the parameters change.
  */
 class SimpleDataReducer : public ProcessingPlugin
 {
@@ -44,9 +47,20 @@ public:
 
 private:
 
-    /** @brief time step factor used for data reduction */
+    enum FilterType { SKIP, FIR, CIC };
+
+    /** @brief time step factor used for data reduction (guarded by variableMutex) */
     int dtFactor;
 
+    /** @brief anti-aliasing filter resolved from input (see setFromInputs()) */
+    FilterType filter;
+
+    /** @brief filter coefficients (odd number, centered at the remaining data point),
+     * guarded by variableMutex, processSignalImplementation() uses a shared copy */
+    QVector<double> coefficients;
+
+    static QVector<double> filterCoefficients(FilterType filter, int M);
+
 };
 
 #endif // SIMPLEDATAREDUCER_H
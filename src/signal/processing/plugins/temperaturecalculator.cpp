@@ -1,6 +1,8 @@
 #include "temperaturecalculator.h"
 
 #include <QDebug>
+#include <QDataStream>
+#include <QFileInfo>
 #include "../../../core.h"
 #include "../../mrun.h"
 #include "../../mpoint.h"
@@ -8,6 +10,7 @@
 #include "../../../calculations/temperature.h"
 #include "../processingchain.h"
 #include "../processingpluginconnector.h"
+#include "../ppresultcache.h"
 #include "multisignalaverage.h"
 
 // init static members
@@ -45,6 +48,9 @@ TemperatureCalculator::TemperatureCalculator(ProcessingChain *parentChain) : Pro
     startT = 2500.0;
     startC = 1.0;
     autoStartC = true;
+    historyRetention = FitHistoryStore::EVERY_NTH;
+    historyInterval = 10;
+    msaMpIdx = 0;
 
     activeChannels = new QList<bool>;
 
@@ -241,6 +247,34 @@ global: Material is taken from global setting in calculation toolbox (top ribbon
     inputs << inputStartC;
 
 
+    ProcessingPluginInput cbFitHistory;
+    cbFitHistory.type = ProcessingPluginInput::COMBOBOX;
+    cbFitHistory.groupID = 2;
+    cbFitHistory.value = QString("%0;%1;%0;%2")
+            .arg(FitHistoryStore::retentionToString(FitHistoryStore::EVERY_NTH))
+            .arg(FitHistoryStore::retentionToString(FitHistoryStore::FINAL))
+            .arg(FitHistoryStore::retentionToString(FitHistoryStore::FULL));
+    cbFitHistory.labelText = "Fit history";
+    cbFitHistory.identifier = "cbFitHistory";
+    cbFitHistory.tooltip = "Iterations kept for each data point (can be visualized in AnalysisTools - TemperatureFit)\n"
+                           "The final iteration is always kept, 'All iterations' needs a lot of memory for long signals";
+
+    inputs << cbFitHistory;
+
+
+    ProcessingPluginInput inputHistoryInterval;
+    inputHistoryInterval.type = ProcessingPluginInput::INTEGER_FIELD;
+    inputHistoryInterval.groupID = 2;
+    inputHistoryInterval.value = historyInterval;
+    inputHistoryInterval.minValue = 1;
+    inputHistoryInterval.maxValue = 500;
+    inputHistoryInterval.labelText = "Fit history interval";
+    inputHistoryInterval.identifier = "inputHistoryInterval";
+    inputHistoryInterval.tooltip = "Every n-th iteration is kept (fit history: 'Every n-th iteration')";
+
+    inputs << inputHistoryInterval;
+
+
     // Parameters: "Test" (GroupID = 3)
 
     ProcessingPluginInput inputSelectChannel_Test;
@@ -606,6 +640,9 @@ void TemperatureCalculator::setFromInputs()
         startC      = inputs.getValue("inputStartC").toDouble();
         autoStartC  = inputs.getValue("inputAutoStartC").toBool();
 
+        historyRetention = FitHistoryStore::retentionFromString(inputs.getValue("cbFitHistory").toString());
+        historyInterval  = inputs.getValue("inputHistoryInterval").toInt();
+
         inputSelectChannelStr = inputs.getValue("inputSelectChannel").toString();
     }
     // Test:
@@ -668,6 +705,7 @@ bool TemperatureCalculator::processSignalImplementation(const Signal &in, Signal
     {
         // qDebug() << "TC: sigsize " << msaTemp.data.size();
         out = msaTemp;
+        mrun->fitHistory()->copyTrace(msaMpIdx, mpIdx, m_tempChannelID);
         return true;
     }
 
@@ -699,6 +737,11 @@ bool TemperatureCalculator::processSignalImplementation(const Signal &in, Signal
         // reset error state
         mProcessingError = false;
 
+        // fit history of Spectrum/Test (see FitHistoryStore)
+        FitHistoryStore::Trace history;
+        history.setRetention(historyRetention, historyInterval);
+        mrun->fitHistory()->remove(mpIdx, m_tempChannelID);
+
         MPoint* mp = mrun->getPost(mpIdx);
         LIISettings curSettings = mrun->liiSettings();
 
@@ -778,8 +821,11 @@ bool TemperatureCalculator::processSignalImplementation(const Signal &in, Signal
                                                            autoStartC,
                                                            iter,
                                                            startT,
-                                                           startC
-                                                           );            
+                                                           startC,
+                                                           &history
+                                                           );
+
+            mrun->fitHistory()->setTrace(mpIdx, m_tempChannelID, history);
         }
         else if(method == "Test")
         {
@@ -797,9 +843,11 @@ bool TemperatureCalculator::processSignalImplementation(const Signal &in, Signal
                                                            activeChannels,
                                                            iter,
                                                            startT,
-                                                           startC
+                                                           startC,
+                                                           &history
                                                            );
 
+            mrun->fitHistory()->setTrace(mpIdx, m_tempChannelID, history);
         }
         else if(method == "copy from signals")
         {
@@ -861,7 +909,10 @@ bool TemperatureCalculator::processSignalImplementation(const Signal &in, Signal
     {
         msaMode = m_sourcePchain->containsActivePlugin( MultiSignalAverage::pluginName );
         if(msaMode )
+        {
             msaTemp = out;
+            msaMpIdx = mpIdx;
+        }
         msaSearched = true;
     }
 
@@ -1045,3 +1096,90 @@ Signal::SType TemperatureCalculator::getInputSignalType()
 {
     return inputSignalType;
 }
+
+
+/**
+ * @brief TemperatureCalculator::resultKeyData implements virtual function,
+ * adds the result of the input processing chain, the LIISettings and the
+ * material (selected or global material of the modeling settings,
+ * database file, modification time and revision)
+ * @param stream key data
+ * @return false if the result of the input chain is unknown
+ */
+bool TemperatureCalculator::resultKeyData(QDataStream &stream)
+{
+    quint64 sourceKey = mrun->getProcessingChain(inputSignalType)->resultKey();
+    if(sourceKey == 0)
+        return false;
+
+    stream << sourceKey;
+
+    writeLIISettingsKey(stream);
+
+    // same material selection as processSignalImplementation()
+    Material material = Core::instance()->modelingSettings->materialSpec();
+    if(selected_material != "global")
+    {
+        QList<DatabaseContent*> materials = *Core::instance()->getDatabaseManager()->getMaterials();
+        for(int k = 0; k < materials.size(); k++)
+        {
+            if(selected_material == materials.at(k)->name)
+                material = Material(*Core::instance()->getDatabaseManager()->getMaterial(k));
+        }
+    }
+
+    QFileInfo file(Core::instance()->generalSettings->databaseDirectory() + material.filename);
+
+    stream << material.name << material.filename << qint32(material.revision)
+           << file.lastModified().toMSecsSinceEpoch();
+
+    return true;
+}
+
+
+/**
+ * @brief The TemperatureCalculator::HistoryState class keeps the fit
+ * histories of a buffered result (see PPResultCache)
+ */
+class TemperatureCalculator::HistoryState : public PPResultState
+{
+public:
+    /** @brief key: MPoint index */
+    QMap<int, FitHistoryStore::Trace> traces;
+
+    quint64 memoryUsage() const
+    {
+        quint64 sum = 0;
+        for(auto it = traces.constBegin(); it != traces.constEnd(); ++it)
+            sum += it.value().memoryUsage();
+        return sum;
+    }
+};
+
+
+/**
+ * @brief TemperatureCalculator::resultState implements virtual function,
+ * the fit histories (Spectrum/Test) are buffered with the step buffer
+ * @return fit histories of the temperature channel
+ */
+QSharedPointer<PPResultState> TemperatureCalculator::resultState()
+{
+    QSharedPointer<HistoryState> state(new HistoryState);
+    state->traces = mrun->fitHistory()->channelTraces(m_tempChannelID);
+    return state;
+}
+
+
+/**
+ * @brief TemperatureCalculator::restoreResultState implements virtual function,
+ * restores the fit histories of a buffered result
+ * @param state
+ */
+void TemperatureCalculator::restoreResultState(const QSharedPointer<PPResultState> &state)
+{
+    QSharedPointer<HistoryState> history = state.dynamicCast<HistoryState>();
+    if(history)
+        mrun->fitHistory()->setChannelTraces(m_tempChannelID, history->traces);
+    else
+        mrun->fitHistory()->removeChannel(m_tempChannelID);
+}
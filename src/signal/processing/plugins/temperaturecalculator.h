@@ -2,6 +2,7 @@
 #define TEMPERATURECALCULATOR_H
 
 #include "../processingplugin.h"
+#include "../../fithistorystore.h"
 
 class Core;
 class MRun;
@@ -69,8 +70,15 @@ class TemperatureCalculator : public ProcessingPlugin
 
         QString getSelectedMaterial() { return selected_material; }
 
+    protected:
+        bool resultKeyData(QDataStream &stream);
+        QSharedPointer<PPResultState> resultState();
+        void restoreResultState(const QSharedPointer<PPResultState> &state);
+
     private:
 
+        class HistoryState;
+
         QString method;
         int chId1;
         int chId2;
@@ -86,6 +94,10 @@ class TemperatureCalculator : public ProcessingPlugin
         double startC;
         bool autoStartC;
 
+        /** @brief iterations kept in MRun::fitHistory() */
+        FitHistoryStore::Retention historyRetention;
+        int historyInterval;
+
         int iter_Test;
         double startT_Test;
         double startC_Test;
@@ -101,6 +113,8 @@ class TemperatureCalculator : public ProcessingPlugin
         bool msaMode;
         bool msaSearched;
         Signal msaTemp;
+        /** @brief MPoint index of msaTemp (fit history) */
+        int msaMpIdx;
 
         /** @brief mProcessingError tracks errors for each temperature channel */
         // moved to Plugin: bool mProcessingError;
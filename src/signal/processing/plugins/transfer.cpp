@@ -2,6 +2,7 @@
 
 #include "../../mrun.h"
 #include "../processingchain.h"
+#include <QDataStream>
 
 QString Transfer::pluginName = "Transfer";
 
@@ -52,3 +53,20 @@ QString Transfer::getParameterPreview()
     else
         return "(ERROR: Wrong signal type! Please remove the plugin!)";
 }
+
+
+/**
+ * @brief Transfer::resultKeyData implements virtual function,
+ * adds the result of the raw processing chain
+ * @param stream key data
+ * @return false if the raw result is unknown
+ */
+bool Transfer::resultKeyData(QDataStream &stream)
+{
+    quint64 rawKey = mrun->getProcessingChain(Signal::RAW)->resultKey();
+    if(rawKey == 0)
+        return false;
+
+    stream << rawKey;
+    return true;
+}
@@ -24,6 +24,9 @@ public:
 
     QString getParameterPreview();
 
+protected:
+    bool resultKeyData(QDataStream &stream);
+
 private:
     Signal::SType destinationSType;
 
@@ -1,7 +1,9 @@
 #include "xshiftsignals.h"
 #include "../processingchain.h"
+#include "../../../calculations/numeric.h"
 
-#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
 
 QString XShiftSignals::descriptionFileName = "xshiftsignals.html"; // TODO
 QString XShiftSignals::iconFileName = "iconfile"; // TODO
@@ -14,6 +16,45 @@ XShiftSignals::XShiftSignals(ProcessingChain *parentChain) :   ProcessingPlugin(
 {
     shortDescription = "X-shift signals";
     executeSyncronized = false;
+
+    method = PEAK;
+    runShift = false;
+    interpolation = SignalResampler::SINC;
+
+    ProcessingPluginInput cbMethod;
+    cbMethod.type = ProcessingPluginInput::COMBOBOX;
+    cbMethod.value = "Peak position;Peak position;Cross-correlation";
+    cbMethod.labelText = "Alignment";
+    cbMethod.identifier = "cbMethod";
+    cbMethod.tooltip = "Peak position: signals are shifted by whole data points to align the peaks\n"
+                       "Cross-correlation: shifts are estimated from the cross-correlation with the first channel\n"
+                       "(sub-sample accuracy, signals are interpolated)";
+
+    inputs << cbMethod;
+
+    ProcessingPluginInput inputRunShift;
+    inputRunShift.type = ProcessingPluginInput::CHECKBOX;
+    inputRunShift.value = runShift;
+    inputRunShift.identifier = "runShift";
+    inputRunShift.labelText = "Shift from average signal";
+    inputRunShift.tooltip = "The shifts are estimated once from the average of all valid signals\n"
+                            "and applied to all signals of the run";
+
+    inputs << inputRunShift;
+
+    ProcessingPluginInput cbInterpolation;
+    cbInterpolation.type = ProcessingPluginInput::COMBOBOX;
+    cbInterpolation.value = "Sinc (Lanczos);Sinc (Lanczos);Cubic;Linear";
+    cbInterpolation.legacyValue = "Linear"; // sessions saved before the option was added
+    cbInterpolation.labelText = "Interpolation";
+    cbInterpolation.identifier = "cbInterpolation";
+    cbInterpolation.tooltip = "Interpolation of fractional shifts (cross-correlation):\n"
+                              "Sinc (Lanczos): nearly flat frequency response, channels keep their shape\n"
+                              "Cubic: Catmull-Rom spline\n"
+                              "Linear: smooths the signal depending on the fractional shift\n"
+                              "(biases channel ratios, eg. two-color temperatures)";
+
+    inputs << cbInterpolation;
 }
 
 
@@ -29,81 +70,190 @@ QString XShiftSignals::getName()
 
 void XShiftSignals::setFromInputs()
 {
+    if(inputs.getValue("cbMethod").toString() == "Cross-correlation")
+        method = CROSS_CORRELATION;
+    else
+        method = PEAK;
+
+    runShift = inputs.getValue("runShift").toBool();
 
+    QString str = inputs.getValue("cbInterpolation").toString();
+    if(str == "Linear")
+        interpolation = SignalResampler::LINEAR;
+    else if(str == "Cubic")
+        interpolation = SignalResampler::CUBIC;
+    else
+        interpolation = SignalResampler::SINC;
 }
 
 
 QString XShiftSignals::getParameterPreview()
 {
-    QString str = "";
-    return str;
+    QString interp = "sinc";
+    if(interpolation == SignalResampler::LINEAR)
+        interp = "linear";
+    else if(interpolation == SignalResampler::CUBIC)
+        interp = "cubic";
+
+    QString str = "(%0%1)";
+    return str.arg(method == CROSS_CORRELATION ? "cross-correlation;" + interp : QString("peak"))
+              .arg(runShift ? ";average" : "");
 }
 
 
-bool XShiftSignals::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
+/**
+ * @brief shiftData shifts the data to earlier times by a fractional number of
+ * data points (see SignalResampler, integer shifts are copied).
+ * Data points without source data keep their values.
+ * @param in input data
+ * @param out output data (same size as in)
+ * @param shift number of data points (>= 0)
+ * @param interpolation
+ */
+static void shiftData(const QVector<double> &in, QVector<double> &out, double shift,
+                      SignalResampler::Method interpolation)
 {
-    QMutexLocker lock(&variableMutex);
+    const int size = in.size();
 
-    //do calculations only for first channel
-    if(in.channelID == 1)
-    {
+    if(shift < 0.0 || shift >= size)
+        return;
+
+    SignalResampler resampler(0.0, 1.0, size, shift, 1.0, size, interpolation);
+    QVector<double> shifted = resampler.apply(in);
+
+    std::copy(shifted.constBegin() + resampler.firstIndex(),
+              shifted.constBegin() + resampler.lastIndex(),
+              out.begin() + resampler.firstIndex());
+}
 
-        shiftSignals[mpIdx].resize(channelCount());
 
-        ProcessingChain* pchain = mrun->getProcessingChain(this->stype);
+/**
+ * @brief XShiftSignals::channelShifts calculates the shift of each channel
+ * relative to the channel with the earliest signal
+ * @param chids channel ids
+ * @param signalList signal of each channel
+ * @return shift of each channel [data points] (index: channel id - 1)
+ */
+QVector<double> XShiftSignals::channelShifts(const QList<int> &chids, const QList<Signal> &signalList)
+{
+    int size = 0;
+    for(int c = 0; c < chids.size(); c++)
+        size = qMax(size, chids.at(c));
 
-        std::vector<int> xpos;
-        int lowest_xpos;
-        int lowest_xpos_ch;
+    QVector<double> res(size, 0.0);
+    if(chids.isEmpty())
+        return res;
 
-        xpos.resize(channelCount());
+    QVector<double> pos(chids.size());
 
-        // iterate through all channels
-        for( int c = 0; c < channelCount(); c++)
-        {
-            // get signal of mpoint mpIdx with channelId c+1 at previous position in chain
-            Signal s = pchain->getStepSignalPre(mpIdx, c+1, positionInChain-1);
+    for( int c = 0; c < chids.size(); c++)
+    {
+        if(method == CROSS_CORRELATION)
+            // delay relative to first channel
+            pos[c] = (c == 0) ? 0.0 : Numeric::crossCorrelationLag(signalList.at(0).data, signalList.at(c).data);
+        else
+            // peak position
+            pos[c] = signalList.at(c).getMaxIndex();
+    }
 
-            shiftSignals[mpIdx][c] = s;
+    double lowest = *std::min_element(pos.constBegin(), pos.constEnd());
 
-            // find and save peak position
-            xpos[c] = s.getMaxIndex();
+    for( int c = 0; c < chids.size(); c++)
+        res[chids.at(c)-1] = pos[c] - lowest;
+
+    return res;
+}
 
-            if(c == 0)
-            {
-                lowest_xpos = xpos[0];
-                lowest_xpos_ch = 0;
-            }
-            else if (xpos[c] < xpos[c-1])
-            {
-                lowest_xpos = xpos[c];
-                lowest_xpos_ch = c;
-            }
-        }
 
-        // iterate again through all channels and save shifted signals
-        for( int c = 0; c < channelCount(); c++)
+/**
+ * @brief XShiftSignals::prepareProcessing implements virtual function,
+ * determines the shift of all channels for each MPoint (or once from
+ * the average signal of the run) relative to the channel with the earliest signal
+ * @param mStart index of first MPoint
+ * @param mEnd index of last MPoint
+ */
+void XShiftSignals::prepareProcessing(int mStart, int mEnd)
+{
+    QList<int> chids = mrun->channelIDs(stype);
+
+    shifts.resize(mrun->sizeAllMpoints());
+
+    if(runShift)
+    {
+        // average signal of each channel (all valid MPoints, common length)
+        QList<Signal> avgSignals;
+        for( int c = 0; c < chids.size(); c++)
         {
-            // calculate new xpos
-            if(c != lowest_xpos_ch)
-            {
-                xpos[c] = xpos[c] - lowest_xpos;
-            }
-            else
-            {
-                continue;
-            }
-            Signal s = pchain->getStepSignalPre(mpIdx, c+1, positionInChain-1);
+            Signal avg;
+            int counter = 0;
 
-            // overwrite signal
-            for(int i = 0; i < (shiftSignals[mpIdx][c].data.size() - xpos[c]); i++)
+            for( int m = 0; m < mrun->sizeAllMpoints(); m++)
             {
-                shiftSignals[mpIdx][c].data[i] = s.data[i+xpos[c]];
+                if(!validAtPreviousStep(m))
+                    continue;
+
+                Signal s = processedSignalPreviousStep(m, chids.at(c));
+                if(s.data.isEmpty())
+                    continue;
+
+                if(counter == 0)
+                    avg = s;
+                else
+                {
+                    if(s.data.size() < avg.data.size())
+                        avg.data.resize(s.data.size());
+
+                    double* dst = avg.data.data();
+                    const double* src = s.data.constData();
+                    for(int i = 0; i < avg.data.size(); i++)
+                        dst[i] += src[i];
+                }
+                counter++;
             }
+
+            if(counter > 1)
+                for(int i = 0; i < avg.data.size(); i++)
+                    avg.data[i] /= double(counter);
+
+            avgSignals.append(avg);
         }
+
+        QVector<double> res = channelShifts(chids, avgSignals);
+        for(int m = mStart; m <= mEnd; m++)
+            shifts[m] = res;
+
+        return;
     }
 
-    out = shiftSignals[mpIdx][in.channelID-1];
+    for(int m = mStart; m <= mEnd; m++)
+    {
+        // get signals of mpoint m at previous position in chain
+        QList<Signal> signalList;
+        for( int c = 0; c < chids.size(); c++)
+            signalList.append(processedSignalPreviousStep(m, chids.at(c)));
+
+        shifts[m] = channelShifts(chids, signalList);
+    }
+}
+
+
+/**
+ * @brief XShiftSignals::processSignalImplementation implements virtual function.
+ * Shifts the signal by the number of data points determined by prepareProcessing()
+ * (can be executed in parallel).
+ * @param in  input signal
+ * @param out output signal
+ * @return true if the signal has passed validation
+ */
+bool XShiftSignals::processSignalImplementation(const Signal &in, Signal &out, int mpIdx)
+{
+    out = in;
+
+    double shift = shifts.value(mpIdx).value(in.channelID-1, 0.0);
+
+    // overwrite signal
+    if(shift > 0.0)
+        shiftData(in.data, out.data, shift, interpolation);
 
     return true; // we do not make any validation here
 }
@@ -115,8 +265,6 @@ bool XShiftSignals::processSignalImplementation(const Signal &in, Signal &out, i
  */
 void XShiftSignals::reset()
 {
-    QMutexLocker lock(&variableMutex);
     ProcessingPlugin::reset();
-    //shiftSignals.clear();
+    shifts.clear();
 }
-
@@ -3,6 +3,7 @@
 
 #include "../../mrun.h"
 #include "../../signal.h"
+#include "../../signalresampler.h"
 #include "../processingplugin.h"
 #include <QList>
 
@@ -32,10 +33,27 @@ public:
 
     QString getParameterPreview();
 
+protected:
+    void prepareProcessing(int mStart, int mEnd);
+
 private:
 
-    // mpIdx -> channel -> Signal
-    std::map<int, std::vector<Signal>> shiftSignals;
+    enum Method { PEAK, CROSS_CORRELATION };
+
+    /** @brief alignment method resolved from input (see setFromInputs()) */
+    Method method;
+
+    /** @brief estimate one shift per channel from the average signal of the run */
+    bool runShift;
+
+    /** @brief interpolation of fractional shifts (see SignalResampler) */
+    SignalResampler::Method interpolation;
+
+    /// @brief shift in data points (fractional for cross-correlation) for each MPoint
+    /// and channel (mpIdx -> channel id - 1), calculated by prepareProcessing()
+    QVector<QVector<double>> shifts;
+
+    QVector<double> channelShifts(const QList<int> &chids, const QList<Signal> &signalList);
 
 };
 
@@ -0,0 +1,155 @@
+#include "pointwiseoperation.h"
+
+#include <cmath>
+
+
+PointwiseOperation::PointwiseOperation()
+{
+    type = IDENTITY;
+    value = 0.0;
+    operandChannelID = -1;
+    stdevMode = STDEV_CLEAR;
+}
+
+
+PointwiseOperation::PointwiseOperation(Type type, double value, StdevMode stdevMode)
+{
+    this->type = type;
+    this->value = value;
+    this->operandChannelID = -1;
+    this->stdevMode = stdevMode;
+}
+
+
+/**
+ * @brief PointwiseOperation::channelOperation creates an operation
+ * which combines the signal with the signal of another channel
+ * @param type one of the *_CHANNEL operation types
+ * @param operandChannelID channel id of second operand
+ * @return PointwiseOperation
+ */
+PointwiseOperation PointwiseOperation::channelOperation(Type type, int operandChannelID)
+{
+    PointwiseOperation op(type);
+    op.operandChannelID = operandChannelID;
+    return op;
+}
+
+
+bool PointwiseOperation::isChannelOperation() const
+{
+    switch(type)
+    {
+        case MULTIPLY_CHANNEL:
+        case DIVIDE_BY_CHANNEL:
+        case DIVIDE_CHANNEL:
+        case ADD_CHANNEL:
+        case SUBTRACT_CHANNEL:
+        case SUBTRACT_FROM_CHANNEL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * @brief PointwiseOperation::apply applies scalar operation in place.
+ * The operation type is resolved once per call, the inner loops are
+ * kept branch-free to allow vectorization by the compiler.
+ * @param x data
+ * @param n number of data points
+ */
+void PointwiseOperation::apply(double *x, int n) const
+{
+    const double v = value;
+
+    switch(type)
+    {
+        case MULTIPLY:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] * v;
+            break;
+        case DIVIDE:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] / v;
+            break;
+        case ADD:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] + v;
+            break;
+        case SUBTRACT:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] - v;
+            break;
+        case QUANTIZE:
+            for(int i = 0; i < n; i++)
+                x[i] = round(x[i] / v) * v;
+            break;
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief PointwiseOperation::apply applies channel operation in place
+ * @param x data (first operand, overwritten)
+ * @param b data of operand channel
+ * @param n number of data points
+ */
+void PointwiseOperation::apply(double *x, const double *b, int n) const
+{
+    if(!isChannelOperation())
+    {
+        apply(x, n);
+        return;
+    }
+
+    switch(type)
+    {
+        case MULTIPLY_CHANNEL:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] * b[i];
+            break;
+        case DIVIDE_BY_CHANNEL:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] / b[i];
+            break;
+        case DIVIDE_CHANNEL:
+            for(int i = 0; i < n; i++)
+                x[i] = b[i] / x[i];
+            break;
+        case ADD_CHANNEL:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] + b[i];
+            break;
+        case SUBTRACT_CHANNEL:
+            for(int i = 0; i < n; i++)
+                x[i] = x[i] - b[i];
+            break;
+        case SUBTRACT_FROM_CHANNEL:
+            for(int i = 0; i < n; i++)
+                x[i] = b[i] - x[i];
+            break;
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief PointwiseOperation::applyToStdev modifies the standard deviation
+ * according to stdevMode
+ * @param stdev standard deviation vector
+ */
+void PointwiseOperation::applyToStdev(QVector<double> &stdev) const
+{
+    if(stdev.isEmpty())
+        return;
+
+    if(stdevMode == STDEV_CLEAR)
+        stdev.clear();
+    else if(stdevMode == STDEV_APPLY && !isIdentity() && !isChannelOperation())
+        apply(stdev.data(), stdev.size());
+}
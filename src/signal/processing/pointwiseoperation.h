@@ -0,0 +1,67 @@
+#ifndef POINTWISEOPERATION_H
+#define POINTWISEOPERATION_H
+
+#include <QVector>
+
+/**
+ * @brief The PointwiseOperation class describes the elementwise operation
+ * of a ProcessingPlugin on a single channel.
+ * @ingroup Signal-Processing
+ * @details Plugins which only depend on the current sample (and optionally
+ * on the same sample of another channel at the previous processing step) can
+ * describe their operation by this class (see ProcessingPlugin::pointwiseOperation()).
+ * This allows the ProcessingChain to fuse consecutive plugins into a single
+ * pass over the signal data (see PointwiseSegment).
+ */
+class PointwiseOperation
+{
+public:
+    enum Type {
+        IDENTITY,
+        MULTIPLY,           // x * value
+        DIVIDE,             // x / value
+        ADD,                // x + value
+        SUBTRACT,           // x - value
+        QUANTIZE,           // round(x / value) * value
+        MULTIPLY_CHANNEL,   // x * b
+        DIVIDE_BY_CHANNEL,  // x / b
+        DIVIDE_CHANNEL,     // b / x
+        ADD_CHANNEL,        // x + b
+        SUBTRACT_CHANNEL,   // x - b
+        SUBTRACT_FROM_CHANNEL // b - x
+    };
+
+    /**
+     * @brief StdevMode defines how the standard deviation
+     * of the signal is treated by the operation
+     */
+    enum StdevMode {
+        STDEV_CLEAR,    // stdev is cleared
+        STDEV_KEEP,     // stdev is passed unchanged
+        STDEV_APPLY     // scalar operation is applied to stdev
+    };
+
+    PointwiseOperation();
+    PointwiseOperation(Type type, double value = 0.0, StdevMode stdevMode = STDEV_CLEAR);
+
+    static PointwiseOperation channelOperation(Type type, int operandChannelID);
+
+    Type type;
+
+    /** @brief scalar operand */
+    double value;
+
+    /** @brief channel id of signal operand (for channel operations) */
+    int operandChannelID;
+
+    StdevMode stdevMode;
+
+    inline bool isIdentity() const { return type == IDENTITY; }
+    bool isChannelOperation() const;
+
+    void apply(double *x, int n) const;
+    void apply(double *x, const double *b, int n) const;
+    void applyToStdev(QVector<double> &stdev) const;
+};
+
+#endif // POINTWISEOPERATION_H
@@ -0,0 +1,333 @@
+#include "pointwisesegment.h"
+
+#include <cstring>
+#include <QStringList>
+
+#include "../../general/LIISimException.h"
+#include "../mrun.h"
+#include "processingchain.h"
+#include "processingplugin.h"
+#include "ppstepbuffer.h"
+#include "../../general/profiling.h"
+
+
+/**
+ * @brief PointwiseSegment::PointwiseSegment Constructor
+ * @param pchain processing chain
+ * @param first index of first plugin of segment
+ * @param last index of last plugin of segment
+ */
+PointwiseSegment::PointwiseSegment(ProcessingChain *pchain, int first, int last)
+{
+    this->pchain = pchain;
+    this->mrun = pchain->mrun();
+
+    for(int i = first; i <= last; i++)
+        plugins.append(pchain->getPlug(i));
+
+    prev = 0;
+    if(first > 0)
+        prev = pchain->getPlug(first - 1);
+
+    chids = mrun->channelIDs(pchain->getSignalType());
+
+    isLastInChain = (last == pchain->noPlugs() - 1);
+}
+
+
+/**
+ * @brief PointwiseSegment::resolveOperations requests the pointwise operations
+ * from all plugins of the segment (once per processing run).
+ * @return false if the segment cannot be executed as fused pass
+ * (the plugins should then be processed individually)
+ */
+bool PointwiseSegment::resolveOperations()
+{
+    ops.clear();
+    operandIdx.clear();
+
+    int noCh = chids.size();
+    int noMpts = mrun->sizeAllMpoints();
+
+    for(int k = 0; k < plugins.size(); k++)
+    {
+        ProcessingPlugin* p = plugins.at(k);
+
+        if(noMpts != p->stepBuffer->data.shape()[0] ||
+           noMpts != p->p_validations.size())
+            return false;
+
+        // inactive plugins pass the signal unchanged
+        QVector<PointwiseOperation> pops(noCh,
+                PointwiseOperation(PointwiseOperation::IDENTITY, 0.0, PointwiseOperation::STDEV_KEEP));
+        QVector<int> pidx(noCh, -1);
+
+        if(p->activated())
+        {
+            for(int c = 0; c < noCh; c++)
+            {
+                PointwiseOperation op;
+                if(!p->pointwiseOperation(chids.at(c), op))
+                    return false;
+
+                // see ProcessingPlugin::processSignal()
+                if(!p->preserveStdev)
+                    op.stdevMode = PointwiseOperation::STDEV_CLEAR;
+
+                if(op.isChannelOperation())
+                {
+                    pidx[c] = chids.indexOf(op.operandChannelID);
+                    if(pidx[c] == -1)
+                        return false;
+                }
+                pops[c] = op;
+            }
+
+            // channel operations read the operand from the previous step,
+            // thus the operand channel must not be modified within the same step
+            for(int c = 0; c < noCh; c++)
+                if(pidx[c] != -1 && pidx[c] != c && !pops[pidx[c]].isIdentity())
+                    return false;
+        }
+
+        ops.append(pops);
+        operandIdx.append(pidx);
+    }
+    return true;
+}
+
+
+/**
+ * @brief PointwiseSegment::processMPoints process segment for a range of MPoints
+ * @param mStart index of first MPoint
+ * @param mEnd index of last MPoint
+ * @details resolveOperations() needs to be called before.
+ */
+void PointwiseSegment::processMPoints(int mStart, int mEnd)
+{
+    int noMpts = mrun->sizeAllMpoints();
+
+    if( mStart < 0 || mEnd >= noMpts || mStart > mEnd )
+    {
+        QString msg;
+        msg.sprintf("PointwiseSegment::processMPoints: invalid MPoint range: %d to %d",mStart, mEnd);
+
+        throw LIISimException(msg);
+    }
+
+    PROFILE_ZONE("plugin", profilingName(), mrun->getName());
+
+    for(int m = mStart; m <= mEnd; m++)
+    {
+        if(mrun->cancelRequested())
+            return;
+        processMPoint(m);
+    }
+}
+
+
+void PointwiseSegment::processMPoint(int m)
+{
+    Signal::SType stype = pchain->getSignalType();
+    int noCh = chids.size();
+    int noPlugs = plugins.size();
+    int last = noPlugs - 1;
+
+    ProcessingPlugin* first = plugins.first();
+
+    QVector<int> bufcidx(noCh);
+    for(int c = 0; c < noCh; c++)
+        bufcidx[c] = first->m_chid_to_bufferidx[chids.at(c)];
+
+    // load input signals
+    QVector<Signal> in(noCh);
+    for(int c = 0; c < noCh; c++)
+    {
+        if(prev)
+            in[c] = prev->stepBuffer->signal(m, bufcidx[c]);
+        else
+            in[c] = mrun->getPre(m)->getSignal(chids.at(c), stype);
+    }
+
+    // input did not pass validation: pass signals without data
+    // to all plugins (see ProcessingPlugin::processMPoints())
+    if(!first->validAtPreviousStep(m))
+    {
+        for(int k = 0; k < noPlugs; k++)
+        {
+            for(int c = 0; c < noCh; c++)
+            {
+                Signal so = in[c];
+                so.data.clear();
+                plugins[k]->stepBuffer->setSignal(m, bufcidx[c], so);
+
+                if(isLastInChain && k == last)
+                    setPostSignal(m, c, so);
+            }
+            plugins[k]->p_calculatedMPts++;
+        }
+        return;
+    }
+
+    /*
+     * src[k][c]: index of the plugin which produced the data of
+     * channel c at step k (-1: data is unchanged input data).
+     * Only these data vectors need to be materialized.
+     */
+    QVector<QVector<int>> src(noPlugs, QVector<int>(noCh, -1));
+    QVector<QVector<bool>> materialize(noPlugs, QVector<bool>(noCh, false));
+
+    for(int k = 0; k < noPlugs; k++)
+    {
+        bool store = (k == last || plugins[k]->stepBufferEnabled());
+
+        for(int c = 0; c < noCh; c++)
+        {
+            if(ops[k][c].isIdentity())
+                src[k][c] = (k > 0 ? src[k-1][c] : -1);
+            else
+                src[k][c] = k;
+
+            if(store && src[k][c] > -1)
+                materialize[src[k][c]][c] = true;
+        }
+    }
+
+    QVector<int> n(noCh);
+    int maxN = 0;
+    for(int c = 0; c < noCh; c++)
+    {
+        n[c] = in[c].data.size();
+        maxN = qMax(maxN, n[c]);
+    }
+
+    for(int k = 0; k < noPlugs; k++)
+        for(int c = 0; c < noCh; c++)
+        {
+            int b = operandIdx[k][c];
+            if(b > -1 && n[b] < n[c])
+                throw LIISimException(QString("%0: signal of channel %1 is shorter than signal of channel %2")
+                                      .arg(plugins[k]->getName())
+                                      .arg(chids.at(b))
+                                      .arg(chids.at(c)));
+        }
+
+    // work[c]: data of channel c, at the end of the pass it holds the output of
+    // the last plugin; stored[k][c]: intermediate results for step buffer
+    QVector<QVector<double>> work(noCh);
+    QVector<QVector<QVector<double>>> stored(noPlugs, QVector<QVector<double>>(noCh));
+
+    for(int c = 0; c < noCh; c++)
+    {
+        if(src[last][c] > -1)
+            work[c].resize(n[c]);
+
+        for(int k = 0; k < noPlugs; k++)
+            if(materialize[k][c] && k != src[last][c])
+                stored[k][c].resize(n[c]);
+    }
+
+    for(int t = 0; t < maxN; t += tileSize)
+    {
+        // load tile
+        for(int c = 0; c < noCh; c++)
+        {
+            int len = qMin(tileSize, n[c] - t);
+            if(len > 0 && !work[c].isEmpty())
+                memcpy(work[c].data() + t, in[c].data.constData() + t, len * sizeof(double));
+        }
+
+        // apply all operations to tile
+        for(int k = 0; k < noPlugs; k++)
+        {
+            for(int c = 0; c < noCh; c++)
+            {
+                int len = qMin(tileSize, n[c] - t);
+                if(len <= 0 || ops[k][c].isIdentity())
+                    continue;
+
+                double* x = work[c].data() + t;
+
+                int b = operandIdx[k][c];
+                if(b > -1)
+                {
+                    const double* y = work[b].isEmpty() ? in[b].data.constData() + t
+                                                        : work[b].constData() + t;
+                    ops[k][c].apply(x, y, len);
+                }
+                else
+                    ops[k][c].apply(x, len);
+
+                if(!stored[k][c].isEmpty())
+                    memcpy(stored[k][c].data() + t, x, len * sizeof(double));
+            }
+        }
+    }
+
+    // write results to step buffers
+    QVector<QVector<double>> stdev(noCh);
+    for(int c = 0; c < noCh; c++)
+        stdev[c] = in[c].stdev;
+
+    for(int k = 0; k < noPlugs; k++)
+    {
+        bool store = (k == last || plugins[k]->stepBufferEnabled());
+
+        for(int c = 0; c < noCh; c++)
+        {
+            ops[k][c].applyToStdev(stdev[c]);
+
+            Signal so = in[c];
+            so.stdev = stdev[c];
+
+            int s = src[k][c];
+            if(!store)
+                so.data.clear();
+            else if(s == src[last][c] && s > -1)
+                so.data = work[c];
+            else if(s > -1)
+                so.data = stored[s][c];
+
+            plugins[k]->stepBuffer->setSignal(m, bufcidx[c], so);
+            plugins[k]->p_validations[m]++;
+
+            if(isLastInChain && k == last)
+                setPostSignal(m, c, so);
+        }
+        plugins[k]->p_calculatedMPts++;
+    }
+}
+
+
+/**
+ * @brief PointwiseSegment::setPostSignal stores the result of the last
+ * plugin of the chain (precision of the plugin's step buffer)
+ * @param m MPoint index
+ * @param c channel index
+ * @param s signal
+ */
+void PointwiseSegment::setPostSignal(int m, int c, const Signal &s)
+{
+    if(plugins.last()->stepBuffer->singlePrecision())
+        mrun->getPost(m)->setSignalSingle(s, chids.at(c), pchain->getSignalType());
+    else
+        mrun->getPost(m)->setSignal(s, chids.at(c), pchain->getSignalType());
+}
+
+
+/**
+ * @brief PointwiseSegment::profilingName
+ * @return name of profiling zone (chain positions and names of all plugins)
+ */
+QString PointwiseSegment::profilingName()
+{
+    QStringList names;
+    for(int i = 0; i < plugins.size(); i++)
+        names << plugins[i]->getName();
+
+    return QString("%0 %1-%2: %3")
+            .arg(Signal::stypeToString(pchain->stype))
+            .arg(plugins.first()->positionInChain + 1)
+            .arg(plugins.last()->positionInChain + 1)
+            .arg(names.join(" + "));
+}
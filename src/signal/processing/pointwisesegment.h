@@ -0,0 +1,66 @@
+#ifndef POINTWISESEGMENT_H
+#define POINTWISESEGMENT_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "pointwiseoperation.h"
+#include "../signal.h"
+
+class ProcessingChain;
+class ProcessingPlugin;
+class MRun;
+
+/**
+ * @brief The PointwiseSegment class executes a run of consecutive
+ * pointwise ProcessingPlugins of a ProcessingChain in a single pass.
+ * @ingroup Signal-Processing
+ * @details Instead of a full pass over every Signal for each plugin,
+ * the signals of a MPoint are processed in cache-sized tiles: each tile
+ * is loaded once, all operations of the segment are applied and the tile
+ * is written to the output of the last plugin. Intermediate results are
+ * only stored for plugins with enabled step buffer.
+ * Validation, step buffer and post-signal handling follow
+ * ProcessingPlugin::processMPoints().
+ * Use ProcessingChain::pointwiseSegmentEnd() to find fusable plugin runs.
+ */
+class PointwiseSegment
+{
+public:
+    PointwiseSegment(ProcessingChain *pchain, int first, int last);
+
+    bool resolveOperations();
+    void processMPoints(int mStart, int mEnd);
+
+    /** @brief number of data points processed per tile */
+    static const int tileSize = 1024;
+
+private:
+
+    ProcessingChain* pchain;
+    MRun* mrun;
+
+    /** @brief plugins of this segment (in chain order) */
+    QList<ProcessingPlugin*> plugins;
+
+    /** @brief plugin before this segment (0 if segment starts the chain) */
+    ProcessingPlugin* prev;
+
+    QList<int> chids;
+
+    /** @brief resolved operations [plugin][channel index] */
+    QVector<QVector<PointwiseOperation>> ops;
+
+    /** @brief channel index of operand for channel operations [plugin][channel index] */
+    QVector<QVector<int>> operandIdx;
+
+    bool isLastInChain;
+
+    void processMPoint(int m);
+    void setPostSignal(int m, int c, const Signal &s);
+
+    QString profilingName();
+};
+
+#endif // POINTWISESEGMENT_H
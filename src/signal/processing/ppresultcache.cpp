@@ -0,0 +1,198 @@
+#include "ppresultcache.h"
+
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <cstring>
+
+
+/** @brief default memory budget [B] (see MemUsageMonitor::updateMemInfo()) */
+static const quint64 defaultBudget = quint64(512) * 1024 * 1024;
+
+
+PPResultCache::PPResultCache()
+{
+    m_budget = defaultBudget;
+    m_memoryUsage = 0;
+}
+
+
+PPResultCache* PPResultCache::instance()
+{
+    static PPResultCache cache;
+    return &cache;
+}
+
+
+/**
+ * @brief PPResultCache::hashKey
+ * @param data serialized key data
+ * @return 64 bit key (never 0, 0 is used for unknown results)
+ */
+quint64 PPResultCache::hashKey(const QByteArray &data)
+{
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+    quint64 key = 0;
+    memcpy(&key, hash.constData(), sizeof(key));
+    return key == 0 ? 1 : key;
+}
+
+
+/**
+ * @brief PPResultCache::restore copies a buffered result into the step buffer
+ * of a plugin and marks the result as most recently used
+ * @param plugin
+ * @param key result key (see ProcessingPlugin::resultKey())
+ * @param buffer step buffer of plugin (output)
+ * @param validations validation counters of plugin (output)
+ * @param state additional state of the result (output, see ProcessingPlugin::resultState())
+ * @return true if a result has been found
+ */
+bool PPResultCache::restore(const ProcessingPlugin *plugin, quint64 key,
+                            PPStepBuffer &buffer, QVector<int> &validations,
+                            QSharedPointer<PPResultState> &state)
+{
+    if(key == 0)
+        return false;
+
+    QMutexLocker lock(&m_mutex);
+
+    for(int i = 0; i < m_entries.size(); i++)
+    {
+        if(m_entries.at(i).plugin != plugin || m_entries.at(i).key != key)
+            continue;
+
+        m_entries.move(i, 0);
+
+        buffer.assign(m_entries.first().buffer);
+        validations = m_entries.first().validations;
+        state = m_entries.first().state;
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief PPResultCache::store buffers the current result of a plugin.
+ * The oldest result of the plugin is removed if the plugin already
+ * has maxEntriesPerPlugin results.
+ * @param plugin
+ * @param key result key (see ProcessingPlugin::resultKey())
+ * @param buffer step buffer of plugin
+ * @param validations validation counters of plugin
+ * @param state additional state of the result (may be null)
+ */
+void PPResultCache::store(const ProcessingPlugin *plugin, quint64 key,
+                          const PPStepBuffer &buffer, const QVector<int> &validations,
+                          const QSharedPointer<PPResultState> &state)
+{
+    if(key == 0)
+        return;
+
+    quint64 bytes = buffer.memoryUsage() + validations.size() * sizeof(int);
+    if(state)
+        bytes += state->memoryUsage();
+
+    QMutexLocker lock(&m_mutex);
+
+    int count = 0;
+    for(int i = 0; i < m_entries.size();)
+    {
+        if(m_entries.at(i).plugin == plugin
+                && (m_entries.at(i).key == key || ++count >= maxEntriesPerPlugin))
+        {
+            m_memoryUsage -= m_entries.at(i).bytes;
+            m_entries.removeAt(i);
+        }
+        else
+            i++;
+    }
+
+    if(bytes > m_budget)
+        return;
+
+    Entry entry;
+    entry.plugin = plugin;
+    entry.key = key;
+    entry.buffer.assign(buffer);
+    entry.validations = validations;
+    entry.state = state;
+    entry.bytes = bytes;
+
+    m_entries.prepend(entry);
+    m_memoryUsage += bytes;
+
+    evict();
+}
+
+
+/**
+ * @brief PPResultCache::remove removes all results of a plugin
+ * (called if the plugin is deleted)
+ * @param plugin
+ */
+void PPResultCache::remove(const ProcessingPlugin *plugin)
+{
+    QMutexLocker lock(&m_mutex);
+
+    for(int i = 0; i < m_entries.size();)
+    {
+        if(m_entries.at(i).plugin == plugin)
+        {
+            m_memoryUsage -= m_entries.at(i).bytes;
+            m_entries.removeAt(i);
+        }
+        else
+            i++;
+    }
+}
+
+
+void PPResultCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_entries.clear();
+    m_memoryUsage = 0;
+}
+
+
+quint64 PPResultCache::budget() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_budget;
+}
+
+
+/**
+ * @brief PPResultCache::setBudget sets the memory budget,
+ * least recently used results are removed if necessary
+ * @param bytes [B]
+ */
+void PPResultCache::setBudget(quint64 bytes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_budget = bytes;
+    evict();
+}
+
+
+quint64 PPResultCache::memoryUsage() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_memoryUsage;
+}
+
+
+/**
+ * @brief PPResultCache::evict removes least recently used results
+ * until the memory budget is met (mutex must be locked)
+ */
+void PPResultCache::evict()
+{
+    while(!m_entries.isEmpty() && m_memoryUsage > m_budget)
+    {
+        m_memoryUsage -= m_entries.last().bytes;
+        m_entries.removeLast();
+    }
+}
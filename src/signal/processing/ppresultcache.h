@@ -0,0 +1,98 @@
+#ifndef PPRESULTCACHE_H
+#define PPRESULTCACHE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "ppstepbuffer.h"
+
+class ProcessingPlugin;
+
+
+/**
+ * @brief The PPResultState class is the base class of additional plugin
+ * state which belongs to a buffered result and is kept together with
+ * the step buffer (see ProcessingPlugin::resultState())
+ * @ingroup Signal-Processing
+ */
+class PPResultState
+{
+public:
+    virtual ~PPResultState() {}
+
+    /** @brief estimated memory used by the state [B] */
+    virtual quint64 memoryUsage() const = 0;
+};
+
+/**
+ * @brief The PPResultCache class keeps the step buffer results of
+ * ProcessingPlugins for previously used parameter sets
+ * @ingroup Signal-Processing
+ * @details Results are identified by the plugin and its result key
+ * (see ProcessingPlugin::resultKey()), which is a hash of the plugin's input
+ * (result key of the previous plugin or the data version of the unprocessed
+ * signals) and its parameters. Switching a parameter back to a previous value
+ * restores the buffered result instead of recalculating the plugin and all
+ * plugins after it.
+ * The cache holds at most maxEntriesPerPlugin results per plugin, the least
+ * recently used results are removed if the memory budget is exceeded
+ * (see MemUsageMonitor). The buffered signals are implicitly shared with the
+ * step buffers, a result only needs additional memory if the plugin has been
+ * recalculated with different parameters since.
+ * All methods are thread safe.
+ */
+class PPResultCache
+{
+public:
+    /** @brief max number of results per plugin */
+    static const int maxEntriesPerPlugin = 4;
+
+    static PPResultCache* instance();
+
+    static quint64 hashKey(const QByteArray &data);
+
+    bool restore(const ProcessingPlugin *plugin, quint64 key,
+                 PPStepBuffer &buffer, QVector<int> &validations,
+                 QSharedPointer<PPResultState> &state);
+    void store(const ProcessingPlugin *plugin, quint64 key,
+               const PPStepBuffer &buffer, const QVector<int> &validations,
+               const QSharedPointer<PPResultState> &state);
+
+    void remove(const ProcessingPlugin *plugin);
+    void clear();
+
+    /** @brief memory budget [B] */
+    quint64 budget() const;
+    void setBudget(quint64 bytes);
+
+    /** @brief estimated memory used by all buffered results [B] */
+    quint64 memoryUsage() const;
+
+private:
+    PPResultCache();
+
+    struct Entry
+    {
+        const ProcessingPlugin *plugin;
+        quint64 key;
+        PPStepBuffer buffer;
+        QVector<int> validations;
+        QSharedPointer<PPResultState> state;
+        quint64 bytes;
+    };
+
+    mutable QMutex m_mutex;
+
+    /** @brief buffered results, most recently used first */
+    QList<Entry> m_entries;
+
+    quint64 m_budget;
+    quint64 m_memoryUsage;
+
+    void evict();
+};
+
+#endif // PPRESULTCACHE_H
@@ -2,6 +2,7 @@
 
 PPStepBuffer::PPStepBuffer()
 {
+    m_singlePrecision = false;
 }
 
 PPStepBuffer::~PPStepBuffer()
@@ -9,6 +10,67 @@ PPStepBuffer::~PPStepBuffer()
 }
 
 
+/**
+ * @brief PPStepBuffer::setSinglePrecision switches the storage mode,
+ * all buffered signals are discarded
+ * @param state
+ */
+void PPStepBuffer::setSinglePrecision(bool state)
+{
+    if(m_singlePrecision == state)
+        return;
+
+    m_singlePrecision = state;
+
+    data.resize(boost::extents[0][0]);
+    singleData.resize(boost::extents[0][0]);
+}
+
+
+void PPStepBuffer::resize(int noMpts, int noCh)
+{
+    data.resize(boost::extents[noMpts][noCh]);
+
+    if(m_singlePrecision)
+        singleData.resize(boost::extents[noMpts][noCh]);
+    else
+        singleData.resize(boost::extents[0][0]);
+}
+
+
+/**
+ * @brief PPStepBuffer::signal
+ * @param m MPoint index
+ * @param c buffer channel index
+ * @return buffered signal (double precision)
+ */
+Signal PPStepBuffer::signal(int m, int c) const
+{
+    if(!m_singlePrecision)
+        return data[m][c];
+
+    Signal s = data[m][c];
+    singleData[m][c].decode(s.data);
+    return s;
+}
+
+
+void PPStepBuffer::setSignal(int m, int c, const Signal &s)
+{
+    if(!m_singlePrecision)
+    {
+        data[m][c] = s;
+        return;
+    }
+
+    Signal meta = s;
+    meta.data.clear();
+    data[m][c] = meta;
+
+    CompactSignal::toSingle(s.data, singleData[m][c].values);
+}
+
+
 unsigned long PPStepBuffer::numberOfSignals()
 {
     int n1 = data.shape()[0];
@@ -23,6 +85,47 @@ unsigned long PPStepBuffer::numberOfDataPoints()
     unsigned long sum = 0;
     for(int m = 0; m < n1; m++)
         for(int c = 0; c < n2; c++)
+        {
             sum += data[m][c].data.size();
+            if(m_singlePrecision)
+                sum += singleData[m][c].size();
+        }
+    return sum;
+}
+
+
+/**
+ * @brief PPStepBuffer::memoryUsage
+ * @return size of the buffered signal data [B] (shared data is not considered)
+ */
+quint64 PPStepBuffer::memoryUsage() const
+{
+    int n1 = data.shape()[0];
+    int n2 = data.shape()[1];
+    quint64 sum = 0;
+    for(int m = 0; m < n1; m++)
+        for(int c = 0; c < n2; c++)
+        {
+            sum += quint64(data[m][c].data.size() + data[m][c].stdev.size()) * sizeof(double);
+            if(m_singlePrecision)
+                sum += quint64(singleData[m][c].size()) * sizeof(float);
+        }
     return sum;
 }
+
+
+/**
+ * @brief PPStepBuffer::assign copies storage mode and all signals of
+ * another buffer (signal data is implicitly shared)
+ * @param other
+ */
+void PPStepBuffer::assign(const PPStepBuffer &other)
+{
+    m_singlePrecision = other.m_singlePrecision;
+
+    data.resize(boost::extents[other.data.shape()[0]][other.data.shape()[1]]);
+    data = other.data;
+
+    singleData.resize(boost::extents[other.singleData.shape()[0]][other.singleData.shape()[1]]);
+    singleData = other.singleData;
+}
@@ -3,10 +3,15 @@
 
 #include "boost/multi_array.hpp"
 #include "../signal.h"
+#include "../compactsignal.h"
 
 
 /**
  * @brief The PPStepBuffer class saves intermediate steps into boost::multi_array
+ * @details In single precision mode (see MRun::setSinglePrecision()) the signal
+ * data is stored as float within singleData, data only holds the signal meta data
+ * (dt, start time, standard deviation). Use signal()/setSignal() to access the
+ * buffered signals, plugins always work on double precision signals.
  */
 class PPStepBuffer
 {
@@ -16,10 +21,27 @@ public:
     // Two dimensions: signals, channels
     boost::multi_array<Signal,2> data;
 
+    /** @brief single precision signal data (same shape as data, if singlePrecision()) */
+    boost::multi_array<CompactSignal,2> singleData;
+
     ~PPStepBuffer();
 
+    inline bool singlePrecision() const { return m_singlePrecision; }
+    void setSinglePrecision(bool state);
+
+    void resize(int noMpts, int noCh);
+
+    Signal signal(int m, int c) const;
+    void setSignal(int m, int c, const Signal &s);
+
     unsigned long numberOfSignals();
     unsigned long numberOfDataPoints();
+    quint64 memoryUsage() const;
+
+    void assign(const PPStepBuffer &other);
+
+private:
+    bool m_singlePrecision;
 };
 
 #endif // PPSTEPBUFFER_H
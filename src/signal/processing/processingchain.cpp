@@ -7,9 +7,11 @@
 #include "../../general/LIISimException.h"
 #include <QDebug>
 #include <QMutexLocker>
+#include <QThread>
 #include <QTime>
 #include <QSettings>
 #include <QFile>
+#include <QDataStream>
 #include "pluginfactory.h"
 #include "../../core.h"
 #include "plugins/multisignalaverage.h"
@@ -17,6 +19,7 @@
 #include "plugins/dummyplugin.h"
 #include "processingpluginconnector.h"
 #include "processingplugin.h"
+#include "ppresultcache.h"
 
 /**
  * @brief ProcessingChain::ProcessingChain Constructor
@@ -196,6 +199,28 @@ void ProcessingChain::initializeCalculation()
 }
 
 
+/**
+ * @brief ProcessingChain::applyPendingChanges applies plugin modifications
+ * made during processing (see ProcessingPlugin::applyPendingChanges())
+ */
+void ProcessingChain::applyPendingChanges()
+{
+    for(int i = 0; i < plugs.size(); i++)
+        plugs[i]->applyPendingChanges();
+}
+
+
+/**
+ * @brief ProcessingChain::snapshotParameters takes the parameter snapshot of all
+ * plugins when processing is scheduled (see ProcessingPlugin::snapshotParameters())
+ */
+void ProcessingChain::snapshotParameters()
+{
+    for(int i = 0; i < plugs.size(); i++)
+        plugs[i]->snapshotParameters();
+}
+
+
 /**
  * @brief ProcessingChain::addPlug register a ProcessingPlugin to this chain
  * @param p ProcessingPlugin
@@ -210,7 +235,8 @@ void ProcessingChain::addPlug(ProcessingPlugin *p)
     int noPlugs =plugs.size();
     p->positionInChain = noPlugs-1;
 
-    connect(p, SIGNAL(dataChanged(int,QVariant)), SLOT(onPluginDataChanged(int,QVariant)));
+    // direct connection: modifications are distinguished from ProcessingTask updates by thread
+    connect(p, SIGNAL(dataChanged(int,QVariant)), SLOT(onPluginDataChanged(int,QVariant)), Qt::DirectConnection);
 
 
     // all plugins need to be recalculated if we resize the step data !!!
@@ -310,6 +336,150 @@ Signal ProcessingChain::getStepSignalPre(int mpIdx, int chID , int stepIdx)
 }
 
 
+/**
+ * @brief ProcessingChain::sourceKey identifies the input of the chain
+ * (unprocessed signals), used as input key of the first plugin
+ * (see ProcessingPlugin::resultKey())
+ * @return hash of the data versions of all unprocessed MPoints
+ */
+quint64 ProcessingChain::sourceKey()
+{
+    QByteArray keyData;
+    QDataStream stream(&keyData, QIODevice::WriteOnly);
+
+    int noMpts = m_mrun->sizeAllMpoints();
+    stream << qint32(stype) << qint32(noMpts);
+    for(int i = 0; i < noMpts; i++)
+        stream << m_mrun->getPre(i)->version();
+
+    return PPResultCache::hashKey(keyData);
+}
+
+
+/**
+ * @brief ProcessingChain::resultKey identifies the output of the chain
+ * @return result key of the last plugin, source key for empty chains or
+ * 0 if the output is unknown (or the step buffer of the last plugin
+ * is not available)
+ */
+quint64 ProcessingChain::resultKey()
+{
+    if(plugs.isEmpty())
+        return sourceKey();
+
+    ProcessingPlugin* last = plugs.last();
+    if(!last->stepBufferEnabled())
+        return 0;
+
+    return last->resultKey();
+}
+
+
+/**
+ * @brief ProcessingChain::pointwiseSegmentEnd finds a run of consecutive
+ * plugins starting at given position, which can be processed in a
+ * single pass (see PointwiseSegment).
+ * @param start index of first plugin
+ * @return index of last plugin of the run or -1 if the run contains less than
+ * two active pointwise plugins
+ * @details Inactive plugins are passed through. Plugins at or after an active
+ * MultiSignalAverage are never fused (initializeCalculation() needs to be called before).
+ */
+int ProcessingChain::pointwiseSegmentEnd(int start)
+{
+    QList<int> chids = m_mrun->channelIDs(stype);
+    int end = -1;
+    int activeCount = 0;
+
+    for(int i = start; i < plugs.size(); i++)
+    {
+        if(m_msaPosition > -1 && i >= m_msaPosition)
+            break;
+
+        ProcessingPlugin* p = plugs.at(i);
+
+        if(p->activated())
+        {
+            PointwiseOperation op;
+            bool pointwise = !chids.isEmpty();
+            for(int c = 0; c < chids.size() && pointwise; c++)
+                pointwise = p->pointwiseOperation(chids.at(c), op);
+
+            if(!pointwise)
+                break;
+
+            activeCount++;
+        }
+        end = i;
+    }
+
+    if(activeCount < 2)
+        return -1;
+
+    return end;
+}
+
+
+/**
+ * @brief ProcessingChain::previewMPoint recalculates a single MPoint,
+ * starting at the first dirty plugin.
+ * @param mpIdx index of MPoint
+ * @param fromStart recalculate all plugins (input signals have changed)
+ * @return see PreviewResult
+ * @details The step buffer entry of the previous plugin is used as input, if
+ * the plugin does not keep its step buffer, the calculation starts at the
+ * last plugin with available buffer. Plugins stay dirty, the results are only
+ * valid until the next full calculation of the run (see ProcessingTask).
+ * Chains with active MultiSignalAverage cannot be previewed.
+ */
+ProcessingChain::PreviewResult ProcessingChain::previewMPoint(int mpIdx, bool fromStart)
+{
+    m_msaPosition = this->indexOfPlugin(MultiSignalAverage::pluginName);
+    if(m_msaPosition > -1)
+        return PREVIEW_UNAVAILABLE;
+
+    if(mpIdx < 0 || mpIdx >= m_mrun->sizeAllMpoints())
+        return PREVIEW_UNAVAILABLE;
+
+    // empty chain: copy pre to post
+    if(plugs.isEmpty())
+    {
+        if(!fromStart)
+            return PREVIEW_NONE;
+
+        QList<int> chIDs = m_mrun->channelIDs(stype);
+        MPoint* mpre = m_mrun->getPre(mpIdx);
+        MPoint* mpost = m_mrun->getPost(mpIdx);
+        for(int j = 0; j < chIDs.size(); j++)
+            mpost->setSignal(mpre->getSignal(chIDs[j], stype), chIDs[j], stype);
+
+        return PREVIEW_PROCESSED;
+    }
+
+    int start = 0;
+    if(!fromStart)
+    {
+        while(start < plugs.size() && !plugs.at(start)->dirty())
+            start++;
+
+        if(start == plugs.size())
+            return PREVIEW_NONE;
+    }
+
+    while(start > 0 && !plugs.at(start-1)->stepBufferAvailable())
+        start--;
+
+    for(int p = start; p < plugs.size(); p++)
+    {
+        plugs[p]->initializeMPoint(mpIdx);
+        plugs[p]->prepareMPoints(mpIdx, mpIdx);
+        plugs[p]->processMPoints(mpIdx, mpIdx);
+    }
+
+    return PREVIEW_PROCESSED;
+}
+
+
 /**
  * @brief ProcessingChain::isValid check if a measurement point has passed validation for this chain
  * @param mpIdx index in MPoint data list
@@ -647,6 +817,10 @@ void ProcessingChain::onPluginDataChanged(int pos = -1, QVariant value = 0)
     if((pos == 2 && value.toBool()) || (pos == 1))
     {
         emit pluginGoneDirty();
+
+        // plugins are reset within the ProcessingTask's thread
+        if(QThread::currentThread() == thread())
+            emit pluginModified();
     }
 }
 
@@ -44,6 +44,17 @@ protected:
 
 public:
 
+    /** @brief result of previewMPoint() */
+    enum PreviewResult
+    {
+        /** @brief no plugin had to be recalculated */
+        PREVIEW_NONE,
+        /** @brief the post signal of the MPoint has been updated */
+        PREVIEW_PROCESSED,
+        /** @brief the MPoint cannot be processed on its own (MultiSignalAverage) */
+        PREVIEW_UNAVAILABLE
+    };
+
     /** @brief filename used to save filename if processing chain is loaded*/
     QString filename;
 
@@ -70,8 +81,14 @@ public:
 
     // processing/calculation
     void initializeCalculation();
+    void applyPendingChanges();
+    void snapshotParameters();
 
     Signal getStepSignalPre(int mpIdx, int chID, int stepIdx);
+    quint64 sourceKey();
+    quint64 resultKey();
+    int pointwiseSegmentEnd(int start);
+    PreviewResult previewMPoint(int mpIdx, bool fromStart);
 
     bool isValid(int mpIdx);
     bool isValidAtStep(int mpIdx, int step);
@@ -97,6 +114,9 @@ private slots:
 signals:
     void pluginGoneDirty();
 
+    /** @brief pluginModified emitted if a plugin has been changed outside of processing (parameters, activation) */
+    void pluginModified();
+
 };
 
 #endif // PROCESSINGCHAIN_H
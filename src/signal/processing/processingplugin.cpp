@@ -9,6 +9,10 @@
 #include "plugins/temperaturecalculator.h"
 #include "pluginfactory.h"
 #include "ppstepbuffer.h"
+#include "ppresultcache.h"
+#include "../../general/profiling.h"
+
+#include <QDataStream>
 
 /**
  * @brief ProcessingPlugin::ProcessingPlugin Constructor
@@ -38,6 +42,9 @@ ProcessingPlugin::ProcessingPlugin(ProcessingChain *parentChain)
     }
     p_validations.fill(0, mrun->sizeAllMpoints());
     p_calculatedMPts = 0;
+    m_resultKey = 0;
+    m_hasPendingInputs = false;
+    m_pendingActivation = -1;
 
     m_data.append(metaObject()->className());
     m_data.append(m_activated);
@@ -54,6 +61,7 @@ ProcessingPlugin::ProcessingPlugin(ProcessingChain *parentChain)
 
 ProcessingPlugin::~ProcessingPlugin()
 {
+    PPResultCache::instance()->remove(this);
     delete stepBuffer;
 }
 
@@ -180,6 +188,15 @@ void ProcessingPlugin::setParameters(const ProcessingPluginInputList &newInputs)
 
     }
 
+    // the inputs are read by the ProcessingTask's thread
+    if(mrun->isBusy())
+    {
+        m_pendingInputs = newInputsCorrected;
+        m_hasPendingInputs = true;
+        queueChange();
+        return;
+    }
+
     // assign inputs
     this->inputs = newInputsCorrected;
 
@@ -218,7 +235,7 @@ void ProcessingPlugin::cleanupStepBuffer()
             stepBuffer->data[m][c].data.clear();
 
    // stepBuffer->data.resize(boost::extents[mrun->sizeAllMpoints()][channelCount()]);
-    stepBuffer->data.resize(boost::extents[0][0]);
+    stepBuffer->resize(0, 0);
 
    // delete stepBuffer;
   //  stepBuffer = new PPStepBuffer;
@@ -227,10 +244,13 @@ void ProcessingPlugin::cleanupStepBuffer()
 
 void ProcessingPlugin::initializeCalculation()
 {
+    // temperature chains are always calculated in double precision
+    stepBuffer->setSinglePrecision(stype != Signal::TEMPERATURE && mrun->singlePrecision());
+
     if((stepBuffer->data.shape()[0] != mrun->sizeAllMpoints()) ||
         stepBuffer->data.shape()[1] != channelCount())
     {
-        stepBuffer->data.resize(boost::extents[mrun->sizeAllMpoints()][channelCount()]);
+        stepBuffer->resize(mrun->sizeAllMpoints(), channelCount());
         p_validations.resize(mrun->sizeAllMpoints());
 
         m_chid_to_bufferidx.clear();
@@ -255,6 +275,43 @@ void ProcessingPlugin::initializeCalculation()
 }
 
 
+/**
+ * @brief ProcessingPlugin::initializeMPoint prepares the recalculation
+ * of a single MPoint (see ProcessingChain::previewMPoint()).
+ * The results of all other MPoints are kept.
+ * @param mPoint index of MPoint
+ */
+void ProcessingPlugin::initializeMPoint(int mPoint)
+{
+    if(stepBuffer->data.shape()[0] != mrun->sizeAllMpoints()
+            || stepBuffer->data.shape()[1] != channelCount()
+            || p_validations.size() != mrun->sizeAllMpoints()
+            || stepBuffer->singlePrecision() != (stype != Signal::TEMPERATURE && mrun->singlePrecision()))
+        initializeCalculation();
+
+    if(mPoint >= 0 && mPoint < p_validations.size())
+        p_validations[mPoint] = 0;
+
+    // step buffer is modified, result does not belong to any key
+    m_resultKey = 0;
+}
+
+
+/**
+ * @brief ProcessingPlugin::stepBufferAvailable
+ * @return true if the step buffer holds the results of the last calculation
+ * (buffer is enabled and matches the current size of the run)
+ */
+bool ProcessingPlugin::stepBufferAvailable()
+{
+    return stepBufferFlag
+            && stepBuffer->data.shape()[0] == mrun->sizeAllMpoints()
+            && stepBuffer->data.shape()[1] == channelCount()
+            && p_validations.size() == mrun->sizeAllMpoints()
+            && stepBuffer->singlePrecision() == (stype != Signal::TEMPERATURE && mrun->singlePrecision());
+}
+
+
 bool ProcessingPlugin::processSignal(const Signal & in, Signal & out, int mpIdx)
 {
     bool ret = processSignalImplementation(in, out, mpIdx);
@@ -287,7 +344,8 @@ void ProcessingPlugin::setActivated(bool activated)
 {
     if(mrun->isBusy())
     {
-        qDebug() << "ProcessingPlugin::setActivated: cannot change state during calculation";
+        m_pendingActivation = activated ? 1 : 0;
+        queueChange();
         return;
     }
     if(m_activated == activated)
@@ -314,6 +372,42 @@ void ProcessingPlugin::setActivated(bool activated)
 }
 
 
+/**
+ * @brief ProcessingPlugin::queueChange is called if the plugin is modified while
+ * the run is processed. The change is applied after processing (see applyPendingChanges()),
+ * pluginModified() notifies the SignalManager to cancel an outdated background processing.
+ */
+void ProcessingPlugin::queueChange()
+{
+    if(m_pchain)
+        emit m_pchain->pluginModified();
+}
+
+
+/**
+ * @brief ProcessingPlugin::applyPendingChanges applies parameters and activation
+ * state which have been modified during processing (see MRun::setBusy())
+ */
+void ProcessingPlugin::applyPendingChanges()
+{
+    if(mrun->isBusy())
+        return;
+
+    if(m_hasPendingInputs)
+    {
+        m_hasPendingInputs = false;
+        setParameters(m_pendingInputs);
+    }
+
+    if(m_pendingActivation > -1)
+    {
+        bool state = (m_pendingActivation == 1);
+        m_pendingActivation = -1;
+        setActivated(state);
+    }
+}
+
+
 /**
  * @brief ProcessingPlugin::setDirty sets the parameters of this plugin dirty.
  * This ensures that the signal data of this plugin is recalculated during next
@@ -432,7 +526,7 @@ Signal ProcessingPlugin::processedSignal(int mPoint, int channelID)
 
     //boost::multi_array<Signal,2>::index mMax = p_stepBuffer.index_bases()[0]+ p_stepBuffer.shape();
 
-    return stepBuffer->data[mPoint][m_chid_to_bufferidx[channelID]];
+    return stepBuffer->signal(mPoint, m_chid_to_bufferidx[channelID]);
 }
 
 
@@ -480,8 +574,212 @@ bool ProcessingPlugin::validAtPreviousStep(int mPoint)
 }
 
 
+/**
+ * @brief ProcessingPlugin::prepareMPoints prepares the processing of a range
+ * of MPoints (see prepareProcessing()). Must be called once after the previous
+ * step has been calculated and before processMPoints() is called for this range.
+ * @param mStart index of first MPoint
+ * @param mEnd index of last MPoint
+ */
+void ProcessingPlugin::prepareMPoints(int mStart, int mEnd)
+{
+    if(!m_activated)
+        return;
+
+    if(mStart < 0 || mEnd >= mrun->sizeAllMpoints() || mStart > mEnd)
+        return;
+
+    prepareProcessing(mStart, mEnd);
+}
+
+
+/**
+ * @brief ProcessingPlugin::processAllMPoints calculates all MPoints of the run
+ * (see ProcessingTask::processChain()). If the plugin has already been calculated
+ * with the same input and parameters, the buffered result is restored
+ * instead (see PPResultCache).
+ */
+void ProcessingPlugin::processAllMPoints()
+{
+    int noMpts = mrun->sizeAllMpoints();
+    if(noMpts == 0)
+        return;
+
+    quint64 key = calculateResultKey();
+
+    QSharedPointer<PPResultState> state;
+    if(PPResultCache::instance()->restore(this, key, *stepBuffer, p_validations, state))
+    {
+        restoreResult();
+        restoreResultState(state);
+        m_resultKey = key;
+        return;
+    }
+
+    prepareMPoints(0, noMpts - 1);
+    processMPoints(0, noMpts - 1);
+
+    // results of stopped calculations are incomplete
+    if(mrun->cancelRequested())
+    {
+        m_resultKey = 0;
+        return;
+    }
+
+    m_resultKey = key;
+
+    // plugins without step buffer release their data after calculation
+    if(stepBufferFlag)
+        PPResultCache::instance()->store(this, key, *stepBuffer, p_validations, resultState());
+}
+
+
+/**
+ * @brief ProcessingPlugin::updateResultKey assigns the key of the current
+ * input and parameters to the step buffer content. Must be called if the
+ * step buffer has been calculated outside of processAllMPoints() (see PointwiseSegment).
+ */
+void ProcessingPlugin::updateResultKey()
+{
+    if(mrun->cancelRequested())
+        m_resultKey = 0;
+    else
+        m_resultKey = calculateResultKey();
+}
+
+
+/**
+ * @brief ProcessingPlugin::snapshotParameters serializes the state and inputs
+ * of the plugin for the result key (see calculateResultKey()). Called within
+ * the GUI thread when processing is scheduled (see ProcessingTask), the
+ * calculation does not read the inputs, which may be edited meanwhile.
+ */
+void ProcessingPlugin::snapshotParameters()
+{
+    m_parameterKeyData.clear();
+    QDataStream stream(&m_parameterKeyData, QIODevice::WriteOnly);
+
+    stream << getName() << m_activated;
+
+    for(int i = 0; i < inputs.size(); i++)
+    {
+        const ProcessingPluginInput &input = inputs.at(i);
+        stream << input.identifier;
+
+        // only the selection of comboboxes, options might change
+        if(input.type == ProcessingPluginInput::COMBOBOX)
+            stream << input.value.toString().split(";").first();
+        else
+            stream << input.value << input.checkboxGroupValues;
+    }
+}
+
+
+/**
+ * @brief ProcessingPlugin::calculateResultKey
+ * @return hash of the input key (result key of previous plugin or source key of
+ * the chain), the state and inputs of this plugin at scheduling time
+ * (see snapshotParameters()) and additional dependencies
+ * (see resultKeyData()) or 0 if the result cannot be identified
+ */
+quint64 ProcessingPlugin::calculateResultKey()
+{
+    ProcessingPlugin* prev = m_pchain->getPlug(positionInChain-1);
+    quint64 inputKey = prev ? prev->resultKey() : m_pchain->sourceKey();
+
+    // no snapshot: plugin has not been scheduled for processing
+    if(inputKey == 0 || m_parameterKeyData.isEmpty())
+        return 0;
+
+    bool msaMode = (m_pchain->msaPosition() > -1 && positionInChain >= m_pchain->msaPosition());
+
+    QByteArray keyData;
+    QDataStream stream(&keyData, QIODevice::WriteOnly);
+
+    stream << inputKey << msaMode
+           << (stype != Signal::TEMPERATURE && mrun->singlePrecision())
+           << qint32(mrun->sizeAllMpoints()) << mrun->channelIDs(stype)
+           << m_parameterKeyData;
+
+    if(m_activated && !resultKeyData(stream))
+        return 0;
+
+    return PPResultCache::hashKey(keyData);
+}
+
+
+/**
+ * @brief ProcessingPlugin::writeLIISettingsKey writes the LIISettings and filter
+ * of the run to the key data (see resultKeyData())
+ * @param stream key data
+ */
+void ProcessingPlugin::writeLIISettingsKey(QDataStream &stream)
+{
+    LIISettings settings = mrun->liiSettings();
+
+    stream << settings.laser_wavelength << qint32(settings.channels.size());
+    for(int i = 0; i < settings.channels.size(); i++)
+    {
+        const Channel &ch = settings.channels.at(i);
+        stream << qint32(ch.wavelength) << qint32(ch.bandwidth)
+               << ch.calibration << ch.offset << ch.pmt_gain
+               << ch.pmt_gain_formula_A << ch.pmt_gain_formula_B;
+    }
+
+    stream << qint32(settings.filters.size());
+    for(int i = 0; i < settings.filters.size(); i++)
+    {
+        const Filter &filter = settings.filters.at(i);
+        stream << filter.identifier;
+        for(auto it = filter.list.begin(); it != filter.list.end(); ++it)
+            stream << qint32(it->first) << it->second;
+    }
+
+    stream << mrun->filterIdentifier();
+}
+
+
+/**
+ * @brief ProcessingPlugin::restoreResult writes the post signals of the run
+ * after a buffered result has been restored (last plugin of chain)
+ */
+void ProcessingPlugin::restoreResult()
+{
+    p_calculatedMPts = mrun->sizeAllMpoints();
+
+    if(positionInChain != m_pchain->noPlugs() - 1)
+        return;
+
+    QList<int> chids = mrun->channelIDs(stype);
+    int noCh = channelCount();
+
+    // msa: only the first MPoint is calculated, see ProcessingTask::processChain()
+    bool msaMode = (m_pchain->msaPosition() > -1 && positionInChain >= m_pchain->msaPosition());
+    int mEnd = msaMode ? 0 : mrun->sizeAllMpoints() - 1;
+
+    for(int m = 0; m <= mEnd; m++)
+    {
+        MPoint * mpost = mrun->getPost(m);
+        bool valid = (p_validations.value(m, 0) == noCh);
+
+        for(int c = 0; c < chids.size(); c++)
+        {
+            Signal so = stepBuffer->signal(m, m_chid_to_bufferidx[chids[c]]);
+
+            if(valid && stepBuffer->singlePrecision())
+                mpost->setSignalSingle( so, chids[c], stype );
+            else
+                mpost->setSignal( so, chids[c], stype );
+        }
+    }
+}
+
+
 void ProcessingPlugin::processMPoints(int mStart, int mEnd)
 {
+    PROFILE_ZONE("plugin",
+                 QString("%0 %1: %2").arg(Signal::stypeToString(stype)).arg(positionInChain + 1).arg(getName()),
+                 mrun->getName());
 
    /* QList<QVariant> procUpdate0;
     procUpdate0 << 0;
@@ -548,6 +846,13 @@ void ProcessingPlugin::processMPoints(int mStart, int mEnd)
         // process mPoints
         for(int m = mStart; m <= newEnd; m++)
         {
+            // processing task has been stopped, the results are discarded anyway
+            if(mrun->cancelRequested())
+            {
+                newEnd = m - 1;
+                break;
+            }
+
            /* QList<QVariant> procUpdate1;
             procUpdate1 << 1;
             procUpdate1 << (int)this->thread();
@@ -568,7 +873,7 @@ void ProcessingPlugin::processMPoints(int mStart, int mEnd)
 
                 if(prev)
                 {
-                    si = prev->stepBuffer->data[m][bufcidx];
+                    si = prev->stepBuffer->signal(m, bufcidx);
                 }
                 else
                 {
@@ -602,13 +907,16 @@ void ProcessingPlugin::processMPoints(int mStart, int mEnd)
                 // squeeze QVector to release unused memory
                 so.data.squeeze();
 
-                stepBuffer->data[m][bufcidx] = so;
+                stepBuffer->setSignal(m, bufcidx, so);
                 p_validations[m] += res;
 
                 if(positionInChain == m_pchain->noPlugs() - 1)
                 {
                     MPoint * mpost = mrun->getPost(m);
-                    mpost->setSignal( so, chids[c], stype );
+                    if(stepBuffer->singlePrecision())
+                        mpost->setSignalSingle( so, chids[c], stype );
+                    else
+                        mpost->setSignal( so, chids[c], stype );
                 }
 
                 if(msaMode)
@@ -627,7 +935,7 @@ void ProcessingPlugin::processMPoints(int mStart, int mEnd)
                     bufcidx = m_chid_to_bufferidx[chids[c]];
                     Signal so = stepBuffer->data[m][bufcidx];
                     so.data.clear();
-                    stepBuffer->data[m][bufcidx] = so;
+                    stepBuffer->setSignal(m, bufcidx, so);
 
                     if(positionInChain == m_pchain->noPlugs() - 1)
                     {
@@ -6,13 +6,17 @@
 #include "../../models/dataitem.h"
 #include "../signal.h"
 #include "processingplugininputlist.h"
+#include "pointwiseoperation.h"
 #include <QMutex>
+#include <QSharedPointer>
 
 class MRun;
 class ProcessingChain;
 class ProcessingPluginConnector;
 class Core;
 class PPStepBuffer;
+class PPResultState;
+class QDataStream;
 
 /**
  * @brief Abstract Baseclass for ProcessingPlugins
@@ -36,6 +40,7 @@ class ProcessingPlugin : public DataItem
 {
     Q_OBJECT
 friend class ProcessingPluginConnector;
+friend class PointwiseSegment;
 public:
 
     explicit ProcessingPlugin(ProcessingChain* parentChain);
@@ -79,7 +84,28 @@ public:
     virtual bool processSignalImplementation(const Signal & in, Signal & out, int mpIdx) = 0;
     virtual void reset();
 
+    void prepareMPoints(int mStart, int mEnd);
     virtual void processMPoints(int mStart, int mEnd);
+    void processAllMPoints();
+
+    /**
+     * @brief resultKey identifies the current content of the step buffer
+     * (see calculateResultKey(), PPResultCache)
+     * @return key of last calculation or 0 if the result is unknown
+     */
+    inline quint64 resultKey() const { return m_resultKey; }
+    void updateResultKey();
+
+    /**
+     * @brief pointwiseOperation describes the processing of channel chID as
+     * elementwise operation. This allows the ProcessingChain to fuse consecutive
+     * pointwise plugins into a single pass (see PointwiseSegment).
+     * Reimplement this method for plugins which only depend on the current sample.
+     * @param chID channel id
+     * @param op operation (output)
+     * @return false (default) if the plugin cannot be described as pointwise operation
+     */
+    virtual bool pointwiseOperation(int chID, PointwiseOperation & op){ return false; }
 
     /**
      * @brief getParameterPreview
@@ -96,6 +122,9 @@ public:
     inline bool dirty(){return m_dirty;}
     void setDirty(bool dirty);
 
+    void applyPendingChanges();
+    void snapshotParameters();
+
     void setStepBufferEnabled(bool state);
     bool stepBufferEnabled(){return stepBufferFlag;}
 
@@ -110,6 +139,8 @@ public:
     bool validAtPreviousStep(int mPoint);
 
     void initializeCalculation();
+    void initializeMPoint(int mPoint);
+    bool stepBufferAvailable();
     virtual void onAddedToPchain(){}
 
 
@@ -142,6 +173,45 @@ protected:
      */
     virtual void setFromInputs() = 0;
 
+    /**
+     * @brief prepareProcessing Derived classes which depend on more than the
+     * processed signal (offsets from all signals, average signals, ...) should
+     * reimplement this method to calculate their state once per run
+     * (see prepareMPoints()). processSignalImplementation() then only reads
+     * this state and can be executed concurrently for different MPoints.
+     * @param mStart index of first MPoint which will be processed
+     * @param mEnd index of last MPoint which will be processed
+     */
+    virtual void prepareProcessing(int mStart, int mEnd){}
+
+    /**
+     * @brief resultKeyData Derived classes which depend on more than the
+     * previous step and the plugin inputs (LIISettings, other processing chains, ...)
+     * should reimplement this method and write these dependencies to the stream
+     * (see calculateResultKey()).
+     * @param stream key data
+     * @return false if the result cannot be identified (result is never buffered)
+     */
+    virtual bool resultKeyData(QDataStream &stream){ return true; }
+
+    /**
+     * @brief resultState Derived classes which store results outside of the
+     * step buffer (eg. fit histories) should reimplement this method and
+     * restoreResultState(), the state is buffered together with the step buffer
+     * (see PPResultCache). Called after all MPoints have been processed.
+     * @return state of current result (null: no additional state)
+     */
+    virtual QSharedPointer<PPResultState> resultState(){ return QSharedPointer<PPResultState>(); }
+
+    /**
+     * @brief restoreResultState restores the state of a buffered result
+     * (see resultState())
+     * @param state buffered state (may be null)
+     */
+    virtual void restoreResultState(const QSharedPointer<PPResultState> &state){}
+
+    void writeLIISettingsKey(QDataStream &stream);
+
     /** @brief holds a short description about the plugins
      * (detailed plugindescription should be done in external file!)
      */
@@ -206,6 +276,25 @@ private:
     /** @brief maps channel-id to step buffer index */
     QMap<int,int> m_chid_to_bufferidx;
 
+    /** @brief key of the current step buffer content (see resultKey()) */
+    quint64 m_resultKey;
+
+    /** @brief parameters set during processing (see applyPendingChanges()) */
+    ProcessingPluginInputList m_pendingInputs;
+    bool m_hasPendingInputs;
+
+    /** @brief activation state set during processing (-1: unchanged) */
+    int m_pendingActivation;
+
+    /** @brief state and inputs serialized when processing has been scheduled
+     * (see snapshotParameters(), calculateResultKey()) */
+    QByteArray m_parameterKeyData;
+
+    void queueChange();
+
+    quint64 calculateResultKey();
+    void restoreResult();
+
 
 signals:
 
@@ -53,6 +53,10 @@ public:
     /** @brief holds current value of ProcessingPluginInput */
     QVariant value;
 
+    /** @brief value used if the input is missing in sessions/processing chains saved
+     * before the input has been added (invalid: current value is kept) */
+    QVariant legacyValue;
+
     /** @brief limits true if field has limits*/
     bool limits;
 
@@ -1,12 +1,13 @@
 #include "processingtask.h"
 #include "processingchain.h"
+#include "pointwisesegment.h"
 
 #include <QtConcurrent/qtconcurrentrun.h>
 #include <QMutexLocker>
 #include <QThread>
-#include <QtConcurrent/qtconcurrentrun.h>
 
 #include "plugins/multisignalaverage.h"
+#include "../../general/profiling.h"
 
 // initialize static id counter
 unsigned long ProcessingTask::id_count = 0;
@@ -33,9 +34,12 @@ ProcessingTask::ProcessingTask(MRun *mrun, Signal::SType start_signal_type, QObj
     this->noMpoints = mrun->sizeAllMpoints();
     this->startStype = start_signal_type;
     threadShouldStop = false;
+    mrun->clearCancelRequest();
 
     // change the MRun's busy state (to avoid further mrun access during calculation!)
     mrun->setBusy(true);
+
+    snapshotParameters();
 }
 
 
@@ -50,9 +54,29 @@ ProcessingTask::ProcessingTask(MRun* mrun, QList<Signal::SType> typeList, QObjec
     this->startStype = Signal::RAW;
     this->processTypes = typeList;
     threadShouldStop = false;
+    mrun->clearCancelRequest();
 
     // change the MRun's busy state (to avoid further mrun access during calculation!)
     mrun->setBusy(true);
+
+    snapshotParameters();
+}
+
+
+/**
+ * @brief ProcessingTask::snapshotParameters takes the parameter snapshot of all
+ * processing chains within the GUI thread (result keys, see PPResultCache)
+ */
+void ProcessingTask::snapshotParameters()
+{
+    QList<Signal::SType> stypes;
+    stypes << Signal::RAW << Signal::ABS << Signal::TEMPERATURE;
+    for(Signal::SType stype : stypes)
+    {
+        ProcessingChain* pchain = mrun->getProcessingChain(stype);
+        if(pchain)
+            pchain->snapshotParameters();
+    }
 }
 
 
@@ -71,6 +95,8 @@ void ProcessingTask::resetIdCounter()
  */
 void ProcessingTask::run()
 {
+    PROFILE_ZONE("task", "ProcessingTask", mrun->getName());
+
     if(processTypes.isEmpty())
     {
         // process all chains in order, starting at start signal point
@@ -125,6 +151,8 @@ void ProcessingTask::processChain(Signal::SType stype)
     if(!pchain)
         return;
 
+    PROFILE_ZONE("chain", Signal::stypeToString(stype) + " chain", mrun->getName());
+
     QList<int> chIDs = mrun->channelIDs(pchain->stype);
 
     pchain->initializeCalculation();
@@ -147,36 +175,56 @@ void ProcessingTask::processChain(Signal::SType stype)
         }
         else
         {
-            for(int p = 0; p < noPlugs; p++)
+            int p = 0;
+            while(p < noPlugs)
             {
                 //FIXME: invalidate MRun?
-                if(threadShouldStop)
+                if(threadShouldStop || mrun->cancelRequested())
                 {
                     mrun->calculationStatus()->setCancelled();
                     return;
                 }
 
+                // process consecutive pointwise plugins in a single pass
+                int segmentEnd = pchain->pointwiseSegmentEnd(p);
+                if(segmentEnd > p)
+                {
+                    PointwiseSegment segment(pchain, p, segmentEnd);
+                    if(segment.resolveOperations())
+                    {
+                        segment.processMPoints(0, noMpoints - 1);
+                        for(; p <= segmentEnd; p++)
+                            pchain->getPlug(p)->updateResultKey();
+                        continue;
+                    }
+                }
+
+                // restores the buffered result if the plugin has
+                // already been calculated with the same input/parameters
                 ProcessingPlugin* plugin = pchain->getPlug(p);
-                plugin->processMPoints(0, noMpoints - 1);
+                plugin->processAllMPoints();
               //  if(!plugin->stepBufferEnabled())
               //      plugin->cleanupStepBuffer();
+                p++;
+            }
+
+            // the last plugin might have been stopped
+            if(threadShouldStop || mrun->cancelRequested())
+            {
+                mrun->calculationStatus()->setCancelled();
+                return;
             }
 
             // msa: write pchain output to all post signals
+            // (shares the stored data, single precision results are not expanded)
             if(pchain->msaPosition() > -1 && noMpoints > 0)
             {
+                MPoint * msa = mrun->getPost(0);
+
                 for(int j = 0; j < chIDs.size(); j++)
                 {
-
-                    MPoint * mpost = mrun->getPost(0);
-                    Signal msa = mpost->getSignal(chIDs[j], pchain->stype);
-                   // Signal msa = pchain->getPlug(pchain->noPlugs()-1)->processedSignal(0,chIDs[j]);
-
                     for(int i  = 1; i < noMpoints; i++)
-                    {
-                            mpost = mrun->getPost(i);
-                            mpost->setSignal(msa, chIDs[j], pchain->stype);
-                    }
+                        mrun->getPost(i)->copySignal(msa, chIDs[j], pchain->stype);
                 }
             }
 
@@ -198,8 +246,13 @@ void ProcessingTask::processChain(Signal::SType stype)
 }
 
 
+/**
+ * @brief ProcessingTask::stopTask stops the calculation. The currently
+ * running plugin returns after the current MPoint.
+ */
 void ProcessingTask::stopTask()
 {
     threadShouldStop = true;
+    mrun->requestCancel();
 }
 
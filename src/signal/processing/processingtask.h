@@ -10,7 +10,8 @@
 
 /**
  * @brief The ProcessingTask class is responsible for calculating all ProcessingChains
- * of a MRun Object. It is started in the global Threadpool by the SignalManager.
+ * of a MRun Object. It is started by the SignalManager (TaskScheduler lanes
+ * INTERACTIVE for the displayed run, PROCESSING for all other runs).
  * @ingroup Signal-Processing
  */
 class ProcessingTask : public QObject, public QRunnable
@@ -37,6 +38,7 @@ private:
     void run();
 
     void processChain(Signal::SType stype);
+    void snapshotParameters();
 
     /// @brief counter used for ID generation
     static unsigned long id_count;
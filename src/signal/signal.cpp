@@ -106,7 +106,7 @@ double Signal::maxTime() const
  * If the requested time is inbetween two samples the signal
  * value is interpolated linearly.
  */
-double Signal::at(double time)
+double Signal::at(double time) const
 {
     // check if out of range
     if(time < start_time || time > maxTime() )
@@ -114,32 +114,28 @@ double Signal::at(double time)
         return 0.0;
     }
 
-    // calculate double index and floor index
+    const int n = data.size();
+    const double* d = data.constData();
+
+    if(n == 1)
+        return d[0];
+
+    // calculate double index and floor index (didx >= 0)
     double didx = ( time - start_time ) / dt;
 
-    int i0 = qFloor( didx );
+    int i0 = int( didx );
 
-    // do linear interpolation if needed
-    if(didx - i0 == 0.0)
-    {
-        return data.at( i0 );
-    }
-    else
-    {
-        int i1 = qCeil( didx );
-        if(i1 >= data.size())
-            i1 = data.size() - 1;
+    if(i0 >= n - 1)
+        return d[n - 1];
 
-        double v0 = data.at( i0 );
-        double v1 = data.at( i1 );
-        return v0 + (v1-v0) / dt * ( time - start_time - i0 * dt );
-    }
+    // linear interpolation
+    return d[i0] + (d[i0+1] - d[i0]) * (didx - i0);
 }
 
 
 
 /**
- * @brief Signal::indexAt return index for data/fitData
+ * @brief Signal::indexAt return index for data
  * @param time
  * @return
  */
@@ -181,9 +177,12 @@ bool Signal::hasDataAt(double time) const
  * @param newStartTime new start time
  * @param newDt new sample size (time step)
  * @param noSamples new number of samples / data points
+ * @param method interpolation method (see SignalResampler)
  * @throw
+ * @details Data points outside of the signal range are set to 0.0.
+ * Nothing is done if the time steps already match.
  */
-void Signal::resample(double newStartTime, double newDt, int noSamples)
+void Signal::resample(double newStartTime, double newDt, int noSamples, SignalResampler::Method method)
 {
     if(this->data.isEmpty())
         throw LIISimException( "Signal::reSample: empty signal !" );
@@ -196,18 +195,15 @@ void Signal::resample(double newStartTime, double newDt, int noSamples)
         throw LIISimException( "Signal::reSample: new delta time must be > 0 !" );
 
 
-    QVector<double> newData;
-    newData.fill(0.0,  noSamples);
+    SignalResampler resampler(start_time, dt, data.size(),
+                              newStartTime, newDt, noSamples,
+                              method);
 
-    // sample data at new time step
-    for(int i = 0; i < noSamples; i++)
-    {
-        double t = newStartTime + i * newDt;
-        newData[i] = at(t);
-    }
+    if(resampler.isIdentity())
+        return;
 
     // rewrite data and time information
-    data = newData;
+    data = resampler.apply(data);
     start_time = newStartTime;
     dt = newDt;
 }
@@ -258,9 +254,6 @@ Signal Signal::getSection(int start, int end)
     for(int i = start, j=0; i < end; i++, j++)
     {
         signal.data[j] = this->data[i];
-
-        if(this->fitData.size() > 0)
-            signal.fitData[j] = this->fitData[i];
     }
 
     return signal;
@@ -3,6 +3,7 @@
 
 #include "../general/channel.h"
 #include <QVector>
+#include "signalresampler.h"
 #include "../../calculations/fit/fititerationresult.h"
 
 /**
@@ -37,11 +38,12 @@ public:
     double getTimeAtMinSignalRange(double start, double end);
     QPair<double, double> calcRangeAverageStdev(double start, double end);
 
-    double at(double time);
+    double at(double time) const;
     int indexAt(double time);
     bool hasDataAt(double time) const;
     double maxTime() const;
-    void resample( double newStartTime, double newDt, int noSamples );
+    void resample( double newStartTime, double newDt, int noSamples,
+                   SignalResampler::Method method = SignalResampler::LINEAR );
 
     enum SType { RAW, ABS, TEMPERATURE }; // signal type
     static QString stypeToString(Signal::SType stype);
@@ -61,8 +63,7 @@ public:
      * should have a corresponding particle diameter trace */
     QVector<double> dataDiameter;
 
-    /** @brief temperature planck fit: iteration list is stored for every time step */
-    QList<QList<FitIterationResult>> fitData;   // fit results
+    // temperature planck fit: iteration histories are stored in MRun::fitHistory()
 
     // TODO: put this meta fit information to MRun class
     QString fitMaterial;                        // save material used for temperature fitting
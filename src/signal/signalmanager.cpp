@@ -8,9 +8,7 @@
 #include <QStack>
 #include <QMutexLocker>
 #include <QTextStream>
-#include <QThreadPool>
 #include <QThread>
-#include <QtConcurrent/qtconcurrentrun.h>
 #include <QList>
 #include <QMap>
 #include <QXmlStreamWriter>
@@ -33,6 +31,9 @@
 #include "processing/processingplugin.h"
 #include "../../models/datamodel.h"
 #include "../../calculations/fit/fitrun.h"
+#include "../general/taskscheduler.h"
+#include "../general/profiling.h"
+#include "../general/headlessapplication.h"
 
 
 /**
@@ -43,7 +44,6 @@ SignalManager::SignalManager(DataModel *dataModel, QObject *parent) :  QObject(p
     m_dataModel(dataModel)
 {
     MSG_DETAIL_1("init SignalManager");
-    threadPool = QThreadPool::globalInstance();
     initActions();
 
     isLoading = false;
@@ -53,6 +53,16 @@ SignalManager::SignalManager(DataModel *dataModel, QObject *parent) :  QObject(p
     connect(m_dataModel,SIGNAL(fitRunCountChanged()),SLOT(onFitrunCountChanged()));
 
     m_calcMode = 0;
+
+    m_livePreview = true;
+    m_previewMPoint = 0;
+    m_previewPending = false;
+    m_backgroundProcessing = false;
+
+    m_reprocessTimer = new QTimer(this);
+    m_reprocessTimer->setSingleShot(true);
+    m_reprocessTimer->setInterval(reprocessDelay);
+    connect(m_reprocessTimer, SIGNAL(timeout()), SLOT(onReprocessTimeout()));
 }
 
 
@@ -117,6 +127,19 @@ void SignalManager::processSignals(MRun *mrun, QList<Signal::SType> typeList)
     else if(m_calcMode == 2)
         runs = m_dataModel->mrunList();
 
+    processRuns(runs, mrun, typeList);
+}
+
+
+/**
+ * @brief SignalManager::processRuns starts ProcessingTasks for the given runs
+ * (see processSignals())
+ * @param runs runs to be processed
+ * @param mrun current MRun (processed first)
+ * @param typeList signal type list to be processed (raw, abs, tempr)
+ */
+void SignalManager::processRuns(QList<MRun *> runs, MRun *mrun, QList<Signal::SType> typeList)
+{
     if(runs.size() == 0)
     {
         MESSAGE("nothing to process",LIISimMessageType::WARNING);
@@ -155,10 +178,13 @@ void SignalManager::processSignals(MRun *mrun, QList<Signal::SType> typeList)
     emit processingStateChanged(true);
     QString msg;
     msg = QString("Processing signal data of %0 run(s), please wait...").arg(runs.size());
-    MSG_NORMAL(msg);
+    if(!m_backgroundProcessing)
+        MSG_NORMAL(msg);
     MSG_STATUS_CONST(msg);
 
-    QApplication::setOverrideCursor(Qt::WaitCursor);
+    // do not block the gui during reprocessing after a preview
+    if(!m_backgroundProcessing)
+        QApplication::setOverrideCursor(Qt::WaitCursor);
 
     if(pendingProcessingTasks == 0)
         processingTimer.start();
@@ -196,7 +222,11 @@ void SignalManager::processSignals(MRun *mrun, QList<Signal::SType> typeList)
                     task, SLOT(stopTask()),
                     Qt::QueuedConnection);
 
-            threadPool->start(task);
+            // the run shown in the GUI is processed first
+            if(runs.at(i) == mrun)
+                TaskScheduler::instance()->start(task, TaskScheduler::INTERACTIVE);
+            else
+                TaskScheduler::instance()->start(task, TaskScheduler::PROCESSING);
         }
         else
         {
@@ -207,7 +237,9 @@ void SignalManager::processSignals(MRun *mrun, QList<Signal::SType> typeList)
 
     if(totalProcessingTasks == 0)
     {
-        QApplication::restoreOverrideCursor();
+        if(!m_backgroundProcessing)
+            QApplication::restoreOverrideCursor();
+        m_backgroundProcessing = false;
         emit allProcessingTasksFinished();
         emit processingStateChanged(false);
         ProcessingTask::resetIdCounter();
@@ -247,8 +279,9 @@ bool SignalManager::checkMemory()
 
             MESSAGE("NOT ENOUGH MEMORY AVAILABLE: " + warnmsg, LIISimMessageType::WARNING);
 
-            // show scary warn message
-            QMessageBox::warning(0,"Not enougth memory available!",warnmsg);
+            // show scary warn message (no dialogs without main window, message is logged)
+            if(!HeadlessApplication::isActive())
+                QMessageBox::warning(0,"Not enougth memory available!",warnmsg);
             return false;
         }
     }
@@ -267,11 +300,12 @@ bool SignalManager::checkMemory()
  * beginning with the given signal type (default raw, execution order:
  * raw->absolute->temperature)
  * @param startStype start signal type
+ * @return false if processing has not been started (see processRunList())
  */
-void SignalManager::processAllMRuns(Signal::SType startStype)
+bool SignalManager::processAllMRuns(Signal::SType startStype)
 {
     QList<MRun*> runList = m_dataModel->mrunList();
-    processRunList(runList, startStype);
+    return processRunList(runList, startStype);
 }
 
 
@@ -280,43 +314,45 @@ void SignalManager::processAllMRuns(Signal::SType startStype)
  * starting with processing chains of given start signal type
  * @param runs list of measurement runs
  * @param startStype first signal type which should be processed (default: Raw)
+ * @return false if processing has not been started (pending imports/exports,
+ * busy, memory check failed), allProcessingTasksFinished() is emitted otherwise
  */
-void SignalManager::processRunList(QList<MRun *> &runs, Signal::SType startStype)
+bool SignalManager::processRunList(QList<MRun *> &runs, Signal::SType startStype)
 {
     if(runs.size() == 0)
     {
         MESSAGE("nothing to process",LIISimMessageType::WARNING);
-        return;
+        return false;
     }
 
     // do no signal processing if signal imports are pending!
     if(isImporting())
     {
         MSG_WARN("SignalManager: cannot process MRun (imports pending!)");
-        return;
+        return false;
     }
 
     if(isExporting())
     {
         MSG_NORMAL("SignalManager: cannot process MRun (exports pending!)");
-        return;
+        return false;
     }
 
     if(isBusy())
     {
         MSG_NORMAL("SignalManager: cannot process MRun (still busy!)");
-        return;
+        return false;
     }
 
     if(m_dataModel->mrunCount() == 0)
     {
         MESSAGE("no signals for calculation available!",LIISimMessageType::WARNING);
-        return;
+        return false;
     }
 
     // memory test
     if(!checkMemory())
-        return;
+        return false;
 
     emit processingStateChanged(true);
     QString msg;
@@ -358,7 +394,7 @@ void SignalManager::processRunList(QList<MRun *> &runs, Signal::SType startStype
                     this, SLOT(onMessageReceive(QString,LIISimMessageType)),
                     Qt::QueuedConnection);
 
-            threadPool->start(task);
+            TaskScheduler::instance()->start(task, TaskScheduler::PROCESSING);
         }
         else
         {
@@ -377,6 +413,8 @@ void SignalManager::processRunList(QList<MRun *> &runs, Signal::SType startStype
         MESSAGE(msg,INFO);
         MSG_STATUS(msg);
     }
+
+    return true;
 }
 
 
@@ -423,13 +461,22 @@ void SignalManager::onProcessingTaskFinished(MRun *mrun)
         MESSAGE(msg,NORMAL);
         MSG_STATUS_CONST(msg);
 
-        QApplication::restoreOverrideCursor();
+        if(!m_backgroundProcessing)
+            QApplication::restoreOverrideCursor();
+        m_backgroundProcessing = false;
         emit allProcessingTasksFinished();        
         emit processingStateChanged(false);
         ProcessingTask::resetIdCounter();
 
         pendingProcessingTasks = 0;
 
+        // preview has been requested during processing
+        if(m_previewPending)
+            QTimer::singleShot(0, this, [this](){
+                if(m_previewPending && m_previewRun)
+                    requestPreview(m_previewRun, m_previewMPoint);
+            });
+
         mem_monitor.updateMemInfo();
         mem_monitor.runDataEstimate();
     }
@@ -461,6 +508,156 @@ void SignalManager::setCalculationMode(int mode)
 }
 
 
+/**
+ * @brief SignalManager::setLivePreview enables/disables the preview
+ * of plugin changes (see requestPreview())
+ * (option is set by CalculationToolbox in SignalEditor)
+ * @param state
+ */
+void SignalManager::setLivePreview(bool state)
+{
+    m_livePreview = state;
+
+    if(!state)
+    {
+        m_reprocessTimer->stop();
+        m_previewPending = false;
+    }
+}
+
+
+/**
+ * @brief SignalManager::previewSignals processes a single MPoint of a run in the
+ * calling thread (see ProcessingChain::previewMPoint()). All chains are processed
+ * in order raw, abs, temperature. If a chain cannot be previewed, the following
+ * chains are skipped.
+ * @param mrun
+ * @param mpIdx index of MPoint
+ * @return true if post signals of the MPoint have been updated
+ */
+bool SignalManager::previewSignals(MRun *mrun, int mpIdx)
+{
+    if(!mrun || mrun->isBusy() || mpIdx < 0 || mpIdx >= mrun->sizeAllMpoints())
+        return false;
+
+    PROFILE_ZONE("task", "Preview", mrun->getName());
+
+    QTime timer;
+    timer.start();
+
+    mrun->clearCancelRequest();
+
+    QList<Signal::SType> types;
+    types << Signal::RAW << Signal::ABS << Signal::TEMPERATURE;
+
+    bool processed = false;
+    try
+    {
+        for(int i = 0; i < types.size(); i++)
+        {
+            ProcessingChain* pchain = mrun->getProcessingChain(types.at(i));
+            if(!pchain)
+                continue;
+
+            // chains after an updated chain are processed completely
+            ProcessingChain::PreviewResult res = pchain->previewMPoint(mpIdx, processed);
+
+            if(res == ProcessingChain::PREVIEW_UNAVAILABLE)
+                break;
+            if(res == ProcessingChain::PREVIEW_PROCESSED)
+                processed = true;
+        }
+    }
+    catch(LIISimException e)
+    {
+        MSG_WARN(QString("Preview of %0: %1").arg(mrun->getName()).arg(e.what()));
+    }
+
+    if(!processed)
+        return false;
+
+    MSG_DEBUG(QString("SignalManager: preview of %0 (signal %1) processed in %2 ms")
+              .arg(mrun->getName()).arg(mpIdx + 1).arg(timer.elapsed()));
+
+    emit previewFinished(mrun, mpIdx);
+    return true;
+}
+
+
+/**
+ * @brief SignalManager::requestPreview is called if a plugin of the displayed run
+ * has been modified. The displayed MPoint is processed immediately, the full
+ * run is reprocessed in background after reprocessDelay.
+ * @param mrun displayed run
+ * @param mpIdx displayed MPoint
+ * @details A running background reprocessing of the run is cancelled, the preview
+ * is then processed when the ProcessingTask has been finished. Each new request
+ * restarts the delay of the background reprocessing.
+ */
+void SignalManager::requestPreview(MRun *mrun, int mpIdx)
+{
+    if(!m_livePreview || !mrun)
+        return;
+
+    if(isImporting() || isExporting() || m_isFitting)
+        return;
+
+    m_previewRun = mrun;
+    m_previewMPoint = mpIdx;
+    m_reprocessTimer->stop();
+
+    if(pendingProcessingTasks > 0)
+    {
+        // results of background processing are outdated
+        if(m_backgroundProcessing)
+            emit processingTasksStop();
+
+        m_previewPending = true;
+        return;
+    }
+
+    m_previewPending = false;
+
+    previewSignals(mrun, mpIdx);
+    m_reprocessTimer->start();
+}
+
+
+/**
+ * @brief SignalManager::onReprocessTimeout starts the background reprocessing
+ * of the last previewed run
+ */
+void SignalManager::onReprocessTimeout()
+{
+    if(!m_previewRun || !m_livePreview)
+        return;
+
+    // wait until manually started tasks are finished
+    if(pendingProcessingTasks > 0)
+    {
+        m_reprocessTimer->start();
+        return;
+    }
+
+    if(isBusy())
+        return;
+
+    QList<Signal::SType> typeList;
+    typeList << Signal::RAW << Signal::ABS << Signal::TEMPERATURE;
+
+    // only the modified run is outdated, independent of the calculation mode
+    QList<MRun*> runs;
+    runs << m_previewRun.data();
+
+    m_backgroundProcessing = true;
+    processRuns(runs, m_previewRun, typeList);
+
+    // processing has been rejected
+    if(pendingProcessingTasks == 0)
+        m_backgroundProcessing = false;
+}
+
+
 
 /************************************
  ***            IMPORT            ***
@@ -510,7 +707,7 @@ void SignalManager::checkImportRequest(SignalIORequest irq)
     connect(io, SIGNAL(checkFilesResult(QList<SignalIORequest>)), SLOT(onCheckFilesResult(QList<SignalIORequest>)));
     io->setAutoDelete(true);
 
-    QtConcurrent::run(io, &IOBase::checkImportRequest, irq);
+    TaskScheduler::instance()->run(TaskScheduler::IO, [io, irq]{ io->checkImportRequest(irq); });
 
     //emit checkImportRequestFinished(io->checkImportRequest(irq));
 }
@@ -527,7 +724,7 @@ void SignalManager::loadImportRequests(QList<SignalIORequest> irq)
         isLoading = true;
 
         // adjust number of cores for import
-        QThreadPool::globalInstance()->setMaxThreadCount( core->generalSettings->coreCountImport() );
+        TaskScheduler::instance()->setLaneLimit(TaskScheduler::IO, core->generalSettings->coreCountImport());
 
         IOBase* io = 0;
 
@@ -586,7 +783,7 @@ void SignalManager::importSignalsManager(SignalIORequest irq)
     isLoading = true;
 
     // adjust number of cores for import
-    QThreadPool::globalInstance()->setMaxThreadCount( core->generalSettings->coreCountImport() );
+    TaskScheduler::instance()->setLaneLimit(TaskScheduler::IO, core->generalSettings->coreCountImport());
 
     IOBase* io = 0;
 
@@ -640,10 +837,6 @@ void SignalManager::onImportFinished(int noSignals, double time)
 {
 
 
-    // reset number of cores
-    QThreadPool::globalInstance()->setMaxThreadCount(QThread::idealThreadCount());
-
-
     if(IOBase::abort_flag)
     {
         MSG_STATUS("Loading aborted.");
@@ -671,6 +864,7 @@ void SignalManager::onImportFinished(int noSignals, double time)
 
     // update calculation states of all runs.
     QList<MRun*> runs = Core::instance()->dataModel()->mrunList();
+    DataModelUpdateScope update(Core::instance()->dataModel());
     for(int i = 0; i < runs.size(); i++)
         runs[i]->updateCalculationStatus();
 
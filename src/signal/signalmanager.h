@@ -7,11 +7,12 @@
 #include <QMutex>
 #include <QTime>
 #include <QQueue>
-#include <QThreadPool>
 #include <QMap>
 #include <QHash>
 #include <QAction>
 #include <QFileInfo>
+#include <QTimer>
+#include <QPointer>
 
 class ProcessingTask;
 class ProcessingChain;
@@ -56,6 +57,7 @@ class SignalManager : public QObject
         bool isImporting() { return isLoading; }
         bool isExporting() { return m_isExporting;}
         bool isBusy() {      return m_isExporting|| m_isFitting || isLoading || (pendingProcessingTasks > 0); }
+        bool isBackgroundProcessing() { return m_backgroundProcessing; }
 
         inline QAction* actionDataImport(){return m_importAction;}
         inline QAction* actionDataExport(){return m_exportAction;}
@@ -64,16 +66,15 @@ class SignalManager : public QObject
 
         MemUsageMonitor* memUsageMonitor(){return &mem_monitor;}
 
+        /** @brief time between last preview and full reprocessing of the run [ms] */
+        static const int reprocessDelay = 500;
+
     private:
 
         /** @brief default directory which should be opened for signal import (used for scans)*/
         QString defaultDirectory;
 
 
-        /** @brief threadpool where all loading and processing tasks will be started in*/
-        QThreadPool *threadPool ;
-
-
         bool isLoading;
         bool m_isExporting = false;
         bool m_isFitting;
@@ -97,6 +98,19 @@ class SignalManager : public QObject
         /** @brief measures signal processing time */
         QTime processingTimer;
 
+        /** @brief live preview of the displayed MPoint after plugin changes (see requestPreview()) */
+        bool m_livePreview;
+        QPointer<MRun> m_previewRun;
+        int m_previewMPoint;
+        /** @brief preview has been requested while the run was processed */
+        bool m_previewPending;
+        /** @brief current processing tasks have been started after a preview */
+        bool m_backgroundProcessing;
+        /** @brief delays full reprocessing after the last preview */
+        QTimer* m_reprocessTimer;
+
+        void processRuns(QList<MRun*> runs, MRun* mrun, QList<Signal::SType> typeList);
+
         void initActions();
         QAction* m_importAction;
         QAction* m_exportAction;
@@ -109,8 +123,8 @@ class SignalManager : public QObject
 
         void importSignalsManager(SignalIORequest rq);
         void exportSignalsManager(SignalIORequest rq);        
-        void processAllMRuns(Signal::SType startStype = Signal::RAW);
-        void processRunList(QList<MRun*>& runs,Signal::SType startStype = Signal::RAW );
+        bool processAllMRuns(Signal::SType startStype = Signal::RAW);
+        bool processRunList(QList<MRun*>& runs,Signal::SType startStype = Signal::RAW );
 
         //void processSignals(MRun* mrun, Signal::SType startStype = Signal::RAW);
         void processSignals(MRun *mrun, QList<Signal::SType> typeList);
@@ -118,6 +132,12 @@ class SignalManager : public QObject
         void setCalculationMode(int mode);
         int calculationMode(){return m_calcMode;}
 
+        void setLivePreview(bool state);
+        bool livePreview(){return m_livePreview;}
+
+        bool previewSignals(MRun* mrun, int mpIdx);
+        void requestPreview(MRun* mrun, int mpIdx);
+
         void onProcessingTaskFinished(MRun* mrun);
         void onMessageReceive(const QString & msg, const LIISimMessageType & msg_type = NORMAL );
 
@@ -134,6 +154,8 @@ class SignalManager : public QObject
         void onProgressUpdate(float value);
         void onExportFinished(double time);
 
+        void onReprocessTimeout();
+
         void onFitrunCountChanged();
         void onFitStarted();
         void onFitFinished();
@@ -165,6 +187,9 @@ class SignalManager : public QObject
         /** @brief processingFinished emitted if signal processing for given runname is finished */
         void processingFinished(QString mrunname, Signal::SType stype);
 
+        /** @brief previewFinished emitted if the post signals of a single MPoint have been updated (see previewSignals()) */
+        void previewFinished(MRun* mrun, int mpIdx);
+
         /** @brief allProcessingTasksFinished is emitted if all ProcessingTasks from the threadpool have been finished */
         void allProcessingTasksFinished();
 
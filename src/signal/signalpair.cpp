@@ -13,3 +13,23 @@ SignalPair::~SignalPair()
 
 }
 
+
+
+/**
+ * @brief SignalPair::maxTime
+ * @param stype RAW or ABS
+ * @return time of last data point (also for compact data)
+ */
+double SignalPair::maxTime(Signal::SType stype) const
+{
+    if(stype == Signal::RAW)
+    {
+        if(!rawCounts.isEmpty())
+            return raw.start_time + (rawCounts.size() - 1) * raw.dt;
+        return raw.maxTime();
+    }
+
+    if(!absoluteCounts.isEmpty())
+        return absolute.start_time + (absoluteCounts.size() - 1) * absolute.dt;
+    return absolute.maxTime();
+}
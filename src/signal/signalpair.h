@@ -2,6 +2,7 @@
 #define SIGNALPAIR_H
 
 #include "signal.h"
+#include "compactsignal.h"
 
 /**
  * @brief stores a pair of signals (raw signal, absolute signal)
@@ -21,6 +22,14 @@ public:
     /** @brief Signal of Signal::SType ABS */
     Signal absolute;
 
+    /** @brief compact data of raw signal (if not empty, raw.data is empty) */
+    CompactSignal rawCounts;
+
+    /** @brief compact data of absolute signal (if not empty, absolute.data is empty) */
+    CompactSignal absoluteCounts;
+
+    double maxTime(Signal::SType stype) const;
+
 };
 
 #endif // SIGNALPAIR_H
@@ -0,0 +1,265 @@
+#include "signalresampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../calculations/constants.h"
+
+
+/** @brief relative tolerance for grid comparisons [data points] */
+static const double gridTolerance = 1E-9;
+
+/** @brief size of the Lanczos window */
+static const int lanczosSize = 3;
+
+
+static double lanczos(double x)
+{
+    if(x == 0.0)
+        return 1.0;
+    if(std::fabs(x) >= lanczosSize)
+        return 0.0;
+
+    const double px = Constants::pi * x;
+    return lanczosSize * std::sin(px) * std::sin(px / lanczosSize) / (px * px);
+}
+
+
+SignalResampler::SignalResampler()
+{
+    m_method = LINEAR;
+    m_srcStart = 0.0;
+    m_srcDt = 0.0;
+    m_srcSize = 0;
+    m_dstSize = 0;
+    m_first = 0;
+    m_last = 0;
+    m_aligned = false;
+    m_offset = 0;
+    m_taps = 0;
+}
+
+
+/**
+ * @brief SignalResampler::SignalResampler calculates the source indices and
+ * weights of all output samples
+ * @param srcStart start time of source grid [s]
+ * @param srcDt time step of source grid [s]
+ * @param srcSize number of source samples
+ * @param dstStart start time of output grid [s]
+ * @param dstDt time step of output grid [s]
+ * @param dstSize number of output samples
+ * @param method interpolation method
+ */
+SignalResampler::SignalResampler(double srcStart, double srcDt, int srcSize,
+                                 double dstStart, double dstDt, int dstSize,
+                                 Method method)
+{
+    m_method = method;
+    m_srcStart = srcStart;
+    m_srcDt = srcDt;
+    m_srcSize = srcSize;
+    m_dstSize = qMax(0, dstSize);
+    m_first = 0;
+    m_last = 0;
+    m_aligned = false;
+    m_offset = 0;
+    m_taps = 0;
+
+    if(srcSize <= 0 || m_dstSize == 0 || dstDt <= 0.0)
+        return;
+
+    // single source sample: only available at its time
+    if(srcSize == 1 || srcDt <= 0.0)
+    {
+        double didx = (srcStart - dstStart) / dstDt;
+        int i = int(std::floor(didx + 0.5));
+        if(std::fabs(didx - i) <= gridTolerance && i >= 0 && i < m_dstSize)
+        {
+            m_aligned = true;
+            m_offset = -i;
+            m_first = i;
+            m_last = i + 1;
+        }
+        return;
+    }
+
+    // output samples within source range [srcStart, srcStart + (srcSize-1)*srcDt]
+    const double srcEnd = srcStart + (srcSize - 1) * srcDt;
+    m_first = int(std::ceil((srcStart - dstStart) / dstDt - gridTolerance));
+    m_last  = int(std::floor((srcEnd - dstStart) / dstDt + gridTolerance)) + 1;
+    m_first = qBound(0, m_first, m_dstSize);
+    m_last  = qBound(m_first, m_last, m_dstSize);
+
+    // same time step and integer offset: no interpolation needed
+    double offset = (dstStart - srcStart) / srcDt;
+    int ioffset = int(std::floor(offset + 0.5));
+    if(std::fabs(dstDt - srcDt) <= gridTolerance * srcDt
+            && std::fabs(offset - ioffset) <= gridTolerance * qMax(1.0, std::fabs(offset)))
+    {
+        m_aligned = true;
+        m_offset = ioffset;
+        m_first = qBound(0, -ioffset, m_dstSize);
+        m_last  = qBound(m_first, srcSize - ioffset, m_dstSize);
+        return;
+    }
+
+    // index/weight stream
+    const double ratio = dstDt / srcDt;
+    const double scale = (method == SINC) ? qMax(1.0, ratio) : 1.0;
+    int half = 1;
+
+    switch(method)
+    {
+    case CUBIC:
+        m_taps = 4;
+        break;
+    case SINC:
+        half = int(std::ceil(lanczosSize * scale));
+        m_taps = 2 * half;
+        break;
+    default:
+        m_taps = 2;
+    }
+
+    const int count = m_last - m_first;
+    m_index.resize(count * m_taps);
+    m_weights.resize(count * m_taps);
+
+    int* index = m_index.data();
+    double* weights = m_weights.data();
+
+    for(int o = 0; o < count; o++)
+    {
+        double x = (dstStart - srcStart) / srcDt + (m_first + o) * ratio;
+        x = qBound(0.0, x, double(srcSize - 1));
+
+        int i0 = qMin(int(x), srcSize - 2);
+        double f = x - i0;
+
+        int* idx = index + o * m_taps;
+        double* w = weights + o * m_taps;
+
+        if(method == CUBIC)
+        {
+            // Catmull-Rom spline, edge samples are repeated
+            const double f2 = f * f;
+            const double f3 = f2 * f;
+            w[0] = -0.5 * f3 + f2 - 0.5 * f;
+            w[1] =  1.5 * f3 - 2.5 * f2 + 1.0;
+            w[2] = -1.5 * f3 + 2.0 * f2 + 0.5 * f;
+            w[3] =  0.5 * f3 - 0.5 * f2;
+
+            for(int k = 0; k < 4; k++)
+                idx[k] = qBound(0, i0 - 1 + k, srcSize - 1);
+        }
+        else if(method == SINC)
+        {
+            // Lanczos kernel, stretched by the decimation ratio (anti-aliasing),
+            // edge samples are repeated and weights are normalized
+            double sum = 0.0;
+            for(int k = 0; k < m_taps; k++)
+            {
+                int i = i0 - half + 1 + k;
+                w[k] = lanczos((x - i) / scale);
+                idx[k] = qBound(0, i, srcSize - 1);
+                sum += w[k];
+            }
+            if(sum != 0.0)
+                for(int k = 0; k < m_taps; k++)
+                    w[k] /= sum;
+        }
+        else
+        {
+            idx[0] = i0;
+            idx[1] = i0 + 1;
+            w[0] = 1.0 - f;
+            w[1] = f;
+        }
+    }
+}
+
+
+/**
+ * @brief SignalResampler::hasSource
+ * @return true if this resampler has been created for the given source grid
+ * (can be reused for signals with this grid)
+ */
+bool SignalResampler::hasSource(double srcStart, double srcDt, int srcSize) const
+{
+    return srcStart == m_srcStart && srcDt == m_srcDt && srcSize == m_srcSize;
+}
+
+
+/**
+ * @brief SignalResampler::apply resamples data
+ * @param src source data (size of source grid)
+ * @param dst output data (size of output grid), samples outside of the
+ * source range are set to 0.0
+ */
+void SignalResampler::apply(const double *src, double *dst) const
+{
+    std::fill(dst, dst + m_first, 0.0);
+    std::fill(dst + m_last, dst + m_dstSize, 0.0);
+
+    if(m_aligned)
+    {
+        std::copy(src + m_first + m_offset, src + m_last + m_offset, dst + m_first);
+        return;
+    }
+
+    const int count = m_last - m_first;
+    const int* index = m_index.constData();
+    const double* weights = m_weights.constData();
+    double* out = dst + m_first;
+
+    if(m_taps == 2)
+    {
+        for(int o = 0; o < count; o++)
+            out[o] = weights[2*o] * src[index[2*o]] + weights[2*o+1] * src[index[2*o+1]];
+    }
+    else if(m_taps == 4)
+    {
+        for(int o = 0; o < count; o++)
+        {
+            const int* idx = index + 4*o;
+            const double* w = weights + 4*o;
+            out[o] = w[0] * src[idx[0]] + w[1] * src[idx[1]] + w[2] * src[idx[2]] + w[3] * src[idx[3]];
+        }
+    }
+    else
+    {
+        for(int o = 0; o < count; o++)
+        {
+            const int* idx = index + m_taps*o;
+            const double* w = weights + m_taps*o;
+
+            double sum = 0.0;
+            for(int k = 0; k < m_taps; k++)
+                sum += w[k] * src[idx[k]];
+            out[o] = sum;
+        }
+    }
+}
+
+
+/**
+ * @brief SignalResampler::apply resamples data
+ * @param src source data (size of source grid)
+ * @return resampled data (shares the source data if the grids are identical)
+ */
+QVector<double> SignalResampler::apply(const QVector<double> &src) const
+{
+    if(isIdentity() && src.size() == m_srcSize)
+        return src;
+
+    QVector<double> dst(m_dstSize);
+    if(src.size() < m_srcSize)
+    {
+        dst.fill(0.0);
+        return dst;
+    }
+
+    apply(src.constData(), dst.data());
+    return dst;
+}
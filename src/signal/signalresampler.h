@@ -0,0 +1,66 @@
+#ifndef SIGNALRESAMPLER_H
+#define SIGNALRESAMPLER_H
+
+#include <QVector>
+
+/**
+ * @brief The SignalResampler class resamples data from one uniform time grid
+ * (start time, dt, size) to another.
+ * @ingroup Hierachical-Data-Model
+ * @details The source index and interpolation weights of each output sample
+ * are calculated once (constructor), apply() only runs a loop over this index/weight
+ * stream. The same resampler can be applied to all signals which share the source
+ * grid (e.g. all MPoints of a run). Grids with the same dt and an integer
+ * offset are copied without interpolation, matching grids need no work at all.
+ * Output samples outside of the source range are set to 0.0 (see Signal::at()).
+ */
+class SignalResampler
+{
+public:
+    /** @brief interpolation method: linear, cubic (Catmull-Rom) or windowed sinc (Lanczos, a = 3) */
+    enum Method { LINEAR, CUBIC, SINC };
+
+    SignalResampler();
+    SignalResampler(double srcStart, double srcDt, int srcSize,
+                    double dstStart, double dstDt, int dstSize,
+                    Method method = LINEAR);
+
+    bool hasSource(double srcStart, double srcDt, int srcSize) const;
+
+    /** @brief true if source and output grid are identical */
+    inline bool isIdentity() const { return m_aligned && m_offset == 0 && m_srcSize == m_dstSize; }
+
+    /** @brief index of first output sample within source range */
+    inline int firstIndex() const { return m_first; }
+    /** @brief index after the last output sample within source range */
+    inline int lastIndex() const { return m_last; }
+    /** @brief number of output samples */
+    inline int size() const { return m_dstSize; }
+
+    void apply(const double *src, double *dst) const;
+    QVector<double> apply(const QVector<double> &src) const;
+
+private:
+    Method m_method;
+
+    double m_srcStart;
+    double m_srcDt;
+    int m_srcSize;
+    int m_dstSize;
+
+    int m_first;
+    int m_last;
+
+    /** @brief same dt and integer offset: output sample i is source sample i + m_offset */
+    bool m_aligned;
+    int m_offset;
+
+    /** @brief number of source samples per output sample */
+    int m_taps;
+    /** @brief source index of each tap (m_taps per output sample within source range) */
+    QVector<int> m_index;
+    /** @brief weight of each tap */
+    QVector<double> m_weights;
+};
+
+#endif // SIGNALRESAMPLER_H